@@ -397,12 +397,18 @@ public:
 
         _total = _keys.size();
 
+        openCheckpoint();
+
+        startVisit();
+
         for (auto &key : _keys)
         {
             this->handleTile(key);
         }
 
-        _group->join();
+        finishVisit();
+
+        closeCheckpoint();
     }    
 
     std::vector< TileKey > _keys;
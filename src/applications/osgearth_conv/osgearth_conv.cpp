@@ -18,6 +18,7 @@
 #include <osgEarth/GLUtils>
 #include <osgEarth/TileRasterizer>
 #include <osgEarth/NodeUtils>
+#include <osgEarth/TMSBackFiller>
 #include <osgEarth/weejobs.h>
 
 #include <osg/ArgumentParser>
@@ -47,84 +48,74 @@ int usage(char** argv)
         << "\n    --extents [minLat] [minLong] [maxLat] [maxLong] : Lat/Long extends to copy"
         << "\n    --no-overwrite                      : skip tiles that already exist in the destination"
         << "\n    --threads [int]                     : go faster by using [n] working threads"
-        << "\n    --threaded-writer                   : write to the output layer in a separate thread (good for MBTiles)"
+        << "\n    --read-threads [int]                : threads reading input tiles (default = --threads)"
+        << "\n    --write-threads [int]               : threads writing output tiles (default = --threads)"
+        << "\n    --threaded-writer                   : write to the output layer with one thread (good for MBTiles)"
+        << "\n    --queue-size [int]                  : max tiles waiting between stages (default = 64)"
+        << "\n    --checkpoint [file]                 : record finished tiles in [file], and resume from it if it exists"
+        << "\n    --backfill                          : copy only the max level, then build the lower levels from it"
         << std::endl;
 
     return 0;
 }
 
-// Visitor that converts image tiles
+// Visitor that converts image tiles, one stage at a time
 struct ImageLayerTileCopy : public TileHandler
 {
-    ImageLayerTileCopy(ImageLayer* source, ImageLayer* dest, bool overwrite, bool compress, bool threaded_writer)
-        : _source(source), _dest(dest), _overwrite(overwrite), _compress(compress), _threaded_writer(threaded_writer)
+    ImageLayerTileCopy(ImageLayer* source, ImageLayer* dest, bool overwrite, bool compress)
+        : _source(source), _dest(dest), _overwrite(overwrite), _compress(compress)
     {
-        if (_threaded_writer)
-        {
-            _write_context.pool = jobs::get_pool("image_writer", 1);
-            _write_context.group = jobs::jobgroup::create();
-        }
     }
 
-    ~ImageLayerTileCopy()
+    bool isStaged() const override
     {
-        if (_threaded_writer)
-        {
-            std::cout << "Stand by while I finish writing..." << std::endl;
-            _write_context.group->join();
-        }
+        return true;
     }
 
-    bool handleTile(const TileKey& key, const TileVisitor& tv) override
+    TileData readTile(const TileKey& key, const TileVisitor& tv) override
     {
-        bool ok = false;
-
         // if overwriting is disabled, check to see whether the destination
         // already has data for the key
         if (_overwrite == false)
         {
             if (_dest->createImage(key).valid())
             {
-                return true;
+                return {};
             }
         }
 
         GeoImage image = _source->createImage(key);
-        if (image.valid())
-        {
-            osg::ref_ptr<const osg::Image> imageToWrite = image.getImage();
-            if (_compress)
-                imageToWrite = ImageUtils::compressImage(image.getImage(), "cpu");
+        return image.valid() ? image.getImage() : nullptr;
+    }
 
-            if (_threaded_writer)
-            {
-#if 1
-                if (_dest->isEncodingSupported())
-                {
-                    auto encoded = _dest->encodeImage(key, imageToWrite.get(), nullptr);
-                    if (encoded.isOK())
-                        imageToWrite = encoded.value();
-                }
-#endif
-
-                jobs::dispatch([=]()
-                    {
-                        Status status = _dest->writeImage(key, imageToWrite.get(), 0L);
-                    },
-                    _write_context);
-            }
-            else
-            {
-                Status status = _dest->writeImage(key, imageToWrite.get(), 0L);
-                ok = status.isOK();
-                if (!ok)
-                {
-                    OE_WARN << key.str() << ": " << status.message() << std::endl;
-                }
-            }
+    TileData processTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+    {
+        const osg::Image* image = static_cast<const osg::Image*>(data);
+        if (_compress)
+            return ImageUtils::compressImage(image, "cpu");
+        return image;
+    }
+
+    TileData encodeTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+    {
+        const osg::Image* image = static_cast<const osg::Image*>(data);
+        if (_dest->isEncodingSupported())
+        {
+            auto encoded = _dest->encodeImage(key, image, nullptr);
+            if (encoded.isOK())
+                return encoded.value();
         }
+        return image;
+    }
 
-        return ok;
+    bool writeTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+    {
+        Status status = _dest->writeImage(key, static_cast<const osg::Image*>(data), 0L);
+        if (status.isError())
+        {
+            OE_WARN << key.str() << ": " << status.message() << std::endl;
+        }
+        return status.isOK();
     }
 
     bool hasData(const TileKey& key) const override
@@ -153,73 +144,45 @@ struct ImageLayerTileCopy : public TileHandler
     osg::ref_ptr<ImageLayer> _dest;
     bool _overwrite;
     bool _compress;  
-    bool _threaded_writer = false;
-    jobs::context _write_context;
-
 };
 
-// Visitor that converts elevation tiles
+// Visitor that converts elevation tiles, one stage at a time
 struct ElevationLayerTileCopy : public TileHandler
 {
-    ElevationLayerTileCopy(ElevationLayer* source, ElevationLayer* dest, bool overwrite, bool threaded_writer)
-        : _source(source), _dest(dest), _overwrite(overwrite), _threaded_writer(threaded_writer)
+    ElevationLayerTileCopy(ElevationLayer* source, ElevationLayer* dest, bool overwrite)
+        : _source(source), _dest(dest), _overwrite(overwrite)
     {
-        if (_threaded_writer)
-        {
-            _write_context.pool = jobs::get_pool("image_writer", 1);
-            _write_context.group = jobs::jobgroup::create();
-        }
     }
 
-    ~ElevationLayerTileCopy()
+    bool isStaged() const override
     {
-        if (_threaded_writer)
-        {
-            std::cout << "Stand by while I finish writing..." << std::endl;
-            _write_context.group->join();
-        }
+        return true;
     }
 
-    bool handleTile(const TileKey& key, const TileVisitor& tv) override
+    TileData readTile(const TileKey& key, const TileVisitor& tv) override
     {
-        bool ok = false;
-
         // if overwriting is disabled, check to see whether the destination
         // already has data for the key
         if (_overwrite == false)
         {
             if (_dest->createHeightField(key).valid())
             {
-                return true;
+                return {};
             }
         }
 
         GeoHeightField hf = _source->createHeightField(key, 0L);
-        if ( hf.valid() )
-        {
-            if (_threaded_writer)
-            {
-                jobs::dispatch([=]()
-                    {
-                        Status s = _dest->writeHeightField(key, hf.getHeightField(), 0L);
-                    },
-                    _write_context);
-            }
-            else
-            {
-                Status s = _dest->writeHeightField(key, hf.getHeightField(), 0L);
-                ok = s.isOK();
-                if (!ok)
-                {
-                    OE_WARN << key.str() << ": " << s.message() << std::endl;
-                }
-            }
-        }
-        else
+        return hf.valid() ? hf.getHeightField() : nullptr;
+    }
+
+    bool writeTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+    {
+        Status s = _dest->writeHeightField(key, static_cast<const osg::HeightField*>(data), 0L);
+        if (s.isError())
         {
-            //OE_WARN << key.str() << " : " << hf.getStatus().message() << std::endl;
+            OE_WARN << key.str() << ": " << s.message() << std::endl;
         }
-        return ok;
+        return s.isOK();
     }
 
     bool hasData(const TileKey& key) const override
@@ -247,8 +210,6 @@ struct ElevationLayerTileCopy : public TileHandler
     osg::ref_ptr<ElevationLayer> _source;
     osg::ref_ptr<ElevationLayer> _dest;
     bool _overwrite;
-    bool _threaded_writer = false;
-    jobs::context _write_context;
 };
 
 
@@ -549,11 +510,30 @@ main(int argc, char** argv)
     mtv->setNumThreads(numThreads < 1 ? 1 : numThreads);
     visitor = mtv;
 
+    // size the stages of the conversion pipeline:
+    unsigned stageThreads = 0;
+    if (args.read("--read-threads", stageThreads))
+        mtv->setNumStageThreads(TileHandler::STAGE_READ, stageThreads);
+
+    if (args.read("--threaded-writer"))
+        mtv->setNumStageThreads(TileHandler::STAGE_WRITE, 1);
+
+    if (args.read("--write-threads", stageThreads))
+        mtv->setNumStageThreads(TileHandler::STAGE_WRITE, stageThreads);
+
+    unsigned queueSize = 0;
+    if (args.read("--queue-size", queueSize))
+        mtv->setQueueSize(queueSize);
+
+    std::string checkpointFile;
+    if (args.read("--checkpoint", checkpointFile))
+        visitor->setCheckpointFile(checkpointFile);
+
     bool overwrite = true;
     if (args.read("--no-overwrite"))
         overwrite = false;
 
-    bool threaded_writer = args.read("--threaded-writer");
+    bool backfill = args.read("--backfill");
 
     if (dynamic_cast<ImageLayer*>(input.get()) && dynamic_cast<ImageLayer*>(output.get()))
     {
@@ -561,16 +541,14 @@ main(int argc, char** argv)
             dynamic_cast<ImageLayer*>(input.get()),
             dynamic_cast<ImageLayer*>(output.get()),
             overwrite,
-            compress,
-            threaded_writer));
+            compress));
     }
     else if (dynamic_cast<ElevationLayer*>(input.get()) && dynamic_cast<ElevationLayer*>(output.get()))
     {
         visitor->setTileHandler(new ElevationLayerTileCopy(
             dynamic_cast<ElevationLayer*>(input.get()),
             dynamic_cast<ElevationLayer*>(output.get()),
-            overwrite,
-            threaded_writer));
+            overwrite));
     }
 
     // set the manual extents, if specified:
@@ -646,6 +624,21 @@ main(int argc, char** argv)
         OE_NOTICE << LC << "Calculated max level = " << maxLevel << std::endl;
     }
 
+    // when backfilling, only the max level comes from the input:
+    unsigned backfillMinLevel = minLevel < ~0 ? minLevel : 0;
+    if (backfill)
+    {
+        if (maxLevel > backfillMinLevel)
+        {
+            visitor->setMinLevel(maxLevel);
+        }
+        else
+        {
+            OE_WARN << LC << "Backfill needs a max level above the min level; ignoring --backfill" << std::endl;
+            backfill = false;
+        }
+    }
+
     // If we've not added any extents to visit just add the entire input extent
     if (visitor->getExtentsToVisit().empty())
     {
@@ -758,6 +751,43 @@ main(int argc, char** argv)
         visitor->run(outputProfile.get());
     }
 
+    if (backfill)
+    {
+        GeoExtent backfillExtent;
+        for (auto& extent : visitor->getExtentsToVisit())
+        {
+            GeoExtent outputExtent = outputProfile->clampAndTransformExtent(extent);
+            if (backfillExtent.isValid())
+                backfillExtent.expandToInclude(outputExtent);
+            else
+                backfillExtent = outputExtent;
+        }
+
+        visitor = nullptr;
+
+        std::cout << "Backfilling levels " << backfillMinLevel << " to " << (maxLevel - 1) << "..." << std::endl;
+
+        Contrib::TMSBackFiller backfiller;
+        backfiller.setMinLevel(backfillMinLevel);
+        backfiller.setMaxLevel(maxLevel);
+        backfiller.setNumThreads(numThreads < 1 ? 1 : numThreads);
+        if (backfillExtent.isValid())
+        {
+            Bounds bounds = backfillExtent.bounds();
+            backfiller.setBounds(bounds);
+        }
+
+        Status status = backfiller.process(output.get());
+        if (status.isError())
+        {
+            OE_WARN << LC << "Backfill failed: " << status.message() << std::endl;
+        }
+        else
+        {
+            std::cout << "Backfilled " << backfiller.getNumTilesWritten() << " tiles." << std::endl;
+        }
+    }
+
     osg::Timer_t t1 = osg::Timer::instance()->tick();
 
     std::cout
@@ -31,6 +31,7 @@ usage(const char* name, const std::string& error)
         << "\n  --extents swlong swlat nelong nelat  ; extents in degrees"
         << "\n  --out out.shp                        ; output features"
         << "\n  --include-asset-property <name>      ; include asset property name as attribute (optional)"
+        << "\n  --benchmark                          ; time placement generation instead of exporting (optional)"
         << std::endl;
 
     return -1;
@@ -47,6 +48,7 @@ struct App
     Threading::Mutexed<std::queue<FeatureList*> > outputQueue;
     Threading::Event outputReady;
     bool debug;
+    bool benchmark;
 
     App() { }
 
@@ -61,6 +63,8 @@ struct App
             getchar();
         }
 
+        benchmark = arguments.read("--benchmark");
+
         std::string layername;
         arguments.read("--layer", layername);
 
@@ -70,7 +74,7 @@ struct App
         extent = GeoExtent(SpatialReference::get("wgs84"), xmin, ymin, xmax, ymax);
 
         std::string outfile;
-        if (!arguments.read("--out", outfile))
+        if (!arguments.read("--out", outfile) && !benchmark)
             return usage(argv[0], "Missing --out");
 
         osg::ref_ptr<osg::Node> node = osgDB::readNodeFiles(arguments);
@@ -98,6 +102,9 @@ struct App
         if (featureGen.getStatus().isError())
             return usage(argv[0], featureGen.getStatus().message());
 
+        if (benchmark)
+            return 0;
+
         // create output shapefile
         osg::ref_ptr<FeatureProfile> outProfile = new FeatureProfile(extent);
         FeatureSchema outSchema;
@@ -136,6 +143,34 @@ struct App
         outputReady.set();
         outputQueue.unlock();
     }
+
+    // Generates the tree placements for every key twice, once from scratch
+    // and once revisiting the same tiles, and reports the times.
+    int runBenchmark(const std::vector<TileKey>& keys)
+    {
+        for (const char* pass : { "cold", "warm" })
+        {
+            std::size_t placements = 0u;
+            osg::Timer_t start = osg::Timer::instance()->tick();
+
+            for (const auto& key : keys)
+            {
+                std::vector<VegetationLayer::Placement> output;
+                veglayer->getAssetPlacements(key, "trees", true, output, nullptr);
+                placements += output.size();
+            }
+
+            double s = osg::Timer::instance()->delta_s(start, osg::Timer::instance()->tick());
+            std::cout
+                << "Placements (" << pass << ")"
+                << "; keys=" << keys.size()
+                << "; placements=" << placements
+                << "; time=" << s << "s"
+                << "; per key=" << (1000.0 * s / keys.size()) << "ms"
+                << std::endl;
+        }
+        return 0;
+    }
 };
 
 int
@@ -155,6 +190,9 @@ main(int argc, char** argv)
     if (keys.empty())
         return usage(argv[0], "No data in extent");
 
+    if (app.benchmark)
+        return app.runBenchmark(keys);
+
     std::cout << "Exporting " << keys.size() << " keys.." << std::endl;
 
     for(const auto key : keys)
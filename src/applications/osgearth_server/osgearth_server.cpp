@@ -7,6 +7,7 @@
 #include <osgEarth/ImageLayer>
 #include <osgEarth/ElevationLayer>
 #include <osgEarth/GDAL>
+#include <osgEarth/MetricsRegistry>
 #include "httplib.h"
 
 using namespace osgEarth;
@@ -16,7 +17,7 @@ int
 usage(const char* name, const char* message)
 {
     std::cerr << "Error: " << message << std::endl;
-    std::cerr << "Usage: " << name << " file.earth" << std::endl;
+    std::cerr << "Usage: " << name << " file.earth [--port n] [--host name] [--threads n] [--no-metrics]" << std::endl;
     return -1;
 }
 
@@ -40,6 +41,10 @@ main(int argc, char** argv)
     unsigned int threads = std::max(std::thread::hardware_concurrency() - 1, 8u);
     arguments.read("--threads", threads);
 
+    // Serve metrics at /metrics (Prometheus) and /metrics.json
+    if (!arguments.read("--no-metrics"))
+        osgEarth::Util::MetricsRegistry::setEnabled(true);
+
     // Load the earth file:
     osg::ref_ptr<osg::Node> node = osgDB::readNodeFiles(arguments);
     if (!node.valid())
@@ -133,6 +138,14 @@ main(int argc, char** argv)
         }
         });
 
+    svr.Get("/metrics", [](const Request& req, Response& res) {
+        res.set_content(osgEarth::Util::MetricsRegistry::instance().toPrometheus(), "text/plain; version=0.0.4");
+        });
+
+    svr.Get("/metrics.json", [](const Request& req, Response& res) {
+        res.set_content(osgEarth::Util::MetricsRegistry::instance().toJSON(), "application/json");
+        });
+
     svr.listen(host, port);
 
     return 0;
@@ -8,6 +8,10 @@
 #include <osgEarth/Registry>
 #include <osgEarth/MemCache>
 #include <osgEarth/Containers>  // For osgEarth::LRUCache
+#include <osgEarth/FileUtils>
+#include <osgEarth/Notify>
+#include <chrono>
+#include <filesystem>
 
 using namespace osgEarth;
 
@@ -63,6 +67,29 @@ TEST_CASE("Cache")
         ReadResult r2 = bin->readImage(key, 0L);
         REQUIRE(r2.failed());
     }
+
+    SECTION("Many")
+    {
+        std::vector<CacheBin::Record> records;
+        for (unsigned i = 0; i < 3; ++i)
+            records.push_back({ "many_" + std::to_string(i), new StringObject(std::to_string(i)), Config() });
+
+        REQUIRE(bin->writeMany(records, 0L) == 3);
+
+        std::vector<std::string> keys = { "many_2", "many_missing", "many_0" };
+
+        auto statuses = bin->statusMany(keys);
+        REQUIRE(statuses.size() == 3);
+        REQUIRE(statuses[0] == CacheBin::STATUS_OK);
+        REQUIRE(statuses[1] == CacheBin::STATUS_NOT_FOUND);
+        REQUIRE(statuses[2] == CacheBin::STATUS_OK);
+
+        auto results = bin->readMany(keys, 0L);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].getString() == "2");
+        REQUIRE(results[1].failed());
+        REQUIRE(results[2].getString() == "0");
+    }
 }
 
 TEST_CASE("LRUCache")
@@ -161,4 +188,113 @@ TEST_CASE("LRUCache")
         REQUIRE_FALSE(cache.touch(4));
     }
 
-}
\ No newline at end of file
+}
+
+namespace
+{
+    osg::ref_ptr<Cache> createCache(const std::string& driver, const std::string& dir, unsigned maxSizeMB)
+    {
+        Config conf;
+        conf.set("driver", driver);
+        conf.set("path", dir);
+        if (maxSizeMB > 0)
+            conf.set("max_size_mb", maxSizeMB);
+
+        osg::ref_ptr<Cache> cache = CacheFactory::create(CacheOptions(conf));
+        if (!cache.valid() || cache->getStatus().isError())
+        {
+            OE_WARN << "Cache driver \"" << driver << "\" is not available" << std::endl;
+            return nullptr;
+        }
+        return cache;
+    }
+
+    osg::ref_ptr<osg::Image> createTile(unsigned i)
+    {
+        osg::ref_ptr<osg::Image> image = new osg::Image();
+        image->allocateImage(256, 256, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+        for (unsigned j = 0; j < image->getTotalSizeInBytes(); ++j)
+            image->data()[j] = (unsigned char)(i + j);
+        return image;
+    }
+
+    double secondsSince(const std::chrono::steady_clock::time_point& t0)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+}
+
+TEST_CASE("Cache bulk read and write benchmarks", "[.benchmark]")
+{
+    const unsigned records = 2000, batch = 100;
+
+    for (std::string driver : { "memory", "filesystem", "leveldb", "rocksdb" })
+    {
+        std::string dir = getTempName(getTempPath(), "_" + driver);
+
+        // two bins, one for each path, so each write is a new record
+        osg::ref_ptr<Cache> cache;
+        if (driver == "memory")
+            cache = new MemCache();
+        else
+            cache = createCache(driver, dir, 0u);
+        if (!cache.valid())
+            continue;
+
+        osg::ref_ptr<CacheBin> single = cache->addBin("single");
+        osg::ref_ptr<CacheBin> bulk = cache->addBin("bulk");
+
+        std::vector<CacheBin::Record> tiles;
+        for (unsigned i = 0; i < records; ++i)
+            tiles.push_back({ std::to_string(i), createTile(i), Config() });
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (auto& tile : tiles)
+            single->write(tile.key, tile.object.get(), tile.metadata, nullptr);
+        double writeOne = secondsSince(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < records; i += batch)
+        {
+            std::vector<CacheBin::Record> some(tiles.begin() + i, tiles.begin() + std::min(i + batch, records));
+            bulk->writeMany(some, nullptr);
+        }
+        double writeMany = secondsSince(t0);
+
+        std::vector<std::string> keys;
+        for (auto& tile : tiles)
+            keys.push_back(tile.key);
+
+        t0 = std::chrono::steady_clock::now();
+        unsigned hitsOne = 0;
+        for (auto& key : keys)
+        {
+            if (single->readImage(key, nullptr).succeeded())
+                ++hitsOne;
+        }
+        double readOne = secondsSince(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        unsigned hitsMany = 0;
+        for (unsigned i = 0; i < records; i += batch)
+        {
+            std::vector<std::string> some(keys.begin() + i, keys.begin() + std::min(i + batch, records));
+            for (auto& result : bulk->readManyImages(some, nullptr))
+            {
+                if (result.succeeded())
+                    ++hitsMany;
+            }
+        }
+        double readMany = secondsSince(t0);
+
+        OE_NOTICE << driver << ": " << records << " tiles in batches of " << batch
+            << "; write " << (records / writeOne) << " vs " << (records / writeMany) << " tiles/s"
+            << "; read " << (hitsOne / readOne) << " vs " << (hitsMany / readMany) << " tiles/s"
+            << " (per-key vs bulk)" << std::endl;
+
+        single = nullptr;
+        bulk = nullptr;
+        cache = nullptr;
+        std::filesystem::remove_all(dir);
+    }
+}
@@ -0,0 +1,101 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+#include <osgEarth/ClusterNode>
+#include <algorithm>
+#include <cmath>
+
+using namespace osgEarth;
+using namespace osgEarth::Contrib;
+
+namespace
+{
+    unsigned totalCount(const std::vector<ClusterIndex::Result>& results)
+    {
+        unsigned total = 0u;
+        for (auto& r : results)
+            total += r.count;
+        return total;
+    }
+}
+
+TEST_CASE("ClusterIndex") {
+
+    ClusterIndex index(50u, 0u, 16u);
+
+    std::vector<osg::Vec2d> points = {
+        { 0.0, 0.0 },
+        { 0.001, 0.0 },
+        { 10.0, 10.0 }
+    };
+    index.build(points);
+    REQUIRE(index.size() == 3u);
+
+    std::vector<ClusterIndex::Result> results;
+
+    SECTION("Nearby points merge at low zoom") {
+        index.query(-180, -90, 180, 90, 0, results);
+        REQUIRE(totalCount(results) == 3u);
+        REQUIRE(results.size() == 1u);
+
+        results.clear();
+        index.query(-180, -90, 180, 90, 8, results);
+        REQUIRE(results.size() == 2u);
+        REQUIRE(totalCount(results) == 3u);
+
+        results.clear();
+        index.query(-180, -90, 180, 90, 17, results);
+        REQUIRE(results.size() == 3u);
+    }
+
+    SECTION("Queries only return clusters in bounds") {
+        index.query(5, 5, 15, 15, 8, results);
+        REQUIRE(results.size() == 1u);
+        REQUIRE(results[0].count == 1u);
+        REQUIRE(results[0].id == 2u);
+        REQUIRE(std::abs(results[0].lat - 10.0) < 1e-6);
+    }
+
+    SECTION("getLeaves") {
+        index.query(-1, -1, 1, 1, 8, results);
+        REQUIRE(results.size() == 1u);
+        REQUIRE(results[0].count == 2u);
+
+        std::vector<unsigned> leaves;
+        index.getLeaves(results[0], leaves);
+        std::sort(leaves.begin(), leaves.end());
+        REQUIRE(leaves == std::vector<unsigned>({ 0u, 1u }));
+    }
+
+    SECTION("Incremental insert and remove") {
+        unsigned id = index.insert(0.0005, 0.0);
+        REQUIRE(id == 3u);
+        REQUIRE(index.size() == 4u);
+
+        index.query(-1, -1, 1, 1, 8, results);
+        REQUIRE(results.size() == 1u);
+        REQUIRE(results[0].count == 3u);
+
+        index.remove(0u);
+        index.remove(id);
+        results.clear();
+        index.query(-1, -1, 1, 1, 8, results);
+        REQUIRE(results.size() == 1u);
+        REQUIRE(results[0].count == 1u);
+        REQUIRE(results[0].id == 1u);
+
+        results.clear();
+        index.query(-180, -90, 180, 90, 0, results);
+        REQUIRE(totalCount(results) == 2u);
+    }
+
+    SECTION("CanMerge predicate") {
+        index.setCanMergeFunction([](unsigned a, unsigned b) { return false; });
+        index.build(points);
+        index.query(-180, -90, 180, 90, 0, results);
+        REQUIRE(results.size() == 3u);
+    }
+}
@@ -7,6 +7,9 @@
 #include <osgEarth/Expression>
 #include <osgEarth/ScriptEngine>
 #include <osgEarth/Math>
+#include <osgEarth/FeatureExpression>
+#include <osgEarth/FilterContext>
+#include <chrono>
 
 using namespace osgEarth;
 using namespace osgEarth::Util;
@@ -115,3 +118,140 @@ TEST_CASE("Expression<>") {
         REQUIRE(result == Angle(3, Units::DEGREES));
     }
 }
+
+namespace
+{
+    osg::ref_ptr<Feature> makeBuilding(double height, int floors, const std::string& name)
+    {
+        osg::ref_ptr<Feature> f = new Feature(new Point(), SpatialReference::get("wgs84"));
+        f->set("name", name);
+        f->set("Height", height);
+        f->set("floors", floors);
+        return f;
+    }
+
+    template<typename FUNC>
+    double benchmark_ns_per_call(unsigned count, FUNC&& func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < count; ++i)
+            func(i);
+        auto end = std::chrono::steady_clock::now();
+        return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)count;
+    }
+}
+
+TEST_CASE("NumericExpression evaluation against features") {
+
+    const FilterContext* cx = nullptr;
+    auto f = makeBuilding(10.0, 3, "Tower");
+    NumericExpression expr("max([height] * [FLOORS] + 2, 5)");
+
+    SECTION("Feature::eval") {
+        REQUIRE(f->eval(expr, cx) == 32.0);
+    }
+
+    SECTION("Resolver eval does not modify the expression") {
+        REQUIRE(expr.eval([](unsigned) { return 1.0; }) == 5.0);
+        REQUIRE(expr.eval([](unsigned i) { return i == 0 ? 2.0 : 4.0; }) == 10.0);
+    }
+
+    SECTION("NaN results") {
+        NumericExpression ratio("[height] / [floors]");
+        REQUIRE(osg::isNaN(ratio.eval([](unsigned) { return 0.0; })));
+
+        osg::ref_ptr<Feature> g = new Feature(new Point(), SpatialReference::get("wgs84"));
+        REQUIRE(g->eval(ratio, cx) == 0.0);
+        REQUIRE(CompiledNumericExpression(ratio, g.get()).eval(g.get(), cx) == 0.0);
+    }
+
+    SECTION("CompiledNumericExpression") {
+        CompiledNumericExpression compiled(expr, f.get());
+        REQUIRE(compiled.eval(f.get(), cx) == 32.0);
+
+        // attribute order differs from the prototype:
+        osg::ref_ptr<Feature> g = new Feature(new Point(), SpatialReference::get("wgs84"));
+        g->set("floors", 2);
+        g->set("height", 4.0);
+        REQUIRE(compiled.eval(g.get(), cx) == 10.0);
+
+        // missing attributes evaluate to zero:
+        osg::ref_ptr<Feature> h = new Feature(new Point(), SpatialReference::get("wgs84"));
+        REQUIRE(compiled.eval(h.get(), cx) == 5.0);
+    }
+
+    SECTION("CompiledNumericExpression batch") {
+        FeatureList features{ makeBuilding(10.0, 3, "A"), makeBuilding(1.0, 1, "B") };
+        CompiledNumericExpression compiled(expr);
+        std::vector<double> results;
+        compiled.eval(features, cx, results);
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0] == 32.0);
+        REQUIRE(results[1] == 5.0);
+    }
+}
+
+TEST_CASE("StringExpression evaluation against features") {
+
+    const FilterContext* cx = nullptr;
+    auto f = makeBuilding(10.0, 3, "Tower");
+    StringExpression expr("\"Building: \" + [name]");
+
+    REQUIRE(f->eval(expr, cx) == "Building: Tower");
+
+    CompiledStringExpression compiled(expr, f.get());
+    REQUIRE(compiled.eval(f.get(), cx) == "Building: Tower");
+
+    FeatureList features{ makeBuilding(1.0, 1, "A"), makeBuilding(1.0, 1, "B") };
+    std::vector<std::string> results;
+    compiled.eval(features, cx, results);
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[1] == "Building: B");
+}
+
+TEST_CASE("Feature expression benchmarks", "[.benchmark]") {
+
+    const FilterContext* cx = nullptr;
+    const unsigned count = 1000000;
+
+    FeatureList features;
+    for (unsigned i = 0; i < 1000; ++i)
+        features.emplace_back(makeBuilding((double)i, i % 10, "Building " + std::to_string(i)));
+
+    NumericExpression numExpr("[height] * [floors] + 2");
+    const NumericExpression& constNumExpr = numExpr;
+    double sum = 0.0;
+
+    double copy_ns = benchmark_ns_per_call(count, [&](unsigned i) {
+        sum += features[i % features.size()]->eval(constNumExpr, cx); });
+
+    double mutable_ns = benchmark_ns_per_call(count, [&](unsigned i) {
+        sum += features[i % features.size()]->eval(numExpr, cx); });
+
+    CompiledNumericExpression compiled(numExpr, features.front().get());
+    double compiled_ns = benchmark_ns_per_call(count, [&](unsigned i) {
+        sum += compiled.eval(features[i % features.size()].get(), cx); });
+
+    std::vector<double> results;
+    double batch_ns = benchmark_ns_per_call(count / features.size(), [&](unsigned) {
+        compiled.eval(features, cx, results); }) / (double)features.size();
+
+    StringExpression strExpr("[name] + \" (\" + [floors] + \")\"");
+    std::string label;
+    double str_ns = benchmark_ns_per_call(count, [&](unsigned i) {
+        label = features[i % features.size()]->eval(strExpr, cx); });
+
+    CompiledStringExpression compiledStr(strExpr, features.front().get());
+    double compiled_str_ns = benchmark_ns_per_call(count, [&](unsigned i) {
+        compiledStr.eval(features[i % features.size()].get(), cx, label); });
+
+    OE_NOTICE << "NumericExpression: Feature::eval(const)=" << copy_ns << "ns"
+        << ", Feature::eval(mutable)=" << mutable_ns << "ns"
+        << ", compiled=" << compiled_ns << "ns"
+        << ", compiled batch=" << batch_ns << "ns (per feature; checksum " << sum << ")" << std::endl;
+
+    OE_NOTICE << "StringExpression: Feature::eval(const)=" << str_ns << "ns"
+        << ", compiled=" << compiled_str_ns << "ns" << std::endl;
+
+    REQUIRE(results.size() == features.size());
+}
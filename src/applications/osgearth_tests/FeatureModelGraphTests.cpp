@@ -0,0 +1,267 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/FeatureModelGraph>
+#include <osgEarth/GeometryCompiler>
+#include <osgEarth/Map>
+#include <osgEarth/Notify>
+#include <osgEarth/OGRFeatureSource>
+#include <osgEarth/Session>
+#include <osgEarth/StyleSheet>
+#include <gdal.h>
+#include <ogr_srs_api.h>
+#include <cpl_conv.h>
+#include <cpl_vsi.h>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    // A block grid of buildings of many kinds, with roads between the blocks
+    void createCity(const std::string& path, unsigned blocks, unsigned buildingKinds, unsigned roadKinds)
+    {
+        GDALAllRegister();
+
+        GDALDriverH driver = GDALGetDriverByName("GPKG");
+        GDALDatasetH ds = GDALCreate(driver, path.c_str(), 0, 0, 0, GDT_Unknown, nullptr);
+
+        OGRSpatialReferenceH srs = OSRNewSpatialReference(nullptr);
+        OSRImportFromEPSG(srs, 4326);
+        OGRLayerH layer = GDALDatasetCreateLayer(ds, "city", srs, wkbUnknown, nullptr);
+        OSRDestroySpatialReference(srs);
+
+        OGRFieldDefnH kind = OGR_Fld_Create("kind", OFTString);
+        OGR_L_CreateField(layer, kind, TRUE);
+        OGR_Fld_Destroy(kind);
+
+        auto add = [&](const std::string& wkt, const std::string& kind)
+            {
+                std::string buffer(wkt);
+                char* ptr = &buffer[0];
+                OGRGeometryH geom = nullptr;
+                OGR_G_CreateFromWkt(&ptr, nullptr, &geom);
+
+                OGRFeatureH feature = OGR_F_Create(OGR_L_GetLayerDefn(layer));
+                OGR_F_SetFieldString(feature, 0, kind.c_str());
+                OGR_F_SetGeometryDirectly(feature, geom);
+                OGR_L_CreateFeature(layer, feature);
+                OGR_F_Destroy(feature);
+            };
+
+        const double block = 0.001, lot = 0.0002;
+        unsigned n = 0;
+
+        GDALDatasetStartTransaction(ds, FALSE);
+        for (unsigned bx = 0; bx < blocks; ++bx)
+        {
+            for (unsigned by = 0; by < blocks; ++by)
+            {
+                double x0 = bx * block, y0 = by * block;
+                for (unsigned i = 0; i < 4; ++i)
+                {
+                    for (unsigned j = 0; j < 4; ++j, ++n)
+                    {
+                        double x = x0 + 0.0001 + i * lot, y = y0 + 0.0001 + j * lot;
+                        double w = lot * 0.8, h = lot * (0.5 + 0.1 * (n % 4));
+                        std::stringstream wkt;
+                        wkt << std::setprecision(12) << "POLYGON((" << x << " " << y << "," << x + w << " " << y << ","
+                            << x + w << " " << y + h << "," << x << " " << y + h << "," << x << " " << y << "))";
+                        add(wkt.str(), "building_" + std::to_string(n % buildingKinds));
+                    }
+                }
+            }
+        }
+        for (unsigned r = 0; r <= blocks; ++r)
+        {
+            double c = r * block, len = blocks * block;
+            std::stringstream ew, ns;
+            ew << std::setprecision(12) << "LINESTRING(0 " << c << "," << len * 0.5 << " " << c << "," << len << " " << c << ")";
+            ns << std::setprecision(12) << "LINESTRING(" << c << " 0," << c << " " << len * 0.5 << "," << c << " " << len << ")";
+            add(ew.str(), "road_" + std::to_string(r % roadKinds));
+            add(ns.str(), "road_" + std::to_string((r + 1) % roadKinds));
+        }
+        GDALDatasetCommitTransaction(ds);
+        GDALClose(ds);
+    }
+
+    // One style per "kind": extruded buildings for polygons, lines otherwise
+    osg::ref_ptr<StyleSheet> createStyles(FeatureSource* source)
+    {
+        std::map<std::string, bool> kinds;
+        osg::ref_ptr<FeatureCursor> cursor = source->createFeatureCursor(Query());
+        while (cursor.valid() && cursor->hasMore())
+        {
+            Feature* feature = cursor->nextFeature();
+            std::string kind = feature->getString("kind");
+            if (!kind.empty() && feature->getGeometry())
+                kinds[kind] = feature->getGeometry()->isPolygon();
+        }
+
+        std::stringstream css;
+        unsigned i = 0;
+        for (auto& kind : kinds)
+        {
+            Color color(0.2f + 0.03f * (i % 20), 0.5f, 1.0f - 0.03f * (i % 20), 1.0f);
+            css << kind.first << " { altitude-clamping: none; ";
+            if (kind.second)
+                css << "fill: " << color.toHTML() << "; extrusion-height: " << (10 + 3 * (i % 10)) << "; } ";
+            else
+                css << "stroke: " << color.toHTML() << "; stroke-width: " << (2 + i % 4) << "px; } ";
+            ++i;
+        }
+
+        osg::ref_ptr<StyleSheet> styles = new StyleSheet();
+        styles->addStylesFromCSS(css.str());
+        styles->addSelector(StyleSelector("kinds", StringExpression(std::string("[kind]"))));
+        return styles;
+    }
+
+    struct City
+    {
+        osg::ref_ptr<Map> map;
+        osg::ref_ptr<OGRFeatureSource> source;
+        osg::ref_ptr<StyleSheet> styles;
+
+        City(const std::string& path)
+        {
+            map = new Map(Map::Options(), nullptr);
+            map->setProfile(Profile::create(Profile::GLOBAL_GEODETIC));
+            source = new OGRFeatureSource();
+            source->setConnection(path);
+            REQUIRE(source->open().isOK());
+            styles = createStyles(source.get());
+        }
+
+        // Builds all features as one unpaged tile
+        osg::ref_ptr<FeatureModelGraph> build(unsigned compileThreads, unsigned rangeSize)
+        {
+            FeatureModelOptions options;
+            options.compileThreads() = compileThreads;
+            options.compileRangeSize() = rangeSize;
+            options.layout().mutable_value().paged() = false;
+
+            osg::ref_ptr<Session> session = new Session(map.get(), styles.get(), source.get(), nullptr);
+            osg::ref_ptr<FeatureModelGraph> graph = new FeatureModelGraph(options);
+            graph->setSession(session.get());
+            graph->setNodeFactory(new GeomFeatureNodeFactory(GeometryCompilerOptions()));
+            REQUIRE(graph->open().isOK());
+            return graph;
+        }
+    };
+
+    // Vertex count of every geometry, in traversal order
+    struct Layout : public osg::NodeVisitor
+    {
+        std::vector<unsigned> vertices;
+        Layout() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) { }
+        void apply(osg::Drawable& drawable) override
+        {
+            osg::Geometry* geom = drawable.asGeometry();
+            if (geom && geom->getVertexArray())
+                vertices.push_back(geom->getVertexArray()->getNumElements());
+        }
+    };
+
+    std::vector<unsigned> layoutOf(osg::Node* node)
+    {
+        Layout layout;
+        node->accept(layout);
+        return layout.vertices;
+    }
+
+    struct AlreadyCanceled : public Cancelable
+    {
+        bool canceled() const override { return true; }
+    };
+}
+
+TEST_CASE("FeatureModelGraph compiles style groups concurrently")
+{
+    const std::string path = "/vsimem/osgearth_city_test.gpkg";
+    createCity(path, 4, 12, 3);
+
+    {
+        City city(path);
+
+        // small ranges, so that large style groups split
+        osg::ref_ptr<FeatureModelGraph> serial = city.build(1, 5);
+        osg::ref_ptr<FeatureModelGraph> concurrent = city.build(4, 5);
+
+        SECTION("The tile is the same as one compiled serially")
+        {
+            auto expected = layoutOf(serial.get());
+            REQUIRE(layoutOf(city.build(4, 0).get()) == expected);
+        }
+
+        SECTION("Style groups split only when compiling concurrently")
+        {
+            auto whole = layoutOf(serial.get());
+            auto split = layoutOf(concurrent.get());
+            REQUIRE(split.size() > whole.size());
+            REQUIRE(std::accumulate(split.begin(), split.end(), 0u) == std::accumulate(whole.begin(), whole.end(), 0u));
+        }
+
+        SECTION("Cancelation stops the tile build")
+        {
+            AlreadyCanceled canceled;
+            REQUIRE(concurrent->load(0, 0, 0, "", nullptr, &canceled).valid() == false);
+            REQUIRE(concurrent->load(0, 0, 0, "", nullptr).valid() == true);
+        }
+    }
+
+    VSIUnlink(path.c_str());
+}
+
+TEST_CASE("FeatureModelGraph tile build benchmarks", "[.benchmark]")
+{
+    // OSGEARTH_BENCHMARK_CITY points at a vector file (e.g. an OSM extract
+    // converted with ogr2ogr) whose features have a "kind" attribute to style
+    // by; otherwise a city of 40,000 buildings in 24 kinds is generated.
+    std::string path;
+    const char* env = ::getenv("OSGEARTH_BENCHMARK_CITY");
+    if (env)
+    {
+        path = env;
+    }
+    else
+    {
+        path = CPLGenerateTempFilename("osgearth_city") + std::string(".gpkg");
+        createCity(path, 50, 24, 8);
+    }
+
+    {
+        City city(path);
+
+        for (unsigned threads : { 1u, std::max(2u, std::thread::hardware_concurrency()) })
+        {
+            // one compile thread never splits a style group
+            for (unsigned rangeSize : { 0u, 500u, 2500u, 10000u })
+            {
+                if (threads == 1u && rangeSize > 0u)
+                    break;
+
+                auto t0 = std::chrono::steady_clock::now();
+                osg::ref_ptr<FeatureModelGraph> graph = city.build(threads, rangeSize);
+                auto t1 = std::chrono::steady_clock::now();
+
+                OE_NOTICE << "Built a tile of " << layoutOf(graph.get()).size() << " geometries with "
+                    << threads << " compile threads, range size " << rangeSize << ", in "
+                    << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms" << std::endl;
+            }
+        }
+    }
+
+    if (!env)
+        VSIUnlink(path.c_str());
+}
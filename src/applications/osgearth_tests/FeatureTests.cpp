@@ -5,9 +5,25 @@
 
 #include <osgEarth/catch.hpp>
 
+#include <osgEarth/AltitudeFilter>
+#include <osgEarth/Containers>
+#include <osgEarth/ConvertTypeFilter>
 #include <osgEarth/Feature>
+#include <osgEarth/FeatureBatch>
 #include <osgEarth/Geometry>
 #include <osgEarth/GeometryUtils>
+#include <osgEarth/Notify>
+#include <osgEarth/OGRFeatureSource>
+#include <osgEarth/OgrUtils>
+#include <osgEarth/ScaleFilter>
+#include <osgEarth/TransformFilter>
+#include <gdal.h>
+#include <ogr_srs_api.h>
+#include <cpl_conv.h>
+#include <cpl_vsi.h>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
 
 using namespace osgEarth;
 
@@ -214,4 +230,691 @@ TEST_CASE("Feature handles attributes correctly.")
         REQUIRE(feature->isSet("bool") == false);
         REQUIRE(feature->getBool("bool") == false);
     }
+
+    SECTION("Attribute names are case-insensitive") {
+        feature->set("Height", 12.0);
+        REQUIRE(feature->getDouble("HEIGHT") == 12.0);
+        REQUIRE(feature->getAttrs().begin()->first == "height");
+
+        AttributeKey key("hEiGhT");
+        REQUIRE(feature->getDouble(key) == 12.0);
+        REQUIRE(feature->indexOf(key) == 0);
+    }
+
+    SECTION("Attributes keep their order") {
+        for (int i = 0; i < 10; ++i)
+            feature->set("a" + std::to_string(i), i);
+        feature->removeAttribute("a2");
+
+        std::vector<std::string> names;
+        for (auto& attr : feature->getAttrs())
+            names.push_back(attr.first);
+        REQUIRE(names.size() == 9u);
+        REQUIRE(names[1] == "a1");
+        REQUIRE(names[2] == "a3");
+        REQUIRE(feature->hasAttr("a2") == false);
+
+        osg::ref_ptr<Feature> copy = new Feature(*feature);
+        REQUIRE(copy->getInt("a9") == 9);
+        REQUIRE(copy->getAttrs().size() == 9);
+    }
+
+    SECTION("Looking up a name does not intern it") {
+        const char* name = "an_attribute_this_feature_never_had";
+        unsigned interned = AttributeKey::count();
+
+        REQUIRE(feature->hasAttr(name) == false);
+        REQUIRE(feature->isSet(name) == false);
+        REQUIRE(feature->getString(name).empty());
+        REQUIRE(feature->getDouble(name, 5.0) == 5.0);
+        REQUIRE(feature->getInt(name, 7) == 7);
+        REQUIRE(feature->getBool(name, true) == true);
+        REQUIRE(feature->indexOf(name) == -1);
+        feature->removeAttribute(name);
+        REQUIRE(AttributeKey::count() == interned);
+
+        feature->set(name, 1.0);
+        REQUIRE(AttributeKey::count() == interned + 1u);
+        REQUIRE(feature->getDouble(name) == 1.0);
+    }
+}
+
+TEST_CASE("AttributeKey")
+{
+    AttributeKey a("Building_Type"), b(std::string("building_type")), c("floors");
+    REQUIRE(a.valid());
+    REQUIRE(a == b);
+    REQUIRE(a != c);
+    REQUIRE(a.id() > 0u);
+    REQUIRE(a.name() == "building_type");
+    REQUIRE(AttributeKey::find("BUILDING_TYPE") == a);
+    REQUIRE(AttributeKey::find("an_attribute_nobody_has_used").valid() == false);
+    REQUIRE(AttributeKey().valid() == false);
+    REQUIRE(AttributeKey().name().empty());
+}
+
+TEST_CASE("Expressions resolve their attribute keys when parsed")
+{
+    NumericExpression numeric("[Height] * 2");
+    REQUIRE(numeric.variableKeys().size() == 1u);
+    REQUIRE(numeric.variableKeys()[0] == AttributeKey::find("height"));
+
+    StringExpression string("[Name]-[floors]");
+    REQUIRE(string.variableKeys().size() == 2u);
+    REQUIRE(string.variableKeys()[0] == AttributeKey::find("name"));
+    REQUIRE(string.variableKeys()[1] == AttributeKey::find("floors"));
+
+    osg::ref_ptr<Feature> feature = new Feature(new Point(), nullptr);
+    feature->set("height", 3.0);
+    feature->set("name", "tower");
+    feature->set("floors", 12);
+
+    unsigned interned = AttributeKey::count();
+    REQUIRE(feature->eval(numeric, (const Util::FilterContext*)nullptr) == 6.0);
+    REQUIRE(feature->eval(string, (const Util::FilterContext*)nullptr) == "tower-12");
+    REQUIRE(AttributeKey::count() == interned);
+}
+
+namespace
+{
+    bool sameGeometry(const Geometry* a, const Geometry* b)
+    {
+        if (!a || !b)
+            return a == b;
+        if (a->getType() != b->getType() || a->size() != b->size())
+            return false;
+        for (unsigned i = 0; i < a->size(); ++i)
+            if ((*a)[i] != (*b)[i])
+                return false;
+
+        if (a->getType() == Geometry::TYPE_POLYGON)
+        {
+            auto& ah = static_cast<const Polygon*>(a)->getHoles();
+            auto& bh = static_cast<const Polygon*>(b)->getHoles();
+            if (ah.size() != bh.size())
+                return false;
+            for (unsigned i = 0; i < ah.size(); ++i)
+                if (!sameGeometry(ah[i].get(), bh[i].get()))
+                    return false;
+        }
+        else if (a->getType() == Geometry::TYPE_MULTI)
+        {
+            auto& ac = static_cast<const MultiGeometry*>(a)->getComponents();
+            auto& bc = static_cast<const MultiGeometry*>(b)->getComponents();
+            if (ac.size() != bc.size())
+                return false;
+            for (unsigned i = 0; i < ac.size(); ++i)
+                if (!sameGeometry(ac[i].get(), bc[i].get()))
+                    return false;
+        }
+        return true;
+    }
+
+    OGRGeometryH ogrGeometryFromWKT(const std::string& wkt)
+    {
+        std::string buffer(wkt);
+        char* ptr = &buffer[0];
+        OGRGeometryH handle = nullptr;
+        OGR_G_CreateFromWkt(&ptr, nullptr, &handle);
+        return handle;
+    }
+
+    // Polygons, some with a hole, with a name, a height and a floor count
+    // that is null for every 7th feature.
+    void createGeoPackage(const std::string& path, unsigned count)
+    {
+        GDALAllRegister();
+
+        GDALDriverH driver = GDALGetDriverByName("GPKG");
+        GDALDatasetH ds = GDALCreate(driver, path.c_str(), 0, 0, 0, GDT_Unknown, nullptr);
+
+        OGRSpatialReferenceH srs = OSRNewSpatialReference(nullptr);
+        OSRImportFromEPSG(srs, 4326);
+        OGRLayerH layer = GDALDatasetCreateLayer(ds, "buildings", srs, wkbPolygon, nullptr);
+        OSRDestroySpatialReference(srs);
+
+        OGRFieldDefnH name = OGR_Fld_Create("Name", OFTString);
+        OGRFieldDefnH height = OGR_Fld_Create("Height", OFTReal);
+        OGRFieldDefnH floors = OGR_Fld_Create("Floors", OFTInteger);
+        OGR_L_CreateField(layer, name, TRUE);
+        OGR_L_CreateField(layer, height, TRUE);
+        OGR_L_CreateField(layer, floors, TRUE);
+        OGR_Fld_Destroy(name);
+        OGR_Fld_Destroy(height);
+        OGR_Fld_Destroy(floors);
+
+        GDALDatasetStartTransaction(ds, FALSE);
+        for (unsigned i = 0; i < count; ++i)
+        {
+            double x = -180.0 + 0.0003 * (i % 1000000), y = -80.0 + 0.0001 * (i / 1000);
+
+            std::stringstream wkt;
+            wkt << std::setprecision(12) << "POLYGON((" << x << " " << y << "," << x + 0.0002 << " " << y << ","
+                << x + 0.0002 << " " << y + 0.00005 << "," << x << " " << y + 0.00005 << "," << x << " " << y << ")";
+            if (i % 5 == 0)
+            {
+                wkt << ",(" << x + 0.00005 << " " << y + 0.00001 << "," << x + 0.00005 << " " << y + 0.00002 << ","
+                    << x + 0.0001 << " " << y + 0.00002 << "," << x + 0.00005 << " " << y + 0.00001 << ")";
+            }
+            wkt << ")";
+
+            OGRFeatureH feature = OGR_F_Create(OGR_L_GetLayerDefn(layer));
+            OGR_F_SetFieldString(feature, 0, ("building " + std::to_string(i)).c_str());
+            OGR_F_SetFieldDouble(feature, 1, 3.0 + (i % 40));
+            if (i % 7 != 0)
+                OGR_F_SetFieldInteger(feature, 2, 1 + (i % 12));
+            OGR_F_SetGeometryDirectly(feature, ogrGeometryFromWKT(wkt.str()));
+            OGR_L_CreateFeature(layer, feature);
+            OGR_F_Destroy(feature);
+        }
+        GDALDatasetCommitTransaction(ds);
+        GDALClose(ds);
+    }
+
+    osg::ref_ptr<OGRFeatureSource> openGeoPackage(const std::string& path, bool useArrowStream)
+    {
+        osg::ref_ptr<OGRFeatureSource> source = new OGRFeatureSource();
+        source->setConnection(path);
+        source->setUseArrowStream(useArrowStream);
+        return source->open().isOK() ? source : nullptr;
+    }
+}
+
+TEST_CASE("OgrUtils decodes WKB like OGR")
+{
+    const char* wkts[] = {
+        "POINT (1 2)",
+        "POINT Z (1 2 3)",
+        "POINT EMPTY",
+        "LINESTRING (0 0,1 1,1 1,2 0)",
+        "LINESTRING ZM (0 0 1 9,1 1 2 9)",
+        "POLYGON ((0 0,0 1,1 1,1 0,0 0),(0.2 0.2,0.4 0.2,0.4 0.4,0.2 0.2))",
+        "MULTIPOINT ((0 0),(1 1),(1 1))",
+        "MULTILINESTRING ((0 0,1 1),(2 2,3 3))",
+        "MULTIPOLYGON (((0 0,1 0,1 1,0 0)),((5 5,6 5,6 6,5 5)))",
+        "GEOMETRYCOLLECTION (POINT (1 1),LINESTRING (0 0,1 1))",
+        "CIRCULARSTRING (0 0,1 1,2 0)"
+    };
+
+    for (auto wkt : wkts)
+    {
+        OGRGeometryH handle = ogrGeometryFromWKT(wkt);
+        REQUIRE(handle != nullptr);
+
+        for (auto variant : { wkbVariantIso, wkbVariantOldOgc })
+        {
+            for (auto order : { wkbNDR, wkbXDR })
+            {
+                std::vector<unsigned char> wkb(OGR_G_WkbSize(handle));
+                if (variant == wkbVariantIso)
+                    OGR_G_ExportToIsoWkb(handle, order, wkb.data());
+                else
+                    OGR_G_ExportToWkb(handle, order, wkb.data());
+
+                osg::ref_ptr<Geometry> expected = OgrUtils::createGeometry(handle);
+                osg::ref_ptr<Geometry> actual = OgrUtils::createGeometryFromWKB(wkb.data(), wkb.size());
+                INFO(wkt);
+                REQUIRE(sameGeometry(expected.get(), actual.get()));
+            }
+        }
+        OGR_G_DestroyGeometry(handle);
+    }
+
+    unsigned char truncated[] = { 1, 2, 0, 0, 0, 5, 0, 0, 0 };
+    REQUIRE(OgrUtils::createGeometryFromWKB(truncated, sizeof(truncated)) == nullptr);
+}
+
+TEST_CASE("OGRFeatureSource reads the same features through the Arrow stream")
+{
+    const std::string path = "/vsimem/osgearth_arrow_test.gpkg";
+    createGeoPackage(path, 2500);
+
+    auto rowwise = openGeoPackage(path, false);
+    auto columnar = openGeoPackage(path, true);
+    REQUIRE(rowwise.valid());
+    REQUIRE(columnar.valid());
+
+    FeatureList expected, actual;
+    osg::ref_ptr<FeatureCursor> c1 = rowwise->createFeatureCursor(Query());
+    osg::ref_ptr<FeatureCursor> c2 = columnar->createFeatureCursor(Query());
+    REQUIRE(c1.valid());
+    REQUIRE(c2.valid());
+    c1->fill(expected);
+    c2->fill(actual);
+
+    REQUIRE(expected.size() == 2500);
+    REQUIRE(actual.size() == expected.size());
+
+    for (unsigned i = 0; i < expected.size(); ++i)
+    {
+        const Feature* a = expected[i].get();
+        const Feature* b = actual[i].get();
+        REQUIRE(a->getFID() == b->getFID());
+        REQUIRE(sameGeometry(a->getGeometry(), b->getGeometry()));
+        REQUIRE(a->getAttrs().size() == b->getAttrs().size());
+        REQUIRE(a->getString("name") == b->getString("name"));
+        REQUIRE(a->getDouble("height") == b->getDouble("height"));
+        REQUIRE(a->isSet("floors") == b->isSet("floors"));
+        REQUIRE(a->getInt("floors") == b->getInt("floors"));
+    }
+
+    SECTION("Spatial queries")
+    {
+        Query query;
+        query.bounds() = Bounds(-180.0, -80.0, 0.0, -179.9, -79.0, 0.0);
+
+        FeatureList e, a;
+        rowwise->createFeatureCursor(query)->fill(e);
+        columnar->createFeatureCursor(query)->fill(a);
+        REQUIRE(e.size() > 0);
+        REQUIRE(e.size() < expected.size());
+        REQUIRE(a.size() == e.size());
+    }
+
+    rowwise = nullptr;
+    columnar = nullptr;
+    VSIUnlink(path.c_str());
+}
+
+TEST_CASE("OGRFeatureSource ingest benchmarks", "[.benchmark]")
+{
+    // OSGEARTH_BENCHMARK_GPKG points at an existing GeoPackage; otherwise
+    // one with a million polygons is generated in the temp directory.
+    std::string path;
+    const char* env = ::getenv("OSGEARTH_BENCHMARK_GPKG");
+    if (env)
+    {
+        path = env;
+    }
+    else
+    {
+        path = CPLGenerateTempFilename("osgearth_ingest") + std::string(".gpkg");
+        createGeoPackage(path, 1000000);
+    }
+
+    for (bool useArrowStream : { false, true })
+    {
+        auto source = openGeoPackage(path, useArrowStream);
+        REQUIRE(source.valid());
+
+        auto t0 = std::chrono::steady_clock::now();
+        std::size_t count = 0, points = 0;
+        osg::ref_ptr<FeatureCursor> cursor = source->createFeatureCursor(Query());
+        while (cursor.valid() && cursor->hasMore())
+        {
+            Feature* feature = cursor->nextFeature();
+            points += feature->getGeometry()->getTotalPointCount();
+            ++count;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        double s = std::chrono::duration<double>(t1 - t0).count();
+
+        OE_NOTICE << (useArrowStream ? "Arrow stream: " : "Row by row:   ")
+            << count << " features (" << points << " points) in " << s << " s, "
+            << (std::size_t)(count / s) << " features/s" << std::endl;
+    }
+
+    if (!env)
+        VSIUnlink(path.c_str());
+}
+
+namespace
+{
+    // polygons (some with holes), multi-lines, points, a mesh and an empty feature
+    FeatureList createMixedFeatures(unsigned count)
+    {
+        const SpatialReference* wgs84 = SpatialReference::get("wgs84");
+        FeatureList features;
+        for (unsigned i = 0; i < count; ++i)
+        {
+            double x = -100.0 + 0.01 * (i % 1000), y = 30.0 + 0.01 * (i / 1000);
+            Geometry* geom = nullptr;
+
+            switch (i % 5)
+            {
+            case 0:
+            case 1:
+            {
+                auto* polygon = new Polygon();
+                polygon->push_back(x, y, 10.0);
+                polygon->push_back(x + 0.005, y, 10.0);
+                polygon->push_back(x + 0.005, y + 0.005, 12.0);
+                polygon->push_back(x, y + 0.005, 12.0);
+                if (i % 5 == 0)
+                {
+                    auto* hole = new Ring();
+                    hole->push_back(x + 0.001, y + 0.001, 11.0);
+                    hole->push_back(x + 0.001, y + 0.002, 11.0);
+                    hole->push_back(x + 0.002, y + 0.002, 11.0);
+                    polygon->getHoles().push_back(hole);
+                }
+                geom = polygon;
+                break;
+            }
+            case 2:
+            {
+                auto* multi = new MultiGeometry();
+                for (unsigned j = 0; j < 2; ++j)
+                {
+                    auto* line = new LineString();
+                    line->push_back(x, y + 0.001 * j, 5.0);
+                    line->push_back(x + 0.003, y + 0.001 * j, 6.0);
+                    line->push_back(x + 0.006, y + 0.002 * j, 7.0);
+                    multi->add(line);
+                }
+                geom = multi;
+                break;
+            }
+            case 3:
+                geom = new Point();
+                geom->push_back(x, y, 1.0);
+                break;
+            default:
+                if (i % 10 == 4)
+                {
+                    auto* mesh = new TriMesh();
+                    mesh->push_back(x, y, 0.0);
+                    mesh->push_back(x + 0.001, y, 0.0);
+                    mesh->push_back(x, y + 0.001, 0.0);
+                    mesh->_indices = { 0u, 1u, 2u };
+                    geom = mesh;
+                }
+                break;
+            }
+
+            Feature* feature = new Feature(geom, wgs84, Style(), (FeatureID)(i + 1));
+            feature->set("name", "feature " + std::to_string(i));
+            if (i % 3 == 0)
+                feature->set("height", 3.0 + (i % 40));
+            else
+                feature->setNull("height");
+            feature->set("floors", (long long)(i % 12));
+            if (i % 4 == 0)
+                feature->set("Kind", std::string("house"));
+            else if (i % 4 == 2)
+                feature->set("Kind", 2.5);
+            features.push_back(feature);
+        }
+        return features;
+    }
+
+    void requireSameGeometry(const Geometry* a, const Geometry* b)
+    {
+        REQUIRE((a == nullptr) == (b == nullptr));
+        if (!a)
+            return;
+
+        REQUIRE(a->getType() == b->getType());
+        REQUIRE(a->getTotalPointCount() == b->getTotalPointCount());
+
+        ConstGeometryIterator ia(a), ib(b);
+        while (ia.hasMore())
+        {
+            REQUIRE(ib.hasMore());
+            const Geometry* pa = ia.next();
+            const Geometry* pb = ib.next();
+            REQUIRE(pa->getType() == pb->getType());
+            REQUIRE(pa->size() == pb->size());
+            for (unsigned i = 0; i < pa->size(); ++i)
+            {
+                REQUIRE((*pa)[i].x() == Approx((*pb)[i].x()).margin(1e-9));
+                REQUIRE((*pa)[i].y() == Approx((*pb)[i].y()).margin(1e-9));
+                REQUIRE((*pa)[i].z() == Approx((*pb)[i].z()).margin(1e-9));
+            }
+        }
+        REQUIRE(!ib.hasMore());
+
+        if (a->getType() == Geometry::TYPE_TRIMESH)
+            REQUIRE(static_cast<const TriMesh*>(a)->_indices == static_cast<const TriMesh*>(b)->_indices);
+    }
+
+    void requireSameFeatures(const FeatureList& a, const FeatureList& b)
+    {
+        REQUIRE(a.size() == b.size());
+        auto j = b.begin();
+        for (auto i = a.begin(); i != a.end(); ++i, ++j)
+        {
+            const Feature* fa = i->get();
+            const Feature* fb = j->get();
+            REQUIRE(fa->getFID() == fb->getFID());
+            requireSameGeometry(fa->getGeometry(), fb->getGeometry());
+
+            REQUIRE(fa->getAttrs().size() == fb->getAttrs().size());
+            for (auto& attr : fa->getAttrs())
+            {
+                REQUIRE(fb->hasAttr(attr.first));
+                REQUIRE(fa->isSet(attr.first) == fb->isSet(attr.first));
+                REQUIRE(attr.second.getType() == fb->getAttrs().find(attr.key)->second.getType());
+                REQUIRE(attr.second.getString() == fb->getString(attr.first));
+            }
+        }
+    }
+
+    // runs a filter on the same features both ways and compares the results
+    void requireSameResult(FeatureFilter* filter, unsigned count)
+    {
+        FeatureList list = createMixedFeatures(count);
+        FilterContext cx;
+        filter->push(list, cx);
+
+        osg::ref_ptr<FeatureBatch> batch = FeatureBatch::create(createMixedFeatures(count));
+        FilterContext bcx;
+        filter->pushBatch(*batch, bcx);
+
+        FeatureList fromBatch;
+        batch->toFeatures(fromBatch);
+        requireSameFeatures(list, fromBatch);
+    }
+}
+
+TEST_CASE("FeatureBatch holds the same features as a FeatureList")
+{
+    FeatureList features = createMixedFeatures(50);
+    features.push_back(nullptr);
+
+    osg::ref_ptr<FeatureBatch> batch = FeatureBatch::create(features);
+    REQUIRE(batch->size() == 50);
+    REQUIRE(batch->getSRS()->isGeographic());
+    REQUIRE(!batch->hasMixedSRS());
+
+    SECTION("Features round-trip")
+    {
+        FeatureList output;
+        batch->toFeatures(output);
+        features.pop_back();
+        requireSameFeatures(features, output);
+    }
+
+    SECTION("Rows read like features")
+    {
+        auto i = features.begin();
+        for (std::size_t row = 0; row < batch->size(); ++row, ++i)
+        {
+            const Feature* feature = i->get();
+            auto view = (*batch)[row];
+            REQUIRE(view.getFID() == feature->getFID());
+            REQUIRE(view.hasGeometry() == (feature->getGeometry() != nullptr));
+            if (feature->getGeometry())
+            {
+                REQUIRE(view.getGeometryType() == feature->getGeometry()->getType());
+                REQUIRE(view.end() - view.begin() == feature->getGeometry()->getTotalPointCount());
+                REQUIRE(view.getBounds() == feature->getGeometry()->getBounds());
+            }
+            REQUIRE(view.getString("NAME") == feature->getString("name"));
+            REQUIRE(view.isSet("height") == feature->isSet("height"));
+            REQUIRE(view.getDouble("height", -1.0) == feature->getDouble("height", -1.0));
+            REQUIRE(view.getInt("floors") == feature->getInt("floors"));
+            REQUIRE(view.hasAttr("kind") == feature->hasAttr("kind"));
+            REQUIRE(view.getString("kind") == feature->getString("kind"));
+        }
+    }
+
+    SECTION("A feature in another SRS keeps it")
+    {
+        Feature* projected = new Feature(new Point(), SpatialReference::get("spherical-mercator"), Style(), 1000);
+        projected->getGeometry()->push_back(1000.0, 2000.0, 0.0);
+        REQUIRE(batch->append(projected));
+        REQUIRE(batch->hasMixedSRS());
+        REQUIRE(batch->getSRS(batch->size() - 1)->isProjected());
+
+        osg::ref_ptr<Feature> output = batch->createFeature(batch->size() - 1);
+        REQUIRE(output->getSRS()->isProjected());
+    }
+}
+
+TEST_CASE("Filters give the same results on a FeatureBatch")
+{
+    const unsigned count = 50;
+
+    SECTION("TransformFilter")
+    {
+        osg::ref_ptr<TransformFilter> filter = new TransformFilter(SpatialReference::get("spherical-mercator"));
+        filter->setMatrix(osg::Matrixd::translate(0.5, 0.25, 1.0));
+        filter->setLocalizeCoordinates(true);
+        requireSameResult(filter.get(), count);
+    }
+
+    SECTION("ScaleFilter")
+    {
+        osg::ref_ptr<ScaleFilter> filter = new ScaleFilter(0.5);
+        requireSameResult(filter.get(), count);
+    }
+
+    SECTION("AltitudeFilter")
+    {
+        osg::ref_ptr<AltitudeFilter> filter = new AltitudeFilter();
+        filter->getOrCreateSymbol()->clamping() = AltitudeSymbol::CLAMP_TO_TERRAIN;
+        filter->getOrCreateSymbol()->technique() = AltitudeSymbol::TECHNIQUE_GPU;
+        requireSameResult(filter.get(), count);
+
+        filter->getOrCreateSymbol()->verticalOffset() = NumericExpression(std::string("[floors]"));
+        requireSameResult(filter.get(), count);
+    }
+
+    SECTION("ConvertTypeFilter")
+    {
+        for (auto type : { Geometry::TYPE_POINTSET, Geometry::TYPE_LINESTRING, Geometry::TYPE_RING, Geometry::TYPE_POLYGON })
+        {
+            osg::ref_ptr<ConvertTypeFilter> filter = new ConvertTypeFilter(type);
+            requireSameResult(filter.get(), count);
+        }
+    }
+}
+
+TEST_CASE("FeatureBatch filter benchmarks", "[.benchmark]")
+{
+    const unsigned count = 200000;
+
+    auto createChain = []()
+        {
+            FeatureFilterChain chain;
+            osg::ref_ptr<TransformFilter> xform = new TransformFilter(SpatialReference::get("spherical-mercator"));
+            xform->setLocalizeCoordinates(true);
+            chain.push_back(xform);
+            chain.push_back(new ScaleFilter(0.25));
+            osg::ref_ptr<AltitudeFilter> altitude = new AltitudeFilter();
+            altitude->getOrCreateSymbol()->technique() = AltitudeSymbol::TECHNIQUE_GPU;
+            altitude->getOrCreateSymbol()->clamping() = AltitudeSymbol::CLAMP_TO_TERRAIN;
+            chain.push_back(altitude);
+            chain.push_back(new ConvertTypeFilter(Geometry::TYPE_LINESTRING));
+            return chain;
+        };
+
+    FeatureList list = createMixedFeatures(count);
+    auto t0 = std::chrono::steady_clock::now();
+    FilterContext cx;
+    createChain().push(list, cx);
+    auto t1 = std::chrono::steady_clock::now();
+
+    osg::ref_ptr<FeatureBatch> batch = FeatureBatch::create(createMixedFeatures(count));
+    auto t2 = std::chrono::steady_clock::now();
+    FilterContext bcx;
+    createChain().push(*batch, bcx);
+    auto t3 = std::chrono::steady_clock::now();
+
+    double listMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    double batchMs = std::chrono::duration<double, std::milli>(t3 - t2).count();
+
+    OE_NOTICE << "Filter chain on " << count << " features: FeatureList " << listMs
+        << " ms, FeatureBatch " << batchMs << " ms (" << (listMs / batchMs) << "x)" << std::endl;
+}
+
+namespace
+{
+    // The attribute table Feature used before keys were interned
+    struct StringAttributes
+    {
+        Util::vector_map<std::string, AttributeValue> attrs;
+
+        void set(const std::string& name, double value) {
+            attrs[Util::toLower(name)].emplace<double>(value);
+        }
+        double getDouble(const std::string& name) const {
+            auto i = attrs.find(Util::toLower(name));
+            return i != attrs.end() ? i->second.getDouble() : 0.0;
+        }
+    };
+}
+
+TEST_CASE("Feature attribute benchmarks", "[.benchmark]")
+{
+    const unsigned count = 1000000;
+    const std::vector<std::string> names = {
+        "name", "height", "floors", "type", "roof_shape", "material", "year_built", "zoning" };
+
+    auto msSince = [](std::chrono::steady_clock::time_point t0)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        };
+
+    double sink = 0.0;
+
+    // before: string keys, re-cased on every access
+    std::vector<StringAttributes> before(count);
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+        for (auto& name : names)
+            before[i].set(name, (double)i);
+    double beforeSet = msSince(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+        sink += before[i].getDouble("height") + before[i].getDouble("zoning");
+    double beforeGet = msSince(t0);
+
+    // after: interned keys, converted from strings on each call
+    FeatureList after;
+    after.reserve(count);
+    for (unsigned i = 0; i < count; ++i)
+        after.push_back(new Feature(new Point(), nullptr));
+
+    t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+        for (auto& name : names)
+            after[i]->set(name, (double)i);
+    double afterSet = msSince(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+        sink += after[i]->getDouble("height") + after[i]->getDouble("zoning");
+    double afterGet = msSince(t0);
+
+    // after: keys resolved once
+    const AttributeKey height("height"), zoning("zoning");
+    t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+        sink += after[i]->getDouble(height) + after[i]->getDouble(zoning);
+    double afterKeyGet = msSince(t0);
+
+    // after: an expression, whose keys are resolved when it is parsed
+    const NumericExpression expr("[height] + [zoning]");
+    t0 = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < count; ++i)
+        sink += after[i]->eval(expr, (const Util::FilterContext*)nullptr);
+    double afterExprGet = msSince(t0);
+
+    OE_NOTICE << "Attributes on " << count << " features, " << names.size() << " attributes each: "
+        << "string table set " << beforeSet << " ms, get " << beforeGet << " ms; "
+        << "interned table set " << afterSet << " ms, get " << afterGet << " ms, get by key "
+        << afterKeyGet << " ms, expression " << afterExprGet << " ms (" << (sink > 0.0) << ")" << std::endl;
 }
@@ -0,0 +1,281 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/GeometryClamper>
+#include <osgEarth/GDAL>
+#include <osgEarth/Map>
+#include <osgEarth/Notify>
+#include <osg/MatrixTransform>
+#include <gdal.h>
+#include <cpl_vsi.h>
+#include <chrono>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    // A planar surface, which bilinear sampling reproduces exactly
+    double heightAt(double lon, double lat)
+    {
+        return 100.0 * lon + 50.0 * lat;
+    }
+
+    // Writes a DEM of the surface covering lon/lat 0..10
+    void createDEM(const std::string& path)
+    {
+        GDALAllRegister();
+
+        const int size = 201;
+        const double step = 10.0 / (size - 1);
+
+        GDALDatasetH ds = GDALCreate(GDALGetDriverByName("GTiff"), path.c_str(), size, size, 1, GDT_Float32, nullptr);
+        double xform[6] = { -0.5 * step, step, 0.0, 10.0 + 0.5 * step, 0.0, -step };
+        GDALSetGeoTransform(ds, xform);
+        GDALSetProjection(ds, SpatialReference::get("wgs84")->getWKT().c_str());
+
+        std::vector<float> row(size);
+        GDALRasterBandH band = GDALGetRasterBand(ds, 1);
+        for (int r = 0; r < size; ++r)
+        {
+            for (int c = 0; c < size; ++c)
+                row[c] = (float)heightAt(c * step, 10.0 - r * step);
+            GDALRasterIO(band, GF_Write, 0, r, size, 1, row.data(), size, 1, GDT_Float32, 0, 0);
+        }
+        GDALClose(ds);
+    }
+
+    osg::ref_ptr<Map> createMap(const std::string& path)
+    {
+        osg::ref_ptr<Map> map = new Map(Map::Options(), nullptr);
+        map->setProfile(Profile::create(Profile::GLOBAL_GEODETIC));
+
+        GDALElevationLayer* layer = new GDALElevationLayer();
+        layer->setURL(path);
+        map->addLayer(layer);
+        REQUIRE(layer->getStatus().isOK());
+        return map;
+    }
+
+    // Line strips of vertices on the ellipsoid, in a local frame at lon/lat 5,5
+    osg::ref_ptr<osg::MatrixTransform> createLines(const SpatialReference* srs, unsigned lines, unsigned vertsPerLine)
+    {
+        osg::Matrixd local2world;
+        GeoPoint(srs, 5.0, 5.0, 0.0).createLocalToWorld(local2world);
+        osg::Matrixd world2local = osg::Matrixd::inverse(local2world);
+
+        const Ellipsoid& em = srs->getEllipsoid();
+        osg::Vec3Array* verts = new osg::Vec3Array();
+        osg::Geometry* geom = new osg::Geometry();
+        for (unsigned i = 0; i < lines; ++i)
+        {
+            double lat = 1.0 + 8.0 * (i + 0.5) / lines;
+            for (unsigned j = 0; j < vertsPerLine; ++j)
+            {
+                double lon = 1.0 + 8.0 * j / (vertsPerLine - 1);
+                verts->push_back(em.geodeticToGeocentric(osg::Vec3d(lon, lat, 0.0)) * world2local);
+            }
+            geom->addPrimitiveSet(new osg::DrawArrays(GL_LINE_STRIP, i * vertsPerLine, vertsPerLine));
+        }
+        geom->setVertexArray(verts);
+
+        osg::ref_ptr<osg::MatrixTransform> xform = new osg::MatrixTransform(local2world);
+        xform->addChild(geom);
+        return xform;
+    }
+
+    osg::Vec3Array* vertsOf(osg::MatrixTransform* xform)
+    {
+        return static_cast<osg::Vec3Array*>(xform->getChild(0)->asGeometry()->getVertexArray());
+    }
+
+    // A terrain patch mesh of the same surface, to intersect
+    osg::ref_ptr<osg::MatrixTransform> createTerrainPatch(const SpatialReference* srs, unsigned size)
+    {
+        osg::Matrixd local2world;
+        GeoPoint(srs, 5.0, 5.0, 0.0).createLocalToWorld(local2world);
+        osg::Matrixd world2local = osg::Matrixd::inverse(local2world);
+
+        const Ellipsoid& em = srs->getEllipsoid();
+        osg::Vec3Array* verts = new osg::Vec3Array();
+        osg::DrawElementsUInt* tris = new osg::DrawElementsUInt(GL_TRIANGLES);
+        for (unsigned r = 0; r < size; ++r)
+        {
+            for (unsigned c = 0; c < size; ++c)
+            {
+                double lon = 10.0 * c / (size - 1), lat = 10.0 * r / (size - 1);
+                verts->push_back(em.geodeticToGeocentric(osg::Vec3d(lon, lat, heightAt(lon, lat))) * world2local);
+                if (r > 0 && c > 0)
+                {
+                    unsigned i = r * size + c;
+                    tris->insert(tris->end(), { i - size - 1, i - size, i, i - size - 1, i, i - 1 });
+                }
+            }
+        }
+        osg::Geometry* geom = new osg::Geometry();
+        geom->setVertexArray(verts);
+        geom->addPrimitiveSet(tris);
+
+        osg::ref_ptr<osg::MatrixTransform> xform = new osg::MatrixTransform(local2world);
+        xform->addChild(geom);
+        return xform;
+    }
+}
+
+TEST_CASE("GeometryClamper samples the elevation pool directly")
+{
+    const std::string path = "/vsimem/osgearth_clamper_test.tif";
+    createDEM(path);
+
+    {
+        osg::ref_ptr<Map> map = createMap(path);
+        const SpatialReference* srs = map->getSRS();
+
+        // 10,000 vertices spread over many elevation tiles
+        osg::ref_ptr<osg::MatrixTransform> lines = createLines(srs, 20, 500);
+
+        GeometryClamper::LocalData data;
+        GeometryClamper clamper(data);
+        clamper.setTerrainSRS(srs);
+        clamper.setElevationPool(map->getElevationPool());
+        clamper.setUseVertexZ(false);
+        lines->accept(clamper);
+
+        const Ellipsoid& em = srs->getEllipsoid();
+        unsigned misses = 0;
+        for (auto& v : *vertsOf(lines.get()))
+        {
+            osg::Vec3d lla = em.geocentricToGeodetic(osg::Vec3d(v) * lines->getMatrix());
+            if (std::abs(lla.z() - heightAt(lla.x(), lla.y())) > 1.0)
+                ++misses;
+        }
+        REQUIRE(misses == 0);
+
+        SECTION("Reverting restores the original vertices")
+        {
+            clamper.setRevert(true);
+            lines->accept(clamper);
+            osg::Vec3d lla = em.geocentricToGeodetic(osg::Vec3d(vertsOf(lines.get())->front()) * lines->getMatrix());
+            REQUIRE(lla.z() == Approx(0.0).margin(0.5));
+        }
+    }
+
+    VSIUnlink(path.c_str());
+}
+
+TEST_CASE("GeometryClamper re-clamps a terrain tile update from resident data")
+{
+    const std::string path = "/vsimem/osgearth_clamper_resident_test.tif";
+    createDEM(path);
+
+    {
+        osg::ref_ptr<Map> map = createMap(path);
+        const SpatialReference* srs = map->getSRS();
+        const Ellipsoid& em = srs->getEllipsoid();
+        osg::ref_ptr<osg::MatrixTransform> lines = createLines(srs, 20, 100);
+
+        osg::ref_ptr<GeometryClamperCallback> callback = new GeometryClamperCallback(lines.get());
+        callback->getClamper().setTerrainSRS(srs);
+        callback->getClamper().setElevationPool(map->getElevationPool());
+        callback->getClamper().setUseVertexZ(false);
+
+        // lon/lat 0..5.625
+        TileKey key = map->getProfile()->createTileKey(2.0, 2.0, 5);
+        TerrainCallbackContext context(nullptr);
+        osg::ref_ptr<osg::Group> tile = new osg::Group();
+
+        SECTION("Nothing is loaded for the update")
+        {
+            callback->onTileUpdate(key, tile.get(), context);
+
+            for (auto& v : *vertsOf(lines.get()))
+            {
+                osg::Vec3d lla = em.geocentricToGeodetic(osg::Vec3d(v) * lines->getMatrix());
+                REQUIRE(lla.z() == Approx(0.0).margin(0.5));
+            }
+        }
+
+        SECTION("Only vertices in the updated tile move")
+        {
+            // hold the tile's elevation data, the way the terrain does
+            osg::ref_ptr<ElevationTexture> resident;
+            REQUIRE(map->getElevationPool()->getTile(key, true, resident, nullptr, nullptr));
+
+            callback->onTileUpdate(key, tile.get(), context);
+
+            unsigned inside = 0, misses = 0;
+            for (auto& v : *vertsOf(lines.get()))
+            {
+                osg::Vec3d lla = em.geocentricToGeodetic(osg::Vec3d(v) * lines->getMatrix());
+                if (key.getExtent().contains(lla.x(), lla.y()))
+                {
+                    ++inside;
+                    if (std::abs(lla.z() - heightAt(lla.x(), lla.y())) > 1.0)
+                        ++misses;
+                }
+                else if (std::abs(lla.z()) > 0.5)
+                {
+                    ++misses;
+                }
+            }
+            REQUIRE(inside > 0);
+            REQUIRE(misses == 0);
+        }
+    }
+
+    VSIUnlink(path.c_str());
+}
+
+TEST_CASE("GeometryClamper benchmarks", "[.benchmark]")
+{
+    const std::string path = "/vsimem/osgearth_clamper_benchmark.tif";
+    createDEM(path);
+
+    {
+        osg::ref_ptr<Map> map = createMap(path);
+        const SpatialReference* srs = map->getSRS();
+
+        // 1M vertices sampled from the elevation pool
+        {
+            osg::ref_ptr<osg::MatrixTransform> lines = createLines(srs, 1000, 1000);
+            GeometryClamper::LocalData data;
+            GeometryClamper clamper(data);
+            clamper.setTerrainSRS(srs);
+            clamper.setElevationPool(map->getElevationPool());
+
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                auto t0 = std::chrono::steady_clock::now();
+                lines->accept(clamper);
+                double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+                OE_NOTICE << "Clamped " << vertsOf(lines.get())->size() << " vertices by sampling"
+                    << (pass == 0 ? " (cold)" : " (warm)") << " in " << s << " s ("
+                    << (vertsOf(lines.get())->size() / s) << " verts/s)" << std::endl;
+            }
+        }
+
+        // ...and a sample of them intersected with a terrain mesh, for comparison
+        {
+            osg::ref_ptr<osg::MatrixTransform> lines = createLines(srs, 10, 1000);
+            osg::ref_ptr<osg::MatrixTransform> patch = createTerrainPatch(srs, 257);
+            GeometryClamper::LocalData data;
+            GeometryClamper clamper(data);
+            clamper.setTerrainSRS(srs);
+            clamper.setTerrainPatch(patch.get());
+
+            auto t0 = std::chrono::steady_clock::now();
+            lines->accept(clamper);
+            double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+            OE_NOTICE << "Clamped " << vertsOf(lines.get())->size() << " vertices by intersection in "
+                << s << " s (" << (vertsOf(lines.get())->size() / s) << " verts/s)" << std::endl;
+        }
+    }
+
+    VSIUnlink(path.c_str());
+}
@@ -8,6 +8,11 @@
 #include <osgEarth/ImageLayer>
 #include <osgEarth/Registry>
 #include <osgEarth/GDAL>
+#include <osgEarth/MemCache>
+#include <osgEarth/Map>
+#include <osgEarth/TerrainTileModelFactory>
+#include <osg/UserDataContainer>
+#include <chrono>
 
 using namespace osgEarth;
 
@@ -50,4 +55,132 @@ TEST_CASE("Attribution works")
 
     REQUIRE(status.isOK());
     REQUIRE(layer->getAttribution() == attribution);
-}
\ No newline at end of file
+}
+namespace
+{
+    GDALImageLayer* createCachedWorldLayer(GDALImageLayer* layer = nullptr)
+    {
+        osg::ref_ptr<CacheSettings> cacheSettings = new CacheSettings();
+        cacheSettings->setCache(new MemCache(1024));
+        osg::ref_ptr<osgDB::Options> dbo = new osgDB::Options();
+        cacheSettings->store(dbo.get());
+
+        if (!layer)
+            layer = new GDALImageLayer();
+        layer->setName("World");
+        layer->setURL("../data/world.tif");
+        layer->setReadOptions(dbo.get());
+        return layer;
+    }
+}
+
+TEST_CASE("Prepared images round-trip through the layer cache")
+{
+    osg::ref_ptr<GDALImageLayer> layer = createCachedWorldLayer();
+    REQUIRE(layer->open().isOK());
+
+    TileKey key(1, 0, 0, layer->getProfile());
+    REQUIRE(layer->readPreparedImageFromCache(key, "cpu") == nullptr);
+
+    GeoImage image = layer->createImage(key);
+    REQUIRE(image.valid());
+
+    osg::ref_ptr<const osg::Image> mipmapped = ImageUtils::mipmapImage(image.getImage());
+    REQUIRE(layer->writePreparedImageToCache(key, "cpu", mipmapped.get()));
+
+    auto cached = layer->readPreparedImageFromCache(key, "cpu");
+    REQUIRE(cached.valid());
+    REQUIRE(cached->getNumMipmapLevels() == mipmapped->getNumMipmapLevels());
+
+    // a different variant is a different record:
+    REQUIRE(layer->readPreparedImageFromCache(key, "none") == nullptr);
+}
+
+namespace
+{
+    // Tags each image it returns, the way BiomeLayer tracks its rasters
+    struct TaggingWorldLayer : public GDALImageLayer
+    {
+        mutable unsigned postCreateCalls = 0u;
+
+        void postCreateImageImplementation(GeoImage& image, const TileKey& key, ProgressCallback* progress) const override
+        {
+            ++postCreateCalls;
+            if (image.getTrackingToken() == nullptr)
+                image.setTrackingToken(new osg::DefaultUserDataContainer());
+        }
+    };
+}
+
+TEST_CASE("Prepared images keep the layer's post-create processing")
+{
+    osg::ref_ptr<TaggingWorldLayer> layer = new TaggingWorldLayer();
+    createCachedWorldLayer(layer.get());
+    REQUIRE(layer->open().isOK());
+
+    TileKey key(1, 0, 0, layer->getProfile());
+    auto prepare = [](const osg::Image* image) { return osg::ref_ptr<const osg::Image>(ImageUtils::mipmapImage(image)); };
+
+    // created, prepared and cached:
+    GeoImage created = layer->createPreparedImage(key, "cpu", prepare, nullptr);
+    REQUIRE(created.valid());
+    REQUIRE(created.getImage()->isMipmap());
+    REQUIRE(created.getTrackingToken() != nullptr);
+    REQUIRE(layer->postCreateCalls == 1u);
+    REQUIRE(layer->readPreparedImageFromCache(key, "cpu").valid());
+
+    // read from the cache, and still processed:
+    GeoImage fromCache = layer->createPreparedImage(key, "cpu", prepare, nullptr);
+    REQUIRE(fromCache.valid());
+    REQUIRE(fromCache.getImage()->isMipmap());
+    REQUIRE(fromCache.getTrackingToken() != nullptr);
+    REQUIRE(layer->postCreateCalls == 2u);
+}
+
+TEST_CASE("Cache-warm terrain tile model creation benchmark", "[.benchmark]")
+{
+    const unsigned lod = 3;
+    const unsigned passes = 5;
+
+    for (bool cacheTextures : { false, true })
+    {
+        osg::ref_ptr<GDALImageLayer> layer = createCachedWorldLayer();
+        osg::ref_ptr<Map> map = new Map();
+        map->addLayer(layer.get());
+        REQUIRE(layer->isOpen());
+
+        TerrainOptions options;
+        options.textureCompression() = "cpu";
+        options.cacheTextures() = cacheTextures;
+        osg::ref_ptr<TerrainTileModelFactory> factory = new TerrainTileModelFactory(options);
+
+        std::vector<TileKey> keys;
+        unsigned tx, ty;
+        layer->getProfile()->getNumTiles(lod, tx, ty);
+        for (unsigned y = 0; y < ty; ++y)
+            for (unsigned x = 0; x < tx; ++x)
+                keys.emplace_back(lod, x, y, layer->getProfile());
+
+        CreateTileManifest manifest;
+        TerrainEngineRequirements reqs;
+
+        // warm the cache:
+        for (auto& key : keys)
+            osg::ref_ptr<TerrainTileModel> model = factory->createTileModel(map.get(), key, manifest, reqs, nullptr);
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned pass = 0; pass < passes; ++pass)
+        {
+            for (auto& key : keys)
+            {
+                osg::ref_ptr<TerrainTileModel> model = factory->createTileModel(map.get(), key, manifest, reqs, nullptr);
+                REQUIRE(model.valid());
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+
+        OE_NOTICE << "cache_textures=" << (cacheTextures ? "true" : "false")
+            << ": " << (double)(keys.size() * passes) / seconds << " tiles/s" << std::endl;
+    }
+}
@@ -0,0 +1,257 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/LocalTileReader>
+#include <osgEarth/XYZ>
+#include <osgEarth/TMS>
+#include <osgEarth/FileUtils>
+#include <osgEarth/Notify>
+#include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <thread>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    osg::Vec4ub colorOf(unsigned z, unsigned x, unsigned y)
+    {
+        return osg::Vec4ub(40 * (x % 6), 60 * (y % 4), 30 * z, 255);
+    }
+
+    std::string tileName(const std::string& dir, unsigned z, unsigned x, unsigned y)
+    {
+        return dir + "/" + std::to_string(z) + "/" + std::to_string(x) + "/" + std::to_string(y) + ".png";
+    }
+
+    // Writes a {z}/{x}/{y}.png pyramid of solid-color tiles
+    std::vector<TileKey> createPyramid(const std::string& dir, const Profile* profile, unsigned maxLevel, unsigned tileSize)
+    {
+        std::vector<TileKey> keys;
+        for (unsigned z = 0; z <= maxLevel; ++z)
+        {
+            unsigned cols, rows;
+            profile->getNumTiles(z, cols, rows);
+            for (unsigned x = 0; x < cols; ++x)
+            {
+                for (unsigned y = 0; y < rows; ++y)
+                {
+                    osg::ref_ptr<osg::Image> image = new osg::Image();
+                    image->allocateImage(tileSize, tileSize, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+                    osg::Vec4ub color = colorOf(z, x, y);
+                    for (unsigned i = 0; i < tileSize * tileSize; ++i)
+                        ::memcpy(image->data() + 4 * i, color.ptr(), 4);
+
+                    std::string filename = tileName(dir, z, x, y);
+                    makeDirectoryForFile(filename);
+                    REQUIRE(osgDB::writeImageFile(*image, filename));
+                    keys.emplace_back(z, x, y, profile);
+                }
+            }
+        }
+        return keys;
+    }
+
+    bool sameImage(const osg::Image* a, const osg::Image* b)
+    {
+        return
+            a && b &&
+            a->s() == b->s() && a->t() == b->t() &&
+            a->getPixelFormat() == b->getPixelFormat() &&
+            a->getTotalSizeInBytes() == b->getTotalSizeInBytes() &&
+            ::memcmp(a->data(), b->data(), a->getTotalSizeInBytes()) == 0;
+    }
+
+    osg::Vec4ub pixel(const osg::Image* image, unsigned s, unsigned t)
+    {
+        const unsigned char* p = image->data(s, t);
+        return osg::Vec4ub(p[0], p[1], p[2], p[3]);
+    }
+}
+
+TEST_CASE("LocalTileReader")
+{
+    std::string dir = getTempName(getTempPath(), "_xyz");
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::SPHERICAL_MERCATOR);
+    createPyramid(dir, profile.get(), 2, 32);
+
+    SECTION("Usable only for templates under an existing local directory")
+    {
+        REQUIRE(LocalTileReader::usable(URI(dir + "/{z}/{x}/{y}.png"), nullptr));
+        REQUIRE(LocalTileReader::usable(URI(dir + "/${z}/${x}/${y}.png"), nullptr));
+        REQUIRE(LocalTileReader::usable(URI("file://" + dir + "/{z}/{x}/{y}.png"), nullptr));
+        REQUIRE(LocalTileReader::usable(URI(dir + "/missing/{z}/{x}/{y}.png"), nullptr) == false);
+        REQUIRE(LocalTileReader::usable(URI("http://tiles.example.com/{z}/{x}/{y}.png"), nullptr) == false);
+        REQUIRE(LocalTileReader::usable(URI(), nullptr) == false);
+    }
+
+    SECTION("File URLs")
+    {
+        REQUIRE(LocalTileReader::toPath("file:///data/tiles/1/0/0.png") == "/data/tiles/1/0/0.png");
+        REQUIRE(LocalTileReader::toPath("file:///C:/tiles/1/0/0.png") == "C:/tiles/1/0/0.png");
+        REQUIRE(LocalTileReader::toPath("/data/tiles/1/0/0.png") == "/data/tiles/1/0/0.png");
+    }
+
+    SECTION("Reads the same image as URI")
+    {
+        LocalTileReader reader;
+        for (unsigned x = 0; x < 4; ++x)
+        {
+            std::string filename = tileName(dir, 2, x, 3);
+            ReadResult local = reader.readImage(filename, nullptr);
+            ReadResult regular = URI(filename).readImage();
+            REQUIRE(local.succeeded());
+            REQUIRE(regular.succeeded());
+            REQUIRE(sameImage(local.getImage(), regular.getImage()));
+            REQUIRE(pixel(local.getImage(), 5, 5) == colorOf(2, x, 3));
+        }
+    }
+
+    SECTION("Missing and unknown files")
+    {
+        LocalTileReader reader;
+        REQUIRE(reader.readImage(tileName(dir, 5, 0, 0), nullptr).code() == ReadResult::RESULT_NOT_FOUND);
+
+        std::string unknown = dir + "/0/0/0.no_such_format";
+        std::ofstream(unknown) << "not an image";
+        REQUIRE(reader.readImage(unknown, nullptr).code() == ReadResult::RESULT_NOT_IMPLEMENTED);
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Tile layers read local tiles")
+{
+    std::string dir = getTempName(getTempPath(), "_xyz");
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::SPHERICAL_MERCATOR);
+    createPyramid(dir, profile.get(), 2, 32);
+
+    SECTION("XYZImageLayer")
+    {
+        for (bool prefetch : { false, true })
+        {
+            osg::ref_ptr<XYZImageLayer> layer = new XYZImageLayer();
+            layer->setURL("file://" + dir + "/{z}/{x}/{y}.png");
+            layer->setProfile(profile.get());
+            layer->setPrefetchSiblings(prefetch);
+            layer->options().maxLevel() = 2;
+            REQUIRE(layer->open().isOK());
+
+            TileKey key(2, 1, 2, profile.get());
+            GeoImage image = layer->createImage(key);
+            REQUIRE(image.valid());
+            REQUIRE(image.getExtent() == key.getExtent());
+            REQUIRE(pixel(image.getImage(), 16, 16) == colorOf(2, 1, 2));
+
+            REQUIRE(layer->createImage(TileKey(2, 1, 2, profile.get()).createChildKey(0)).valid() == false);
+        }
+    }
+
+    SECTION("TMSImageLayer")
+    {
+        // TMS tile rows count from the south
+        osg::ref_ptr<TMS::TileMap> tileMap = TMS::TileMap::create(
+            dir + "/tms.xml", profile.get(), DataExtentList(), "png", 32, 32);
+        TMS::TileMapReaderWriter::write(tileMap.get(), dir + "/tms.xml");
+
+        osg::ref_ptr<TMSImageLayer> layer = new TMSImageLayer();
+        layer->setURL(dir + "/tms.xml");
+        layer->setPrefetchSiblings(true);
+        REQUIRE(layer->open().isOK());
+
+        GeoImage image = layer->createImage(TileKey(2, 3, 0, profile.get()));
+        REQUIRE(image.valid());
+        REQUIRE(pixel(image.getImage(), 16, 16) == colorOf(2, 3, 3));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Local tile read benchmarks", "[.benchmark]")
+{
+    // Random reads from a warm (page-cached) pyramid of 256x256 PNG tiles,
+    // through URI and through the local fast path, on one thread and on
+    // all cores.
+    const unsigned maxLevel = 5;
+    const unsigned numReads = 20000;
+
+    std::string dir = getTempName(getTempPath(), "_xyz");
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::SPHERICAL_MERCATOR);
+    std::vector<TileKey> keys = createPyramid(dir, profile.get(), maxLevel, 256);
+
+    std::vector<std::string> files;
+    std::mt19937 random(42);
+    std::uniform_int_distribution<std::size_t> pick(0, keys.size() - 1);
+    for (unsigned i = 0; i < numReads; ++i)
+    {
+        const TileKey& key = keys[pick(random)];
+        files.push_back(tileName(dir, key.getLOD(), key.getTileX(), key.getTileY()));
+    }
+
+    auto run = [&](const char* name, unsigned threads, const std::function<bool(const std::string&)>& read)
+        {
+            std::atomic_uint next(0u), failed(0u);
+            auto t0 = std::chrono::steady_clock::now();
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&]()
+                    {
+                        for (unsigned i = next++; i < files.size(); i = next++)
+                            if (!read(files[i]))
+                                ++failed;
+                    });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+            OE_NOTICE << name << " with " << threads << " threads: "
+                << (files.size() / s) << " tiles/s (" << failed << " failed)" << std::endl;
+        };
+
+    LocalTileReader reader;
+
+    for (unsigned threads : { 1u, std::max(1u, std::thread::hardware_concurrency()) })
+    {
+        run("URI::readImage", threads, [](const std::string& file)
+            {
+                return URI(file).readImage().succeeded();
+            });
+
+        run("LocalTileReader", threads, [&](const std::string& file)
+            {
+                return reader.readImage(file, nullptr).succeeded();
+            });
+    }
+
+    osg::ref_ptr<XYZImageLayer> layer = new XYZImageLayer();
+    layer->setURL(dir + "/{z}/{x}/{y}.png");
+    layer->setProfile(profile.get());
+    layer->options().maxLevel() = maxLevel;
+    REQUIRE(layer->open().isOK());
+
+    std::vector<TileKey> randomKeys;
+    for (unsigned i = 0; i < numReads; ++i)
+        randomKeys.push_back(keys[pick(random)]);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (auto& key : randomKeys)
+        layer->createImage(key);
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    OE_NOTICE << "XYZImageLayer::createImage: " << (randomKeys.size() / s) << " tiles/s" << std::endl;
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,217 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/Map>
+#include <osgEarth/Layer>
+#include <osgEarth/Notify>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace osgEarth;
+
+namespace
+{
+    std::atomic_int s_openSequence(0);
+
+    // A layer that takes a while to open, like one reading a remote catalog,
+    // and that can refer to another layer by name.
+    // An "undeclared" layer doesn't report its dependencies and opens its
+    // dependency itself, the way a LayerReference can.
+    class SlowOpenLayer : public Layer
+    {
+    public:
+        class Options : public Layer::Options
+        {
+        public:
+            META_LayerOptions(osgEarth, Options, Layer::Options);
+            OE_OPTION(unsigned, delay, 0u);
+            OE_OPTION(std::string, dependsOn);
+            virtual Config getConfig() const
+            {
+                Config conf = Layer::Options::getConfig();
+                conf.set("delay", delay());
+                conf.set("depends_on", dependsOn());
+                return conf;
+            }
+        private:
+            void fromConfig(const Config& conf)
+            {
+                conf.get("delay", delay());
+                conf.get("depends_on", dependsOn());
+            }
+        };
+
+        META_Layer(osgEarth, SlowOpenLayer, Options, Layer, slow_open);
+
+        int openedAt = -1;
+        int dependencyOpenedAt = -1;
+        osg::observer_ptr<SlowOpenLayer> dependency;
+        bool undeclared = false;
+
+        bool getOpenDependencies(std::vector<std::string>& layerNames) const override
+        {
+            if (undeclared)
+                return false;
+            if (options().dependsOn().isSet())
+                layerNames.push_back(options().dependsOn().get());
+            return true;
+        }
+
+    protected:
+        Status openImplementation() override
+        {
+            Status parent = Layer::openImplementation();
+            if (parent.isError())
+                return parent;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(options().delay().get()));
+
+            osg::ref_ptr<SlowOpenLayer> dep;
+            if (undeclared && dependency.lock(dep) && !dep->isOpen())
+                dep->open();
+            if (dependency.lock(dep))
+                dependencyOpenedAt = dep->isOpen() ? dep->openedAt : -1;
+
+            openedAt = s_openSequence++;
+            return Status::NoError;
+        }
+    };
+
+    SlowOpenLayer* createSlowLayer(const std::string& name, unsigned delay)
+    {
+        SlowOpenLayer* layer = new SlowOpenLayer();
+        layer->setName(name);
+        layer->options().delay() = delay;
+        return layer;
+    }
+
+    osg::ref_ptr<Map> createMap(unsigned openThreads)
+    {
+        Map::Options options;
+        options.layerOpenThreads() = openThreads;
+        return new Map(options, nullptr);
+    }
+}
+
+TEST_CASE("Map opens layers concurrently")
+{
+    osg::ref_ptr<Map> map = createMap(4);
+
+    LayerVector layers;
+    for (unsigned i = 0; i < 8; ++i)
+        layers.push_back(createSlowLayer("Layer " + std::to_string(i), 20));
+
+    // "Layer 0" waits on "Base" by naming it in its options, even though
+    // it comes first in the batch.
+    SlowOpenLayer* base = createSlowLayer("Base", 50);
+    SlowOpenLayer* first = static_cast<SlowOpenLayer*>(layers[0].get());
+    first->options().dependsOn() = "Base";
+    first->dependency = base;
+    layers.push_back(base);
+
+    map->addLayers(layers);
+
+    SECTION("All layers are open")
+    {
+        for (auto& layer : layers)
+            REQUIRE(layer->isOpen());
+    }
+
+    SECTION("A referenced layer opens before the layer that refers to it")
+    {
+        REQUIRE(first->dependencyOpenedAt >= 0);
+        REQUIRE(first->dependencyOpenedAt < first->openedAt);
+    }
+
+    SECTION("Layer order is the order given")
+    {
+        LayerVector result;
+        map->getLayers(result);
+        REQUIRE(result.size() == layers.size());
+        for (unsigned i = 0; i < layers.size(); ++i)
+            REQUIRE(result[i] == layers[i]);
+    }
+}
+
+TEST_CASE("Map layers that refer to each other still open")
+{
+    osg::ref_ptr<Map> map = createMap(4);
+
+    SlowOpenLayer* a = createSlowLayer("A", 1);
+    SlowOpenLayer* b = createSlowLayer("B", 1);
+    a->options().dependsOn() = "B";
+    b->options().dependsOn() = "A";
+
+    map->addLayers(LayerVector{ a, b });
+
+    REQUIRE(a->isOpen());
+    REQUIRE(b->isOpen());
+}
+
+TEST_CASE("Map opens layers with unknown dependencies on their own")
+{
+    osg::ref_ptr<Map> map = createMap(4);
+
+    LayerVector layers;
+    for (unsigned i = 0; i < 4; ++i)
+        layers.push_back(createSlowLayer("Layer " + std::to_string(i), 10));
+
+    // "Loner" opens "Layer 3" itself without declaring it, so it must not
+    // run alongside the other layers.
+    SlowOpenLayer* loner = createSlowLayer("Loner", 10);
+    loner->undeclared = true;
+    loner->dependency = static_cast<SlowOpenLayer*>(layers[3].get());
+    layers.push_back(loner);
+
+    map->addLayers(layers);
+
+    REQUIRE(loner->isOpen());
+    REQUIRE(loner->dependencyOpenedAt >= 0);
+    REQUIRE(loner->dependencyOpenedAt < loner->openedAt);
+
+    for (unsigned i = 0; i < 3; ++i)
+    {
+        REQUIRE(layers[i]->isOpen());
+        REQUIRE(static_cast<SlowOpenLayer*>(layers[i].get())->openedAt > loner->openedAt);
+    }
+}
+
+TEST_CASE("Map startup benchmarks", "[.benchmark]")
+{
+    const unsigned numLayers = 60;
+    const unsigned delay = 50;
+
+    auto time = [&](unsigned threads)
+        {
+            osg::ref_ptr<Map> map = createMap(threads);
+            LayerVector layers;
+            for (unsigned i = 0; i < numLayers; ++i)
+            {
+                SlowOpenLayer* layer = createSlowLayer("Layer " + std::to_string(i), delay);
+                if (i % 10 == 9)
+                    layer->options().dependsOn() = "Layer " + std::to_string(i - 1);
+                layers.push_back(layer);
+            }
+
+            auto t0 = std::chrono::steady_clock::now();
+            map->addLayers(layers);
+            auto t1 = std::chrono::steady_clock::now();
+
+            for (auto& layer : layers)
+                REQUIRE(layer->isOpen());
+
+            return std::chrono::duration<double, std::milli>(t1 - t0).count();
+        };
+
+    double serial = time(1);
+    double parallel = time(std::max(4u, std::thread::hardware_concurrency()));
+
+    OE_NOTICE << "Opened " << numLayers << " layers (" << delay << " ms each): "
+        << "serial " << serial << " ms, concurrent " << parallel << " ms ("
+        << (serial / parallel) << "x)" << std::endl;
+}
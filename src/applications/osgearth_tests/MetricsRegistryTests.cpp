@@ -0,0 +1,180 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/MetricsRegistry>
+#include <osgEarth/Containers>
+#include <osgEarth/Notify>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    // Enables recording for the life of the object
+    struct ScopedEnable
+    {
+        bool previous = MetricsRegistry::enabled();
+        ScopedEnable(bool value = true) { MetricsRegistry::setEnabled(value); }
+        ~ScopedEnable() { MetricsRegistry::setEnabled(previous); }
+    };
+}
+
+TEST_CASE("MetricsRegistry")
+{
+    auto& registry = MetricsRegistry::instance();
+
+    SECTION("Metrics record only while enabled")
+    {
+        auto& counter = registry.counter("test_enabled_total", "test");
+        auto& gauge = registry.gauge("test_enabled_gauge", "test");
+        auto& histogram = registry.histogram("test_enabled_seconds", "test");
+        registry.reset();
+        {
+            ScopedEnable off(false);
+            counter.add(5);
+            gauge.set(5);
+            histogram.record(5);
+            { MetricsRegistry::ScopedTimer timer(histogram); }
+        }
+        REQUIRE(counter.value() == 0u);
+        REQUIRE(gauge.value() == 0);
+        REQUIRE(histogram.count() == 0u);
+        {
+            ScopedEnable on;
+            counter.add(5);
+            gauge.set(5);
+            gauge.add(-2);
+            histogram.record(5);
+            { MetricsRegistry::ScopedTimer timer(histogram); }
+        }
+        REQUIRE(counter.value() == 5u);
+        REQUIRE(gauge.value() == 3);
+        REQUIRE(histogram.count() == 2u);
+    }
+
+    SECTION("The same name and labels return the same metric")
+    {
+        REQUIRE(&registry.counter("test_same_total", "test", { { "a", "1" } }) ==
+                &registry.counter("test_same_total", "test", { { "a", "1" } }));
+        REQUIRE(&registry.counter("test_same_total", "test", { { "a", "1" } }) !=
+                &registry.counter("test_same_total", "test", { { "a", "2" } }));
+    }
+
+    SECTION("Histogram buckets cover every value")
+    {
+        using H = MetricsRegistry::Histogram;
+        for (unsigned i = 1; i < H::NUM_BUCKETS; ++i)
+            REQUIRE(H::bucketLowerBound(i) == H::bucketUpperBound(i - 1));
+
+        for (std::uint64_t v : { 0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456ull, (1ull << 39) + 12345ull })
+        {
+            unsigned b = H::bucketOf(v);
+            REQUIRE(H::bucketLowerBound(b) <= v);
+            REQUIRE(v < H::bucketUpperBound(b));
+        }
+        REQUIRE(H::bucketOf(~0ull) == H::NUM_BUCKETS - 1u);
+    }
+
+    SECTION("Histogram percentiles are within the bucket resolution")
+    {
+        ScopedEnable on;
+        auto& histogram = registry.histogram("test_percentile_seconds", "test");
+        registry.reset();
+        for (std::uint64_t v = 1; v <= 100000; ++v)
+            histogram.record(v);
+
+        REQUIRE(histogram.count() == 100000u);
+        REQUIRE(histogram.max() == 100000u);
+        for (double q : { 0.5, 0.9, 0.99, 0.999 })
+        {
+            double expected = q * 100000.0;
+            REQUIRE(std::abs((double)histogram.percentile(q) - expected) <= expected / 16.0);
+        }
+    }
+
+    SECTION("Exports")
+    {
+        ScopedEnable on;
+        registry.counter("test_export_total", "Exported \"things\"", { { "kind", "a\"b" } }).add(3);
+        registry.histogram("test_export_seconds", "Exported latency").record(1500);
+
+        std::string prom = registry.toPrometheus();
+        REQUIRE(prom.find("# TYPE test_export_total counter") != std::string::npos);
+        REQUIRE(prom.find("test_export_total{kind=\"a\\\"b\"}") != std::string::npos);
+        REQUIRE(prom.find("# TYPE test_export_seconds histogram") != std::string::npos);
+        REQUIRE(prom.find("test_export_seconds_bucket{le=\"0.002048\"}") != std::string::npos);
+        REQUIRE(prom.find("test_export_seconds_bucket{le=\"+Inf\"}") != std::string::npos);
+        REQUIRE(prom.find("test_export_seconds_count") != std::string::npos);
+
+        std::string json = registry.toJSON();
+        REQUIRE(json.find("\"name\":\"test_export_total\"") != std::string::npos);
+        REQUIRE(json.find("\"p99_us\":") != std::string::npos);
+    }
+
+    SECTION("LRUCache reports hits and misses")
+    {
+        ScopedEnable on;
+        auto& hits = registry.counter("osgearth_lru_cache_hits_total", "", { { "cache", "test" } });
+        auto& misses = registry.counter("osgearth_lru_cache_misses_total", "", { { "cache", "test" } });
+        registry.reset();
+
+        LRUCache<int, int> cache(4u);
+        cache.setMetricsName("test");
+        cache.insert(1, 1);
+        cache.get(1);
+        cache.get(2);
+        cache.get_or_insert(3, [](std::optional<int>& v) { v = 3; });
+        cache.get_or_insert(3, [](std::optional<int>& v) { v = 3; });
+
+        REQUIRE(hits.value() == 2u);
+        REQUIRE(misses.value() == 2u);
+    }
+}
+
+TEST_CASE("MetricsRegistry overhead", "[.benchmark]")
+{
+    auto& registry = MetricsRegistry::instance();
+    auto& counter = registry.counter("test_benchmark_total", "test");
+    auto& histogram = registry.histogram("test_benchmark_seconds", "test");
+    const unsigned N = 10000000;
+
+    auto perEvent = [&](const std::function<void()>& func)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            func();
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / N;
+        };
+
+    for (bool enabled : { false, true })
+    {
+        ScopedEnable state(enabled);
+        const char* mode = enabled ? "enabled" : "disabled";
+
+        double c = perEvent([&]() { for (unsigned i = 0; i < N; ++i) counter.add(); });
+        double h = perEvent([&]() { for (unsigned i = 0; i < N; ++i) histogram.record(i & 0xffff); });
+        double t = perEvent([&]() { for (unsigned i = 0; i < N; ++i) { MetricsRegistry::ScopedTimer timer(histogram); } });
+
+        unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+        double mt = perEvent([&]()
+            {
+                std::vector<std::thread> workers;
+                for (unsigned w = 0; w < threads; ++w)
+                    workers.emplace_back([&]() { for (unsigned i = 0; i < N / threads; ++i) counter.add(); });
+                for (auto& worker : workers)
+                    worker.join();
+            });
+
+        OE_NOTICE << "Metrics " << mode << ": counter " << c << " ns, histogram " << h
+            << " ns, scoped timer " << t << " ns, contended counter (" << threads << " threads) "
+            << mt << " ns per event" << std::endl;
+    }
+}
@@ -0,0 +1,144 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/PackedTileKey>
+#include <osgEarth/Profile>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+using namespace osgEarth;
+
+TEST_CASE("PackedTileKey")
+{
+    osg::ref_ptr<const Profile> geo = Profile::create(Profile::GLOBAL_GEODETIC);
+    osg::ref_ptr<const Profile> merc = Profile::create(Profile::SPHERICAL_MERCATOR);
+
+    SECTION("Round trip through TileKey")
+    {
+        for (const TileKey& key : {
+            TileKey(0, 1, 0, geo.get()),
+            TileKey(12, 3071, 1533, geo.get()),
+            TileKey(26, (1u << 27) - 1u, (1u << 26) - 1u, geo.get()),
+            TileKey(19, 12345, 67890, merc.get()) })
+        {
+            PackedTileKey packed = key;
+            REQUIRE(packed.valid());
+            REQUIRE(packed.getLOD() == key.getLOD());
+            REQUIRE(packed.getTileX() == key.getTileX());
+            REQUIRE(packed.getTileY() == key.getTileY());
+            REQUIRE(packed.getProfile()->isHorizEquivalentTo(key.getProfile()));
+            REQUIRE(TileKey(packed) == key);
+            REQUIRE(packed.str() == key.str());
+            REQUIRE(packed.getExtent() == key.getExtent());
+        }
+    }
+
+    SECTION("Invalid and out-of-range keys")
+    {
+        REQUIRE(PackedTileKey().valid() == false);
+        REQUIRE(PackedTileKey(TileKey::INVALID).valid() == false);
+        REQUIRE(TileKey(PackedTileKey()).valid() == false);
+        REQUIRE(PackedTileKey(TileKey(26, 0, (1u << 26) - 1u, geo.get()).createChildKey(2)).valid() == false);
+        REQUIRE(PackedTileKey(32, 0, 0, geo.get()).valid() == false);
+        REQUIRE(PackedTileKey(5, 1u << 27, 0, geo.get()).valid() == false);
+    }
+
+    SECTION("Identical profiles share an index")
+    {
+        osg::ref_ptr<const Profile> geo2 = Profile::create(Profile::GLOBAL_GEODETIC);
+        REQUIRE(PackedTileKey::getProfileIndex(geo.get()) == PackedTileKey::getProfileIndex(geo2.get()));
+        REQUIRE(PackedTileKey::getProfileIndex(geo.get()) != PackedTileKey::getProfileIndex(merc.get()));
+        REQUIRE(PackedTileKey(3, 2, 1, geo.get()) == PackedTileKey(3, 2, 1, geo2.get()));
+        REQUIRE(PackedTileKey(3, 2, 1, geo.get()) != PackedTileKey(3, 2, 1, merc.get()));
+    }
+
+    SECTION("Unpacking keeps the vertical datum")
+    {
+        osg::ref_ptr<const Profile> egm = Profile::create_with_vdatum(Profile::GLOBAL_GEODETIC, "egm96");
+        REQUIRE(egm->isHorizEquivalentTo(geo.get()));
+        REQUIRE(PackedTileKey::getProfileIndex(egm.get()) != PackedTileKey::getProfileIndex(geo.get()));
+
+        PackedTileKey packed = TileKey(5, 6, 7, egm.get());
+        REQUIRE(packed.getProfile()->isEquivalentTo(egm.get()));
+        REQUIRE(TileKey(packed).getProfile()->getSRS()->getVerticalDatum() != nullptr);
+        REQUIRE(TileKey(PackedTileKey(TileKey(5, 6, 7, geo.get()))).getProfile()->getSRS()->getVerticalDatum() == nullptr);
+    }
+
+    SECTION("Keys that fit")
+    {
+        REQUIRE(PackedTileKey::getMaxLOD(geo.get()) == 26u);
+        REQUIRE(PackedTileKey::getMaxLOD(merc.get()) == 26u);
+
+        REQUIRE(PackedTileKey::fits(TileKey(26, (1u << 27) - 1u, (1u << 26) - 1u, geo.get())));
+        REQUIRE(PackedTileKey::fits(TileKey(27, 0, 0, geo.get())));
+        REQUIRE(PackedTileKey::fits(TileKey(27, 0, 1u << 26, geo.get())) == false);
+        REQUIRE(PackedTileKey::fits(TileKey::INVALID) == false);
+    }
+
+    SECTION("Parent, child and quadrant match TileKey")
+    {
+        TileKey key(7, 101, 42, geo.get());
+        PackedTileKey packed = key;
+
+        REQUIRE(TileKey(packed.createParentKey()) == key.createParentKey());
+        REQUIRE(TileKey(packed.createAncestorKey(2)) == key.createAncestorKey(2));
+        REQUIRE(packed.createAncestorKey(8).valid() == false);
+        REQUIRE(PackedTileKey(0, 0, 0, geo.get()).createParentKey().valid() == false);
+
+        for (unsigned q = 0; q < 4; ++q)
+        {
+            PackedTileKey child = packed.createChildKey(q);
+            REQUIRE(TileKey(child) == key.createChildKey(q));
+            REQUIRE(child.getQuadrant() == key.createChildKey(q).getQuadrant());
+            REQUIRE(child.createParentKey() == packed);
+            REQUIRE(child.isDescendantOf(packed));
+        }
+        REQUIRE(packed.isDescendantOf(packed.createChildKey(0)) == false);
+    }
+
+    SECTION("Morton order")
+    {
+        PackedTileKey key(9, 300, 177, geo.get());
+        REQUIRE(PackedTileKey::fromMorton(9, key.morton(), geo.get()) == key);
+
+        // children are numbered in Z-order
+        for (unsigned q = 0; q < 4; ++q)
+            REQUIRE(key.createChildKey(q).morton() == (key.morton() << 2) + q);
+
+        // sorting a quadtree visits each parent before its children,
+        // and each subtree contiguously
+        std::vector<PackedTileKey> keys;
+        for (unsigned lod = 1; lod <= 3; ++lod)
+            for (unsigned x = 0; x < (2u << lod); ++x)
+                for (unsigned y = 0; y < (1u << lod); ++y)
+                    keys.emplace_back(lod, x, y, geo.get());
+        std::sort(keys.begin(), keys.end(), PackedTileKey::mortonLess);
+
+        for (unsigned i = 0; i < keys.size(); ++i)
+        {
+            if (keys[i].getLOD() < 3)
+            {
+                REQUIRE(keys[i + 1] == keys[i].createChildKey(0));
+            }
+            if (i > 0 && keys[i].getLOD() > 1)
+            {
+                REQUIRE((keys[i - 1] == keys[i].createParentKey() || keys[i - 1].getLOD() >= keys[i].getLOD()));
+            }
+        }
+    }
+
+    SECTION("Hash containers")
+    {
+        std::unordered_map<PackedTileKey, int> map;
+        map[TileKey(4, 1, 2, geo.get())] = 1;
+        map[TileKey(4, 1, 2, merc.get())] = 2;
+        map[TileKey(4, 1, 2, geo.get())] = 3;
+        REQUIRE(map.size() == 2u);
+        REQUIRE(map[PackedTileKey(4, 1, 2, geo.get())] == 3);
+    }
+}
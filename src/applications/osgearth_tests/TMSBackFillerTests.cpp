@@ -0,0 +1,129 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/TMSBackFiller>
+#include <osgEarth/FileUtils>
+#include <osgEarth/Notify>
+#include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+using namespace osgEarth;
+using namespace osgEarth::Contrib;
+
+namespace
+{
+    osg::Vec4ub colorOf(unsigned x, unsigned y)
+    {
+        return osg::Vec4ub(40 * (x % 6), 60 * (y % 4), 10 * ((x + y) % 25), 255);
+    }
+
+    // Writes a local TMS tree with solid-color tiles at one level.
+    osg::ref_ptr<TMS::TileMap> createTMS(const std::string& dir, unsigned level, unsigned tileSize)
+    {
+        osg::ref_ptr<const Profile> profile = Profile::create(Profile::GLOBAL_GEODETIC);
+        osg::ref_ptr<TMS::TileMap> tileMap = TMS::TileMap::create(
+            dir + "/tms.xml", profile.get(), DataExtentList(), "png", tileSize, tileSize);
+        makeDirectoryForFile(dir + "/tms.xml");
+        TMS::TileMapReaderWriter::write(tileMap.get(), dir + "/tms.xml");
+
+        unsigned cols, rows;
+        profile->getNumTiles(level, cols, rows);
+        for (unsigned x = 0; x < cols; ++x)
+        {
+            for (unsigned y = 0; y < rows; ++y)
+            {
+                osg::ref_ptr<osg::Image> image = new osg::Image();
+                image->allocateImage(tileSize, tileSize, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+                osg::Vec4ub color = colorOf(x, y);
+                for (unsigned i = 0; i < tileSize * tileSize; ++i)
+                    ::memcpy(image->data() + 4 * i, color.ptr(), 4);
+
+                std::string filename = tileMap->getURL(TileKey(level, x, y, profile.get()), false);
+                makeDirectoryForFile(filename);
+                REQUIRE(osgDB::writeImageFile(*image, filename));
+            }
+        }
+        return tileMap;
+    }
+
+    osg::Vec4ub pixel(const osg::Image* image, unsigned s, unsigned t)
+    {
+        const unsigned char* p = image->data(s, t);
+        return osg::Vec4ub(p[0], p[1], p[2], p[3]);
+    }
+}
+
+TEST_CASE("TMSBackFiller builds each parent from its four children")
+{
+    std::string dir = getTempName(getTempPath(), "_tms");
+    osg::ref_ptr<TMS::TileMap> tileMap = createTMS(dir, 2, 64);
+
+    TMSBackFiller backfiller;
+    backfiller.setMinLevel(0);
+    backfiller.setMaxLevel(2);
+    backfiller.setNumThreads(2);
+    backfiller.process(dir + "/tms.xml", nullptr);
+
+    // 4x2 tiles at level 1 and 2x1 at level 0
+    REQUIRE(backfiller.getNumTilesWritten() == 10);
+
+    osg::ref_ptr<const Profile> profile = tileMap->createProfile();
+
+    SECTION("Quadrants come from the matching children")
+    {
+        // Tile (1,0) at level 1 has children x=2..3, y=0..1 at level 2;
+        // y grows southward, and image row 0 is the southern edge.
+        osg::ref_ptr<osg::Image> image = osgDB::readRefImageFile(tileMap->getURL(TileKey(1, 1, 0, profile.get()), false));
+        REQUIRE(image.valid());
+        REQUIRE(image->s() == 64);
+        REQUIRE(image->t() == 64);
+        REQUIRE(pixel(image.get(), 16, 48) == colorOf(2, 0));
+        REQUIRE(pixel(image.get(), 48, 48) == colorOf(3, 0));
+        REQUIRE(pixel(image.get(), 16, 16) == colorOf(2, 1));
+        REQUIRE(pixel(image.get(), 48, 16) == colorOf(3, 1));
+    }
+
+    SECTION("Levels build on the tiles built below them")
+    {
+        osg::ref_ptr<osg::Image> image = osgDB::readRefImageFile(tileMap->getURL(TileKey(0, 1, 0, profile.get()), false));
+        REQUIRE(image.valid());
+        // north-east corner: child (3,0) at level 1, grandchild (7,0) at level 2
+        REQUIRE(pixel(image.get(), 63, 63) == colorOf(7, 0));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("TMSBackFiller benchmarks", "[.benchmark]")
+{
+    const unsigned level = 5;
+    std::string dir = getTempName(getTempPath(), "_tms");
+    createTMS(dir, level, 256);
+
+    for (unsigned threads : { 1u, std::max(1u, std::thread::hardware_concurrency()) })
+    {
+        TMSBackFiller backfiller;
+        backfiller.setMinLevel(0);
+        backfiller.setMaxLevel(level);
+        backfiller.setNumThreads(threads);
+
+        auto t0 = std::chrono::steady_clock::now();
+        backfiller.process(dir + "/tms.xml", nullptr);
+        auto t1 = std::chrono::steady_clock::now();
+        double s = std::chrono::duration<double>(t1 - t0).count();
+
+        OE_NOTICE << "Backfilled " << backfiller.getNumTilesWritten() << " tiles from level " << level
+            << " with " << threads << " threads in " << s << " s ("
+            << (backfiller.getNumTilesWritten() / s) << " tiles/s)" << std::endl;
+    }
+
+    std::filesystem::remove_all(dir);
+}
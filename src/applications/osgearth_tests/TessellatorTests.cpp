@@ -0,0 +1,456 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/Tessellator>
+#include <osgEarth/Notify>
+#include <osgUtil/Tessellator>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    Ring* makeRing(const std::vector<osg::Vec2d>& points, const osg::Vec2d& offset = osg::Vec2d())
+    {
+        Ring* ring = new Ring();
+        for (auto& p : points)
+            ring->push_back(osg::Vec3d(p.x() + offset.x(), p.y() + offset.y(), 0.0));
+        return ring;
+    }
+
+    Polygon* makePolygon(const std::vector<osg::Vec2d>& shell, const std::vector<std::vector<osg::Vec2d>>& holes = {}, const osg::Vec2d& offset = osg::Vec2d())
+    {
+        Polygon* polygon = new Polygon();
+        for (auto& p : shell)
+            polygon->push_back(osg::Vec3d(p.x() + offset.x(), p.y() + offset.y(), 0.0));
+        for (auto& hole : holes)
+            polygon->getHoles().push_back(makeRing(hole, offset));
+        return polygon;
+    }
+
+    std::vector<osg::Vec2d> circle(const osg::Vec2d& center, double radius, unsigned n, double noise = 0.0, unsigned seed = 0)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> jitter(1.0 - noise, 1.0 + noise);
+        std::vector<osg::Vec2d> points;
+        for (unsigned i = 0; i < n; ++i)
+        {
+            double a = 2.0 * osg::PI * (double)i / (double)n;
+            double r = radius * (noise > 0.0 ? jitter(gen) : 1.0);
+            points.emplace_back(center.x() + r * cos(a), center.y() + r * sin(a));
+        }
+        return points;
+    }
+
+    // Shoelace area, relative to the first point so that large
+    // coordinates do not swamp the result
+    double areaOf(const Geometry* geom)
+    {
+        double area = 0.0;
+        const osg::Vec3d& o = geom->front();
+        for (std::size_t i = 0, j = geom->size() - 1; i < geom->size(); j = i++)
+        {
+            osg::Vec3d a = (*geom)[j] - o, b = (*geom)[i] - o;
+            area += a.x() * b.y() - b.x() * a.y();
+        }
+        return 0.5 * std::fabs(area);
+    }
+
+    // Area of the polygons, less their holes
+    double expectedArea(const Geometry* input)
+    {
+        double area = 0.0;
+        ConstGeometryIterator iter(input, false);
+        while (iter.hasMore())
+        {
+            const Geometry* part = iter.next();
+            area += areaOf(part);
+            if (part->getType() == Geometry::TYPE_POLYGON)
+                for (auto& hole : static_cast<const Polygon*>(part)->getHoles())
+                    area -= areaOf(hole.get());
+        }
+        return area;
+    }
+
+    // Sum of the areas of the triangles
+    template<typename V>
+    double triangleArea(const std::vector<V>& points, const std::vector<uint32_t>& indices)
+    {
+        REQUIRE(indices.size() % 3 == 0);
+        double area = 0.0;
+        const V& o = points.front();
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+        {
+            REQUIRE(indices[i] < points.size());
+            REQUIRE(indices[i + 1] < points.size());
+            REQUIRE(indices[i + 2] < points.size());
+            osg::Vec2d a(points[indices[i]].x() - o.x(), points[indices[i]].y() - o.y());
+            osg::Vec2d b(points[indices[i + 1]].x() - o.x(), points[indices[i + 1]].y() - o.y());
+            osg::Vec2d c(points[indices[i + 2]].x() - o.x(), points[indices[i + 2]].y() - o.y());
+            area += 0.5 * std::fabs((b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x()));
+        }
+        return area;
+    }
+
+    void requireCovers(const Geometry* input)
+    {
+        std::vector<osg::Vec3d> points;
+        ConstGeometryIterator iter(input, true);
+        while (iter.hasMore())
+        {
+            const Geometry* part = iter.next();
+            points.insert(points.end(), part->begin(), part->end());
+        }
+
+        Tessellator tess;
+        std::vector<uint32_t> indices;
+        REQUIRE(tess.tessellate2D(input, indices));
+
+        double expected = expectedArea(input);
+        REQUIRE(triangleArea(points, indices) == Approx(expected).epsilon(1e-6));
+    }
+
+    // Rings of an osg::Geometry as LINE_LOOPs, the way the extruder builds roofs
+    osg::Geometry* makeLoops(const std::vector<std::vector<osg::Vec2d>>& rings, double z = 10.0)
+    {
+        osg::Geometry* geom = new osg::Geometry();
+        osg::Vec3Array* verts = new osg::Vec3Array();
+        geom->setVertexArray(verts);
+        for (auto& ring : rings)
+        {
+            unsigned first = verts->size();
+            for (auto& p : ring)
+                verts->push_back(osg::Vec3(p.x(), p.y(), z));
+            geom->addPrimitiveSet(new osg::DrawArrays(GL_LINE_LOOP, first, ring.size()));
+        }
+        return geom;
+    }
+
+    std::vector<uint32_t> indicesOf(const osg::Geometry* geom)
+    {
+        std::vector<uint32_t> indices;
+        for (unsigned i = 0; i < geom->getNumPrimitiveSets(); ++i)
+        {
+            const osg::PrimitiveSet* pset = geom->getPrimitiveSet(i);
+            REQUIRE(pset->getMode() == GL_TRIANGLES);
+            for (unsigned j = 0; j < pset->getNumIndices(); ++j)
+                indices.push_back(pset->index(j));
+        }
+        return indices;
+    }
+
+    double vec3ArrayArea(const osg::Geometry* geom)
+    {
+        auto verts = static_cast<const osg::Vec3Array*>(geom->getVertexArray());
+        return triangleArea(verts->asVector(), indicesOf(geom));
+    }
+
+    // A building footprint: a rectangle with many small, noisy steps
+    std::vector<osg::Vec2d> footprint(unsigned stepsPerSide, unsigned seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> depth(0.5, 2.0);
+        std::vector<osg::Vec2d> points;
+        const double side = 100.0;
+        const osg::Vec2d corners[4] = { {0, 0}, {side, 0}, {side, side}, {0, side} };
+        const osg::Vec2d inward[4] = { {0, 1}, {-1, 0}, {0, -1}, {1, 0} };
+        for (unsigned c = 0; c < 4; ++c)
+        {
+            osg::Vec2d a = corners[c], b = corners[(c + 1) % 4];
+            osg::Vec2d step = (b - a) / (double)stepsPerSide;
+            for (unsigned i = 0; i < stepsPerSide; ++i)
+            {
+                osg::Vec2d p = a + step * (double)i;
+                double d = (i % 2 == 1) ? depth(gen) : 0.0;
+                points.push_back(p + inward[c] * d);
+                points.push_back(p + step * 0.5 + inward[c] * d);
+            }
+        }
+        return points;
+    }
+}
+
+TEST_CASE("Tessellator covers the polygon area")
+{
+    SECTION("Square")
+    {
+        osg::ref_ptr<Polygon> p = makePolygon({ {0,0}, {10,0}, {10,10}, {0,10} });
+        requireCovers(p.get());
+    }
+
+    SECTION("Concave shapes")
+    {
+        osg::ref_ptr<Polygon> L = makePolygon({ {0,0}, {10,0}, {10,2}, {2,2}, {2,10}, {0,10} });
+        requireCovers(L.get());
+
+        osg::ref_ptr<Polygon> U = makePolygon({ {0,0}, {9,0}, {9,9}, {6,9}, {6,3}, {3,3}, {3,9}, {0,9} });
+        requireCovers(U.get());
+
+        std::vector<osg::Vec2d> comb = { {0,0}, {39,0} };
+        for (int i = 19; i >= 0; --i)
+        {
+            comb.push_back({ i * 2.0 + 1.0, 10.0 });
+            comb.push_back({ i * 2.0, 10.0 });
+            if (i > 0)
+            {
+                comb.push_back({ i * 2.0, 1.0 });
+                comb.push_back({ i * 2.0 - 1.0, 1.0 });
+            }
+        }
+        osg::ref_ptr<Polygon> c = makePolygon(comb);
+        requireCovers(c.get());
+    }
+
+    SECTION("Star")
+    {
+        std::vector<osg::Vec2d> star;
+        for (int i = 0; i < 10; ++i)
+        {
+            double r = (i % 2) ? 3.0 : 10.0;
+            double a = osg::PI * i / 5.0;
+            star.push_back({ r * cos(a), r * sin(a) });
+        }
+        osg::ref_ptr<Polygon> p = makePolygon(star);
+        requireCovers(p.get());
+    }
+
+    SECTION("Spiral")
+    {
+        std::vector<osg::Vec2d> outer, inner;
+        for (int i = 0; i <= 200; ++i)
+        {
+            double a = i * 0.05;
+            outer.push_back({ (2.0 + a) * cos(a), (2.0 + a) * sin(a) });
+            inner.push_back({ (1.0 + a) * cos(a), (1.0 + a) * sin(a) });
+        }
+        outer.insert(outer.end(), inner.rbegin(), inner.rend());
+        osg::ref_ptr<Polygon> p = makePolygon(outer);
+        requireCovers(p.get());
+    }
+
+    SECTION("Holes")
+    {
+        osg::ref_ptr<Polygon> p = makePolygon(
+            { {0,0}, {20,0}, {20,20}, {0,20} },
+            { { {2,2}, {2,8}, {8,8}, {8,2} }, { {12,12}, {12,18}, {18,18}, {18,12} } });
+        requireCovers(p.get());
+    }
+
+    SECTION("Hole touching the shell")
+    {
+        osg::ref_ptr<Polygon> p = makePolygon(
+            { {0,0}, {10,0}, {10,10}, {0,10} },
+            { { {0,5}, {5,8}, {5,2} } });
+        requireCovers(p.get());
+    }
+
+    SECTION("Duplicate and collinear points")
+    {
+        osg::ref_ptr<Polygon> p = makePolygon({ {0,0}, {5,0}, {5,0}, {10,0}, {10,5}, {10,10}, {10,10}, {0,10}, {0,5} });
+        requireCovers(p.get());
+    }
+
+    SECTION("Multipolygon")
+    {
+        osg::ref_ptr<MultiGeometry> m = new MultiGeometry();
+        m->add(makePolygon({ {0,0}, {10,0}, {10,10}, {0,10} }, { { {2,2}, {2,8}, {8,8}, {8,2} } }));
+        m->add(makePolygon({ {20,0}, {30,0}, {25,10} }));
+        m->add(makePolygon({ {40,0}, {50,0}, {50,10}, {40,10} }));
+        requireCovers(m.get());
+    }
+
+    SECTION("Large projected coordinates")
+    {
+        // UTM-scale offsets, where single precision loses the detail
+        osg::Vec2d offset(500000.0, 4649776.0);
+        osg::ref_ptr<Polygon> p = makePolygon(circle(osg::Vec2d(), 25.0, 300, 0.05, 7), { circle(osg::Vec2d(), 5.0, 40) }, offset);
+        requireCovers(p.get());
+    }
+}
+
+TEST_CASE("Tessellator handles degenerate input")
+{
+    Tessellator tess;
+    std::vector<uint32_t> indices;
+
+    SECTION("Collinear points")
+    {
+        osg::ref_ptr<Polygon> p = makePolygon({ {0,0}, {5,0}, {10,0} });
+        REQUIRE(tess.tessellate2D(p.get(), indices));
+        REQUIRE(triangleArea(p->asVector(), indices) == Approx(0.0));
+    }
+
+    SECTION("Too few points")
+    {
+        osg::ref_ptr<Polygon> p = makePolygon({ {0,0}, {5,0} });
+        REQUIRE(tess.tessellate2D(p.get(), indices));
+        REQUIRE(indices.empty());
+    }
+}
+
+TEST_CASE("Tessellator tessellates an osg::Geometry")
+{
+    Tessellator tess;
+
+    SECTION("A ring with a hole, in any winding order")
+    {
+        std::vector<osg::Vec2d> shell = { {0,0}, {10,0}, {10,10}, {0,10} };
+        std::vector<osg::Vec2d> hole = { {2,2}, {8,2}, {8,8}, {2,8} };
+        osg::ref_ptr<osg::Geometry> geom = makeLoops({ shell, hole });
+
+        REQUIRE(tess.tessellateGeometry(*geom));
+        REQUIRE(geom->getNumPrimitiveSets() == 1);
+        REQUIRE(dynamic_cast<osg::DrawElementsUInt*>(geom->getPrimitiveSet(0)) != nullptr);
+        REQUIRE(vec3ArrayArea(geom.get()) == Approx(64.0));
+    }
+
+    SECTION("Separate rings are separate polygons")
+    {
+        osg::ref_ptr<osg::Geometry> geom = makeLoops({
+            { {0,0}, {10,0}, {10,10}, {0,10} },
+            { {20,0}, {30,0}, {30,10}, {20,10} },
+            { {22,2}, {22,8}, {28,8}, {28,2} } });
+
+        REQUIRE(tess.tessellateGeometry(*geom));
+        REQUIRE(vec3ArrayArea(geom.get()) == Approx(100.0 + 64.0));
+    }
+
+    SECTION("Vertical rings use their own plane")
+    {
+        osg::ref_ptr<osg::Geometry> geom = new osg::Geometry();
+        osg::Vec3Array* verts = new osg::Vec3Array();
+        verts->push_back(osg::Vec3(0, 5, 0));
+        verts->push_back(osg::Vec3(10, 5, 0));
+        verts->push_back(osg::Vec3(10, 5, 10));
+        verts->push_back(osg::Vec3(0, 5, 10));
+        geom->setVertexArray(verts);
+        geom->addPrimitiveSet(new osg::DrawArrays(GL_POLYGON, 0, 4));
+
+        REQUIRE(tess.tessellateGeometry(*geom));
+        REQUIRE(indicesOf(geom.get()).size() == 6);
+    }
+
+    SECTION("Nothing to tessellate")
+    {
+        osg::ref_ptr<osg::Geometry> geom = new osg::Geometry();
+        REQUIRE(tess.tessellateGeometry(*geom) == false);
+    }
+}
+
+TEST_CASE("Tessellator handles holes and touching rings")
+{
+    auto square = [](double x0, double y0, double x1, double y1)
+        {
+            return std::vector<osg::Vec2d>{ {x0,y0}, {x0,y1}, {x1,y1}, {x1,y0} };
+        };
+
+    SECTION("Holes that share a vertex")
+    {
+        osg::ref_ptr<Polygon> p = makePolygon(
+            { {0,0}, {20,0}, {20,20}, {0,20} },
+            { square(2, 2, 10, 10), square(10, 10, 18, 18) });
+        requireCovers(p.get());
+        REQUIRE(expectedArea(p.get()) == Approx(272.0));
+    }
+
+    SECTION("Checkerboard of holes touching at their corners")
+    {
+        std::vector<std::vector<osg::Vec2d>> holes;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                if ((i + j) % 2 == 0)
+                    holes.push_back(square(10 + 10 * i, 10 + 10 * j, 20 + 10 * i, 20 + 10 * j));
+        osg::ref_ptr<Polygon> p = makePolygon({ {0,0}, {50,0}, {50,50}, {0,50} }, holes);
+        requireCovers(p.get());
+    }
+
+    SECTION("Polygons that touch at a vertex")
+    {
+        osg::ref_ptr<MultiGeometry> m = new MultiGeometry();
+        m->add(makePolygon({ {0,0}, {10,0}, {10,10}, {0,10} }));
+        m->add(makePolygon({ {10,10}, {20,10}, {20,20}, {10,20} }));
+        requireCovers(m.get());
+    }
+
+    Tessellator tess;
+
+    SECTION("Rings of an osg::Geometry with holes that share a vertex")
+    {
+        osg::ref_ptr<osg::Geometry> geom = makeLoops({
+            { {0,0}, {20,0}, {20,20}, {0,20} },
+            square(2, 2, 10, 10),
+            square(10, 10, 18, 18) });
+
+        REQUIRE(tess.tessellateGeometry(*geom));
+        REQUIRE(vec3ArrayArea(geom.get()) == Approx(400.0 - 64.0 - 64.0));
+    }
+
+    SECTION("A ring inside a hole is a polygon of its own")
+    {
+        osg::ref_ptr<osg::Geometry> geom = makeLoops({
+            { {0,0}, {30,0}, {30,30}, {0,30} },
+            square(5, 5, 25, 25),
+            { {10,10}, {20,10}, {20,20}, {10,20} } });
+
+        REQUIRE(tess.tessellateGeometry(*geom));
+        REQUIRE(vec3ArrayArea(geom.get()) == Approx(900.0 - 400.0 + 100.0));
+    }
+}
+
+TEST_CASE("Tessellator benchmarks", "[.benchmark]")
+{
+    struct Shape
+    {
+        std::string name;
+        std::vector<std::vector<osg::Vec2d>> rings;
+    };
+
+    std::vector<Shape> shapes;
+    shapes.push_back({ "building footprint, 4k points", { footprint(500, 1) } });
+    shapes.push_back({ "land use, 10k points + 20 holes", { circle(osg::Vec2d(), 1000.0, 10000, 0.1, 2) } });
+    for (unsigned i = 0; i < 20; ++i)
+    {
+        double a = 2.0 * osg::PI * i / 20.0;
+        auto hole = circle(osg::Vec2d(500.0 * cos(a), 500.0 * sin(a)), 60.0, 200, 0.1, 3 + i);
+        std::reverse(hole.begin(), hole.end());
+        shapes.back().rings.push_back(hole);
+    }
+    shapes.push_back({ "lake, 50k points", { circle(osg::Vec2d(), 5000.0, 50000, 0.02, 4) } });
+
+    for (auto& shape : shapes)
+    {
+        const int runs = 5;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; ++i)
+        {
+            osg::ref_ptr<osg::Geometry> geom = makeLoops(shape.rings);
+            Tessellator tess;
+            REQUIRE(tess.tessellateGeometry(*geom));
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; ++i)
+        {
+            osg::ref_ptr<osg::Geometry> geom = makeLoops(shape.rings);
+            osgUtil::Tessellator tess;
+            tess.setTessellationType(osgUtil::Tessellator::TESS_TYPE_GEOMETRY);
+            tess.setWindingType(osgUtil::Tessellator::TESS_WINDING_ODD);
+            tess.retessellatePolygons(*geom);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        double oe = std::chrono::duration<double, std::milli>(t1 - t0).count() / runs;
+        double glu = std::chrono::duration<double, std::milli>(t2 - t1).count() / runs;
+
+        OE_NOTICE << "Tessellated " << shape.name << ": " << oe << " ms (GLU "
+            << glu << " ms, " << (glu / oe) << "x)" << std::endl;
+    }
+}
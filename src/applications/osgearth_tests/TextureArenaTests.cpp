@@ -0,0 +1,49 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/TextureArena>
+#include <osg/Texture2D>
+
+using namespace osgEarth;
+
+TEST_CASE("Texture resident image memory")
+{
+    osg::ref_ptr<osg::Image> image = new osg::Image();
+    image->allocateImage(256, 256, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+    const std::size_t imageBytes = image->getTotalSizeInBytesIncludingMipmaps();
+
+    SECTION("Loaded images count")
+    {
+        Texture::Ptr tex = Texture::create(image.get());
+        REQUIRE(tex->getResidentImageBytes() == imageBytes);
+        REQUIRE(Texture::create()->getResidentImageBytes() == 0u);
+    }
+
+    SECTION("Released images do not count")
+    {
+        Texture::Ptr tex = Texture::create(image.get());
+        tex->osgTexture()->setImage(0, nullptr);
+        REQUIRE(tex->getResidentImageBytes() == 0u);
+
+        // what Texture::compileGLObjects does when the image is not kept
+        tex = Texture::create(image.get());
+        tex->osgTexture_mutable() = nullptr;
+        REQUIRE(tex->getResidentImageBytes() == 0u);
+    }
+
+    SECTION("Images released after GPU upload do not count")
+    {
+        Texture::Ptr tex = Texture::create(image.get());
+        tex->keepImage() = false;
+        REQUIRE(tex->getResidentImageBytes() == 0u);
+
+        tex = Texture::create(new osg::Texture2D(image.get()));
+        REQUIRE(tex->getResidentImageBytes() == imageBytes);
+        tex->osgTexture()->setUnRefImageDataAfterApply(true);
+        REQUIRE(tex->getResidentImageBytes() == 0u);
+    }
+}
@@ -0,0 +1,473 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+#include <osgEarth/TDTiles>
+#include <osgEarth/TDTilesTree>
+#include <osgEarth/GeoData>
+#include <osgEarth/FileUtils>
+#include <osgEarth/Notify>
+#include <osgEarth/Threading>
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osgDB/FileNameUtils>
+#include <osgDB/FileUtils>
+#include <osgDB/ReadFile>
+#include <osgDB/WriteFile>
+#include <osgUtil/SceneView>
+#include <osgUtil/UpdateVisitor>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+using namespace osgEarth::Contrib::ThreeDTiles;
+
+namespace
+{
+    // Quadtree tileset over a small region, with one content file per tile.
+    struct SyntheticTileset
+    {
+        std::string path;
+        double west = 0.0, south = 0.0, size = 0.002; // radians
+        unsigned depth = 5;
+        unsigned gridSize = 64;
+        const SpatialReference* srs = SpatialReference::get("wgs84");
+
+        Json::Value tile(unsigned lod, unsigned x, unsigned y, bool writeContent)
+        {
+            double step = size / (double)(1u << lod);
+            double w = west + step * x, s = south + step * y;
+
+            Json::Value region(Json::arrayValue);
+            for (double v : { w, s, w + step, s + step, 0.0, 100.0 })
+                region.append(v);
+
+            Json::Value value;
+            value["boundingVolume"]["region"] = region;
+            value["geometricError"] = lod + 1 < depth ? 256.0 / (double)(1u << lod) : 0.0;
+            value["refine"] = "REPLACE";
+
+            if (writeContent)
+            {
+                std::string name = "tile_" + std::to_string(lod) + "_" + std::to_string(x) + "_" + std::to_string(y) + ".osgb";
+                value["content"]["uri"] = name;
+
+                // a grid of vertices covering the tile, localized at its center
+                GeoPoint center(srs, osg::RadiansToDegrees(w + step / 2), osg::RadiansToDegrees(s + step / 2), 50.0);
+                osg::Matrixd local2world;
+                center.createLocalToWorld(local2world);
+
+                double meters = step * srs->getEllipsoid().getRadiusEquator();
+                osg::Vec3Array* verts = new osg::Vec3Array();
+                osg::DrawElementsUInt* tris = new osg::DrawElementsUInt(GL_TRIANGLES);
+                for (unsigned r = 0; r < gridSize; ++r)
+                {
+                    for (unsigned c = 0; c < gridSize; ++c)
+                    {
+                        verts->push_back(osg::Vec3(
+                            meters * ((double)c / (gridSize - 1) - 0.5),
+                            meters * ((double)r / (gridSize - 1) - 0.5),
+                            0.0f));
+
+                        if (r > 0 && c > 0)
+                        {
+                            unsigned i = r * gridSize + c;
+                            for (unsigned k : { i - gridSize - 1, i - gridSize, i, i - gridSize - 1, i, i - 1 })
+                                tris->push_back(k);
+                        }
+                    }
+                }
+
+                osg::Geometry* geom = new osg::Geometry();
+                geom->setUseVertexBufferObjects(true);
+                geom->setVertexArray(verts);
+                geom->addPrimitiveSet(tris);
+
+                osg::ref_ptr<osg::MatrixTransform> xform = new osg::MatrixTransform(local2world);
+                xform->addChild(geom);
+                if (!osgDB::writeNodeFile(*xform, osgDB::concatPaths(path, name)))
+                    return Json::Value();
+            }
+
+            if (lod + 1 < depth)
+            {
+                for (unsigned q = 0; q < 4; ++q)
+                {
+                    Json::Value child = tile(lod + 1, x * 2 + (q & 1), y * 2 + (q >> 1), writeContent);
+                    if (child.isNull())
+                        return child;
+                    value["children"].append(child);
+                }
+            }
+            return value;
+        }
+
+        Tileset* create(bool writeContent)
+        {
+            Json::Value root = tile(0, 0, 0, writeContent);
+            if (root.isNull())
+                return nullptr;
+
+            Json::Value tileset;
+            tileset["asset"]["version"] = "1.0";
+            tileset["geometricError"] = 512.0;
+            tileset["root"] = root;
+            return Tileset::create(Json::FastWriter().write(tileset), osgDB::concatPaths(path, "tileset.json"));
+        }
+    };
+}
+
+TEST_CASE("ThreeDTiles") {
+
+    SyntheticTileset synthetic;
+    synthetic.depth = 3;
+    synthetic.path = getTempPath();
+
+    osg::ref_ptr<Tileset> tileset = synthetic.create(false);
+    REQUIRE(tileset.valid());
+    REQUIRE(tileset->root().valid());
+
+    // children are created from the parsed tree on demand
+    REQUIRE(tileset->root()->mayHaveChildren());
+    tileset->root()->resolveChildren(nullptr);
+    REQUIRE(tileset->root()->children().size() == 4u);
+    tileset->root()->children()[0]->resolveChildren(nullptr);
+    REQUIRE(tileset->root()->children()[0]->children().size() == 4u);
+
+    osg::ref_ptr<ThreeDTilesetNode> node = new ThreeDTilesetNode(tileset.get(), "", nullptr, nullptr);
+
+    SECTION("Memory budget defaults to unlimited") {
+        REQUIRE(node->getMaxContentBytes() == 0u);
+        REQUIRE(node->getContentBytes() == 0u);
+        REQUIRE(node->getCancelStaleRequests() == true);
+
+        node->setMaxContentBytes(1024u * 1024u);
+        REQUIRE(node->getMaxContentBytes() == 1024u * 1024u);
+    }
+
+    SECTION("Content byte accounting") {
+        node->addContentBytes(1000);
+        node->addContentBytes(-400);
+        REQUIRE(node->getContentBytes() == 600u);
+    }
+
+    SECTION("Children are attached in the update traversal") {
+        osg::ref_ptr<Tileset> deferred = synthetic.create(false);
+        osg::ref_ptr<ThreeDTilesetNode> deferredNode = new ThreeDTilesetNode(deferred.get(), "", nullptr, nullptr);
+        auto content = dynamic_cast<ThreeDTilesetContentNode*>(deferredNode->getChild(0));
+        REQUIRE(content);
+        ThreeDTileNode* root = content->getTileNode();
+        REQUIRE(root->getNumChildren() == 0u);
+
+        // starts building the children without touching the graph
+        REQUIRE(root->isHighestResolution() == false);
+        REQUIRE(root->getNumChildren() == 0u);
+
+        osg::ref_ptr<osg::FrameStamp> frameStamp = new osg::FrameStamp();
+        osgUtil::UpdateVisitor update;
+        update.setFrameStamp(frameStamp.get());
+        for (unsigned frame = 1; frame < 5000 && root->getNumChildren() == 0u; ++frame)
+        {
+            frameStamp->setFrameNumber(frame);
+            deferredNode->accept(update);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        REQUIRE(root->getNumChildren() == 1u);
+        auto children = root->getChild(0)->asGroup();
+        REQUIRE(children);
+        REQUIRE(children->getNumChildren() == 4u);
+    }
+}
+
+TEST_CASE("ThreeDTiles TileTree") {
+
+    SECTION("Matches the JSON document") {
+        SyntheticTileset synthetic;
+        synthetic.depth = 3;
+        Json::Value root = synthetic.tile(0, 0, 0, false);
+        root["transform"] = Json::Value(Json::arrayValue);
+        for (int i = 0; i < 16; ++i)
+            root["transform"].append(i % 5 == 0 ? 1.0 : 0.0);
+        root["children"][1u]["content"]["uri"] = "a \"quoted\" name.b3dm";
+        root["children"][2u]["content"]["uri"] = "a \"quoted\" name.b3dm";
+        root["children"][3u]["refine"] = "ADD";
+
+        Json::Value doc;
+        doc["asset"]["version"] = "1.1";
+        doc["geometricError"] = 512.0;
+        doc["extras"]["ignored"] = Json::Value(Json::arrayValue);
+        doc["extras"]["ignored"].append("}]");
+        doc["root"] = root;
+
+        TileTree::Header header;
+        std::string error;
+        osg::ref_ptr<TileTree> tree = TileTree::parse(Json::StyledWriter().write(doc), header, error);
+        REQUIRE(tree.valid());
+        REQUIRE(header.asset.version().get() == "1.1");
+        REQUIRE(header.geometricError.get() == 512.0);
+        REQUIRE(tree->size() == 21u);
+        REQUIRE(tree->getNumChildren(0) == 4u);
+        REQUIRE(tree->getTransform(0) != nullptr);
+        REQUIRE(tree->getTransform(1) == nullptr);
+
+        TileTree::Index c1 = tree->getChild(0, 1), c2 = tree->getChild(0, 2), c3 = tree->getChild(0, 3);
+        REQUIRE(tree->getNumChildren(c1) == 4u);
+        REQUIRE(std::string(tree->getContentURI(c1)) == "a \"quoted\" name.b3dm");
+        REQUIRE(tree->getContentURI(c1) == tree->getContentURI(c2)); // interned
+        REQUIRE(tree->getRefine(c1) == REFINE_REPLACE);
+        REQUIRE(tree->getRefine(c3) == REFINE_ADD);
+
+        const double* region = tree->getVolume(c3);
+        REQUIRE(tree->getVolumeType(c3) == TileTree::VOLUME_REGION);
+        REQUIRE(region[0] == root["children"][3u]["boundingVolume"]["region"][0u].asDouble());
+        REQUIRE(region[5] == 100.0);
+        REQUIRE(tree->getGeometricError(c3) == 128.0);
+    }
+
+    SECTION("Syntax errors") {
+        TileTree::Header header;
+        std::string error;
+        osg::ref_ptr<TileTree> tree = TileTree::parse("{\"root\": {\"children\": [{}, }", header, error);
+        REQUIRE(!tree.valid());
+        REQUIRE(!error.empty());
+    }
+
+    SECTION("Implicit tiling") {
+        // quadtree with two levels per subtree: the root and its first and last children
+        const std::string json = "{\"tileAvailability\":{\"bitstream\":0},"
+            "\"contentAvailability\":[{\"constant\":1}],\"childSubtreeAvailability\":{\"constant\":0},"
+            "\"buffers\":[{\"byteLength\":8}],\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":1}]}";
+        std::string padded = json + std::string((8 - json.size() % 8) % 8, ' ');
+        std::string subtree = "subt";
+        std::uint32_t version = 1u;
+        std::uint64_t jsonLength = padded.size(), binaryLength = 8u;
+        subtree.append((const char*)&version, 4);
+        subtree.append((const char*)&jsonLength, 8);
+        subtree.append((const char*)&binaryLength, 8);
+        subtree += padded;
+        subtree += std::string("\x13\0\0\0\0\0\0\0", 8);
+
+        ImplicitTiling tiling;
+        tiling.subtreeLevels = 2u;
+        tiling.availableLevels = 2u;
+        REQUIRE(ImplicitSubtree::morton(1, 1, 0, false) == 3u);
+        REQUIRE(ImplicitSubtree::morton(1, 0, 1, true) == 5u);
+        REQUIRE(ImplicitTiling::expand("{level}/{x}/{y}.b3dm", 3, 4, 5, 0) == "3/4/5.b3dm");
+
+        std::string error;
+        osg::ref_ptr<ImplicitSubtree> parsed = ImplicitSubtree::create(subtree, tiling, URIContext(), nullptr, error);
+        REQUIRE(parsed.valid());
+        REQUIRE(parsed->isTileAvailable(0, 0));
+        REQUIRE(parsed->isTileAvailable(1, 0));
+        REQUIRE(!parsed->isTileAvailable(1, 1));
+        REQUIRE(parsed->isTileAvailable(1, 3));
+        REQUIRE(parsed->isContentAvailable(1, 3));
+        REQUIRE(!parsed->isChildSubtreeAvailable(0));
+
+        // a tileset that refers to it
+        std::string path = osgDB::concatPaths(getTempPath(), "osgearth_3dtiles_implicit");
+        makeDirectory(osgDB::concatPaths(path, "subtrees"));
+        std::ofstream(osgDB::concatPaths(path, "subtrees/0.0.0.subtree"), std::ios::binary) << subtree;
+
+        const std::string tilesetJSON = "{\"asset\":{\"version\":\"1.1\"},\"geometricError\":100,\"root\":{"
+            "\"boundingVolume\":{\"region\":[0,0,0.002,0.002,0,100]},\"geometricError\":50,\"refine\":\"REPLACE\","
+            "\"content\":{\"uri\":\"content/{level}/{x}/{y}.b3dm\"},"
+            "\"implicitTiling\":{\"subdivisionScheme\":\"QUADTREE\",\"subtreeLevels\":2,\"availableLevels\":2,"
+            "\"subtrees\":{\"uri\":\"subtrees/{level}.{x}.{y}.subtree\"}}}}";
+
+        osg::ref_ptr<Tileset> tileset = Tileset::create(tilesetJSON, osgDB::concatPaths(path, "tileset.json"));
+        REQUIRE(tileset.valid());
+        REQUIRE(tileset->root().valid());
+        REQUIRE(tileset->root()->content()->uri()->base() == "content/0/0/0.b3dm");
+        REQUIRE(!tileset->root()->resolveChildrenRequiresIO());
+
+        tileset->root()->resolveChildren(nullptr);
+        auto& children = tileset->root()->children();
+        REQUIRE(children.size() == 2u);
+        REQUIRE(children[1]->content()->uri()->base() == "content/1/1/1.b3dm");
+        REQUIRE(children[1]->geometricError().get() == 25.0);
+        REQUIRE(children[1]->boundingVolume()->region()->xMin() == 0.001);
+        REQUIRE(!children[1]->mayHaveChildren());
+    }
+}
+
+TEST_CASE("ThreeDTiles benchmarks", "[.benchmark]") {
+
+    using clock = std::chrono::steady_clock;
+    const auto ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count(); };
+
+    SyntheticTileset synthetic;
+    synthetic.path = osgDB::concatPaths(getTempPath(), "osgearth_3dtiles_benchmark");
+    makeDirectory(synthetic.path);
+
+    osg::ref_ptr<Tileset> tileset = synthetic.create(true);
+    if (!tileset.valid())
+    {
+        WARN("Unable to write the synthetic tileset to " << synthetic.path);
+        return;
+    }
+
+    auto pool = jobs::get_pool("oe.3dtiles");
+    pool->set_concurrency(2);
+
+    struct Mode {
+        const char* name;
+        bool cancel;
+        std::size_t budget;
+    };
+
+    for (auto& mode : { Mode{ "unbounded", false, 0u }, Mode{ "cancel+budget", true, 8u * 1024u * 1024u } })
+    {
+        osg::ref_ptr<ThreeDTilesetNode> node = new ThreeDTilesetNode(tileset.get(), "", nullptr, nullptr);
+        node->setCancelStaleRequests(mode.cancel);
+        node->setMaxContentBytes(mode.budget);
+        node->setMaxTiles(~0u);
+
+        // headless cull; no graphics context is needed to select tiles
+        osg::ref_ptr<osgUtil::SceneView> view = new osgUtil::SceneView();
+        view->setDefaults();
+        view->setSceneData(node.get());
+        view->setViewport(0, 0, 1920, 1080);
+        view->setProjectionMatrixAsPerspective(45.0, 1920.0 / 1080.0, 1.0, 1e6);
+        osg::ref_ptr<osg::FrameStamp> frameStamp = new osg::FrameStamp();
+        view->setFrameStamp(frameStamp.get());
+
+        // fly west to east across the tileset, low and looking ahead
+        const double lat = osg::RadiansToDegrees(synthetic.south + synthetic.size * 0.5);
+        const double lon0 = osg::RadiansToDegrees(synthetic.west);
+        const double lon1 = osg::RadiansToDegrees(synthetic.west + synthetic.size);
+        const unsigned frames = 600u;
+
+        std::size_t peakBytes = 0u;
+        auto start = clock::now();
+
+        for (unsigned f = 0; f <= frames; ++f)
+        {
+            double lon = lon0 + (lon1 - lon0) * (double)f / (double)frames;
+            osg::Vec3d eye, target, up;
+            GeoPoint(synthetic.srs, lon, lat, 300.0).toWorld(eye);
+            GeoPoint(synthetic.srs, lon + 0.01, lat, 0.0).toWorld(target);
+            up = eye;
+            up.normalize();
+
+            frameStamp->setFrameNumber(f + 1);
+            frameStamp->setReferenceTime(ms(clock::now() - start) * 0.001);
+            view->setViewMatrixAsLookAt(eye, target, up);
+            view->update();
+            view->cull();
+
+            peakBytes = std::max(peakBytes, node->getContentBytes());
+
+            // pace the flight at 60 frames per second
+            std::this_thread::sleep_until(start + std::chrono::microseconds(16667 * (f + 1)));
+        }
+
+        double flight_ms = ms(clock::now() - start);
+        unsigned backlog = pool->metrics()->pending + pool->metrics()->running;
+
+        // time for the loader to drain once the camera stops
+        auto stop = clock::now();
+        while (pool->metrics()->pending + pool->metrics()->running > 0u)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        double drain_ms = ms(clock::now() - stop);
+
+        OE_NOTICE << "3D Tiles flight (" << mode.name << "): " << flight_ms << " ms, peak content = "
+            << peakBytes / 1048576.0 << " MB, final content = " << node->getContentBytes() / 1048576.0
+            << " MB, canceled requests = " << node->getNumCanceledRequests()
+            << ", backlog at end = " << backlog << " jobs, drain = " << drain_ms << " ms" << std::endl;
+
+        REQUIRE(peakBytes > 0u);
+    }
+}
+
+TEST_CASE("glTF decoding benchmarks", "[.benchmark]") {
+
+    using clock = std::chrono::steady_clock;
+    const auto ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count(); };
+
+    // A folder of .glb/.gltf/.b3dm samples, e.g. the same assets with and
+    // without EXT_meshopt_compression, KHR_draco_mesh_compression or KTX2 textures
+    const char* samples = ::getenv("OSGEARTH_GLTF_SAMPLES");
+    if (!samples)
+    {
+        WARN("Set OSGEARTH_GLTF_SAMPLES to a folder of glTF assets to run this benchmark");
+        return;
+    }
+
+    struct SizeVisitor : public osg::NodeVisitor
+    {
+        std::size_t bytes = 0u;
+        SizeVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) { }
+        void apply(osg::Drawable& drawable) override
+        {
+            osg::Geometry* geom = drawable.asGeometry();
+            if (geom)
+            {
+                for (auto& array : geom->getVertexAttribArrayList())
+                    if (array.valid()) bytes += array->getTotalDataSize();
+                for (auto array : { geom->getVertexArray(), geom->getNormalArray(), geom->getColorArray() })
+                    if (array) bytes += array->getTotalDataSize();
+                for (auto& array : geom->getTexCoordArrayList())
+                    if (array.valid()) bytes += array->getTotalDataSize();
+                for (auto& prim : geom->getPrimitiveSetList())
+                    if (prim->getDrawElements()) bytes += prim->getDrawElements()->getTotalDataSize();
+            }
+            if (drawable.getStateSet())
+                addTextures(*drawable.getStateSet());
+        }
+        void addTextures(osg::StateSet& stateSet)
+        {
+            for (unsigned unit = 0; unit < stateSet.getNumTextureAttributeLists(); ++unit)
+            {
+                osg::Texture* tex = dynamic_cast<osg::Texture*>(stateSet.getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+                if (tex && tex->getImage(0))
+                    bytes += tex->getImage(0)->getTotalSizeInBytesIncludingMipmaps();
+            }
+        }
+    };
+
+    std::size_t totalRead = 0u, totalDecoded = 0u;
+    double total_ms = 0.0;
+
+    for (auto& name : osgDB::getDirectoryContents(samples))
+    {
+        std::string ext = osgDB::getLowerCaseFileExtension(name);
+        if (ext != "glb" && ext != "gltf" && ext != "b3dm")
+            continue;
+
+        std::string path = osgDB::concatPaths(samples, name);
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        std::size_t bytesRead = (std::size_t)in.tellg();
+
+        auto start = clock::now();
+        osg::ref_ptr<osg::Node> node = osgDB::readRefNodeFile(path);
+        double t = ms(clock::now() - start);
+
+        if (!node.valid())
+        {
+            WARN("Failed to read " << path);
+            continue;
+        }
+
+        SizeVisitor sizes;
+        node->accept(sizes);
+
+        OE_NOTICE << name << ": read " << bytesRead / 1024.0 << " KB, decoded " << sizes.bytes / 1024.0
+            << " KB (" << (double)sizes.bytes / (double)std::max(bytesRead, (std::size_t)1u) << "x) in "
+            << t << " ms, " << (sizes.bytes / 1048576.0) / (t * 0.001) << " MB/s" << std::endl;
+
+        totalRead += bytesRead;
+        totalDecoded += sizes.bytes;
+        total_ms += t;
+    }
+
+    OE_NOTICE << "glTF total: read " << totalRead / 1048576.0 << " MB, decoded "
+        << totalDecoded / 1048576.0 << " MB in " << total_ms << " ms" << std::endl;
+}
@@ -0,0 +1,147 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/TileMesher>
+#include <osgEarth/weemesh.h>
+#include <algorithm>
+#include <array>
+
+using namespace osgEarth;
+
+namespace
+{
+    // A 17x17 grid cut by a few diagonal segments
+    void buildConstrainedGrid(weemesh::mesh_t& mesh, double offset)
+    {
+        const int n = 17;
+        for (int row = 0; row < n; ++row)
+        {
+            for (int col = 0; col < n; ++col)
+            {
+                int i = mesh.get_or_create_vertex(weemesh::vert_t(col, row, 0.0), VERTEX_VISIBLE);
+                if (row > 0 && col > 0)
+                {
+                    mesh.add_triangle(i, i - 1, i - n - 1);
+                    mesh.add_triangle(i, i - n - 1, i - n);
+                }
+            }
+        }
+        for (int s = 0; s < 8; ++s)
+        {
+            weemesh::vert_t p0(offset + s * 1.7, 0.3 + s * 0.9, 0.0), p1(offset + 2.1 + s, 5.7 + s * 1.1, 0.0);
+            mesh.insert(weemesh::segment_t(p0, p1), VERTEX_VISIBLE | VERTEX_CONSTRAINT);
+        }
+    }
+
+    std::vector<std::array<unsigned, 3>> triangleList(const weemesh::mesh_t& mesh)
+    {
+        std::vector<std::array<unsigned, 3>> out;
+        for (auto& tri : mesh.triangles)
+            out.push_back({ tri.second.i0, tri.second.i1, tri.second.i2 });
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+    // Polygon covering the middle of a tile
+    MeshConstraint centerConstraint(const TileKey& key, bool removeInterior, bool removeExterior)
+    {
+        const GeoExtent& e = key.getExtent();
+        auto* polygon = new Polygon();
+        polygon->push_back(e.xMin() + e.width() * 0.25, e.yMin() + e.height() * 0.25, 0.0);
+        polygon->push_back(e.xMin() + e.width() * 0.75, e.yMin() + e.height() * 0.3, 0.0);
+        polygon->push_back(e.xMin() + e.width() * 0.7, e.yMin() + e.height() * 0.75, 0.0);
+        polygon->push_back(e.xMin() + e.width() * 0.3, e.yMin() + e.height() * 0.7, 0.0);
+
+        MeshConstraint constraint;
+        constraint.features.push_back(new Feature(polygon, e.getSRS()));
+        constraint.removeInterior = removeInterior;
+        constraint.removeExterior = removeExterior;
+        return constraint;
+    }
+}
+
+TEST_CASE("weemesh")
+{
+    SECTION("A cleared mesh rebuilds the same triangles as a new one")
+    {
+        weemesh::mesh_t fresh;
+        buildConstrainedGrid(fresh, 0.5);
+
+        weemesh::mesh_t reused;
+        buildConstrainedGrid(reused, 3.25);
+        reused.clear();
+        REQUIRE(reused.triangles.empty());
+        REQUIRE(reused.verts.empty());
+        buildConstrainedGrid(reused, 0.5);
+
+        REQUIRE(fresh.triangles.size() > 2u * 16u * 16u);
+        REQUIRE(reused.verts.size() == fresh.verts.size());
+        REQUIRE(triangleList(reused) == triangleList(fresh));
+
+        reused.release();
+        REQUIRE(reused.triangles.empty());
+        REQUIRE(reused.verts.capacity() == 0u);
+        buildConstrainedGrid(reused, 0.5);
+        REQUIRE(triangleList(reused) == triangleList(fresh));
+    }
+
+    SECTION("Triangle table")
+    {
+        weemesh::mesh_t mesh;
+        for (int i = 0; i < 4; ++i)
+            mesh.get_or_create_vertex(weemesh::vert_t(i & 1, i >> 1, 0.0), VERTEX_VISIBLE);
+        REQUIRE(mesh.get_or_create_vertex(weemesh::vert_t(1.0, 1.0, 5.0), VERTEX_BOUNDARY) == 3);
+        REQUIRE(mesh.markers[3] == (VERTEX_VISIBLE | VERTEX_BOUNDARY));
+
+        weemesh::UID a = mesh.add_triangle(0, 1, 3);
+        weemesh::UID b = mesh.add_triangle(0, 3, 2);
+        REQUIRE(mesh.add_triangle(0, 0, 2) == weemesh::INVALID_UID);
+
+        weemesh::triangle_t* first = &mesh.triangles[a];
+        for (int i = 0; i < 5000; ++i)
+            mesh.add_triangle(0, 1, 2);
+        REQUIRE(first == &mesh.triangles[a]); // references are stable
+
+        mesh.remove_triangle(mesh.triangles[a]);
+        REQUIRE(mesh.triangles.count(a) == 0);
+        REQUIRE(mesh.triangles.size() == 5001u);
+        REQUIRE(mesh.triangles.begin()->first == b);
+    }
+}
+
+TEST_CASE("TileMesher constraints")
+{
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::GLOBAL_GEODETIC);
+    TileKey key = profile->createTileKey(-71.06, 42.36, 12);
+    TileMesher mesher;
+
+    TileMesh standard = mesher.createMesh(key, {}, nullptr);
+    REQUIRE(standard.hasConstraints == false);
+
+    SECTION("Removing the interior of a polygon")
+    {
+        TileMesh first = mesher.createMesh(key, { centerConstraint(key, true, false) }, nullptr);
+        REQUIRE(first.hasConstraints);
+        REQUIRE(first.indices->getNumIndices() > 0u);
+
+        // a pooled scratch mesh must not leak state between tiles
+        mesher.createMesh(key.createChildKey(3), { centerConstraint(key.createChildKey(3), false, true) }, nullptr);
+
+        TileMesh second = mesher.createMesh(key, { centerConstraint(key, true, false) }, nullptr);
+        REQUIRE(second.verts->size() == first.verts->size());
+        REQUIRE(second.indices->getNumIndices() == first.indices->getNumIndices());
+        for (unsigned i = 0; i < first.indices->getNumIndices(); ++i)
+            REQUIRE(second.indices->index(i) == first.indices->index(i));
+    }
+
+    SECTION("Removing both sides leaves nothing")
+    {
+        TileMesh empty = mesher.createMesh(key, { centerConstraint(key, true, true) }, nullptr);
+        REQUIRE(empty.hasConstraints);
+        REQUIRE(empty.verts.valid() == false);
+    }
+}
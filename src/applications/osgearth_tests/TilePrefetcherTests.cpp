@@ -0,0 +1,127 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/TilePrefetcher>
+#include <osgEarth/ImageLayer>
+#include <osgEarth/Map>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace osgEarth;
+
+namespace
+{
+    // An image layer that counts its reads and can hold them until released.
+    class CountingImageLayer : public ImageLayer
+    {
+    public:
+        META_Layer(osgEarth, CountingImageLayer, ImageLayer::Options, ImageLayer, counting_image);
+
+        mutable std::atomic_uint reads = { 0u };
+        std::atomic_bool hold = { false };
+
+    protected:
+        Status openImplementation() override
+        {
+            Status parent = ImageLayer::openImplementation();
+            if (parent.isError())
+                return parent;
+
+            setProfile(Profile::create(Profile::GLOBAL_GEODETIC));
+            return Status::NoError;
+        }
+
+        GeoImage createImageImplementation(const TileKey& key, ProgressCallback* progress) const override
+        {
+            ++reads;
+            while (hold)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            osg::ref_ptr<osg::Image> image = new osg::Image();
+            image->allocateImage(8, 8, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+            return GeoImage(image.get(), key.getExtent());
+        }
+    };
+
+    std::vector<TilePrefetcher::Request> requestsAtLOD(const Profile* profile, unsigned lod)
+    {
+        std::vector<TileKey> keys;
+        profile->getAllKeysAtLOD(lod, keys);
+
+        std::vector<TilePrefetcher::Request> requests;
+        for (unsigned i = 0; i < keys.size(); ++i)
+            requests.push_back(TilePrefetcher::Request{ keys[i], (double)i });
+        return requests;
+    }
+}
+
+TEST_CASE("TilePrefetcher")
+{
+    osg::ref_ptr<Map> map = new Map();
+    osg::ref_ptr<CountingImageLayer> layer = new CountingImageLayer();
+    layer->layerHints().L2CacheSize() = 0u; // count every read
+    map->addLayer(layer.get());
+    REQUIRE(layer->isOpen());
+
+    // lod 1 of the geodetic profile has 8 tiles
+    auto requests = requestsAtLOD(map->getProfile(), 1);
+    REQUIRE(requests.size() == 8u);
+
+    TilePrefetcher prefetcher(map.get());
+    prefetcher.setJobPoolName("oe.prefetch.test");
+    jobs::get_pool("oe.prefetch.test")->set_concurrency(1);
+
+    SECTION("Loads each requested key once")
+    {
+        REQUIRE(prefetcher.prefetch(requests) == 8u);
+        REQUIRE(prefetcher.prefetch(requests) == 0u);
+        prefetcher.join();
+
+        REQUIRE(prefetcher.getNumPending() == 0u);
+        REQUIRE(prefetcher.getNumRequested() == 8u);
+        REQUIRE(layer->reads == 8u);
+    }
+
+    SECTION("Cancel abandons queued jobs")
+    {
+        layer->hold = true;
+        REQUIRE(prefetcher.prefetch(requests) == 8u);
+
+        // wait for the single worker to pick up the first job
+        while (layer->reads == 0u)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        prefetcher.cancel();
+        REQUIRE(prefetcher.getNumRequested() == 0u);
+
+        layer->hold = false;
+        prefetcher.join();
+        REQUIRE(layer->reads == 1u);
+        REQUIRE(prefetcher.getNumPending() == 0u);
+
+        // cancelled keys can be requested again
+        REQUIRE(prefetcher.prefetch(requests) == 8u);
+        prefetcher.join();
+        REQUIRE(layer->reads == 9u);
+    }
+
+    SECTION("Remembers a bounded number of keys")
+    {
+        prefetcher.setMaxRequestedKeys(4u);
+        REQUIRE(prefetcher.prefetch(requests) == 8u);
+        REQUIRE(prefetcher.getNumRequested() == 4u);
+
+        // the oldest requests were forgotten, the newest were not
+        std::vector<TilePrefetcher::Request> first(requests.begin(), requests.begin() + 4);
+        std::vector<TilePrefetcher::Request> last(requests.begin() + 4, requests.end());
+        REQUIRE(prefetcher.prefetch(last) == 0u);
+        REQUIRE(prefetcher.prefetch(first) == 4u);
+        REQUIRE(prefetcher.getNumRequested() == 4u);
+        prefetcher.join();
+    }
+}
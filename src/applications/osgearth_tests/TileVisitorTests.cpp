@@ -0,0 +1,311 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/TileVisitor>
+#include <osgEarth/GDAL>
+#include <osgEarth/FileUtils>
+#include <osgEarth/Notify>
+#include <osgEarth/Progress>
+#include <osgDB/FileUtils>
+#include <osgDB/Registry>
+#include <gdal.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+namespace
+{
+    // Staged handler that records what each stage sees
+    struct CountingHandler : public TileHandler
+    {
+        std::atomic_uint reads = { 0u }, processed = { 0u }, encoded = { 0u };
+        Threading::Mutexed<std::multiset<TileKey>> written;
+
+        bool isStaged() const override { return true; }
+
+        TileData readTile(const TileKey& key, const TileVisitor& tv) override
+        {
+            ++reads;
+            // pretend every third tile has no data
+            if ((key.getTileX() + key.getTileY()) % 3 == 0)
+                return {};
+            return new osg::Referenced();
+        }
+
+        TileData processTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+        {
+            ++processed;
+            return data;
+        }
+
+        TileData encodeTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+        {
+            ++encoded;
+            return data;
+        }
+
+        bool writeTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+        {
+            std::lock_guard<std::mutex> lock(written.mutex());
+            written.insert(key);
+            return true;
+        }
+    };
+
+    // Handler that lists the keys it handles, in order
+    struct ListingHandler : public TileHandler
+    {
+        std::vector<TileKey> keys;
+
+        bool handleTile(const TileKey& key, const TileVisitor& tv) override
+        {
+            keys.push_back(key);
+            return true;
+        }
+    };
+
+    // Listing handler that cancels the run on its Nth tile
+    struct CancelingHandler : public ListingHandler
+    {
+        unsigned cancelAt = 0u;
+
+        bool handleTile(const TileKey& key, const TileVisitor& tv) override
+        {
+            ListingHandler::handleTile(key, tv);
+            if (keys.size() == cancelAt)
+                tv.getProgressCallback()->cancel();
+            return true;
+        }
+    };
+
+    std::set<TileKey> expectedKeys(const Profile* profile, unsigned maxLevel)
+    {
+        std::set<TileKey> keys;
+        for (unsigned lod = 0; lod <= maxLevel; ++lod)
+        {
+            unsigned cols, rows;
+            profile->getNumTiles(lod, cols, rows);
+            for (unsigned x = 0; x < cols; ++x)
+                for (unsigned y = 0; y < rows; ++y)
+                    keys.insert(TileKey(lod, x, y, profile));
+        }
+        return keys;
+    }
+}
+
+TEST_CASE("MultithreadedTileVisitor pipelines staged handlers")
+{
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::GLOBAL_GEODETIC);
+    std::set<TileKey> expected = expectedKeys(profile.get(), 4);
+
+    osg::ref_ptr<CountingHandler> handler = new CountingHandler();
+    osg::ref_ptr<MultithreadedTileVisitor> visitor = new MultithreadedTileVisitor(handler.get());
+    visitor->setMaxLevel(4);
+    visitor->setNumThreads(4);
+    visitor->setNumStageThreads(TileHandler::STAGE_WRITE, 1);
+    visitor->setQueueSize(2); // tiny queues, so stages block on each other
+    visitor->addExtentToVisit(profile->getExtent());
+    visitor->run(profile.get());
+
+    SECTION("Every tile is read once")
+    {
+        REQUIRE(handler->reads.load() == expected.size());
+    }
+
+    SECTION("Only tiles with data go through the later stages, once each")
+    {
+        unsigned withData = 0;
+        for (auto& key : expected)
+            if ((key.getTileX() + key.getTileY()) % 3 != 0)
+                ++withData;
+
+        REQUIRE(handler->processed.load() == withData);
+        REQUIRE(handler->encoded.load() == withData);
+        REQUIRE(handler->written.size() == withData);
+        for (auto& key : handler->written)
+            REQUIRE(handler->written.count(key) == 1);
+    }
+}
+
+TEST_CASE("TileVisitor resumes from a checkpoint")
+{
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::GLOBAL_GEODETIC);
+    std::string checkpoint = getTempName(getTempPath(), ".checkpoint");
+
+    // an earlier run finished the root tiles and the first level-1 tile
+    {
+        std::ofstream out(checkpoint.c_str());
+        out << "0, 0, 0, 1\n" << "0, 1, 0, 1\n" << "1, 0, 0, 1\n";
+    }
+
+    osg::ref_ptr<ListingHandler> handler = new ListingHandler();
+    osg::ref_ptr<TileVisitor> visitor = new TileVisitor(handler.get());
+    visitor->setMaxLevel(2);
+    visitor->setCheckpointFile(checkpoint);
+    visitor->addExtentToVisit(profile->getExtent());
+    visitor->run(profile.get());
+
+    std::set<TileKey> handled(handler->keys.begin(), handler->keys.end());
+    std::set<TileKey> expected = expectedKeys(profile.get(), 2);
+
+    REQUIRE(handled.size() == expected.size() - 3);
+    REQUIRE(handled.count(TileKey(0, 0, 0, profile.get())) == 0);
+    REQUIRE(handled.count(TileKey(1, 0, 0, profile.get())) == 0);
+    // children of finished tiles are still visited
+    REQUIRE(handled.count(TileKey(2, 0, 0, profile.get())) == 1);
+
+    // a completed run removes its checkpoint
+    REQUIRE(osgDB::fileExists(checkpoint) == false);
+}
+
+TEST_CASE("TileVisitor resumes a canceled run from its checkpoint")
+{
+    osg::ref_ptr<const Profile> profile = Profile::create(Profile::GLOBAL_GEODETIC);
+    std::string checkpoint = getTempName(getTempPath(), ".checkpoint");
+    std::set<TileKey> expected = expectedKeys(profile.get(), 3);
+
+    // the first run is canceled while handling its 20th tile
+    osg::ref_ptr<CancelingHandler> first = new CancelingHandler();
+    first->cancelAt = 20u;
+    {
+        osg::ref_ptr<TileVisitor> visitor = new TileVisitor(first.get());
+        visitor->setMaxLevel(3);
+        visitor->setCheckpointFile(checkpoint);
+        visitor->setProgressCallback(new ProgressCallback());
+        visitor->addExtentToVisit(profile->getExtent());
+        visitor->run(profile.get());
+    }
+
+    REQUIRE(first->keys.size() == 20u);
+
+    // a canceled run keeps its checkpoint
+    REQUIRE(osgDB::fileExists(checkpoint) == true);
+
+    osg::ref_ptr<ListingHandler> second = new ListingHandler();
+    {
+        osg::ref_ptr<TileVisitor> visitor = new TileVisitor(second.get());
+        visitor->setMaxLevel(3);
+        visitor->setCheckpointFile(checkpoint);
+        visitor->addExtentToVisit(profile->getExtent());
+        visitor->run(profile.get());
+    }
+
+    std::set<TileKey> handled(second->keys.begin(), second->keys.end());
+    REQUIRE(handled.size() == second->keys.size());
+
+    // tiles finished before the cancel are not handled again...
+    for (unsigned i = 0; i < 19u; ++i)
+        REQUIRE(handled.count(first->keys[i]) == 0);
+
+    // ...but the one canceled mid-way is, along with everything left
+    REQUIRE(handled.count(first->keys[19]) == 1);
+    REQUIRE(handled.size() == expected.size() - 19u);
+
+    REQUIRE(osgDB::fileExists(checkpoint) == false);
+}
+
+TEST_CASE("MultithreadedTileVisitor throughput", "[.benchmark]")
+{
+    // A local 4096x2048 GeoTIFF, converted to PNG tiles down to level 5
+    // with a staged read/encode/write handler.
+    GDALAllRegister();
+    std::string dir = getTempName(getTempPath(), "_mttv");
+    std::string tif = dir + "/source.tif";
+    makeDirectoryForFile(tif);
+    {
+        const int w = 4096, h = 2048;
+        GDALDatasetH ds = GDALCreate(GDALGetDriverByName("GTiff"), tif.c_str(), w, h, 3, GDT_Byte, nullptr);
+        double xform[6] = { -180.0, 360.0 / w, 0.0, 90.0, 0.0, -180.0 / h };
+        GDALSetGeoTransform(ds, xform);
+        GDALSetProjection(ds, SpatialReference::get("wgs84")->getWKT().c_str());
+        std::vector<unsigned char> row(w);
+        for (int b = 1; b <= 3; ++b)
+        {
+            for (int r = 0; r < h; ++r)
+            {
+                for (int c = 0; c < w; ++c)
+                    row[c] = (unsigned char)((c * b + r) & 0xff);
+                GDALRasterIO(GDALGetRasterBand(ds, b), GF_Write, 0, r, w, 1, row.data(), w, 1, GDT_Byte, 0, 0);
+            }
+        }
+        GDALClose(ds);
+    }
+
+    osg::ref_ptr<GDALImageLayer> source = new GDALImageLayer();
+    source->setURL(tif);
+    REQUIRE(source->open().isOK());
+
+    struct Convert : public TileHandler
+    {
+        osg::ref_ptr<ImageLayer> source;
+        osgDB::ReaderWriter* png = osgDB::Registry::instance()->getReaderWriterForExtension("png");
+        std::string dir;
+        std::atomic_uint count = { 0u };
+
+        bool isStaged() const override { return true; }
+
+        TileData readTile(const TileKey& key, const TileVisitor& tv) override
+        {
+            GeoImage image = source->createImage(key);
+            return image.valid() ? image.getImage() : nullptr;
+        }
+
+        TileData encodeTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+        {
+            std::stringstream buf;
+            png->writeImage(*static_cast<const osg::Image*>(data), buf);
+            osg::ref_ptr<osg::Image> encoded = new osg::Image();
+            std::string bytes = buf.str();
+            encoded->allocateImage(bytes.size(), 1, 1, GL_LUMINANCE, GL_UNSIGNED_BYTE);
+            ::memcpy(encoded->data(), bytes.data(), bytes.size());
+            return encoded;
+        }
+
+        bool writeTile(const TileKey& key, const osg::Referenced* data, const TileVisitor& tv) override
+        {
+            const osg::Image* encoded = static_cast<const osg::Image*>(data);
+            std::string filename = dir + "/" + std::to_string(key.getLevelOfDetail()) + "_" +
+                std::to_string(key.getTileX()) + "_" + std::to_string(key.getTileY()) + ".png";
+            std::ofstream out(filename.c_str(), std::ios::binary);
+            out.write((const char*)encoded->data(), encoded->s());
+            ++count;
+            return true;
+        }
+    };
+
+    for (unsigned threads : { 1u, 2u, 4u, 8u, 16u, 32u, 64u })
+    {
+        std::string out = dir + "/" + std::to_string(threads);
+        std::filesystem::create_directories(out);
+
+        osg::ref_ptr<Convert> handler = new Convert();
+        handler->source = source;
+        handler->dir = out;
+
+        osg::ref_ptr<MultithreadedTileVisitor> visitor = new MultithreadedTileVisitor(handler.get());
+        visitor->setNumThreads(threads);
+        visitor->setMaxLevel(5);
+        visitor->addExtentToVisit(source->getProfile()->getExtent());
+
+        auto t0 = std::chrono::steady_clock::now();
+        visitor->run(source->getProfile());
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        OE_NOTICE << "Converted " << handler->count.load() << " tiles with " << threads << " threads per stage in "
+            << s << " s (" << (handler->count.load() / s) << " tiles/s)" << std::endl;
+    }
+
+    source->close();
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,144 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/catch.hpp>
+
+#include <osgEarth/Map>
+#include <osgEarth/FileUtils>
+#include <osgEarthProcedural/BiomeLayer>
+#include <osgEarthProcedural/VegetationLayer>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osgDB/WriteFile>
+#include <filesystem>
+
+using namespace osgEarth;
+using namespace osgEarth::Procedural;
+
+namespace
+{
+    // Writes a small upright quad to use as a tree model.
+    std::string writeTreeModel(const std::string& dir)
+    {
+        osg::Geometry* geom = new osg::Geometry();
+        osg::Vec3Array* verts = new osg::Vec3Array();
+        verts->push_back(osg::Vec3(-2, 0, 0));
+        verts->push_back(osg::Vec3(2, 0, 0));
+        verts->push_back(osg::Vec3(2, 0, 8));
+        verts->push_back(osg::Vec3(-2, 0, 8));
+        geom->setVertexArray(verts);
+        osg::Vec3Array* normals = new osg::Vec3Array(osg::Array::BIND_OVERALL);
+        normals->push_back(osg::Vec3(0, -1, 0));
+        geom->setNormalArray(normals);
+        GLubyte indices[6] = { 0, 1, 2, 0, 2, 3 };
+        geom->addPrimitiveSet(new osg::DrawElementsUByte(GL_TRIANGLES, 6, indices));
+
+        osg::ref_ptr<osg::Geode> geode = new osg::Geode();
+        geode->addDrawable(geom);
+
+        std::string filename = dir + "/tree.osgt";
+        makeDirectoryForFile(filename);
+        REQUIRE(osgDB::writeNodeFile(*geode, filename));
+        return filename;
+    }
+
+    // One biome with one tree asset in the "trees" group.
+    std::shared_ptr<BiomeCatalog> createCatalog(const std::string& modelFile)
+    {
+        Config asset("asset");
+        asset.set("name", "tree");
+        asset.set("url", modelFile);
+        Config group("group");
+        group.set("name", "trees");
+        group.add(asset);
+        Config models("models");
+        models.add(group);
+        Config assetCatalog("assetcatalog");
+        assetCatalog.add(models);
+
+        Config assetRef("asset");
+        assetRef.set("name", "tree");
+        Config assets("assets");
+        assets.add(assetRef);
+        Config biome("biome");
+        biome.set("id", "forest");
+        biome.set("name", "forest");
+        biome.add(assets);
+        Config biomes("biomes");
+        biomes.add(biome);
+
+        Config conf("biomecatalog");
+        conf.add(assetCatalog);
+        conf.add(biomes);
+        return std::make_shared<BiomeCatalog>(conf);
+    }
+}
+
+TEST_CASE("VegetationLayer places assets the same in parallel and serially")
+{
+    std::string dir = getTempName(getTempPath(), "_vegetation");
+    std::string modelFile = writeTreeModel(dir);
+
+    osg::ref_ptr<BiomeLayer> biomes = new BiomeLayer();
+    biomes->options().biomeCatalog() = createCatalog(modelFile);
+    biomes->setAutoBiomeManagement(false);
+
+    // No placement cache, so every call below places the tile anew;
+    // and some overlap, so the collision test depends on placement order.
+    osg::ref_ptr<VegetationLayer> veg = new VegetationLayer();
+    veg->options().placementCacheSize() = 0u;
+    veg->options().group("trees").overlap() = 0.5f;
+    veg->setBiomeLayer(biomes.get());
+
+    osg::ref_ptr<Map> map = new Map();
+    map->addLayer(biomes.get());
+    map->addLayer(veg.get());
+
+    // Without a land cover or biome base layer there is no biome map,
+    // so the placement falls back on the only (manually loaded) biome.
+    const Biome* forest = biomes->getBiomeCatalog()->getBiome("forest");
+    REQUIRE(forest != nullptr);
+    biomes->getBiomeManager().ref(forest);
+
+    // a tile near the equator holds tens of thousands of candidates,
+    // i.e. many placement blocks.
+    TileKey key(veg->options().group("trees").lod().get(), 16000, 8000, map->getProfile());
+
+    auto place = [&](unsigned blockSize)
+        {
+            veg->options().placementBlockSize() = blockSize;
+            std::vector<VegetationLayer::Placement> output;
+            REQUIRE(veg->getAssetPlacements(key, "trees", true, output, nullptr));
+            return output;
+        };
+
+    std::vector<VegetationLayer::Placement> serial = place(0u);
+    REQUIRE(!serial.empty());
+
+    for (unsigned blockSize : { 4096u, 1000u })
+    {
+        INFO("Block size " << blockSize);
+
+        std::vector<VegetationLayer::Placement> parallel = place(blockSize);
+        REQUIRE(parallel.size() == serial.size());
+
+        for (std::size_t i = 0; i < serial.size(); ++i)
+        {
+            INFO("Placement " << i);
+            REQUIRE(parallel[i].uv() == serial[i].uv());
+            REQUIRE(parallel[i].localPoint() == serial[i].localPoint());
+            REQUIRE(parallel[i].mapPoint() == serial[i].mapPoint());
+            REQUIRE(parallel[i].scale() == serial[i].scale());
+            REQUIRE(parallel[i].rotation() == serial[i].rotation());
+            REQUIRE(parallel[i].density() == serial[i].density());
+            REQUIRE(parallel[i].asset() == serial[i].asset());
+            REQUIRE(parallel[i].biome == serial[i].biome);
+        }
+    }
+
+    map->removeLayer(veg.get());
+    map->removeLayer(biomes.get());
+    std::filesystem::remove_all(dir);
+}
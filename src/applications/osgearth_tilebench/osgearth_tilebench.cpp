@@ -0,0 +1,354 @@
+/* osgEarth
+* Copyright 2025 Pelican Mapping
+* MIT License
+*/
+
+#include <osgEarth/Notify>
+#include <osgEarth/MapNode>
+#include <osgEarth/TerrainEngineNode>
+#include <osgEarth/TerrainTileModelFactory>
+#include <osgEarth/TerrainConstraintLayer>
+#include <osgEarth/TileMesher>
+#include <osgEarth/JsonUtils>
+#include <osgEarth/StringUtils>
+#include <osgEarth/weejobs.h>
+
+#include <osg/ArgumentParser>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+#define LC "[tilebench] "
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+// Allocation tracking.
+// Replacing the global allocator lets us count the heap allocations made by
+// each pipeline stage. Counters are per-thread so that concurrent jobs do not
+// pollute each other's numbers. (Note: on Windows, allocations made inside
+// other DLLs with their own CRT heap are not counted.)
+namespace
+{
+    thread_local std::uint64_t t_allocCount = 0u;
+    thread_local std::uint64_t t_allocBytes = 0u;
+}
+
+void* operator new(std::size_t size)
+{
+    ++t_allocCount;
+    t_allocBytes += size;
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+int
+usage(const char* name, const std::string& error)
+{
+    OE_NOTICE
+        << "Headless benchmark of the terrain tile creation pipeline."
+        << "\nError: " << error
+        << "\nUsage:"
+        << "\n" << name
+        << "\n  <earthfile>                         ; earth file containing the map to benchmark"
+        << "\n  --key <z/x/y>                       ; tile key to build (repeatable)"
+        << "\n  --lod <n>                           ; build all tiles at this LOD within --bounds"
+        << "\n  [--bounds xmin ymin xmax ymax]      ; geographic bounds for --lod (default = whole map)"
+        << "\n  [--threads 1,2,4,...]               ; thread counts to measure (default = 1)"
+        << "\n  [--iterations <n>]                  ; passes over the key list per thread count (default = 1)"
+        << "\n  [--no-warmup]                       ; skip the initial serial pass that warms caches"
+        << "\n  [--out <file.json>]                 ; write results here instead of stdout"
+        << std::endl;
+
+    return -1;
+}
+
+namespace
+{
+    // Pipeline stages, in execution order
+    enum Stage
+    {
+        STAGE_TILE_MODEL,        // TerrainEngine::createTileModel (as run by LoadTileDataOperation)
+        STAGE_MESH,              // TileMesher::createMesh without constraints
+        STAGE_MESH_CONSTRAINED,  // TileMesher::createMesh with the map's MeshConstraints
+        STAGE_CREATE_TILE,       // TerrainEngine::createStandaloneTile (REX CreateTileImplementation)
+        NUM_STAGES
+    };
+
+    const char* stageNames[NUM_STAGES] = {
+        "tile_model", "mesh", "mesh_constrained", "create_tile"
+    };
+
+    // One measurement of one stage
+    struct Sample
+    {
+        bool ran = false;
+        double ms = 0.0;
+        std::uint64_t allocs = 0u;
+        std::uint64_t bytes = 0u;
+    };
+
+    using TileSamples = std::array<Sample, NUM_STAGES>;
+
+    // Runs a function and records its elapsed time and allocations.
+    template<typename FUNC>
+    void measure(Sample& sample, FUNC&& func)
+    {
+        std::uint64_t allocs0 = t_allocCount, bytes0 = t_allocBytes;
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        sample.ran = true;
+        sample.ms = std::chrono::duration<double, std::milli>(end - start).count();
+        sample.allocs = t_allocCount - allocs0;
+        sample.bytes = t_allocBytes - bytes0;
+    }
+
+    struct Bench
+    {
+        osg::ref_ptr<MapNode> mapNode;
+        osg::ref_ptr<const Map> map;
+        TerrainEngine* engine = nullptr;
+        std::vector<TileKey> keys;
+
+        // Build one tile through every stage of the pipeline.
+        void buildTile(const TileKey& key, TileSamples& out) const
+        {
+            osg::ref_ptr<TerrainTileModel> model;
+            CreateTileManifest manifest;
+
+            measure(out[STAGE_TILE_MODEL], [&]() {
+                model = engine->createTileModel(map.get(), key, manifest, nullptr);
+            });
+
+            TileMesher mesher;
+            mesher.setTerrainOptions(engine->getOptions());
+
+            measure(out[STAGE_MESH], [&]() {
+                TileMesh mesh = mesher.createMesh(key, {}, nullptr);
+            });
+
+            TerrainConstraintQuery query(map.get());
+            MeshConstraints constraints;
+            query.getConstraints(key, constraints, nullptr);
+            if (!constraints.empty())
+            {
+                measure(out[STAGE_MESH_CONSTRAINED], [&]() {
+                    TileMesh mesh = mesher.createMesh(key, constraints, nullptr);
+                });
+            }
+
+            if (model.valid())
+            {
+                measure(out[STAGE_CREATE_TILE], [&]() {
+                    osg::ref_ptr<osg::Node> node = engine->createStandaloneTile(
+                        model.get(), TerrainEngineNode::CREATE_TILE_INCLUDE_ALL, 0u, TileKey::INVALID);
+                });
+            }
+        }
+
+        // Build every tile using a pool of N threads; returns wall-clock seconds.
+        double run(unsigned threads, unsigned iterations, std::vector<TileSamples>& samples) const
+        {
+            samples.assign(keys.size() * iterations, TileSamples());
+
+            auto pool = jobs::get_pool("oe.tilebench");
+            pool->set_concurrency(threads);
+
+            auto start = std::chrono::steady_clock::now();
+
+            auto group = jobs::jobgroup::create();
+            jobs::context context;
+            context.pool = pool;
+            context.group = group;
+
+            for (unsigned i = 0; i < samples.size(); ++i)
+            {
+                context.name = keys[i % keys.size()].str();
+                jobs::dispatch([this, i, &samples]() {
+                    buildTile(keys[i % keys.size()], samples[i]);
+                }, context);
+            }
+            group->join();
+
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double>(end - start).count();
+        }
+    };
+
+    double percentile(std::vector<double>& values, double p)
+    {
+        if (values.empty()) return 0.0;
+        std::size_t index = std::min(values.size() - 1, (std::size_t)(p * (double)(values.size() - 1) + 0.5));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    Json::Value summarize(const std::vector<TileSamples>& samples)
+    {
+        Json::Value stages(Json::objectValue);
+        for (unsigned s = 0; s < NUM_STAGES; ++s)
+        {
+            std::vector<double> ms;
+            double total = 0.0, allocs = 0.0, bytes = 0.0;
+            for (auto& tile : samples)
+            {
+                if (tile[s].ran)
+                {
+                    ms.push_back(tile[s].ms);
+                    total += tile[s].ms;
+                    allocs += (double)tile[s].allocs;
+                    bytes += (double)tile[s].bytes;
+                }
+            }
+
+            Json::Value stage(Json::objectValue);
+            double count = (double)ms.size();
+            stage["count"] = count;
+            if (count > 0)
+            {
+                stage["mean_ms"] = total / count;
+                stage["p50_ms"] = percentile(ms, 0.50);
+                stage["p95_ms"] = percentile(ms, 0.95);
+                stage["max_ms"] = *std::max_element(ms.begin(), ms.end());
+                stage["allocs_per_tile"] = allocs / count;
+                stage["bytes_per_tile"] = bytes / count;
+            }
+            stages[stageNames[s]] = stage;
+        }
+        return stages;
+    }
+}
+
+int
+main(int argc, char** argv)
+{
+    osgEarth::initialize();
+
+    osg::ArgumentParser arguments(&argc, argv);
+
+    Bench bench;
+
+    std::vector<unsigned> threadCounts;
+    std::string threadsArg;
+    if (arguments.read("--threads", threadsArg))
+    {
+        for (auto& token : StringTokenizer().delim(",").keepEmpties(false).tokenize(threadsArg))
+            threadCounts.push_back(std::max(1u, as<unsigned>(token, 1u)));
+    }
+    if (threadCounts.empty())
+        threadCounts.push_back(1u);
+
+    unsigned iterations = 1u;
+    arguments.read("--iterations", iterations);
+    iterations = std::max(1u, iterations);
+
+    bool warmup = !arguments.read("--no-warmup");
+
+    std::string outfile;
+    arguments.read("--out", outfile);
+
+    std::vector<std::string> keyStrings;
+    std::string keyString;
+    while (arguments.read("--key", keyString))
+        keyStrings.push_back(keyString);
+
+    int lod = -1;
+    arguments.read("--lod", lod);
+
+    double xmin = -180, ymin = -90, xmax = 180, ymax = 90;
+    bool haveBounds = arguments.read("--bounds", xmin, ymin, xmax, ymax);
+
+    bench.mapNode = MapNode::load(arguments);
+    if (!bench.mapNode.valid())
+        return usage(argv[0], "No earth file");
+
+    if (!bench.mapNode->open())
+        return usage(argv[0], "Failed to open the map");
+
+    bench.map = bench.mapNode->getMap();
+    bench.engine = bench.mapNode->getTerrainEngine();
+    if (!bench.engine)
+        return usage(argv[0], "No terrain engine");
+
+    const Profile* profile = bench.map->getProfile();
+
+    for (auto& str : keyStrings)
+    {
+        auto parts = StringTokenizer().delim("/").keepEmpties(false).tokenize(str);
+        if (parts.size() != 3)
+            return usage(argv[0], "Illegal --key " + str);
+        bench.keys.emplace_back(as<unsigned>(parts[0], 0u), as<unsigned>(parts[1], 0u), as<unsigned>(parts[2], 0u), profile);
+    }
+
+    if (lod >= 0)
+    {
+        GeoExtent extent = haveBounds ?
+            GeoExtent(SpatialReference::get("wgs84"), xmin, ymin, xmax, ymax) :
+            profile->getExtent();
+        std::vector<TileKey> lodKeys;
+        profile->getIntersectingTiles(extent, (unsigned)lod, lodKeys);
+        bench.keys.insert(bench.keys.end(), lodKeys.begin(), lodKeys.end());
+    }
+
+    if (bench.keys.empty())
+        return usage(argv[0], "No tile keys; use --key or --lod");
+
+    OE_INFO << LC << "Benchmarking " << bench.keys.size() << " tiles" << std::endl;
+
+    std::vector<TileSamples> samples;
+
+    if (warmup)
+    {
+        bench.run(1u, 1u, samples);
+    }
+
+    Json::Value runs(Json::arrayValue);
+    for (auto threads : threadCounts)
+    {
+        double seconds = bench.run(threads, iterations, samples);
+
+        Json::Value run(Json::objectValue);
+        run["threads"] = threads;
+        run["tiles"] = (double)samples.size();
+        run["wall_seconds"] = seconds;
+        run["tiles_per_second"] = seconds > 0.0 ? (double)samples.size() / seconds : 0.0;
+        run["stages"] = summarize(samples);
+        runs.append(run);
+
+        OE_INFO << LC << threads << " thread(s): " << run["tiles_per_second"].asDouble() << " tiles/s" << std::endl;
+    }
+
+    Json::Value root(Json::objectValue);
+    root["benchmark"] = "tilebench";
+    root["num_keys"] = (double)bench.keys.size();
+    root["iterations"] = iterations;
+    root["warmup"] = warmup;
+    root["runs"] = runs;
+
+    std::string json = Json::StyledWriter().write(root);
+    if (outfile.empty())
+    {
+        std::cout << json;
+    }
+    else
+    {
+        std::ofstream out(outfile);
+        out << json;
+    }
+
+    return 0;
+}
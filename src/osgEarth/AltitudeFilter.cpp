@@ -4,6 +4,7 @@
  */
 #include "AltitudeFilter"
 #include "GeoData"
+#include "FeatureExpression"
 
 #define LC "[AltitudeFilter] "
 
@@ -50,16 +51,101 @@ AltitudeFilter::push( FeatureList& features, FilterContext& cx )
     return cx;
 }
 
+FilterContext
+AltitudeFilter::pushBatch( FeatureBatch& batch, FilterContext& cx )
+{
+    bool clampToMap = 
+        _altitude.valid()                                          && 
+        _altitude->clamping()  != AltitudeSymbol::CLAMP_NONE       &&
+        _altitude->technique() == AltitudeSymbol::TECHNIQUE_MAP    &&
+        cx.getSession()        != 0L                               &&
+        cx.profile()           != 0L;
+
+    // scripts and expressions are evaluated against whole features
+    bool perFeature =
+        _altitude.valid() &&
+        (_altitude->script().isSet() || _altitude->verticalScale().isSet() || _altitude->verticalOffset().isSet());
+
+    if ( clampToMap || perFeature )
+        return FeatureFilter::pushBatch( batch, cx );
+
+    // same as pushAndDontClamp with unit scale and no offset
+    bool gpuClamping =
+        _altitude.valid() &&
+        _altitude->technique() == _altitude->TECHNIQUE_GPU;
+
+    bool ignoreZ =
+        gpuClamping && 
+        _altitude->clamping() == _altitude->CLAMP_TO_TERRAIN;
+
+    auto& coords = batch.getCoords();
+    auto& parts = batch.getParts();
+    auto& offsets = batch.getPartOffsets();
+
+    // create the columns up front; adding one may move the others
+    batch.getOrCreateColumn( "__min_hat" );
+    batch.getOrCreateColumn( "__max_hat" );
+    if ( gpuClamping )
+    {
+        batch.getOrCreateColumn( "__oe_verticalScale" );
+        batch.getOrCreateColumn( "__oe_verticalOffset" );
+    }
+
+    auto& columns = batch.getColumns();
+    FeatureBatch::Column& minHATs = columns[batch.indexOf( "__min_hat" )];
+    FeatureBatch::Column& maxHATs = columns[batch.indexOf( "__max_hat" )];
+
+    for( std::size_t row = 0; row < batch.size(); ++row )
+    {
+        if ( !batch.hasGeometry(row) )
+            continue;
+
+        double minHAT =  DBL_MAX;
+        double maxHAT = -DBL_MAX;
+
+        if ( offsets[row] < offsets[row+1] )
+        {
+            auto end = coords.begin() + parts[offsets[row+1]-1].end;
+            for( auto g = coords.begin() + parts[offsets[row]].begin; g != end; ++g )
+            {
+                if ( ignoreZ )
+                    g->z() = 0.0;
+
+                if ( g->z() < minHAT )
+                    minHAT = g->z();
+                if ( g->z() > maxHAT )
+                    maxHAT = g->z();
+            }
+        }
+
+        if ( minHAT != DBL_MAX )
+        {
+            minHATs.set( row, minHAT );
+            maxHATs.set( row, maxHAT );
+        }
+
+        if ( gpuClamping )
+        {
+            columns[batch.indexOf( "__oe_verticalScale" )].set( row, 1.0 );
+            columns[batch.indexOf( "__oe_verticalOffset" )].set( row, 0.0 );
+        }
+    }
+
+    return cx;
+}
+
 void
 AltitudeFilter::pushAndDontClamp( FeatureList& features, FilterContext& cx )
 {
-    NumericExpression scaleExpr;
+    const Feature* prototype = features.empty() ? nullptr : features.front().get();
+
+    CompiledNumericExpression scaleExpr;
     if ( _altitude.valid() && _altitude->verticalScale().isSet() )
-        scaleExpr = *_altitude->verticalScale();
+        scaleExpr = CompiledNumericExpression(*_altitude->verticalScale(), prototype);
 
-    NumericExpression offsetExpr;
+    CompiledNumericExpression offsetExpr;
     if ( _altitude.valid() && _altitude->verticalOffset().isSet() )
-        offsetExpr = *_altitude->verticalOffset();
+        offsetExpr = CompiledNumericExpression(*_altitude->verticalOffset(), prototype);
 
     bool gpuClamping =
         _altitude.valid() &&
@@ -88,11 +174,11 @@ AltitudeFilter::pushAndDontClamp( FeatureList& features, FilterContext& cx )
 
         double scaleZ = 1.0;
         if ( _altitude.valid() && _altitude->verticalScale().isSet() )
-            scaleZ = feature->eval( scaleExpr, &cx );
+            scaleZ = scaleExpr.eval( feature.get(), &cx );
 
         optional<double> offsetZ( 0.0 );
         if ( _altitude.valid() && _altitude->verticalOffset().isSet() )
-            offsetZ = feature->eval( offsetExpr, &cx );       
+            offsetZ = offsetExpr.eval( feature.get(), &cx );       
         
         GeometryIterator gi( feature->getGeometry() );
         while( gi.hasMore() )
@@ -151,13 +237,15 @@ AltitudeFilter::pushAndClamp(FeatureList& features, FilterContext& cx)
     const SpatialReference* mapSRS = map->getSRS();
     osg::ref_ptr<const SpatialReference> featureSRS = cx.profile()->getSRS();
 
-    NumericExpression scaleExpr;
+    const Feature* prototype = features.front().get();
+
+    CompiledNumericExpression scaleExpr;
     if ( _altitude->verticalScale().isSet() )
-        scaleExpr = *_altitude->verticalScale();
+        scaleExpr = CompiledNumericExpression(*_altitude->verticalScale(), prototype);
 
-    NumericExpression offsetExpr;
+    CompiledNumericExpression offsetExpr;
     if ( _altitude->verticalOffset().isSet() )
-        offsetExpr = *_altitude->verticalOffset();
+        offsetExpr = CompiledNumericExpression(*_altitude->verticalOffset(), prototype);
 
     // whether to record the min/max height-above-terrain values.
     bool collectHATs =
@@ -203,11 +291,11 @@ AltitudeFilter::pushAndClamp(FeatureList& features, FilterContext& cx)
 
         double scaleZ = 1.0;
         if ( _altitude.valid() && _altitude->verticalScale().isSet() )
-            scaleZ = feature->eval( scaleExpr, &cx );
+            scaleZ = scaleExpr.eval( feature.get(), &cx );
 
         double offsetZ = 0.0;
         if ( _altitude.valid() && _altitude->verticalOffset().isSet() )
-            offsetZ = feature->eval( offsetExpr, &cx );
+            offsetZ = offsetExpr.eval( feature.get(), &cx );
 
         osgEarth::Bounds bounds = feature->getGeometry()->getBounds();
         auto center = bounds.center();
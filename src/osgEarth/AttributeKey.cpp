@@ -0,0 +1,148 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/AttributeKey>
+#include <atomic>
+#include <cctype>
+#include <deque>
+#include <mutex>
+
+using namespace osgEarth;
+
+namespace
+{
+    inline char lowerChar(char c)
+    {
+        return (char)::tolower((unsigned char)c);
+    }
+
+    // FNV-1a hash of the lower-cased name
+    inline std::uint64_t hashName(std::string_view name)
+    {
+        std::uint64_t h = 0xcbf29ce484222325ull;
+        for (char c : name)
+        {
+            h ^= (unsigned char)lowerChar(c);
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    // Process-wide table of interned attribute names. Lookups do not lock:
+    // a slot is written once, the slot array is replaced (never resized in
+    // place) when it fills up, and neither the records nor the retired
+    // arrays are ever freed, so a concurrent reader always sees valid data.
+    struct KeyTable
+    {
+        using Record = AttributeKey::Record;
+
+        struct Slots
+        {
+            explicit Slots(unsigned n) : mask(n - 1u), slots(new std::atomic<const Record*>[n])
+            {
+                for (unsigned i = 0; i < n; ++i)
+                    slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+            unsigned mask;
+            std::atomic<const Record*>* slots;
+        };
+
+        std::atomic<Slots*> current = { new Slots(1024u) };
+        std::deque<Record> records;
+        std::mutex mutex;
+
+        const Record* find(std::string_view name, std::uint64_t hash) const
+        {
+            const Slots* s = current.load(std::memory_order_acquire);
+            for (unsigned i = (unsigned)hash & s->mask; ; i = (i + 1u) & s->mask)
+            {
+                const Record* record = s->slots[i].load(std::memory_order_acquire);
+                if (!record)
+                    return nullptr;
+                if (record->hash == hash && same(record->name, name))
+                    return record;
+            }
+        }
+
+        const Record* intern(std::string_view name)
+        {
+            std::uint64_t hash = hashName(name);
+            const Record* record = find(name, hash);
+            if (record)
+                return record;
+
+            std::lock_guard<std::mutex> lock(mutex);
+
+            record = find(name, hash);
+            if (record)
+                return record;
+
+            Slots* s = current.load(std::memory_order_relaxed);
+            if (2u * (records.size() + 1u) > s->mask + 1u)
+            {
+                // grow, and leave the old array to any readers still using it
+                s = new Slots(2u * (s->mask + 1u));
+                for (auto& r : records)
+                    place(s, &r);
+                current.store(s, std::memory_order_release);
+            }
+
+            std::string lowered(name);
+            for (auto& c : lowered)
+                c = lowerChar(c);
+
+            records.push_back(Record{ std::move(lowered), hash, (AttributeKey::ID)records.size() + 1u });
+            place(s, &records.back());
+            return &records.back();
+        }
+
+        static bool same(const std::string& lowered, std::string_view name)
+        {
+            if (lowered.size() != name.size())
+                return false;
+            for (std::size_t i = 0; i < name.size(); ++i)
+                if (lowered[i] != lowerChar(name[i]))
+                    return false;
+            return true;
+        }
+
+        static void place(Slots* s, const Record* record)
+        {
+            unsigned i = (unsigned)record->hash & s->mask;
+            while (s->slots[i].load(std::memory_order_relaxed))
+                i = (i + 1u) & s->mask;
+            s->slots[i].store(record, std::memory_order_release);
+        }
+    };
+
+    KeyTable& keyTable()
+    {
+        // never destroyed, so keys stay valid during static destruction
+        static KeyTable* s_table = new KeyTable();
+        return *s_table;
+    }
+}
+
+AttributeKey::AttributeKey(std::string_view name) :
+    _record(keyTable().intern(name))
+{
+    //nop
+}
+
+AttributeKey
+AttributeKey::find(std::string_view name)
+{
+    AttributeKey key;
+    key._record = keyTable().find(name, hashName(name));
+    return key;
+}
+
+unsigned
+AttributeKey::count()
+{
+    KeyTable& table = keyTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return (unsigned)table.records.size();
+}
+
@@ -40,6 +40,9 @@ using namespace osgEarth;
 
 namespace
 {
+    // Z offset attribute written by the AltitudeFilter for GPU clamping
+    const AttributeKey VERTICAL_OFFSET("__oe_verticalOffset");
+
     bool isCCW(double x1, double y1, double x2, double y2, double x3, double y3)
     {
         return (x2 - x1) * (y3 - y1) - (y2 - y1) * (x3 - x1) > 0.0;
@@ -396,7 +399,7 @@ BuildGeometryFilter::processPolygons(FeatureList& features, FilterContext& conte
                 if (_style.has<AltitudeSymbol>() &&
                     _style.get<AltitudeSymbol>()->technique() == AltitudeSymbol::TECHNIQUE_GPU)
                 {
-                    Clamping::applyDefaultClampingAttrs( osgGeom.get(), input->getDouble("__oe_verticalOffset", 0.0) );
+                    Clamping::applyDefaultClampingAttrs( osgGeom.get(), input->getDouble(VERTICAL_OFFSET, 0.0) );
                 }
             }
             else
@@ -629,7 +632,7 @@ BuildGeometryFilter::processPolygonizedLines(FeatureList&   features,
             // install clamping attributes if necessary
             if (gpuClamping)
             {
-                Clamping::applyDefaultClampingAttrs( geom, input->getDouble("__oe_verticalOffset", 0.0) );
+                Clamping::applyDefaultClampingAttrs( geom, input->getDouble(VERTICAL_OFFSET, 0.0) );
                 Clamping::setHeights( geom, copyHeights._newHeights.get() );
                 //OE_WARN << "heights = " << hats->size() << ", new hats = " << copyHeights._newHeights->size() << ", verts=" << geom->getVertexArray()->getNumElements() << std::endl;
             }
@@ -793,7 +796,7 @@ BuildGeometryFilter::processLines(FeatureList& features, FilterContext& context)
             // install clamping attributes if necessary
             if (doGpuClamping)
             {
-                Clamping::applyDefaultClampingAttrs( drawable, input->getDouble("__oe_verticalOffset", 0.0) );
+                Clamping::applyDefaultClampingAttrs( drawable, input->getDouble(VERTICAL_OFFSET, 0.0) );
             }
 
             // finalize the drawable and generate primitive sets
@@ -907,7 +910,7 @@ BuildGeometryFilter::processPoints(FeatureList& features, FilterContext& context
             // install clamping attributes if necessary
             if (doGpuClamping)
             {
-                Clamping::applyDefaultClampingAttrs( drawable, input->getDouble("__oe_verticalOffset", 0.0) );
+                Clamping::applyDefaultClampingAttrs( drawable, input->getDouble(VERTICAL_OFFSET, 0.0) );
             }
 
             drawable->dirty();
@@ -260,6 +260,68 @@ CacheBin::writeNode(const std::string&    key,
     return true;
 }
 
+std::vector<ReadResult>
+CacheBin::readMany(const std::vector<std::string>& keys,
+                   const osgDB::Options*           readOptions)
+{
+    std::vector<ReadResult> results;
+    results.reserve(keys.size());
+    for (auto& key : keys)
+        results.emplace_back(readObject(key, readOptions));
+    return results;
+}
+
+std::vector<ReadResult>
+CacheBin::readManyImages(const std::vector<std::string>& keys,
+                         const osgDB::Options*           readOptions)
+{
+    std::vector<ReadResult> results;
+    results.reserve(keys.size());
+    for (auto& key : keys)
+        results.emplace_back(readImage(key, readOptions));
+    return results;
+}
+
+unsigned
+CacheBin::writeMany(const std::vector<Record>& records,
+                    const osgDB::Options*      writeOptions)
+{
+    unsigned count = 0;
+    for (auto& record : records)
+    {
+        if (write(record.key, record.object.get(), record.metadata, writeOptions))
+            ++count;
+    }
+    return count;
+}
+
+std::vector<CacheBin::RecordStatus>
+CacheBin::statusMany(const std::vector<std::string>& keys)
+{
+    std::vector<RecordStatus> results;
+    results.reserve(keys.size());
+    for (auto& key : keys)
+        results.push_back(getRecordStatus(key));
+    return results;
+}
+
+CacheBin::BinMetrics::BinMetrics(const std::string& driver) :
+    hits(Util::MetricsRegistry::instance().counter(
+        "osgearth_cache_reads_total", "Cache bin reads", { { "driver", driver }, { "result", "hit" } })),
+    misses(Util::MetricsRegistry::instance().counter(
+        "osgearth_cache_reads_total", "Cache bin reads", { { "driver", driver }, { "result", "miss" } })),
+    writes(Util::MetricsRegistry::instance().counter(
+        "osgearth_cache_writes_total", "Cache bin writes", { { "driver", driver }, { "result", "ok" } })),
+    failedWrites(Util::MetricsRegistry::instance().counter(
+        "osgearth_cache_writes_total", "Cache bin writes", { { "driver", driver }, { "result", "failed" } })),
+    readLatency(Util::MetricsRegistry::instance().histogram(
+        "osgearth_cache_read_seconds", "Cache bin read latency", { { "driver", driver } })),
+    writeLatency(Util::MetricsRegistry::instance().histogram(
+        "osgearth_cache_write_seconds", "Cache bin write latency", { { "driver", driver } }))
+{
+    //nop
+}
+
 
 #undef  LC
 #define LC "[ReadImageFromCachePseudoLoader] "
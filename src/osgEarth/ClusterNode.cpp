@@ -1,13 +1,401 @@
 #include <osgEarth/ClusterNode>
 
-#include <osgEarth/kdbush.hpp>
-
-typedef std::pair<int, int> TPoint;
-typedef std::vector< std::size_t > TIds;
+#include <algorithm>
+#include <climits>
+#include <cmath>
 
 using namespace osgEarth;
 using namespace osgEarth::Contrib;
 
+//........................................................................
+
+namespace
+{
+    // longitude/latitude (degrees) to normalized [0..1] Web Mercator
+    inline double lonToX(double lon)
+    {
+        return lon / 360.0 + 0.5;
+    }
+
+    inline double latToY(double lat)
+    {
+        double s = sin(osg::DegreesToRadians(osg::clampBetween(lat, -85.0511, 85.0511)));
+        return osg::clampBetween(0.5 - 0.25 * log((1.0 + s) / (1.0 - s)) / osg::PI, 0.0, 1.0);
+    }
+
+    inline double xToLon(double x)
+    {
+        return (x - 0.5) * 360.0;
+    }
+
+    inline double yToLat(double y)
+    {
+        double y2 = (180.0 - y * 360.0) * osg::PI / 180.0;
+        return 360.0 * atan(exp(y2)) / osg::PI - 90.0;
+    }
+}
+
+void
+ClusterIndex::Grid::reset(double value)
+{
+    cellSize = value;
+    dim = (std::uint64_t)std::ceil(1.0 / cellSize) + 1u;
+    sorted.clear();
+    pending.clear();
+}
+
+std::uint64_t
+ClusterIndex::Grid::cell(double x, double y) const
+{
+    std::uint64_t cx = (std::uint64_t)osg::clampBetween(x / cellSize, 0.0, (double)(dim - 1));
+    std::uint64_t cy = (std::uint64_t)osg::clampBetween(y / cellSize, 0.0, (double)(dim - 1));
+    return cy * dim + cx;
+}
+
+void
+ClusterIndex::Grid::insert(double x, double y, int item)
+{
+    pending.emplace_back(cell(x, y), item);
+
+    // fold recent insertions into the sorted list once scanning them
+    // would slow queries down
+    if (pending.size() > 1024u)
+    {
+        std::sort(pending.begin(), pending.end());
+        std::size_t middle = sorted.size();
+        sorted.insert(sorted.end(), pending.begin(), pending.end());
+        std::inplace_merge(sorted.begin(), sorted.begin() + middle, sorted.end());
+        pending.clear();
+    }
+}
+
+void
+ClusterIndex::Grid::rebuild(const std::vector<Item>& items)
+{
+    sorted.clear();
+    pending.clear();
+    sorted.reserve(items.size());
+    for (unsigned i = 0; i < items.size(); ++i)
+    {
+        if (items[i].count > 0)
+            sorted.emplace_back(cell(items[i].x, items[i].y), (int)i);
+    }
+    std::sort(sorted.begin(), sorted.end());
+}
+
+template<typename FUNC>
+void
+ClusterIndex::Grid::query(double x0, double y0, double x1, double y1, FUNC&& func) const
+{
+    std::uint64_t c0 = cell(x0, y0), c1 = cell(x1, y1);
+    std::uint64_t cx0 = c0 % dim, cy0 = c0 / dim;
+    std::uint64_t cx1 = c1 % dim, cy1 = c1 / dim;
+
+    // each row of cells is a contiguous run in the sorted list
+    for (std::uint64_t cy = cy0; cy <= cy1; ++cy)
+    {
+        std::pair<std::uint64_t, int> lo(cy * dim + cx0, INT_MIN);
+        auto i = std::lower_bound(sorted.begin(), sorted.end(), lo);
+        for (; i != sorted.end() && i->first <= cy * dim + cx1; ++i)
+            func(i->second);
+    }
+
+    for (auto& p : pending)
+    {
+        std::uint64_t cx = p.first % dim, cy = p.first / dim;
+        if (cx >= cx0 && cx <= cx1 && cy >= cy0 && cy <= cy1)
+            func(p.second);
+    }
+}
+
+ClusterIndex::ClusterIndex(unsigned radius, unsigned minZoom, unsigned maxZoom, unsigned tileSize) :
+    _radius(radius),
+    _minZoom(minZoom),
+    _maxZoom(osg::clampBetween(maxZoom, minZoom, 20u)), // keeps grid cell keys within 64 bits
+    _tileSize(tileSize)
+{
+    reset();
+}
+
+void
+ClusterIndex::reset()
+{
+    // one level per zoom, plus the points themselves
+    _levels.clear();
+    _levels.resize(_maxZoom - _minZoom + 2u);
+    for (unsigned i = 0; i < _levels.size(); ++i)
+    {
+        double scale = (double)_tileSize * (double)(1u << std::min(_minZoom + i, 30u));
+        _levels[i].radius = (double)_radius / scale;
+        // cells twice the search radius keep a query to at most 4 cells
+        _levels[i].grid.reset(2.0 * _levels[i].radius);
+    }
+    _size = 0u;
+    _changes = 0u;
+}
+
+void
+ClusterIndex::attach(unsigned level, int child, int parent)
+{
+    Item& c = _levels[level].items[child];
+    Item& p = _levels[level - 1].items[parent];
+    c.parent = parent;
+    c.nextSibling = p.firstChild;
+    p.firstChild = child;
+}
+
+void
+ClusterIndex::detach(unsigned level, int child)
+{
+    Item& c = _levels[level].items[child];
+    if (c.parent >= 0)
+    {
+        Item& p = _levels[level - 1].items[c.parent];
+        int* link = &p.firstChild;
+        while (*link >= 0 && *link != child)
+            link = &_levels[level].items[*link].nextSibling;
+        if (*link == child)
+            *link = c.nextSibling;
+    }
+    c.parent = -1;
+    c.nextSibling = -1;
+}
+
+void
+ClusterIndex::build(const std::vector<osg::Vec2d>& points)
+{
+    reset();
+
+    Level& leaves = _levels.back();
+    leaves.items.reserve(points.size());
+    for (unsigned i = 0; i < points.size(); ++i)
+    {
+        leaves.items.push_back(Item{ lonToX(points[i].x()), latToY(points[i].y()), 1u, i, -1, -1, -1 });
+    }
+    leaves.grid.rebuild(leaves.items);
+    _size = points.size();
+
+    std::vector<int> neighbors;
+
+    // cluster each level into the one below it
+    for (int z = (int)_levels.size() - 2; z >= 0; --z)
+    {
+        Level& src = _levels[z + 1];
+        Level& dst = _levels[z];
+        const double r = dst.radius, r2 = r * r;
+
+        // seed in grid order so that neighboring queries touch the same memory
+        for (auto& entry : src.grid.sorted)
+        {
+            int i = entry.second;
+            if (src.items[i].count == 0 || src.items[i].parent >= 0)
+                continue;
+
+            const Item& seed = src.items[i];
+            int parent = (int)dst.items.size();
+            dst.items.push_back(Item{ 0.0, 0.0, 0u, seed.rep, -1, -1, -1 });
+
+            double wx = 0.0, wy = 0.0;
+            unsigned count = 0u;
+
+            neighbors.clear();
+            neighbors.push_back(i);
+            src.grid.query(seed.x - r, seed.y - r, seed.x + r, seed.y + r, [&](int j)
+                {
+                    const Item& n = src.items[j];
+                    if (j != i && n.count > 0 && n.parent < 0)
+                    {
+                        double dx = n.x - seed.x, dy = n.y - seed.y;
+                        if (dx * dx + dy * dy <= r2 && (!_canMerge || _canMerge(seed.rep, n.rep)))
+                            neighbors.push_back(j);
+                    }
+                });
+
+            for (int j : neighbors)
+            {
+                const Item& n = src.items[j];
+                wx += n.x * n.count;
+                wy += n.y * n.count;
+                count += n.count;
+                attach(z + 1, j, parent);
+            }
+
+            Item& cluster = dst.items[parent];
+            cluster.x = wx / (double)count;
+            cluster.y = wy / (double)count;
+            cluster.count = count;
+        }
+
+        dst.grid.rebuild(dst.items);
+    }
+}
+
+unsigned
+ClusterIndex::insert(double lon, double lat)
+{
+    const double x = lonToX(lon), y = latToY(lat);
+
+    unsigned last = _levels.size() - 1u;
+    unsigned id = _levels[last].items.size();
+    _levels[last].items.push_back(Item{ x, y, 1u, id, -1, -1, -1 });
+    _levels[last].grid.insert(x, y, (int)id);
+    ++_size;
+    ++_changes;
+
+    int child = (int)id;
+
+    // Descend the zoom levels. Join the nearest cluster in range if there is
+    // one; otherwise the point starts its own cluster at that level.
+    for (int z = (int)last - 1; z >= 0; --z)
+    {
+        Level& level = _levels[z];
+        const double r = level.radius;
+
+        int nearest = -1;
+        double nearest2 = r * r;
+        level.grid.query(x - r, y - r, x + r, y + r, [&](int j)
+            {
+                const Item& n = level.items[j];
+                if (n.count > 0)
+                {
+                    double dx = n.x - x, dy = n.y - y;
+                    double d2 = dx * dx + dy * dy;
+                    if (d2 <= nearest2 && (!_canMerge || _canMerge(n.rep, id)))
+                    {
+                        nearest = j;
+                        nearest2 = d2;
+                    }
+                }
+            });
+
+        if (nearest >= 0)
+        {
+            attach(z + 1, child, nearest);
+
+            // fold the point into the cluster and all its ancestors
+            for (int zz = z, p = nearest; zz >= 0 && p >= 0; --zz)
+            {
+                Item& c = _levels[zz].items[p];
+                c.x = (c.x * c.count + x) / (double)(c.count + 1u);
+                c.y = (c.y * c.count + y) / (double)(c.count + 1u);
+                ++c.count;
+                p = c.parent;
+            }
+            return id;
+        }
+
+        int cluster = (int)level.items.size();
+        level.items.push_back(Item{ x, y, 1u, id, -1, -1, -1 });
+        level.grid.insert(x, y, cluster);
+        attach(z + 1, child, cluster);
+        child = cluster;
+    }
+
+    return id;
+}
+
+void
+ClusterIndex::remove(unsigned id)
+{
+    unsigned last = _levels.size() - 1u;
+    if (id >= _levels[last].items.size() || _levels[last].items[id].count == 0)
+        return;
+
+    Item& leaf = _levels[last].items[id];
+    const double x = leaf.x, y = leaf.y;
+    int parent = leaf.parent;
+    leaf.count = 0u;
+    detach(last, (int)id);
+    --_size;
+    ++_changes;
+
+    // take the point out of each ancestor, dropping clusters that empty out
+    for (int z = (int)last - 1; z >= 0 && parent >= 0; --z)
+    {
+        Item& c = _levels[z].items[parent];
+        int next = c.parent;
+
+        if (c.count <= 1u)
+        {
+            c.count = 0u;
+            detach(z, parent);
+        }
+        else
+        {
+            c.x = (c.x * c.count - x) / (double)(c.count - 1u);
+            c.y = (c.y * c.count - y) / (double)(c.count - 1u);
+            --c.count;
+            if (c.rep == id && c.firstChild >= 0)
+                c.rep = _levels[z + 1].items[c.firstChild].rep;
+        }
+        parent = next;
+    }
+}
+
+double
+ClusterIndex::getZoom(double metersPerPixel, double latitude, double earthRadius) const
+{
+    double worldPixels = 2.0 * osg::PI * earthRadius * cos(osg::DegreesToRadians(latitude)) / std::max(metersPerPixel, 1e-9);
+    return log2(std::max(worldPixels / (double)_tileSize, 1.0));
+}
+
+void
+ClusterIndex::query(double west, double south, double east, double north, int zoom, std::vector<Result>& out) const
+{
+    if (west > east)
+    {
+        // crosses the antimeridian
+        query(west, south, 180.0, north, zoom, out);
+        query(-180.0, south, east, north, zoom, out);
+        return;
+    }
+
+    int z = osg::clampBetween(zoom, (int)_minZoom, (int)_maxZoom + 1) - (int)_minZoom;
+    const Level& level = _levels[z];
+
+    double x0 = lonToX(west), x1 = lonToX(east);
+    double y0 = latToY(north), y1 = latToY(south);
+
+    level.grid.query(x0, y0, x1, y1, [&](int i)
+        {
+            const Item& c = level.items[i];
+            if (c.count > 0 && c.x >= x0 && c.x <= x1 && c.y >= y0 && c.y <= y1)
+            {
+                out.push_back(Result{ xToLon(c.x), yToLat(c.y), c.count, c.rep, z, i });
+            }
+        });
+}
+
+void
+ClusterIndex::getLeaves(const Result& cluster, std::vector<unsigned>& out) const
+{
+    if (cluster.level < 0 || cluster.level >= (int)_levels.size())
+        return;
+
+    const int last = (int)_levels.size() - 1;
+
+    std::vector<std::pair<int, int>> stack;
+    stack.emplace_back(cluster.level, cluster.index);
+
+    while (!stack.empty())
+    {
+        auto top = stack.back();
+        stack.pop_back();
+
+        if (top.first == last)
+        {
+            out.push_back((unsigned)top.second);
+        }
+        else
+        {
+            for (int c = _levels[top.first].items[top.second].firstChild; c >= 0; c = _levels[top.first + 1].items[c].nextSibling)
+                stack.emplace_back(top.first + 1, c);
+        }
+    }
+}
+
+//........................................................................
+
 ClusterNode::ClusterNode(MapNode* mapNode, osg::Image* defaultImage) :
     _radius(50),
     _mapNode(mapNode),
@@ -26,7 +414,11 @@ void ClusterNode::addNode(osg::Node* node)
 {
     _nodes.push_back(node);
     _dirty = true;
-    _dirtyIndex = true;
+
+    if (!_dirtyIndex)
+    {
+        indexNode(node);
+    }
 }
 
 void ClusterNode::removeNode(osg::Node* node)
@@ -37,12 +429,37 @@ void ClusterNode::removeNode(osg::Node* node)
         _nodes.erase(itr);
     }
     _dirty = true;
-    _dirtyIndex = true;
+
+    auto id = _nodeIds.find(node);
+    if (id != _nodeIds.end())
+    {
+        _index.remove(id->second);
+        _indexedNodes[id->second] = nullptr;
+        _nodeIds.erase(id);
+    }
+}
+
+void ClusterNode::updateNode(osg::Node* node)
+{
+    auto id = _nodeIds.find(node);
+    if (id != _nodeIds.end())
+    {
+        _index.remove(id->second);
+        _indexedNodes[id->second] = nullptr;
+        _nodeIds.erase(id);
+
+        indexNode(node);
+    }
+    _dirty = true;
 }
 
 void ClusterNode::clear()
 {
     _nodes.clear();
+    _indexedNodes.clear();
+    _indexedCenters.clear();
+    _nodeIds.clear();
+    _index.build({});
     _dirty = true;
     _dirtyIndex = true;
 }
@@ -56,6 +473,7 @@ void ClusterNode::setRadius(unsigned int radius)
 {
     _radius = radius;
     _dirty = true;
+    _dirtyIndex = true;
 }
 
 bool ClusterNode::getEnabled() const
@@ -107,43 +525,182 @@ void ClusterNode::setCanClusterCallback(ClusterNode::CanClusterCallback* callbac
 {
     _canClusterCallback = callback;
     _dirty = true;
+    _dirtyIndex = true;
 }
 
-namespace
+bool ClusterNode::getNodeLocation(osg::Node* node, double& lon, double& lat) const
 {
-    bool boundSort(const osg::ref_ptr< osg::Node> &i, const osg::ref_ptr< osg::Node> &j)
-    {
-        osg::BoundingSphere bsI = i->getBound();
-        osg::BoundingSphere bsJ = j->getBound();
+    osg::ref_ptr<MapNode> mapNode;
+    if (!node || !_mapNode.lock(mapNode))
+        return false;
+
+    GeoPoint p;
+    if (!p.fromWorld(mapNode->getMapSRS(), node->getBound().center()))
+        return false;
+
+    p = p.transform(mapNode->getMapSRS()->getGeographicSRS());
+    lon = p.x();
+    lat = p.y();
+    return p.isValid();
+}
 
-        return bsI.center().x() < bsJ.center().x();
+void ClusterNode::indexNode(osg::Node* node)
+{
+    double lon, lat;
+    if (getNodeLocation(node, lon, lat))
+    {
+        unsigned id = _index.insert(lon, lat);
+        if (id >= _indexedNodes.size())
+        {
+            _indexedNodes.resize(id + 1);
+            _indexedCenters.resize(id + 1);
+        }
+        _indexedNodes[id] = node;
+        _indexedCenters[id] = node->getBound().center();
+        _nodeIds[node] = id;
     }
 }
-void ClusterNode::buildIndex()
+
+void ClusterNode::updateMovedNodes()
 {
+    // a rebuild picks up every node's current position anyway
     if (_dirtyIndex)
+        return;
+
+    // (updateNode appends re-indexed nodes, which then match their centers)
+    for (unsigned id = 0; id < _indexedNodes.size(); ++id)
     {
-        _clusterIndex.clear();
+        osg::Node* node = _indexedNodes[id].get();
+        if (node && node->getBound().center() != _indexedCenters[id])
+        {
+            updateNode(node);
+        }
+    }
+}
 
-        std::sort(_nodes.begin(), _nodes.end(), boundSort);
+void ClusterNode::buildIndex()
+{
+    // Incremental edits don't re-cluster neighboring points, so start over
+    // once they make up a good fraction of the index.
+    if (!_dirtyIndex && _index.getNumChanges() > 1000u + _index.size() / 4u)
+    {
+        _dirtyIndex = true;
+    }
 
-        unsigned int maxNodes = 10000;
+    if (_dirtyIndex && _mapNode.valid())
+    {
+        _indexedNodes.clear();
+        _indexedCenters.clear();
+        _nodeIds.clear();
 
-        osg::Group* currentGroup = 0;
+        std::vector<osg::Vec2d> points;
+        points.reserve(_nodes.size());
+        _indexedNodes.reserve(_nodes.size());
+        _indexedCenters.reserve(_nodes.size());
 
-        for (unsigned int i = 0; i < _nodes.size(); i++)
+        for (auto& node : _nodes)
         {
-            if (!currentGroup || currentGroup->getNumChildren() >= maxNodes)
+            double lon, lat;
+            if (getNodeLocation(node.get(), lon, lat))
             {
-                currentGroup = new osg::Group;
-                _clusterIndex.push_back(currentGroup);
+                _nodeIds[node.get()] = points.size();
+                points.emplace_back(lon, lat);
+                _indexedNodes.push_back(node);
+                _indexedCenters.push_back(node->getBound().center());
             }
-            currentGroup->addChild(_nodes[i]);                      
         }
+
+        _index.setRadius(_radius);
+
+        if (_canClusterCallback.valid())
+        {
+            _index.setCanMergeFunction([this](unsigned a, unsigned b)
+                {
+                    osg::Node* nodeA = _indexedNodes[a].get();
+                    osg::Node* nodeB = _indexedNodes[b].get();
+                    return !nodeA || !nodeB || (*_canClusterCallback)(nodeA, nodeB);
+                });
+        }
+        else
+        {
+            _index.setCanMergeFunction(nullptr);
+        }
+
+        _index.build(points);
+
+        _dirtyIndex = false;
     }
-    _dirtyIndex = false;
 }
 
+namespace
+{
+    // Lon/lat bounds of the area visible in a camera, or false if the
+    // whole map should be considered.
+    bool computeViewBounds(
+        const osg::Matrixd& windowToWorld,
+        const osg::Viewport& viewport,
+        const SpatialReference* mapSRS,
+        const osg::Vec3d& eye,
+        double& west, double& south, double& east, double& north)
+    {
+        if (!mapSRS->isGeographic())
+            return false;
+
+        const Ellipsoid& ellipsoid = mapSRS->getEllipsoid();
+        const SpatialReference* geoSRS = mapSRS->getGeographicSRS();
+
+        west = 180.0, east = -180.0, south = 90.0, north = -90.0;
+
+        // intersect a 3x3 grid of rays through the viewport with the ellipsoid
+        for (int i = 0; i <= 2; ++i)
+        {
+            for (int j = 0; j <= 2; ++j)
+            {
+                double sx = viewport.x() + viewport.width() * 0.5 * i;
+                double sy = viewport.y() + viewport.height() * 0.5 * j;
+                osg::Vec3d p0 = osg::Vec3d(sx, sy, 0.0) * windowToWorld;
+                osg::Vec3d p1 = osg::Vec3d(sx, sy, 1.0) * windowToWorld;
+
+                osg::Vec3d hit;
+                if (!ellipsoid.intersectGeocentricLine(p0, p1, hit))
+                {
+                    // the view includes the horizon; use the visible cap instead
+                    osg::Vec3d lla = ellipsoid.geocentricToGeodetic(eye);
+                    double R = ellipsoid.getRadiusEquator();
+                    double cap = osg::RadiansToDegrees(acos(R / (R + std::max(lla.z(), 1.0))));
+                    south = std::max(lla.y() - cap, -90.0);
+                    north = std::min(lla.y() + cap, 90.0);
+                    double coslat = cos(osg::DegreesToRadians(std::max(fabs(south), fabs(north))));
+                    if (coslat < 1e-3 || cap / coslat >= 180.0)
+                    {
+                        west = -180.0, east = 180.0;
+                    }
+                    else
+                    {
+                        west = lla.x() - cap / coslat;
+                        east = lla.x() + cap / coslat;
+                        if (west < -180.0) west += 360.0;
+                        if (east > 180.0) east -= 360.0;
+                    }
+                    return true;
+                }
+
+                GeoPoint p;
+                p.fromWorld(mapSRS, hit);
+                p = p.transform(geoSRS);
+                west = std::min(west, p.x()), east = std::max(east, p.x());
+                south = std::min(south, p.y()), north = std::max(north, p.y());
+            }
+        }
+
+        // a footprint spanning more than half the globe straddles the antimeridian
+        if (east - west > 180.0)
+        {
+            west = -180.0, east = 180.0;
+        }
+        return true;
+    }
+}
 
 void ClusterNode::getClusters(osgUtil::CullVisitor* cv, ClusterList& out)
 {
@@ -161,105 +718,113 @@ void ClusterNode::getClusters(osgUtil::CullVisitor* cv, ClusterList& out)
         camera->getProjectionMatrix() *
         camera->getViewport()->computeWindowMatrix();
 
-    std::vector<TPoint> points;
-
-    osg::NodeList validPlaces;
-
     buildIndex();
 
-    for (osg::NodeList::iterator itr = _clusterIndex.begin(); itr != _clusterIndex.end(); ++itr)
-    {
-        osg::Group* index = static_cast<osg::Group*>(itr->get());
-        if (cv->isCulled(index->getBound()))
-        {
-            continue;
-        }
-
-        for (unsigned int i = 0; i < index->getNumChildren(); i++)
-        {
-            osg::Node* node = index->getChild(i);
-            osg::Vec3d world = node->getBound().center();
+    if (_index.size() == 0) return;
 
-            if (cv->isCulled(*node))
-            {
-                continue;
-            }
+    const SpatialReference* mapSRS = _mapNode->getMapSRS();
 
-            if (!_horizon->isVisible(world))
-            {
-                continue;
-            }
+    // Pick the zoom level from the ground resolution under the camera.
+    osg::Vec3d eye, center, up;
+    camera->getViewMatrixAsLookAt(eye, center, up);
 
-            osg::Vec3d screen = world * mvpw;
+    GeoPoint eyeGeo;
+    eyeGeo.fromWorld(mapSRS, eye);
+    eyeGeo = eyeGeo.transform(mapSRS->getGeographicSRS());
 
-            if (screen.x() >= 0 && screen.x() <= viewport->width() &&
-                screen.y() >= 0 && screen.y() <= viewport->height())
-            {
-                validPlaces.push_back(node);
-                points.push_back(TPoint(screen.x(), screen.y()));
-            }
-        }
+    double fovy, aspect, znear, zfar;
+    double metersPerPixel;
+    if (camera->getProjectionMatrixAsPerspective(fovy, aspect, znear, zfar))
+    {
+        double distance = std::max(eyeGeo.z(), 1.0);
+        metersPerPixel = 2.0 * distance * tan(osg::DegreesToRadians(fovy * 0.5)) / viewport->height();
+    }
+    else
+    {
+        double left, right, bottom, top;
+        camera->getProjectionMatrixAsOrtho(left, right, bottom, top, znear, zfar);
+        metersPerPixel = (top - bottom) / viewport->height();
     }
 
-    if (validPlaces.size() == 0) return;
-
-    kdbush::KDBush<TPoint> index(points);
-    std::set< unsigned int > clustered;
+    int zoom = (int)floor(_index.getZoom(metersPerPixel, eyeGeo.y(), mapSRS->getEllipsoid().getRadiusEquator()));
 
-    for (unsigned int i = 0; i < validPlaces.size(); i++)
-    {
-        TPoint &screen = points[i];
-        osg::Node* node = validPlaces[i].get();
+    double west = -180.0, south = -90.0, east = 180.0, north = 90.0;
+    osg::Matrixd windowToWorld = osg::Matrixd::inverse(mvpw);
+    computeViewBounds(windowToWorld, *viewport, mapSRS, eye, west, south, east, north);
 
-        // If this thing is already part of a cluster then just continue.
-        if (clustered.find(i) != clustered.end())
-        {
-            continue;
-        }
+    std::vector<ClusterIndex::Result> results;
+    _index.query(west, south, east, north, zoom, results);
 
-        osg::Vec3d world = node->getBound().center();
+    std::vector<unsigned> leaves;
 
-        // Get any matching indices that are part of this cluster.
-        TIds indices;
+    const auto isVisible = [&](const osg::Vec3d& world)
+        {
+            if (!_horizon->isVisible(world))
+                return false;
 
-        index.range(screen.first - _radius, screen.second - _radius, screen.first + _radius, screen.second + _radius, indices);
+            osg::Vec3d screen = world * mvpw;
+            return
+                screen.x() >= 0 && screen.x() <= viewport->width() &&
+                screen.y() >= 0 && screen.y() <= viewport->height();
+        };
 
+    for (auto& result : results)
+    {
         // Create a new cluster.
         Cluster cluster;
 
-        unsigned int actualCount = 0;
+        if (result.count == 1)
+        {
+            if (_indexedNodes[result.id].valid())
+                cluster.nodes.push_back(_indexedNodes[result.id]);
+        }
+        else
+        {
+            leaves.clear();
+            _index.getLeaves(result, leaves);
+            cluster.nodes.reserve(leaves.size());
+            for (unsigned id : leaves)
+            {
+                if (_indexedNodes[id].valid())
+                    cluster.nodes.push_back(_indexedNodes[id]);
+            }
+        }
 
-        // Add all of the points to the cluster.
-        for (unsigned int j = 0; j < indices.size(); j++)
+        // A cluster is visible if any of its members is; its marker sits at
+        // the cluster centroid, at the height of the first visible member.
+        osg::Node* visibleMember = nullptr;
+        for (auto& node : cluster.nodes)
         {
-            if (clustered.find(indices[j]) == clustered.end())
+            if (isVisible(node->getBound().center()))
             {
-                if (_canClusterCallback.valid())
-                {
-                    bool canCluster = (*_canClusterCallback)(node, validPlaces[indices[j]].get());
-                    if (!canCluster) {
-                        continue;
-                    }
-                }
-                cluster.nodes.push_back(validPlaces[indices[j]]);
-                actualCount++;
-                clustered.insert(indices[j]);
+                visibleMember = node.get();
+                break;
             }
         }
 
+        if (!visibleMember)
+        {
+            continue;
+        }
+
+        GeoPoint markerPos;
+        markerPos.fromWorld(mapSRS, visibleMember->getBound().center());
+        if (cluster.nodes.size() > 1)
+        {
+            markerPos = markerPos.transform(mapSRS->getGeographicSRS());
+            markerPos.x() = result.lon;
+            markerPos.y() = result.lat;
+        }
+
         std::stringstream buf;
-        buf << actualCount << std::endl;
+        buf << cluster.nodes.size() << std::endl;
 
         PlaceNode* marker = getOrCreateLabel();
-        GeoPoint markerPos;
-        markerPos.fromWorld(_mapNode->getMapSRS(), world);
         marker->setPosition(markerPos);
         marker->setText(buf.str());
 
         cluster.marker = marker;
         out.push_back(cluster);
-
-        clustered.insert(i);
     }
 }
 
@@ -281,6 +846,9 @@ void ClusterNode::traverse(osg::NodeVisitor& nv)
         {
             if (_mapNode.valid())
             {
+                // re-cluster nodes that moved since they were indexed
+                updateMovedNodes();
+
                 const osg::Matrixd &currentViewMatrix = cv->getCurrentCamera()->getViewMatrix();
                 if (_lastViewMatrix != currentViewMatrix || _dirty)
                 {
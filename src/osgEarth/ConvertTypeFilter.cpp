@@ -3,6 +3,7 @@
  * MIT License
  */
 #include <osgEarth/ConvertTypeFilter>
+#include <algorithm>
 
 using namespace osgEarth;
 using namespace osgEarth::Util;
@@ -65,3 +66,160 @@ ConvertTypeFilter::push( FeatureList& input, FilterContext& context )
 
     return context;
 }
+
+FilterContext
+ConvertTypeFilter::pushBatch( FeatureBatch& input, FilterContext& context )
+{
+    if ( !isSupported() )
+    {
+        OE_WARN << "ConvertTypeFilter support not enabled" << std::endl;
+        return context;
+    }
+
+    const Geometry::Type toType = _toType.value();
+
+    if (toType == Geometry::TYPE_UNKNOWN)
+    {
+        return context;
+    }
+
+    if (toType != Geometry::TYPE_POINT &&
+        toType != Geometry::TYPE_POINTSET &&
+        toType != Geometry::TYPE_LINESTRING &&
+        toType != Geometry::TYPE_RING &&
+        toType != Geometry::TYPE_POLYGON)
+    {
+        return FeatureFilter::pushBatch(input, context);
+    }
+
+    using Part = FeatureBatch::Part;
+
+    const auto& src = input.getCoords();
+    const auto& parts = input.getParts();
+    const auto& offsets = input.getPartOffsets();
+
+    std::vector<osg::Vec3d> coords;
+    coords.reserve(src.size());
+    std::vector<Part> outParts;
+    outParts.reserve(parts.size());
+    std::vector<std::uint32_t> outOffsets;
+    outOffsets.reserve(offsets.size());
+    outOffsets.push_back(0u);
+    std::vector<std::int8_t> outTypes = input.getGeometryTypes();
+
+    // copies the coordinates of a part, and returns the index of the copy
+    auto copy = [&](const Part& part, Geometry::Type type, bool hole)
+        {
+            Part out = part;
+            out.begin = (std::uint32_t)coords.size();
+            coords.insert(coords.end(), src.begin() + part.begin, src.begin() + part.end);
+            out.end = (std::uint32_t)coords.size();
+            out.type = type;
+            out.hole = hole;
+            if (type != Geometry::TYPE_TRIMESH)
+                out.mesh = ~0u;
+            outParts.push_back(out);
+            return outParts.size() - 1;
+        };
+
+    // same as LineString::close() when cloning a ring as a line
+    auto closeLine = [&](std::size_t p)
+        {
+            Part& part = outParts[p];
+            if (part.end - part.begin > 1 && coords[part.begin] != coords[part.end - 1])
+            {
+                coords.push_back(coords[part.begin]);
+                ++part.end;
+            }
+        };
+
+    // same as Ring::open()
+    auto openRing = [&](std::size_t p)
+        {
+            Part& part = outParts[p];
+            while (part.end - part.begin > 2 && coords[part.begin] == coords[part.end - 1])
+            {
+                coords.pop_back();
+                --part.end;
+            }
+        };
+
+    for (std::size_t row = 0; row < input.size(); ++row)
+    {
+        std::uint32_t first = offsets[row], last = offsets[row + 1];
+
+        bool convert =
+            input.hasGeometry(row) &&
+            first < last &&
+            parts[first].type != toType;
+
+        if (!convert)
+        {
+            for (auto p = first; p < last; ++p)
+                copy(parts[p], parts[p].type, parts[p].hole);
+
+            // an empty geometry only changes its type
+            if (first == last && input.hasGeometry(row) && outTypes[row] != Geometry::TYPE_MULTI)
+                outTypes[row] = (std::int8_t)toType;
+        }
+        else
+        {
+            unsigned count = 0u;
+
+            for (auto p = first; p < last; ++p)
+            {
+                const Part& part = parts[p];
+
+                // holes go with the polygon before them
+                if (part.hole)
+                    continue;
+
+                if (part.type == Geometry::TYPE_POLYGON && toType == Geometry::TYPE_LINESTRING)
+                {
+                    closeLine(copy(part, Geometry::TYPE_LINESTRING, false));
+                    ++count;
+
+                    for (auto h = p + 1; h < last && parts[h].hole; ++h)
+                    {
+                        if (parts[h].end > parts[h].begin)
+                        {
+                            auto line = copy(parts[h], Geometry::TYPE_LINESTRING, false);
+                            closeLine(line);
+                            std::reverse(coords.begin() + outParts[line].begin, coords.begin() + outParts[line].end);
+                            ++count;
+                        }
+                    }
+                }
+                else if (part.type == Geometry::TYPE_POLYGON && toType == Geometry::TYPE_POLYGON)
+                {
+                    copy(part, part.type, false);
+                    for (auto h = p + 1; h < last && parts[h].hole; ++h)
+                        openRing(copy(parts[h], parts[h].type, true));
+                    ++count;
+                }
+                else if (part.type == Geometry::TYPE_RING && toType == Geometry::TYPE_LINESTRING)
+                {
+                    closeLine(copy(part, Geometry::TYPE_LINESTRING, false));
+                    ++count;
+                }
+                else
+                {
+                    auto out = copy(part, toType, false);
+                    if (toType == Geometry::TYPE_RING || toType == Geometry::TYPE_POLYGON)
+                        openRing(out);
+                    ++count;
+                }
+            }
+
+            outTypes[row] = (std::int8_t)(
+                outTypes[row] == Geometry::TYPE_MULTI || count > 1 ?
+                Geometry::TYPE_MULTI : toType);
+        }
+
+        outOffsets.push_back((std::uint32_t)outParts.size());
+    }
+
+    input.setGeometry(std::move(coords), std::move(outParts), std::move(outOffsets), std::move(outTypes));
+
+    return context;
+}
@@ -6,6 +6,7 @@
 #include <osgEarth/Progress>
 #include <osgEarth/MemCache>
 #include <osgEarth/Metrics>
+#include <osgEarth/MetricsRegistry>
 #include <osgEarth/NetworkMonitor>
 #include <osgEarth/Math>
 
@@ -355,6 +356,10 @@ ElevationLayer::createHeightField(const TileKey& key, ProgressCallback* progress
         return GeoHeightField::INVALID;
     }
 
+    static auto& latency = MetricsRegistry::instance().histogram(
+        "osgearth_layer_create_tile_seconds", "Layer tile creation time", { { "type", "elevation" } });
+    MetricsRegistry::ScopedTimer timer(latency);
+
     NetworkMonitor::ScopedRequestLayer layerRequest(getName());
 
     GeoHeightField result = createHeightFieldInKeyProfile(key, progress);
@@ -24,6 +24,7 @@ ElevationPool::ElevationPool() :
     _mapRevision(-1),
     _elevationHash(0)
 {
+    _L2.setMetricsName("elevationpool");
 }
 
 const SpatialReference*
@@ -291,6 +292,23 @@ ElevationPool::findExistingRaster(
     return output.valid();
 }
 
+osg::ref_ptr<ElevationTexture>
+ElevationPool::findResidentRaster(const Internal::RevElevationKey& key)
+{
+    osg::ref_ptr<ElevationTexture> result;
+    bool fromLUT;
+
+    Internal::RevElevationKey k = key;
+    for (TileKey tk = key.getTileKey(); tk.valid(); tk.makeParent())
+    {
+        k.setTileKey(tk);
+        if (findExistingRaster(k, result, &fromLUT))
+            break;
+    }
+
+    return result;
+}
+
 osg::ref_ptr<ElevationTexture>
 ElevationPool::getOrCreateRaster(
     const Internal::RevElevationKey& key,
@@ -311,7 +329,7 @@ ElevationPool::getOrCreateRaster(
     {
         // need to build NEW data for this key
         osg::ref_ptr<osg::HeightField> hf = HeightFieldUtils::createReferenceHeightField(
-            key._tilekey.getExtent(),
+            key.getTileKey().getExtent(),
             _tileSize, _tileSize,
             false,      // no border
             true);      // initialize to HAE (0.0) heights
@@ -326,7 +344,7 @@ ElevationPool::getOrCreateRaster(
             ws && !ws->_elevationLayers.empty() ? ws->_elevationLayers :
             _elevationLayers;
 
-        for (keyToUse = key._tilekey;
+        for (keyToUse = key.getTileKey();
             keyToUse.valid();
             keyToUse.makeParent())
         {
@@ -373,7 +391,7 @@ ElevationPool::getOrCreateRaster(
         // found it ... but if it's a lower res tile and we aren't accepting
         // those, discard it.
         if (acceptLowerRes == false &&
-            result->getTileKey() != key._tilekey)
+            result->getTileKey() != key.getTileKey())
         {
             return NULL;
         }
@@ -494,6 +512,32 @@ ElevationPool::prepareEnvelope(
     return true;
 }
 
+bool
+ElevationPool::prepareEnvelope(
+    ElevationPool::Envelope& env,
+    const TileKey& key,
+    WorkingSet* ws)
+{
+    if (!key.valid())
+        return false;
+
+    Distance resolution(
+        key.getExtent().width() / (double)(ELEVATION_TILE_SIZE - 1),
+        key.getExtent().getSRS()->getUnits());
+
+    if (!prepareEnvelope(env, key.getExtent().getCentroid(), resolution, ws))
+        return false;
+
+    // no finer than the tile itself
+    if (env._lod > (int)key.getLOD() && key.getProfile()->isHorizEquivalentTo(env._profile.get()))
+    {
+        env._lod = key.getLOD();
+        env._profile->getNumTiles(env._lod, env._tw, env._th);
+    }
+
+    return true;
+}
+
 int
 ElevationPool::Envelope::sampleMapCoords(
     std::vector<osg::Vec3d>::iterator begin,
@@ -538,25 +582,27 @@ ElevationPool::Envelope::sampleMapCoords(
 
             if (lod != lod_prev || tx != tx_prev || ty != ty_prev)
             {
-                _key._tilekey = TileKey(lod, tx, ty, _profile.get());
+                _key.setTileKey(lod, tx, ty, _profile.get());
                 lod_prev = lod;
                 tx_prev = tx;
                 ty_prev = ty;
             }
         }
 
-        if (_key._tilekey.valid())
+        if (_key.valid())
         {
             auto iter = _cache.find(_key);
 
             if (iter == _cache.end())
             {
-                _raster = _pool->getOrCreateRaster(
-                    _key,   // key to query
-                    _map.get(), // map to query
-                    true,  // fall back on lower resolution data if necessary
-                    _ws,    // user's workingset
-                    progress);
+                _raster = _residentOnly ?
+                    _pool->findResidentRaster(_key) :
+                    _pool->getOrCreateRaster(
+                        _key,   // key to query
+                        _map.get(), // map to query
+                        true,  // fall back on lower resolution data if necessary
+                        _ws,    // user's workingset
+                        progress);
 
                 // bail on cancelation before using the quickcache
                 if (progress && progress->isCanceled())
@@ -688,14 +734,14 @@ ElevationPool::sampleMapCoords(
 
             if (lod != lod_prev || tx != tx_prev || ty != ty_prev)
             {
-                key._tilekey = TileKey(lod, tx, ty, profile);
+                key.setTileKey(lod, tx, ty, profile);
                 lod_prev = lod;
                 tx_prev = tx;
                 ty_prev = ty;
             }
         }
 
-        if (key._tilekey.valid())
+        if (key.valid())
         {
             auto iter = quickCache.find(key);
 
@@ -839,14 +885,14 @@ ElevationPool::sampleMapCoords(
 
             if (lod != lod_prev || tx != tx_prev || ty != ty_prev)
             {
-                key._tilekey = TileKey(lod, tx, ty, profile);
+                key.setTileKey(lod, tx, ty, profile);
                 lod_prev = lod;
                 tx_prev = tx;
                 ty_prev = ty;
             }
         }
 
-        if (key._tilekey.valid())
+        if (key.valid())
         {
             auto iter = quickCache.find(key);
 
@@ -931,7 +977,7 @@ ElevationPool::getSample(
 
     if (lod >= 0)
     {
-        key._tilekey = map->getProfile()->createTileKey(p.x(), p.y(), lod);
+        key.setTileKey(map->getProfile()->createTileKey(p.x(), p.y(), lod));
         key._revision = getElevationHash(ws);
 
         osg::ref_ptr<ElevationTexture> raster = getOrCreateRaster(
@@ -1034,7 +1080,7 @@ ElevationPool::getTile(
     ScopedReadLock lk(_mutex);
 
     Internal::RevElevationKey key;
-    key._tilekey = tilekey;
+    key.setTileKey(tilekey);
     key._revision = getElevationHash(ws);
 
     out_tex = getOrCreateRaster(
@@ -230,6 +230,27 @@ NumericExpression::init()
         _rpn.push_back(s.top());
         s.pop();
     }
+
+    // resolve the attribute keys once so evaluators don't have to:
+    _keys.clear();
+    _keys.reserve(_vars.size());
+    for (auto& var : _vars)
+        _keys.emplace_back(var.first);
+
+    // the deepest the evaluation stack will get, so eval() can use a fixed buffer:
+    _maxDepth = 0u;
+    unsigned depth = 0u;
+    for (auto& a : _rpn)
+    {
+        if (IS_OPERATOR(a) || a.first == MIN || a.first == MAX)
+        {
+            if (depth >= 2) --depth;
+        }
+        else
+        {
+            _maxDepth = std::max(_maxDepth, ++depth);
+        }
+    }
 }
 
 void
@@ -248,82 +269,10 @@ NumericExpression::eval() const
 {
     if (_dirty)
     {
-        std::stack<double> s;
-
-        for (unsigned i = 0; i < _rpn.size(); ++i)
-        {
-            const Atom& a = _rpn[i];
-
-            if (a.first == ADD)
-            {
-                if (s.size() >= 2)
-                {
-                    double op2 = s.top(); s.pop();
-                    double op1 = s.top(); s.pop();
-                    s.push(op1 + op2);
-                }
-            }
-            else if (a.first == SUB)
-            {
-                if (s.size() >= 2)
-                {
-                    double op2 = s.top(); s.pop();
-                    double op1 = s.top(); s.pop();
-                    s.push(op1 - op2);
-                }
-            }
-            else if (a.first == MULT)
-            {
-                if (s.size() >= 2)
-                {
-                    double op2 = s.top(); s.pop();
-                    double op1 = s.top(); s.pop();
-                    s.push(op1 * op2);
-                }
-            }
-            else if (a.first == DIV)
-            {
-                if (s.size() >= 2)
-                {
-                    double op2 = s.top(); s.pop();
-                    double op1 = s.top(); s.pop();
-                    s.push(op1 / op2);
-                }
-            }
-            else if (a.first == MOD)
-            {
-                if (s.size() >= 2)
-                {
-                    double op2 = s.top(); s.pop();
-                    double op1 = s.top(); s.pop();
-                    s.push(fmod(op1, op2));
-                }
-            }
-            else if (a.first == MIN)
-            {
-                if (s.size() >= 2)
-                {
-                    double op2 = s.top(); s.pop();
-                    double op1 = s.top(); s.pop();
-                    s.push(osg::minimum(op1, op2));
-                }
-            }
-            else if (a.first == MAX)
-            {
-                if (s.size() >= 2)
-                {
-                    double op2 = s.top(); s.pop();
-                    double op1 = s.top(); s.pop();
-                    s.push(osg::maximum(op1, op2));
-                }
-            }
-            else // OPERAND or VARIABLE
-            {
-                s.push(a.second);
-            }
-        }
+        // variable values live in the RPN atoms themselves (see set)
+        const_cast<NumericExpression*>(this)->_value = eval(
+            [this](unsigned i) { return _rpn[_vars[i].second].second; });
 
-        const_cast<NumericExpression*>(this)->_value = s.size() > 0 ? s.top() : 0.0;
         const_cast<NumericExpression*>(this)->_dirty = false;
     }
 
@@ -471,6 +420,11 @@ StringExpression::init()
             _infix.push_back(Atom(VARIABLE, val));
         }
     }
+
+    _keys.clear();
+    _keys.reserve(_vars.size());
+    for (auto& var : _vars)
+        _keys.emplace_back(var.first);
 }
 
 void
@@ -4,6 +4,7 @@
  */
 #include <osgEarth/ExtrudeGeometryFilter>
 #include <osgEarth/Session>
+#include <osgEarth/FeatureExpression>
 #include <osgEarth/FeatureSourceIndexNode>
 #include <osgEarth/StyleSheet>
 #include <osgEarth/Clamping>
@@ -23,6 +24,9 @@ using namespace osgEarth;
 
 namespace
 {
+    // Z offset attribute written by the AltitudeFilter for GPU clamping
+    const AttributeKey VERTICAL_OFFSET("__oe_verticalOffset");
+
     // Calculates the rotation angle of a shape. This conanically applies to
     // buildings; it finds the longest edge and compares its angle to the
     // x-axis to determine a rotation value. This method is used so we can 
@@ -1147,6 +1151,17 @@ ExtrudeGeometryFilter::addDrawable(osg::Drawable*       drawable,
 bool
 ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
 {
+    // compile the per-feature expressions once for the whole batch:
+    const Feature* prototype = features.empty() ? nullptr : features.front().get();
+
+    CompiledNumericExpression heightExpr;
+    if (_heightExpr.isSet())
+        heightExpr = CompiledNumericExpression(_heightExpr.get(), prototype);
+
+    CompiledStringExpression featureNameExpr;
+    if (!_featureNameExpr.empty())
+        featureNameExpr = CompiledStringExpression(_featureNameExpr, prototype);
+
     for( FeatureList::iterator f = features.begin(); f != features.end(); ++f )
     {
         Feature* input = f->get();
@@ -1188,7 +1203,7 @@ ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
             }
             else if (_heightExpr.isSet())
             {
-                height = input->eval(_heightExpr.mutable_value(), &context);
+                height = heightExpr.eval(input, &context);
             }
             else
             {
@@ -1198,7 +1213,7 @@ ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
             // Set up for feature naming and feature indexing:
             std::string name;
             if (!_featureNameExpr.empty())
-                name = input->eval(_featureNameExpr, &context);
+                featureNameExpr.eval(input, &context, name);
 
             osg::ref_ptr<osg::StateSet> wallStateSet;
             osg::ref_ptr<osg::StateSet> roofStateSet;
@@ -1312,7 +1327,7 @@ ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
                 }
             }
 
-            float verticalOffset = (float)input->getDouble("__oe_verticalOffset", 0.0);
+            float verticalOffset = (float)input->getDouble(VERTICAL_OFFSET, 0.0);
 
             // modify our values based on the directionality.
             double heightOffset = 0.0;
@@ -1391,10 +1406,14 @@ ExtrudeGeometryFilter::process( FeatureList& features, FilterContext& context )
 
             if ( baselines.valid() )
             {
-                osgUtil::Tessellator tess;
-                tess.setTessellationType( osgUtil::Tessellator::TESS_TYPE_GEOMETRY );
-                tess.setWindingType( osgUtil::Tessellator::TESS_WINDING_ODD );
-                tess.retessellatePolygons( *(baselines.get()) );
+                osgEarth::Tessellator oeTess;
+                if (!oeTess.tessellateGeometry(*baselines))
+                {
+                    osgUtil::Tessellator tess;
+                    tess.setTessellationType( osgUtil::Tessellator::TESS_TYPE_GEOMETRY );
+                    tess.setWindingType( osgUtil::Tessellator::TESS_WINDING_ODD );
+                    tess.retessellatePolygons( *(baselines.get()) );
+                }
             }        
         }
     }
@@ -198,260 +198,286 @@ Feature::getOrCreateStyle()
 }
 
 void
-Feature::set(const std::string& name, const std::string& value)
+Feature::set(const AttributeKey& name, const std::string& value)
 {
-    _attrs[toLower(name)].emplace<std::string>(value);
+    _attrs[name].emplace<std::string>(value);
 }
 
 void
-Feature::set(const std::string& name, double value)
+Feature::set(const AttributeKey& name, double value)
 {
-    _attrs[toLower(name)].emplace<double>(value);
+    _attrs[name].emplace<double>(value);
 }
 
 void
-Feature::set(const std::string& name, long long value)
+Feature::set(const AttributeKey& name, long long value)
 {
-    _attrs[toLower(name)].emplace<long long>(value);
+    _attrs[name].emplace<long long>(value);
 }
 
 void
-Feature::set(const std::string& name, int value)
+Feature::set(const AttributeKey& name, int value)
 {
-    _attrs[toLower(name)].emplace<long long>(static_cast<long long>(value));
+    _attrs[name].emplace<long long>(static_cast<long long>(value));
 }
 
 void
-Feature::set(const std::string& name, bool value)
+Feature::set(const AttributeKey& name, bool value)
 {
-    _attrs[toLower(name)].emplace<bool>(value);
+    _attrs[name].emplace<bool>(value);
 }
 
 void
-Feature::set(const std::string& name, const AttributeValue& value)
+Feature::set(const AttributeKey& name, const AttributeValue& value)
 {
-    _attrs[toLower(name)] = value;
+    _attrs[name] = value;
 }
 
 void
-Feature::setNull(const std::string& name)
+Feature::setNull(const AttributeKey& name)
 {
-    _attrs[toLower(name)].emplace<std::monostate>();
+    _attrs[name].emplace<std::monostate>();
 }
 
 void
-Feature::removeAttribute(const std::string& name)
+Feature::removeAttribute(const AttributeKey& name)
 {
-    _attrs.erase(toLower(name));
+    _attrs.erase(name);
+}
+
+void
+Feature::removeAttribute(std::string_view name)
+{
+    AttributeKey key = AttributeKey::find(name);
+    if (key.valid())
+        removeAttribute(key);
 }
 
 bool
-Feature::hasAttr( const std::string& name ) const
+Feature::hasAttr(const AttributeKey& name) const
 {
-    return _attrs.find(toLower(name)) != _attrs.end();
+    return _attrs.indexOf(name) >= 0;
+}
+
+bool
+Feature::hasAttr(std::string_view name) const
+{
+    AttributeKey key = AttributeKey::find(name);
+    return key.valid() && hasAttr(key);
 }
 
 std::string
-Feature::getString( const std::string& name ) const
+Feature::getString(const AttributeKey& name) const
 {
-    auto i = _attrs.find(toLower(name));
+    auto i = _attrs.find(name);
     return i != _attrs.end()? i->second.getString() : EMPTY_STRING;
 }
 
+std::string
+Feature::getString(std::string_view name) const
+{
+    AttributeKey key = AttributeKey::find(name);
+    return key.valid() ? getString(key) : EMPTY_STRING;
+}
+
 double
-Feature::getDouble( const std::string& name, double defaultValue ) const
+Feature::getDouble(const AttributeKey& name, double defaultValue) const
 {
-    auto i = _attrs.find(toLower(name));
+    auto i = _attrs.find(name);
     return i != _attrs.end()? i->second.getDouble(defaultValue) : defaultValue;
 }
 
+double
+Feature::getDouble(std::string_view name, double defaultValue) const
+{
+    AttributeKey key = AttributeKey::find(name);
+    return key.valid() ? getDouble(key, defaultValue) : defaultValue;
+}
+
 long long
-Feature::getInt( const std::string& name, long long defaultValue ) const
+Feature::getInt(const AttributeKey& name, long long defaultValue) const
 {
-    auto i = _attrs.find(toLower(name));
+    auto i = _attrs.find(name);
     return i != _attrs.end()? i->second.getInt(defaultValue) : defaultValue;
 }
 
+long long
+Feature::getInt(std::string_view name, long long defaultValue) const
+{
+    AttributeKey key = AttributeKey::find(name);
+    return key.valid() ? getInt(key, defaultValue) : defaultValue;
+}
+
 bool
-Feature::getBool( const std::string& name, bool defaultValue ) const
+Feature::getBool(const AttributeKey& name, bool defaultValue) const
 {
-    auto i = _attrs.find(toLower(name));
+    auto i = _attrs.find(name);
     return i != _attrs.end()? i->second.getBool(defaultValue) : defaultValue;
 }
 
 bool
-Feature::isSet(const std::string& name) const
+Feature::getBool(std::string_view name, bool defaultValue) const
+{
+    AttributeKey key = AttributeKey::find(name);
+    return key.valid() ? getBool(key, defaultValue) : defaultValue;
+}
+
+bool
+Feature::isSet(const AttributeKey& name) const
 {
-    auto i = _attrs.find(toLower(name));
+    auto i = _attrs.find(name);
     return i != _attrs.end() ? i->second.getType() != ATTRTYPE_UNSPECIFIED : false;
 }
 
-double
-Feature::eval(const NumericExpression& expr, FilterContext const* context) const
+bool
+Feature::isSet(std::string_view name) const
 {
-    NumericExpression temp(expr);
-    return eval(temp, context);
+    AttributeKey key = AttributeKey::find(name);
+    return key.valid() ? isSet(key) : false;
 }
 
-double
-Feature::eval( NumericExpression& expr, FilterContext const* context ) const
+namespace
 {
-    const NumericExpression::Variables& vars = expr.variables();
-    for (NumericExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i)
+    // Resolves variable "i" of a numeric expression against a feature's attributes,
+    // falling back on the script engine (if there is one) for non-attribute variables.
+    inline double resolveNumeric(
+        const NumericExpression& expr, unsigned i,
+        const Feature* feature, ScriptEngine* engine, const FilterContext* context)
     {
-        double val = 0.0;
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
+        auto& attrs = feature->getAttrs();
+        auto ai = attrs.find(expr.variableKeys()[i]);
+        if (ai != attrs.end())
         {
-            val = ai->second.getDouble(0.0);
+            return ai->second.getDouble(0.0);
         }
-        else if (context && context->getSession())
+        else if (engine)
         {
-            //No attr found, look for script
-            ScriptEngine* engine = context->getSession()->getScriptEngine();
-            if (engine)
-            {
-                ScriptResult result = engine->run(i->first, this, context);
-                if (result.success())
-                    val = result.asDouble();
-                else {
-                    OE_WARN << LC << "Feature Script error on '" << expr.expr() << "': " << result.message() << std::endl;
-                }
-            }
+            ScriptResult result = engine->run(expr.variables()[i].first, feature, context);
+            if (result.success())
+                return result.asDouble();
+            else
+                OE_WARN << LC << "Feature Script error on '" << expr.expr() << "': " << result.message() << std::endl;
+        }
+        return 0.0;
+    }
+
+    // Resolves variable "i" of a string expression and appends it to "out".
+    inline void resolveString(
+        const StringExpression& expr, unsigned i, std::string& out,
+        const Feature* feature, ScriptEngine* engine, const FilterContext* context)
+    {
+        auto& attrs = feature->getAttrs();
+        auto ai = attrs.find(expr.variableKeys()[i]);
+        if (ai != attrs.end())
+        {
+            if (ai->second.is<std::string>())
+                out.append(ai->second.get<std::string>());
+            else
+                out.append(ai->second.getString());
+        }
+        else if (engine)
+        {
+            ScriptResult result = engine->run(expr.variables()[i].first, feature, context);
+            if (result.success())
+                out.append(result.asString());
+            else
+                // Couldn't execute it as code, just take it as a string literal.
+                out.append(expr.variables()[i].first);
         }
+    }
 
-        expr.set(*i, val);
+    inline ScriptEngine* getScriptEngine(const FilterContext* context)
+    {
+        return context && context->getSession() ? context->getSession()->getScriptEngine() : nullptr;
     }
 
+    inline ScriptEngine* getScriptEngine(Session* session)
+    {
+        return session ? session->getScriptEngine() : nullptr;
+    }
+}
+
+double
+Feature::eval(const NumericExpression& expr, FilterContext const* context) const
+{
+    ScriptEngine* engine = getScriptEngine(context);
+    double value = expr.eval([&](unsigned i) { return resolveNumeric(expr, i, this, engine, context); });
+    return !osg::isNaN(value) ? value : 0.0;
+}
+
+double
+Feature::eval( NumericExpression& expr, FilterContext const* context ) const
+{
+    ScriptEngine* engine = getScriptEngine(context);
+    for (unsigned i = 0; i < expr.variables().size(); ++i)
+    {
+        expr.set(expr.variables()[i], resolveNumeric(expr, i, this, engine, context));
+    }
     return expr.eval();
 }
 
 double
 Feature::eval(const NumericExpression& expr, Session* session) const
 {
-    NumericExpression temp(expr);
-    return eval(temp, session);
+    ScriptEngine* engine = getScriptEngine(session);
+    double value = expr.eval([&](unsigned i) { return resolveNumeric(expr, i, this, engine, nullptr); });
+    return !osg::isNaN(value) ? value : 0.0;
 }
 
 double
 Feature::eval(NumericExpression& expr, Session* session) const
 {
-    const NumericExpression::Variables& vars = expr.variables();
-    for( NumericExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i )
+    ScriptEngine* engine = getScriptEngine(session);
+    for (unsigned i = 0; i < expr.variables().size(); ++i)
     {
-        double val = 0.0;
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
-        {
-            val = ai->second.getDouble(0.0);
-        }
-        else if (session)
-        {
-            //No attr found, look for script
-            ScriptEngine* engine = session->getScriptEngine();
-            if (engine)
-            {
-                ScriptResult result = engine->run(i->first, this);
-                if (result.success())
-                {
-                    val = result.asDouble();
-                }
-                else
-                {
-                    OE_WARN << LC << "Feature Script error on '" << expr.expr() << "': " << result.message() << std::endl;
-                }
-            }
-        }
-
-        expr.set( *i, val );
+        expr.set(expr.variables()[i], resolveNumeric(expr, i, this, engine, nullptr));
     }
-
     return expr.eval();
 }
 
 std::string
 Feature::eval(const StringExpression& expr, FilterContext const* context) const
 {
-    StringExpression temp(expr);
-    return eval(temp, context);
+    ScriptEngine* engine = getScriptEngine(context);
+    std::string result;
+    expr.eval([&](unsigned i, std::string& out) { resolveString(expr, i, out, this, engine, context); }, result);
+    return result;
 }
 
 const std::string&
 Feature::eval(StringExpression& expr, FilterContext const* context) const
 {
-    const StringExpression::Variables& vars = expr.variables();
-    for (StringExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i)
+    ScriptEngine* engine = getScriptEngine(context);
+    std::string val;
+    for (unsigned i = 0; i < expr.variables().size(); ++i)
     {
-        std::string val = "";
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
-        {
-            val = ai->second.getString();
-        }
-        else if (context && context->getSession())
-        {
-            //No attr found, look for script
-            ScriptEngine* engine = context->getSession()->getScriptEngine();
-            if (engine)
-            {
-                ScriptResult result = engine->run(i->first, this, context);
-                if (result.success())
-                    val = result.asString();
-                else
-                {
-                    // Couldn't execute it as code, just take it as a string literal.
-                    val = i->first;
-                    //OE_DEBUG << LC << "Feature Script error on '" << expr.expr() << "': " << result.message() << std::endl;
-                }
-            }
-        }
-
-        expr.set(*i, val);
+        val.clear();
+        resolveString(expr, i, val, this, engine, context);
+        expr.set(expr.variables()[i], val);
     }
-
     return expr.eval();
 }
 
 std::string
 Feature::eval(const StringExpression& expr, Session* session) const
 {
-    StringExpression temp(expr);
-    return eval(temp, session);
+    ScriptEngine* engine = getScriptEngine(session);
+    std::string result;
+    expr.eval([&](unsigned i, std::string& out) { resolveString(expr, i, out, this, engine, nullptr); }, result);
+    return result;
 }
 
 const std::string&
 Feature::eval(StringExpression& expr, Session* session) const
 {
-    const StringExpression::Variables& vars = expr.variables();
-    for( StringExpression::Variables::const_iterator i = vars.begin(); i != vars.end(); ++i )
+    ScriptEngine* engine = getScriptEngine(session);
+    std::string val;
+    for (unsigned i = 0; i < expr.variables().size(); ++i)
     {
-        std::string val = "";
-        AttributeTable::const_iterator ai = _attrs.find(toLower(i->first));
-        if (ai != _attrs.end())
-        {
-            val = ai->second.getString();
-        }
-        else if (session)
-        {
-            //No attr found, look for script
-            ScriptEngine* engine = session->getScriptEngine();
-            if (engine)
-            {
-                ScriptResult result = engine->run(i->first, this);
-                if (result.success())
-                    val = result.asString();
-                else
-                {
-                    // Couldn't execute it as code, just take it as a string literal.
-                    val = i->first;
-                    //OE_DEBUG << LC << "Feature Script error on '" << expr.expr() << "': " << result.message() << std::endl;
-                }
-            }
-        }
-
-        expr.set( *i, val );
+        val.clear();
+        resolveString(expr, i, val, this, engine, nullptr);
+        expr.set(expr.variables()[i], val);
     }
-
     return expr.eval();
 }
 
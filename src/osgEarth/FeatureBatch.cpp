@@ -0,0 +1,541 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/FeatureBatch>
+#include <osgEarth/StringUtils>
+
+#define LC "[FeatureBatch] "
+
+using namespace osgEarth;
+
+namespace
+{
+    Geometry* createSimpleGeometry(Geometry::Type type, int capacity)
+    {
+        switch (type)
+        {
+        case Geometry::TYPE_POINT: return new Point(capacity);
+        case Geometry::TYPE_POINTSET: return new PointSet(capacity);
+        case Geometry::TYPE_LINESTRING: return new LineString(capacity);
+        case Geometry::TYPE_RING: return new Ring(capacity);
+        case Geometry::TYPE_POLYGON: return new Polygon(capacity);
+        case Geometry::TYPE_TRIMESH: return new TriMesh();
+        default: return new Geometry();
+        }
+    }
+}
+
+//........................................................................
+
+AttributeValue
+FeatureBatch::Column::get(std::size_t row) const
+{
+    AttributeValue value;
+    if (state[row] != STATE_SET)
+        return value;
+
+    if (mixed)
+        return values[row];
+
+    switch (type)
+    {
+    case ATTRTYPE_STRING: value.emplace<std::string>(strings[row]); break;
+    case ATTRTYPE_DOUBLE: value.emplace<double>(doubles[row]); break;
+    case ATTRTYPE_INT: value.emplace<long long>(ints[row]); break;
+    case ATTRTYPE_BOOL: value.emplace<bool>(ints[row] != 0); break;
+    default: break;
+    }
+    return value;
+}
+
+void
+FeatureBatch::Column::set(std::size_t row, const AttributeValue& value)
+{
+    AttributeType valueType = value.getType();
+    if (valueType == ATTRTYPE_UNSPECIFIED)
+    {
+        setNull(row);
+        return;
+    }
+
+    if (!mixed && type == ATTRTYPE_UNSPECIFIED)
+    {
+        type = valueType;
+        resize(state.size());
+    }
+
+    if (!mixed && type != valueType)
+    {
+        makeMixed();
+    }
+
+    if (mixed)
+    {
+        values[row] = value;
+    }
+    else switch (type)
+    {
+    case ATTRTYPE_STRING: strings[row] = value.get<std::string>(); break;
+    case ATTRTYPE_DOUBLE: doubles[row] = value.get<double>(); break;
+    case ATTRTYPE_INT: ints[row] = value.get<long long>(); break;
+    case ATTRTYPE_BOOL: ints[row] = value.get<bool>() ? 1 : 0; break;
+    default: break;
+    }
+
+    state[row] = STATE_SET;
+}
+
+void
+FeatureBatch::Column::set(std::size_t row, double value)
+{
+    if (!mixed && type == ATTRTYPE_DOUBLE)
+    {
+        doubles[row] = value;
+        state[row] = STATE_SET;
+    }
+    else
+    {
+        AttributeValue temp;
+        temp.emplace<double>(value);
+        set(row, temp);
+    }
+}
+
+void
+FeatureBatch::Column::set(std::size_t row, long long value)
+{
+    if (!mixed && type == ATTRTYPE_INT)
+    {
+        ints[row] = value;
+        state[row] = STATE_SET;
+    }
+    else
+    {
+        AttributeValue temp;
+        temp.emplace<long long>(value);
+        set(row, temp);
+    }
+}
+
+void
+FeatureBatch::Column::setNull(std::size_t row)
+{
+    state[row] = STATE_NULL;
+}
+
+void
+FeatureBatch::Column::resize(std::size_t rows)
+{
+    state.resize(rows, STATE_ABSENT);
+
+    if (mixed)
+    {
+        values.resize(rows);
+    }
+    else switch (type)
+    {
+    case ATTRTYPE_STRING: strings.resize(rows); break;
+    case ATTRTYPE_DOUBLE: doubles.resize(rows, 0.0); break;
+    case ATTRTYPE_INT:
+    case ATTRTYPE_BOOL: ints.resize(rows, 0); break;
+    default: break;
+    }
+}
+
+void
+FeatureBatch::Column::makeMixed()
+{
+    values.resize(state.size());
+    for (std::size_t row = 0; row < state.size(); ++row)
+    {
+        if (state[row] == STATE_SET)
+            values[row] = get(row);
+    }
+
+    mixed = true;
+    type = ATTRTYPE_UNSPECIFIED;
+    strings.clear();
+    doubles.clear();
+    ints.clear();
+}
+
+//........................................................................
+
+const osg::Vec3d*
+FeatureBatch::Row::begin() const
+{
+    auto& parts = _batch._parts;
+    auto first = _batch._partOffsets[_index], last = _batch._partOffsets[_index + 1];
+    return _batch._coords.data() + (first < last ? parts[first].begin : 0u);
+}
+
+const osg::Vec3d*
+FeatureBatch::Row::end() const
+{
+    auto& parts = _batch._parts;
+    auto first = _batch._partOffsets[_index], last = _batch._partOffsets[_index + 1];
+    return _batch._coords.data() + (first < last ? parts[last - 1].end : 0u);
+}
+
+const FeatureBatch::Column*
+FeatureBatch::Row::column(const std::string& name) const
+{
+    int index = _batch.indexOf(name);
+    if (index < 0)
+        return nullptr;
+    const Column& c = _batch._columns[index];
+    return c.state[_index] != STATE_ABSENT ? &c : nullptr;
+}
+
+bool
+FeatureBatch::Row::hasAttr(const std::string& name) const
+{
+    return column(name) != nullptr;
+}
+
+bool
+FeatureBatch::Row::isSet(const std::string& name) const
+{
+    const Column* c = column(name);
+    return c && c->state[_index] == STATE_SET;
+}
+
+std::string
+FeatureBatch::Row::getString(const std::string& name) const
+{
+    const Column* c = column(name);
+    if (c && !c->mixed && c->type == ATTRTYPE_STRING)
+        return c->state[_index] == STATE_SET ? c->strings[_index] : std::string();
+    return c ? c->get(_index).getString() : std::string();
+}
+
+double
+FeatureBatch::Row::getDouble(const std::string& name, double defaultValue) const
+{
+    const Column* c = column(name);
+    if (c && !c->mixed && c->type == ATTRTYPE_DOUBLE && c->state[_index] == STATE_SET)
+        return c->doubles[_index];
+    return c ? c->get(_index).getDouble(defaultValue) : defaultValue;
+}
+
+long long
+FeatureBatch::Row::getInt(const std::string& name, long long defaultValue) const
+{
+    const Column* c = column(name);
+    if (c && !c->mixed && c->type == ATTRTYPE_INT && c->state[_index] == STATE_SET)
+        return c->ints[_index];
+    return c ? c->get(_index).getInt(defaultValue) : defaultValue;
+}
+
+bool
+FeatureBatch::Row::getBool(const std::string& name, bool defaultValue) const
+{
+    const Column* c = column(name);
+    return c ? c->get(_index).getBool(defaultValue) : defaultValue;
+}
+
+//........................................................................
+
+FeatureBatch*
+FeatureBatch::create(const FeatureList& features)
+{
+    FeatureBatch* batch = new FeatureBatch();
+    batch->assign(features);
+    return batch;
+}
+
+void
+FeatureBatch::assign(const FeatureList& features)
+{
+    clear();
+
+    std::size_t numCoords = 0;
+    for (auto& feature : features)
+        if (feature.valid() && feature->getGeometry())
+            numCoords += feature->getGeometry()->getTotalPointCount();
+
+    _fids.reserve(features.size());
+    _types.reserve(features.size());
+    _interps.reserve(features.size());
+    _partOffsets.reserve(features.size() + 1);
+    _coords.reserve(numCoords);
+
+    for (auto& feature : features)
+        append(feature.get());
+}
+
+void
+FeatureBatch::clear()
+{
+    _srs = nullptr;
+    _fids.clear();
+    _types.clear();
+    _partOffsets.assign(1, 0u);
+    _parts.clear();
+    _coords.clear();
+    _interps.clear();
+    _styles.clear();
+    _rowSRS.clear();
+    _meshIndices.clear();
+    _columns.clear();
+    _columnIndex.clear();
+}
+
+void
+FeatureBatch::appendGeometry(const Geometry* geom)
+{
+    if (geom->getType() == Geometry::TYPE_MULTI)
+    {
+        for (auto& part : static_cast<const MultiGeometry*>(geom)->getComponents())
+            if (part.valid())
+                appendGeometry(part.get());
+        return;
+    }
+
+    Part part;
+    part.begin = (std::uint32_t)_coords.size();
+    _coords.insert(_coords.end(), geom->begin(), geom->end());
+    part.end = (std::uint32_t)_coords.size();
+    part.type = geom->getType();
+
+    if (geom->getType() == Geometry::TYPE_TRIMESH)
+    {
+        part.mesh = (std::uint32_t)_meshIndices.size();
+        _meshIndices.push_back(static_cast<const TriMesh*>(geom)->_indices);
+    }
+
+    _parts.push_back(part);
+
+    if (geom->getType() == Geometry::TYPE_POLYGON)
+    {
+        for (auto& hole : static_cast<const Polygon*>(geom)->getHoles())
+        {
+            if (!hole.valid())
+                continue;
+            Part holePart;
+            holePart.begin = (std::uint32_t)_coords.size();
+            _coords.insert(_coords.end(), hole->begin(), hole->end());
+            holePart.end = (std::uint32_t)_coords.size();
+            holePart.type = Geometry::TYPE_RING;
+            holePart.hole = true;
+            _parts.push_back(holePart);
+        }
+    }
+}
+
+bool
+FeatureBatch::append(const Feature* feature)
+{
+    if (!feature)
+        return false;
+
+    std::uint32_t row = (std::uint32_t)_fids.size();
+
+    if (row == 0 && _rowSRS.empty())
+    {
+        _srs = feature->getSRS();
+    }
+    else if (feature->getSRS() != _srs.get() &&
+        (!feature->getSRS() || !_srs.valid() || !feature->getSRS()->isEquivalentTo(_srs.get())))
+    {
+        _rowSRS[row] = feature->getSRS();
+    }
+
+    const Geometry* geom = feature->getGeometry();
+    if (geom)
+    {
+        appendGeometry(geom);
+        _types.push_back((std::int8_t)geom->getType());
+    }
+    else
+    {
+        _types.push_back(-1);
+    }
+
+    _partOffsets.push_back((std::uint32_t)_parts.size());
+    _fids.push_back(feature->getFID());
+    _interps.push_back(feature->geoInterp());
+    if (feature->getStyle())
+        _styles[row] = *feature->getStyle();
+
+    for (auto& column : _columns)
+        column.resize(row + 1);
+
+    for (auto& attr : feature->getAttrs())
+    {
+        Column* column;
+        auto i = _columnIndex.find(attr.first);
+        if (i != _columnIndex.end())
+        {
+            column = &_columns[i->second];
+        }
+        else
+        {
+            column = &getOrCreateColumn(attr.first);
+        }
+
+        if (attr.second.getType() == ATTRTYPE_UNSPECIFIED)
+            column->setNull(row);
+        else
+            column->set(row, attr.second);
+    }
+
+    return true;
+}
+
+const SpatialReference*
+FeatureBatch::getSRS(std::size_t row) const
+{
+    if (!_rowSRS.empty())
+    {
+        auto i = _rowSRS.find((std::uint32_t)row);
+        if (i != _rowSRS.end())
+            return i->second.get();
+    }
+    return _srs.get();
+}
+
+int
+FeatureBatch::indexOf(const std::string& name) const
+{
+    auto i = _columnIndex.find(name);
+    if (i == _columnIndex.end())
+        i = _columnIndex.find(Util::toLower(name));
+    return i != _columnIndex.end() ? i->second : -1;
+}
+
+FeatureBatch::Column&
+FeatureBatch::getOrCreateColumn(const std::string& name)
+{
+    std::string key = Util::toLower(name);
+    auto i = _columnIndex.find(key);
+    if (i != _columnIndex.end())
+        return _columns[i->second];
+
+    _columnIndex[key] = (int)_columns.size();
+    _columns.emplace_back();
+    Column& column = _columns.back();
+    column.name = key;
+    column.key = AttributeKey(key);
+    column.resize(size());
+    return column;
+}
+
+Bounds
+FeatureBatch::getBounds(std::size_t row) const
+{
+    Bounds bounds;
+    for (auto p = _partOffsets[row]; p < _partOffsets[row + 1]; ++p)
+    {
+        const Part& part = _parts[p];
+        if (!part.hole)
+        {
+            for (auto c = part.begin; c < part.end; ++c)
+                bounds.expandBy(_coords[c]);
+        }
+    }
+    return bounds;
+}
+
+void
+FeatureBatch::setGeometry(
+    std::vector<osg::Vec3d>&& coords,
+    std::vector<Part>&& parts,
+    std::vector<std::uint32_t>&& partOffsets,
+    std::vector<std::int8_t>&& types)
+{
+    OE_SOFT_ASSERT_AND_RETURN(types.size() == size() && partOffsets.size() == size() + 1, void());
+    _coords = std::move(coords);
+    _parts = std::move(parts);
+    _partOffsets = std::move(partOffsets);
+    _types = std::move(types);
+}
+
+Geometry*
+FeatureBatch::createGeometry(std::uint32_t firstPart, std::uint32_t endPart, Geometry::Type type) const
+{
+    // a simple geometry, or a polygon with the holes that follow it
+    auto createSimple = [&](std::uint32_t& p) -> Geometry*
+        {
+            const Part& part = _parts[p++];
+            Geometry* geom = createSimpleGeometry(part.type, part.end - part.begin);
+            for (auto c = part.begin; c < part.end; ++c)
+                geom->push_back(_coords[c]);
+
+            if (part.type == Geometry::TYPE_TRIMESH && part.mesh < _meshIndices.size())
+            {
+                static_cast<TriMesh*>(geom)->_indices = _meshIndices[part.mesh];
+            }
+            else if (part.type == Geometry::TYPE_POLYGON)
+            {
+                auto& holes = static_cast<Polygon*>(geom)->getHoles();
+                while (p < endPart && _parts[p].hole)
+                {
+                    const Part& holePart = _parts[p++];
+                    Ring* hole = new Ring(holePart.end - holePart.begin);
+                    for (auto c = holePart.begin; c < holePart.end; ++c)
+                        hole->push_back(_coords[c]);
+                    holes.push_back(hole);
+                }
+            }
+            return geom;
+        };
+
+    if (type == Geometry::TYPE_MULTI)
+    {
+        MultiGeometry* multi = new MultiGeometry();
+        for (std::uint32_t p = firstPart; p < endPart; )
+            multi->add(createSimple(p));
+        return multi;
+    }
+    else if (firstPart < endPart)
+    {
+        std::uint32_t p = firstPart;
+        return createSimple(p);
+    }
+    else
+    {
+        return createSimpleGeometry(type, 0);
+    }
+}
+
+Feature*
+FeatureBatch::createFeature(std::size_t row) const
+{
+    Geometry* geom = hasGeometry(row) ?
+        createGeometry(_partOffsets[row], _partOffsets[row + 1], getGeometryType(row)) :
+        nullptr;
+
+    auto style = _styles.find((std::uint32_t)row);
+
+    Feature* feature = new Feature(
+        geom,
+        getSRS(row),
+        style != _styles.end() ? style->second : Style(),
+        _fids[row]);
+
+    if (_interps[row].isSet())
+        feature->geoInterp() = _interps[row].get();
+
+    feature->reserveAttrs((unsigned)_columns.size());
+    for (auto& column : _columns)
+    {
+        switch (column.state[row])
+        {
+        case STATE_SET: feature->set(column.key, column.get(row)); break;
+        case STATE_NULL: feature->setNull(column.key); break;
+        default: break;
+        }
+    }
+
+    return feature;
+}
+
+void
+FeatureBatch::toFeatures(FeatureList& output) const
+{
+    output.reserve(output.size() + size());
+    for (std::size_t row = 0; row < size(); ++row)
+        output.emplace_back(createFeature(row));
+}
@@ -0,0 +1,177 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/FeatureExpression>
+#include <osgEarth/FilterContext>
+#include <osgEarth/ScriptEngine>
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+#define LC "[FeatureExpression] "
+
+namespace
+{
+    // Finds the slot of each variable's attribute key in a feature's
+    // attribute table.
+    void resolveSlots(const std::vector<AttributeKey>& keys, const Feature* prototype,
+        std::vector<int>& slots)
+    {
+        slots.assign(keys.size(), -1);
+        if (prototype)
+        {
+            for (unsigned i = 0; i < keys.size(); ++i)
+                slots[i] = prototype->getAttrs().indexOf(keys[i]);
+        }
+    }
+
+    // Finds an attribute, trying the pre-resolved slot first.
+    inline const AttributeValue* lookup(const AttributeTable& attrs, const AttributeKey& key, int slot)
+    {
+        if (slot < 0 || slot >= attrs.size() || attrs.keyAt(slot) != key)
+            slot = attrs.indexOf(key);
+
+        return slot >= 0 ? &attrs.at(slot) : nullptr;
+    }
+
+    inline ScriptEngine* getScriptEngine(const FilterContext* context)
+    {
+        return context && context->getSession() ? context->getSession()->getScriptEngine() : nullptr;
+    }
+
+    const Feature* firstValid(const FeatureList& features)
+    {
+        for (auto& feature : features)
+            if (feature.valid())
+                return feature.get();
+        return nullptr;
+    }
+}
+
+//........................................................................
+
+CompiledNumericExpression::CompiledNumericExpression(const NumericExpression& expr, const Feature* prototype) :
+    _expr(expr)
+{
+    resolveSlots(_expr.variableKeys(), prototype, _slots);
+    _bound = (prototype != nullptr);
+}
+
+void
+CompiledNumericExpression::bind(const Feature* prototype)
+{
+    resolveSlots(_expr.variableKeys(), prototype, _slots);
+    _bound = (prototype != nullptr);
+}
+
+double
+CompiledNumericExpression::eval(const Feature* feature, const FilterContext* context) const
+{
+    if (!feature)
+        return 0.0;
+
+    auto& attrs = feature->getAttrs();
+    double value = _expr.eval([&](unsigned i)
+        {
+            auto* attr = lookup(attrs, _expr.variableKeys()[i], _slots[i]);
+            if (attr)
+                return attr->getDouble(0.0);
+
+            // not an attribute; perhaps it's script
+            ScriptEngine* engine = getScriptEngine(context);
+            if (engine)
+            {
+                ScriptResult result = engine->run(_expr.variables()[i].first, feature, context);
+                if (result.success())
+                    return result.asDouble();
+                else
+                    OE_WARN << LC << "Feature Script error on '" << _expr.expr() << "': " << result.message() << std::endl;
+            }
+            return 0.0;
+        });
+
+    // same as Feature::eval
+    return !osg::isNaN(value) ? value : 0.0;
+}
+
+void
+CompiledNumericExpression::eval(const FeatureList& features, const FilterContext* context, std::vector<double>& out)
+{
+    if (!_bound)
+        bind(firstValid(features));
+
+    out.resize(features.size());
+    for (unsigned i = 0; i < features.size(); ++i)
+        out[i] = eval(features[i].get(), context);
+}
+
+//........................................................................
+
+CompiledStringExpression::CompiledStringExpression(const StringExpression& expr, const Feature* prototype) :
+    _expr(expr)
+{
+    resolveSlots(_expr.variableKeys(), prototype, _slots);
+    _bound = (prototype != nullptr);
+}
+
+void
+CompiledStringExpression::bind(const Feature* prototype)
+{
+    resolveSlots(_expr.variableKeys(), prototype, _slots);
+    _bound = (prototype != nullptr);
+}
+
+void
+CompiledStringExpression::eval(const Feature* feature, const FilterContext* context, std::string& out) const
+{
+    out.clear();
+    if (!feature)
+        return;
+
+    auto& attrs = feature->getAttrs();
+    _expr.eval([&](unsigned i, std::string& buf)
+        {
+            auto* attr = lookup(attrs, _expr.variableKeys()[i], _slots[i]);
+            if (attr)
+            {
+                if (attr->is<std::string>())
+                    buf.append(attr->get<std::string>());
+                else
+                    buf.append(attr->getString());
+                return;
+            }
+
+            // not an attribute; perhaps it's script
+            ScriptEngine* engine = getScriptEngine(context);
+            if (engine)
+            {
+                ScriptResult result = engine->run(_expr.variables()[i].first, feature, context);
+                if (result.success())
+                    buf.append(result.asString());
+                else
+                    // Couldn't execute it as code, just take it as a string literal.
+                    buf.append(_expr.variables()[i].first);
+            }
+        },
+        out);
+}
+
+std::string
+CompiledStringExpression::eval(const Feature* feature, const FilterContext* context) const
+{
+    std::string result;
+    eval(feature, context, result);
+    return result;
+}
+
+void
+CompiledStringExpression::eval(const FeatureList& features, const FilterContext* context, std::vector<std::string>& out)
+{
+    if (!_bound)
+        bind(firstValid(features));
+
+    out.resize(features.size());
+    for (unsigned i = 0; i < features.size(); ++i)
+        eval(features[i].get(), context, out[i]);
+}
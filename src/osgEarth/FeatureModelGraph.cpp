@@ -28,6 +28,8 @@
 #include <osg/ShapeDrawable>
 
 #include <iterator>
+#include <mutex>
+#include <thread>
 
 #ifdef OSGEARTH_HAVE_SUPERLUMINALAPI
 #include <Superluminal/PerformanceAPI.h>
@@ -46,6 +48,8 @@ using namespace osgEarth::Util;
 
 #define USER_OBJECT_NAME "osgEarth.FeatureModelGraph"
 
+#define COMPILE_POOL "oe.features.compile"
+
 // Whether to install a cull callback on PagedLODs that adds an extra
 // culling step (beyond the normal bounding sphere test) based on a
 // tile extent box compared against the frustum. This provides tighter
@@ -59,7 +63,8 @@ namespace
         osg::observer_ptr<FeatureModelGraph> _graph;
         osg::ref_ptr<const Session> _session;
 
-        MyProgressCallback(FeatureModelGraph* graph, const Session* session) :
+        MyProgressCallback(FeatureModelGraph* graph, const Session* session, Cancelable* cancelable) :
+            ProgressCallback(cancelable),
             _graph(graph),
             _session(session)
         {
@@ -477,6 +482,18 @@ FeatureModelGraph::open()
     // Create a filter chain if necessary
     _filterChain = FeatureFilterChain::create(_options.filters(), NULL);
 
+    // The pool that compiles style groups concurrently is shared by all
+    // graphs; the first graph that uses it sets its size.
+    if (_options.compileThreads().get() != 1u)
+    {
+        static std::once_flag s_sizeCompilePool;
+        unsigned numThreads = _options.compileThreads().get() > 0u ?
+            _options.compileThreads().get() :
+            std::max(1u, std::thread::hardware_concurrency());
+        std::call_once(s_sizeCompilePool, [numThreads]() {
+            jobs::get_pool(COMPILE_POOL)->set_concurrency(numThreads); });
+    }
+
     // Call addedToMap on all of the FeatureFilters
     if (_session->getMap())
         for (auto& filter : _filterChain)
@@ -848,7 +865,7 @@ FeatureModelGraph::setupPaging()
             osg::ref_ptr<osg::Group> result;
             osg::ref_ptr<FeatureModelGraph> graph;
             if (graph_weakptr.lock(graph))
-                result = graph->load(0, 0, 0, uri, readOptions.get());
+                result = graph->load(0, 0, 0, uri, readOptions.get(), c);
             return result;
         };
 
@@ -885,7 +902,8 @@ osg::ref_ptr<osg::Group>
 FeatureModelGraph::load(
     unsigned lod, unsigned tileX, unsigned tileY,
     const std::string& uri,
-    const osgDB::Options* readOptions)
+    const osgDB::Options* readOptions,
+    Cancelable* cancelable)
 {
     OE_PROFILING_ZONE;
     OE_PROFILING_ZONE_TEXT(_ownerName);
@@ -934,7 +952,7 @@ FeatureModelGraph::load(
 
             TileKey key(lod, tileX, invertedTileY, featureProfile->getTilingProfile());
 
-            geometry = buildTile(level, tileExtent, &key, readOptions);
+            geometry = buildTile(level, tileExtent, &key, readOptions, cancelable);
             result = geometry;
         }
 
@@ -966,7 +984,7 @@ FeatureModelGraph::load(
         // maximum camera range.
 
         FeatureLevel all(0.0f, FLT_MAX);
-        result = buildTile(all, GeoExtent::INVALID, (const TileKey*)0L, readOptions);
+        result = buildTile(all, GeoExtent::INVALID, (const TileKey*)0L, readOptions, cancelable);
     }
 
     else if ((int)lod < _lodmap.size())
@@ -988,7 +1006,7 @@ FeatureModelGraph::load(
                 s_getTileExtent(lod, tileX, tileY, _usableFeatureExtent) :
                 _usableFeatureExtent;
 
-            geometry = buildTile(*level, tileExtent, (const TileKey*)0L, readOptions);
+            geometry = buildTile(*level, tileExtent, (const TileKey*)0L, readOptions, cancelable);
             result = geometry;
         }
 
@@ -1114,7 +1132,7 @@ FeatureModelGraph::buildSubTilePagedLODs(
                         osg::ref_ptr<osg::Group> result;
                         osg::ref_ptr<FeatureModelGraph> graph;
                         if (graph_weakptr.lock(graph))
-                            result = graph->load(subtileLOD, u, v, uri, ro.get());
+                            result = graph->load(subtileLOD, u, v, uri, ro.get(), c);
                         return result;
                     };
 
@@ -1265,7 +1283,8 @@ FeatureModelGraph::buildTile(
     const FeatureLevel& level,
     const GeoExtent& extent,
     const TileKey* key,
-    const osgDB::Options* readOptions)
+    const osgDB::Options* readOptions,
+    Cancelable* cancelable)
 {
     OE_PROFILING_ZONE;
     OE_PROFILING_ZONE_TEXT((key?key->str().c_str():"no key"));
@@ -1285,7 +1304,7 @@ FeatureModelGraph::buildTile(
     // Not there? Build it
     if (!group.valid())
     {
-        osg::ref_ptr<ProgressCallback> progress = new MyProgressCallback(this, _session.get());
+        osg::ref_ptr<ProgressCallback> progress = new MyProgressCallback(this, _session.get(), cancelable);
 
         // set up for feature indexing if appropriate:
         FeatureSourceIndexNode* index = 0L;
@@ -1754,11 +1773,12 @@ FeatureModelGraph::queryAndSortIntoStyleGroups(
             return;
     }
 
-    // next create a style group per bin.
+    // resolve the style of each bin.
+    std::vector<StyleBin> bins;
+    bins.reserve(styleBins.size());
     for(auto& i : styleBins)
     {
         const std::string& styleString = i.first;
-        FeatureList&       workingSet = i.second;
 
         // resolve the style:
         Style combinedStyle;
@@ -1783,31 +1803,40 @@ FeatureModelGraph::queryAndSortIntoStyleGroups(
                 combinedStyle = *selectedStyle;
         }
 
-        // if there is a valid style, create the node and add it. (Otherwise we will skip
+        // if there is a valid style, compile the bin. (Otherwise we will skip
         // the feature.)
         if (!combinedStyle.empty())
         {
-            osg::Group* styleGroup = createStyleGroup(combinedStyle, workingSet, context, readOptions, query);
-            if (styleGroup)
-                parent->addChild(styleGroup);
+            bins.emplace_back();
+            bins.back().style = combinedStyle;
+            bins.back().features.swap(i.second);
         }
     }
+
+    // next create a style group per bin.
+    std::vector<osg::ref_ptr<osg::Group>> styleGroups;
+    createStyleGroups(bins, context, readOptions, query, progress, styleGroups);
+
+    for (auto& styleGroup : styleGroups)
+    {
+        if (styleGroup.valid())
+            parent->addChild(styleGroup.get());
+    }
 }
 
 
-osg::Group*
-FeatureModelGraph::createStyleGroup(const Style&          style,
-                                    FeatureList&          workingSet,
-                                    const FilterContext&  contextPrototype,
-                                    const osgDB::Options* readOptions,
-                                    const Query&          query)
+bool
+FeatureModelGraph::compileFeatures(const Style&             style,
+                                   FeatureList&             workingSet,
+                                   const FilterContext&     contextPrototype,
+                                   const osgDB::Options*    readOptions,
+                                   const Query&             query,
+                                   osg::ref_ptr<osg::Node>& output)
 {
-    OE_TEST << LC << "createStyleGroup " << style.getName() << std::endl;
+    OE_TEST << LC << "compileFeatures " << style.getName() << std::endl;
 
     NetworkMonitor::ScopedRequestLayer layerRequest(_ownerName);
 
-    osg::Group* styleGroup = 0L;
-
     FilterContext context(contextPrototype);
 
     if (_options.autoCropFeatures() == true)
@@ -1838,21 +1867,117 @@ FeatureModelGraph::createStyleGroup(const Style&          style,
     // finally, compile the features into a node.
     if (workingSet.size() > 0)
     {
-        osg::ref_ptr<osg::Node> node;
         osg::ref_ptr<FeatureCursor> newCursor = new FeatureListCursor(workingSet);
+        return createOrUpdateNode(newCursor.get(), style, context, readOptions, output, query);
+    }
+
+    return false;
+}
+
+
+void
+FeatureModelGraph::createStyleGroups(std::vector<StyleBin>&                 bins,
+                                     const FilterContext&                   context,
+                                     const osgDB::Options*                  readOptions,
+                                     const Query&                           query,
+                                     ProgressCallback*                      progress,
+                                     std::vector<osg::ref_ptr<osg::Group>>& output)
+{
+    OE_PROFILING_ZONE;
+
+    // Each bin compiles as one or more ranges of its features. Ranges are
+    // independent, so they can compile concurrently; the results are then
+    // assembled in bin and range order so the tile is the same every time.
+    struct Range
+    {
+        unsigned bin;
+        FeatureList features;
+        osg::ref_ptr<osg::Node> node;
+        bool ok = false;
+    };
+    std::vector<Range> ranges;
+
+    // Splitting a bin only pays off when more than one thread compiles.
+    unsigned numThreads = _options.compileThreads().get() > 0u ?
+        _options.compileThreads().get() :
+        jobs::get_pool(COMPILE_POOL)->concurrency();
+    bool concurrent = numThreads > 1u;
 
-        if ( createOrUpdateNode( newCursor.get(), style, context, readOptions, node, query ) )
+    unsigned rangeSize = concurrent ? _options.compileRangeSize().get() : 0u;
+    for (unsigned b = 0; b < bins.size(); ++b)
+    {
+        FeatureList& features = bins[b].features;
+        if (rangeSize == 0u || features.size() <= rangeSize)
         {
-            if (!styleGroup)
-                styleGroup = getOrCreateStyleGroupFromFactory(style);
+            ranges.emplace_back();
+            ranges.back().bin = b;
+            ranges.back().features.swap(features);
+        }
+        else
+        {
+            auto i = features.begin();
+            while (i != features.end())
+            {
+                ranges.emplace_back();
+                ranges.back().bin = b;
+                ranges.back().features.reserve(rangeSize);
+                for (unsigned n = 0; n < rangeSize && i != features.end(); ++n, ++i)
+                    ranges.back().features.push_back(*i);
+            }
+            features.clear();
+        }
+    }
 
-            // if it returned a node, add it. (it doesn't necessarily have to)
-            if (node.valid())
-                styleGroup->addChild(node.get());
+    auto compile = [&](Range& range)
+    {
+        if (progress && progress->isCanceled())
+            return;
+
+        range.ok = compileFeatures(bins[range.bin].style, range.features, context, readOptions, query, range.node);
+        range.features.clear();
+    };
+
+    if (ranges.size() > 1 && concurrent)
+    {
+        // Ranges check for cancelation before they start, so a tile that
+        // is no longer needed stops after the ranges already running.
+        jobs::context job;
+        job.name = COMPILE_POOL;
+        job.pool = jobs::get_pool(job.name);
+        job.group = jobs::jobgroup::create();
+
+        for (auto& range : ranges)
+        {
+            Range* r = &range;
+            jobs::dispatch([&compile, r]() { compile(*r); }, job);
         }
+
+        job.group->join();
+    }
+    else
+    {
+        for (auto& range : ranges)
+            compile(range);
     }
 
-    return styleGroup;
+    output.assign(bins.size(), nullptr);
+
+    if (progress && progress->isCanceled())
+        return;
+
+    for (auto& range : ranges)
+    {
+        if (range.ok)
+        {
+            osg::ref_ptr<osg::Group>& styleGroup = output[range.bin];
+            if (!styleGroup.valid())
+                styleGroup = getOrCreateStyleGroupFromFactory(bins[range.bin].style);
+
+            // if it returned a node, add it. (it doesn't necessarily have to)
+            if (range.node.valid())
+                styleGroup->addChild(range.node.get());
+        }
+    }
 }
 
 
@@ -1892,16 +2017,18 @@ FeatureModelGraph::createStyleGroup(const Style&          style,
         // start by culling our feature list to the working extent. By default, this is done by
         // checking feature centroids. But the user can override this to crop feature geometry to
         // the cell boundaries.
-        FeatureList workingSet;
-        cursor->fill(workingSet);
+        std::vector<StyleBin> bins(1);
+        bins[0].style = style;
+        cursor->fill(bins[0].features);
 
         if (progress && progress->isCanceled())
             return NULL;
 
-        styleGroup = createStyleGroup(style, workingSet, context, readOptions, query);
+        std::vector<osg::ref_ptr<osg::Group>> styleGroups;
+        createStyleGroups(bins, context, readOptions, query, progress, styleGroups);
+        styleGroup = styleGroups[0].release();
     }
 
-
     return styleGroup;
 }
 
@@ -2029,7 +2156,7 @@ FeatureModelGraph::redraw()
         FeatureLevel defaultLevel(0.0f, FLT_MAX);
 
         //Remove all current children
-        node = buildTile(defaultLevel, GeoExtent::INVALID, 0, _session->getDBOptions());
+        node = buildTile(defaultLevel, GeoExtent::INVALID, 0, _session->getDBOptions(), nullptr);
     }
 
     // If we want fading, install fading.
@@ -55,6 +55,8 @@ FeatureModelOptions::fromConfig(const Config& conf)
     conf.get( "session_wide_resource_cache", _sessionWideResourceCache );
 
     conf.get("auto_crop_features", _autoCropFeatures);
+    conf.get("compile_threads", _compileThreads);
+    conf.get("compile_range_size", _compileRangeSize);
 
     const Config& filtersConf = conf.child("filters");
     for(ConfigSet::const_iterator i = filtersConf.children().begin(); i != filtersConf.children().end(); ++i)
@@ -89,6 +91,8 @@ FeatureModelOptions::getConfig() const
     conf.set( "session_wide_resource_cache", _sessionWideResourceCache );
 
     conf.set("auto_crop_features", _autoCropFeatures);
+    conf.set("compile_threads", _compileThreads);
+    conf.set("compile_range_size", _compileRangeSize);
 
     if (filters().empty() == false)
     {
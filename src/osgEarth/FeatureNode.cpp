@@ -357,6 +357,15 @@ FeatureNode::clamp(osg::Node* graph, const Terrain* terrain)
         clamper.setUseVertexZ( relative );
         clamper.setOffset( offset );
 
+        // sample the elevation data the terrain has in memory, as fine as
+        // it has loaded, and only intersect where there is none
+        if (getMapNode())
+        {
+            clamper.setElevationPool(getMapNode()->getMap()->getElevationPool());
+            clamper.setResidentDataOnly(true);
+            clamper.setResolution(Distance(0.0, Units::METERS));
+        }
+
         this->accept( clamper );
     }
 }
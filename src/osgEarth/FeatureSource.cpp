@@ -103,6 +103,7 @@ FeatureSource::openImplementation()
     {
         // note: cannot use std::make_unique in C++11
         _featuresCache = std::unique_ptr<FeaturesLRU>(new FeaturesLRU(l2CacheSize));
+        _featuresCache->setMetricsName("features");
     }
 
     Status parent = super::openImplementation();
@@ -89,7 +89,7 @@ FeatureSourceIndexNode::tagDrawable(osg::Drawable* drawable, Feature* feature)
 {
     if ( !feature || !_index.valid() ) return OSGEARTH_OBJECTID_EMPTY;
     RefIDPair* r = _index->tagDrawable( drawable, feature );
-    if ( r ) _fids[ feature->getFID() ] = r;
+    if ( r ) addFID( feature->getFID(), r );
     return r ? r->_oid : OSGEARTH_OBJECTID_EMPTY;
 }
 
@@ -98,7 +98,7 @@ FeatureSourceIndexNode::tagAllDrawables(osg::Node* node, Feature* feature)
 {
     if ( !feature || !_index.valid() ) return OSGEARTH_OBJECTID_EMPTY;
     RefIDPair* r = _index->tagAllDrawables( node, feature );
-    if ( r ) _fids[ feature->getFID() ] = r;
+    if ( r ) addFID( feature->getFID(), r );
     return r ? r->_oid : OSGEARTH_OBJECTID_EMPTY;
 }
 
@@ -107,7 +107,7 @@ FeatureSourceIndexNode::tagNode(osg::Node* node, Feature* feature)
 {
     if ( !feature || !_index.valid() ) return OSGEARTH_OBJECTID_EMPTY;
     RefIDPair* r = _index->tagNode( node, feature );
-    if ( r ) _fids[ feature->getFID() ] = r;
+    if ( r ) addFID( feature->getFID(), r );
     return r ? r->_oid : OSGEARTH_OBJECTID_EMPTY;
 }
 
@@ -116,10 +116,18 @@ FeatureSourceIndexNode::tagRange(osg::Drawable* drawable, Feature* feature, unsi
 {
     if (!feature || !_index.valid()) return OSGEARTH_OBJECTID_EMPTY;
     RefIDPair* r = _index->tagRange(drawable, feature, start, count);
-    if (r) _fids[feature->getFID()] = r;
+    if (r) addFID(feature->getFID(), r);
     return r ? r->_oid : OSGEARTH_OBJECTID_EMPTY;
 }
 
+void
+FeatureSourceIndexNode::addFID(FeatureID fid, RefIDPair* r)
+{
+    // style groups of one tile may compile concurrently
+    std::lock_guard<std::mutex> lock(_fidsMutex);
+    _fids[fid] = r;
+}
+
 bool
 FeatureSourceIndexNode::getAllFIDs(std::vector<FeatureID>& output) const
 {
@@ -29,6 +29,16 @@ void FeatureFilter::addedToMap(const class Map*)
 {
 }
 
+FilterContext
+FeatureFilter::pushBatch(FeatureBatch& input, FilterContext& context)
+{
+    FeatureList features;
+    input.toFeatures(features);
+    FilterContext output = push(features, context);
+    input.assign(features);
+    return output;
+}
+
 /********************************************************************************/
 
 #undef LC
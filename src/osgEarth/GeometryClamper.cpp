@@ -4,6 +4,7 @@
  */
 #include <osgEarth/GeometryClamper>
 #include <osgEarth/LineDrawable>
+#include <osgEarth/Threading>
 #include <osg/Geometry>
 
 #define LC "[GeometryClamper] "
@@ -13,6 +14,9 @@ using namespace osgEarth::Util;
 
 #define ZOFFSETS_NAME "GeometryClamper::zOffsets"
 
+// vertices per batch when sampling (and possibly loading) elevation data
+#define SAMPLING_BATCH_SIZE 4096
+
 //-----------------------------------------------------------------------
 
 GeometryClamper::GeometryClamper(GeometryClamper::LocalData& localData) :
@@ -21,7 +25,9 @@ _localData(localData),
 _useVertexZ(true),
 _revert(false),
 _scale( 1.0f ),
-_offset( 0.0f )
+_offset( 0.0f ),
+_resolution( 10.0, Units::METERS ),
+_residentOnly( false )
 {
     this->setNodeMaskOverride( ~0 );
     _lsi = new osgUtil::LineSegmentIntersector(osg::Vec3d(0,0,0), osg::Vec3d(0,0,0));
@@ -90,62 +96,146 @@ GeometryClamper::apply(osg::Drawable& drawable)
     if ( !_terrainSRS.valid() )
         return;
 
-    const osg::Matrixd& local2world = _matrixStack.back();
+    osg::Matrixd local2world;
+    if ( !_matrixStack.empty() )
+        local2world = _matrixStack.back();
     osg::Matrix world2local;
     world2local.invert( local2world );
 
-    const Ellipsoid& em = _terrainSRS->getEllipsoid();
-    osg::Vec3d n_vector(0,0,1), start, end, msl;
-
-    bool isGeocentric = _terrainSRS->isGeographic();
-
-    osgUtil::IntersectionVisitor iv( _lsi.get() );
-
-    double r = osg::minimum( em.getRadiusEquator(), em.getRadiusPolar() );
-
-    unsigned count = 0;
-
-    bool geomDirty = false;
-
     // Use the vertex array on the geometry as the lookup instead of the verts array as it might be a temporary array for a LineDrawable.
     GeometryData& data = _localData[&drawable];
 
-    bool storeAltitudes = false;
-
     if (!data._verts.valid() || data._verts->size() != verts->size())
     {
         data._verts = osg::clone(verts.get(), osg::CopyOp::DEEP_COPY_ALL);
         data._altitudes = new osg::FloatArray();
         data._altitudes->reserve(verts->size());
-        storeAltitudes = true;
-    }
-
-    for( unsigned k=0; k<verts->size(); ++k )
-    {
-        osg::Vec3d vw = (*verts)[k];
-        vw = vw * local2world;
 
-        if ( isGeocentric )
+        for( unsigned k=0; k<verts->size(); ++k )
         {
-            // normal to the ellipsoid:
-            n_vector = em.geocentricToUpVector(vw);
-
-            // if we need to store the original altitudes:
-            if (storeAltitudes)
+            if ( _terrainSRS->isGeographic() )
             {
                 // should really be the alt along the n_vector but leave for now
                 // since most scene-clamped geometry will be in relative to a
                 // local tangent plane anyway -gw
                 data._altitudes->push_back( (*verts)[k].z() );
             }
+            else
+            {
+                osg::Vec3d vw = osg::Vec3d((*verts)[k]) * local2world;
+                data._altitudes->push_back( float(vw.z()) - _offset);
+            }
         }
+    }
+
+    std::vector<unsigned> indices;
+    selectVertices(*verts, local2world, indices);
+
+    unsigned count = 0;
+
+    osg::ref_ptr<ElevationPool> pool;
+    if (_pool.lock(pool) && !indices.empty())
+        count += clampBySampling(pool.get(), *verts, data, local2world, world2local, indices);
 
+    // anything left had no elevation data to sample:
+    if (!indices.empty())
+        count += clampByIntersection(*verts, data, local2world, world2local, indices);
+
+    bool geomDirty = count > 0;
+
+    if ( geomDirty )
+    {
+        if (lineDrawable)
+        {
+            for (unsigned int i = 0; i < verts->size(); ++i)
+            {
+                lineDrawable->setVertex(i, (*verts)[i]);
+            }
+            lineDrawable->dirtyBound();
+        }
         else
         {
-            if (storeAltitudes)
+            geom->dirtyBound();
+            if (geom->getUseVertexBufferObjects())
             {
-                data._altitudes->push_back( float(vw.z()) - _offset);
+                verts->getVertexBufferObject()->setUsage(GL_DYNAMIC_DRAW_ARB);
+                verts->dirty();
             }
+            else
+            {
+                geom->dirtyGLObjects();
+            }
+        }
+    }
+}
+
+void
+GeometryClamper::selectVertices(const osg::Vec3Array& verts,
+                                const osg::Matrixd& local2world,
+                                std::vector<unsigned>& indices) const
+{
+    indices.reserve(verts.size());
+
+    if ( !_tileKey.valid() )
+    {
+        for (unsigned k = 0; k < verts.size(); ++k)
+            indices.push_back(k);
+        return;
+    }
+
+    // only the vertices that fall within the tile:
+    const GeoExtent& extent = _tileKey.getExtent();
+    const Ellipsoid& em = _terrainSRS->getEllipsoid();
+    bool isGeocentric = _terrainSRS->isGeographic();
+    bool transform = !_terrainSRS->isHorizEquivalentTo(extent.getSRS());
+
+    std::vector<osg::Vec3d> points(verts.size());
+    for (unsigned k = 0; k < verts.size(); ++k)
+    {
+        osg::Vec3d vw = osg::Vec3d(verts[k]) * local2world;
+        points[k] = isGeocentric ? em.geocentricToGeodetic(vw) : vw;
+    }
+
+    if ( transform )
+        _terrainSRS->transform(points, extent.getSRS());
+
+    for (unsigned k = 0; k < verts.size(); ++k)
+    {
+        if ( extent.contains(points[k].x(), points[k].y()) )
+            indices.push_back(k);
+    }
+}
+
+unsigned
+GeometryClamper::clampByIntersection(osg::Vec3Array& verts,
+                                     const GeometryData& data,
+                                     const osg::Matrixd& local2world,
+                                     const osg::Matrixd& world2local,
+                                     const std::vector<unsigned>& indices)
+{
+    if ( !_terrainPatch.valid() )
+        return 0u;
+
+    const Ellipsoid& em = _terrainSRS->getEllipsoid();
+    osg::Vec3d n_vector(0,0,1);
+
+    bool isGeocentric = _terrainSRS->isGeographic();
+
+    osgUtil::IntersectionVisitor iv( _lsi.get() );
+
+    double r = osg::minimum( em.getRadiusEquator(), em.getRadiusPolar() );
+
+    unsigned count = 0;
+
+    for( unsigned k : indices )
+    {
+        osg::Vec3d vw = verts[k];
+        vw = vw * local2world;
+
+        if ( isGeocentric )
+        {
+            // normal to the ellipsoid:
+            n_vector = em.geocentricToUpVector(vw);
         }
 
         _lsi->reset();
@@ -158,11 +248,6 @@ GeometryClamper::apply(osg::Drawable& drawable)
         if ( _lsi->containsIntersections() )
         {
             osg::Vec3d fw = _lsi->getFirstIntersection().getWorldIntersectPoint();
-            //if ( _scale != 1.0 )
-            //{
-            //    osg::Vec3d delta = fw - msl;
-            //    fw += delta*_scale;
-            //}
 
             if ( _offset != 0.0 )
             {
@@ -174,43 +259,154 @@ GeometryClamper::apply(osg::Drawable& drawable)
                 fw += n_vector * (*data._altitudes)[k];
             }
 
-            (*verts)[k] = (fw * world2local);
-            geomDirty = true;
+            verts[k] = (fw * world2local);
             ++count;
         }
     }
 
-    if ( geomDirty )
+    return count;
+}
+
+unsigned
+GeometryClamper::clampBySampling(ElevationPool* pool,
+                                 osg::Vec3Array& verts,
+                                 const GeometryData& data,
+                                 const osg::Matrixd& local2world,
+                                 const osg::Matrixd& world2local,
+                                 std::vector<unsigned>& indices)
+{
+    const SpatialReference* mapSRS = pool->getMapSRS();
+    if ( !mapSRS )
+        return 0u;
+
+    const Ellipsoid& em = _terrainSRS->getEllipsoid();
+    bool isGeocentric = _terrainSRS->isGeographic();
+    bool transform = !_terrainSRS->isHorizEquivalentTo(mapSRS);
+
+    const unsigned size = indices.size();
+    std::vector<osg::Vec3d> world(size), points(size);
+    for (unsigned i = 0; i < size; ++i)
     {
-        if (lineDrawable)
+        world[i] = osg::Vec3d(verts[indices[i]]) * local2world;
+        points[i] = isGeocentric ? em.geocentricToGeodetic(world[i]) : world[i];
+    }
+
+    std::vector<osg::Vec3d> samples(points);
+    if ( transform )
+        _terrainSRS->transform(samples, mapSRS);
+
+    // Samples the vertices [begin, end) with one envelope. Consecutive
+    // vertices are usually close together, so each batch only touches
+    // a few elevation tiles.
+    auto sampleRange = [&](unsigned begin, unsigned end)
+    {
+        ElevationPool::Envelope envelope;
+        bool prepared = _tileKey.valid() ?
+            pool->prepareEnvelope(envelope, _tileKey) :
+            pool->prepareEnvelope(envelope, GeoPoint(mapSRS, samples[begin]), _resolution);
+
+        if ( !prepared )
         {
-            for (unsigned int i = 0; i < verts->size(); ++i)
-            {
-                lineDrawable->setVertex(i, (*verts)[i]);
-            }
-            lineDrawable->dirtyBound();
+            for (unsigned i = begin; i < end; ++i)
+                samples[i].z() = NO_DATA_VALUE;
+            return;
+        }
+
+        envelope.setResidentDataOnly(_residentOnly);
+        envelope.sampleMapCoords(samples.begin() + begin, samples.begin() + end, nullptr);
+    };
+
+    // Loading data is the slow part, so sample in parallel batches when
+    // sampling may load; resident data is quick to sample in place, and
+    // this may be the update traversal.
+    unsigned batches = (size + SAMPLING_BATCH_SIZE - 1) / SAMPLING_BATCH_SIZE;
+
+    if (batches > 1 && !_residentOnly)
+    {
+        jobs::context job;
+        job.name = "oe.clamper";
+        job.pool = jobs::get_pool(job.name);
+        job.group = jobs::jobgroup::create();
+
+        for (unsigned b = 0; b < batches; ++b)
+        {
+            unsigned begin = b * SAMPLING_BATCH_SIZE;
+            unsigned end = std::min(begin + SAMPLING_BATCH_SIZE, size);
+            jobs::dispatch([&sampleRange, begin, end]() { sampleRange(begin, end); }, job);
+        }
+
+        job.group->join();
+    }
+    else if (size > 0)
+    {
+        sampleRange(0u, size);
+    }
+
+    unsigned count = 0;
+    std::vector<unsigned> missed;
+    for (unsigned i = 0; i < size; ++i)
+    {
+        unsigned k = indices[i];
+        const osg::Vec3d& p = points[i];
+        double h = samples[i].z();
+        if ( h == NO_DATA_VALUE )
+        {
+            missed.push_back(k);
+            continue;
+        }
+
+        osg::Vec3d n_vector(0,0,1), fw;
+        if ( isGeocentric )
+        {
+            n_vector = em.geocentricToUpVector(world[i]);
+            fw = em.geodeticToGeocentric(osg::Vec3d(p.x(), p.y(), h));
         }
         else
         {
-            geom->dirtyBound();
-            if (geom->getUseVertexBufferObjects())
-            {
-                verts->getVertexBufferObject()->setUsage(GL_DYNAMIC_DRAW_ARB);
-                verts->dirty();
-            }
-            else
-            {
-                geom->dirtyGLObjects();
-            }
+            fw.set(p.x(), p.y(), h);
         }
+
+        if ( _offset != 0.0 )
+        {
+            fw += n_vector*_offset;
+        }
+
+        if (_useVertexZ)
+        {
+            fw += n_vector * (*data._altitudes)[k];
+        }
+
+        verts[k] = (fw * world2local);
+        ++count;
     }
+
+    indices.swap(missed);
+    return count;
 }
 
 
+GeometryClamperCallback::GeometryClamperCallback(osg::Node* graph) :
+    _clamper(_localData),
+    _graph(graph)
+{
+    // runs during the update traversal, so never load elevation data
+    _clamper.setResidentDataOnly(true);
+}
+
 void
 GeometryClamperCallback::onTileUpdate(const TileKey&          key,
                                      osg::Node*              tile,
                                      TerrainCallbackContext& context)
 {
-    tile->accept( _clamper );
+    osg::ref_ptr<osg::Node> graph;
+    if ( !_graph.lock(graph) )
+        return;
+
+    // re-clamp the vertices in the updated tile, in one batch, falling
+    // back on intersecting the tile itself.
+    _clamper.setTileKey( key );
+    _clamper.setTerrainPatch( tile );
+    graph->accept( _clamper );
+    _clamper.setTerrainPatch( nullptr );
+    _clamper.setTileKey( TileKey::INVALID );
 }
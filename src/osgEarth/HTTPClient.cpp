@@ -5,6 +5,7 @@
 #include <osgEarth/HTTPClient>
 #include <osgEarth/Progress>
 #include <osgEarth/Metrics>
+#include <osgEarth/MetricsRegistry>
 #include <osgEarth/Version>
 #include <osgEarth/ImageUtils>
 #include <osgEarth/Cache>
@@ -1607,9 +1608,40 @@ HTTPClient::doGet(const HTTPRequest&    request,
         }
     }
 
+    static auto& cacheHits = MetricsRegistry::instance().counter(
+        "osgearth_http_cache_hits_total", "HTTP responses served from the cache");
+    if (gotFromCache && !expired)
+        cacheHits.add();
+
     if ((expired || !gotFromCache) && cachePolicy->usage() != CachePolicy::USAGE_CACHE_ONLY)
     {
-        HTTPResponse remoteResponse = _impl->doGet(request, options, progress);
+        static auto& latency = MetricsRegistry::instance().histogram(
+            "osgearth_http_request_seconds", "HTTP request latency");
+        static auto& bytes = MetricsRegistry::instance().counter(
+            "osgearth_http_response_bytes_total", "HTTP response bytes received");
+        static MetricsRegistry::Counter* requests[] = {
+            &MetricsRegistry::instance().counter("osgearth_http_requests_total", "HTTP requests", { { "status", "error" } }),
+            &MetricsRegistry::instance().counter("osgearth_http_requests_total", "HTTP requests", { { "status", "1xx" } }),
+            &MetricsRegistry::instance().counter("osgearth_http_requests_total", "HTTP requests", { { "status", "2xx" } }),
+            &MetricsRegistry::instance().counter("osgearth_http_requests_total", "HTTP requests", { { "status", "3xx" } }),
+            &MetricsRegistry::instance().counter("osgearth_http_requests_total", "HTTP requests", { { "status", "4xx" } }),
+            &MetricsRegistry::instance().counter("osgearth_http_requests_total", "HTTP requests", { { "status", "5xx" } }),
+            &MetricsRegistry::instance().counter("osgearth_http_requests_total", "HTTP requests", { { "status", "canceled" } })
+        };
+
+        HTTPResponse remoteResponse;
+        {
+            MetricsRegistry::ScopedTimer timer(latency);
+            remoteResponse = _impl->doGet(request, options, progress);
+        }
+
+        if (MetricsRegistry::enabled())
+        {
+            unsigned code = remoteResponse.getCode();
+            requests[remoteResponse.isCanceled() ? 6 : (code >= 100 && code < 600) ? code / 100 : 0]->add();
+            for (unsigned i = 0; i < remoteResponse.getNumParts(); ++i)
+                bytes.add(remoteResponse.getPartSize(i));
+        }
 
         if (remoteResponse.getCode() == ReadResult::RESULT_NOT_MODIFIED)
         {
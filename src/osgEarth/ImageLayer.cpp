@@ -5,6 +5,7 @@
 #include <osgEarth/ImageLayer>
 #include <osgEarth/Progress>
 #include <osgEarth/Metrics>
+#include <osgEarth/MetricsRegistry>
 #include <osgEarth/NetworkMonitor>
 #include <osgEarth/Random>
 #include <osgEarth/Math>
@@ -354,6 +355,10 @@ ImageLayer::createImage(const TileKey& key, ProgressCallback* progress)
         return GeoImage::INVALID;
     }
 
+    static auto& latency = MetricsRegistry::instance().histogram(
+        "osgearth_layer_create_tile_seconds", "Layer tile creation time", { { "type", "image" } });
+    MetricsRegistry::ScopedTimer timer(latency);
+
     NetworkMonitor::ScopedRequestLayer layerRequest(getName());
 
     GeoImage result = createImageInKeyProfile(key, progress);
@@ -590,6 +595,104 @@ ImageLayer::createImageInKeyProfile(const TileKey& key, ProgressCallback* progre
     return result;
 }
 
+namespace
+{
+    std::string makePreparedImageCacheKey(const TileKey& key, const std::string& variant)
+    {
+        return Cache::makeCacheKey(
+            Stringify() << key.str() << "-" << std::hex << key.getProfile()->getHorizSignature()
+            << "-" << (variant.empty() ? "none" : variant),
+            "texture");
+    }
+}
+
+osg::ref_ptr<osg::Image>
+ImageLayer::readPreparedImageFromCache(const TileKey& key, const std::string& variant)
+{
+    OE_PROFILING_ZONE;
+
+    if (!isOpen() || !key.valid() || !getCacheSettings())
+        return nullptr;
+
+    const CachePolicy& policy = getCacheSettings()->cachePolicy().get();
+    if (!policy.isCacheReadable())
+        return nullptr;
+
+    CacheBin* cacheBin = getCacheBin(key.getProfile());
+    if (!cacheBin)
+        return nullptr;
+
+    ReadResult r = cacheBin->readImage(makePreparedImageCacheKey(key, variant), nullptr);
+    if (r.succeeded() && !policy.isExpired(r.lastModifiedTime()))
+    {
+        return r.releaseImage();
+    }
+
+    return nullptr;
+}
+
+bool
+ImageLayer::writePreparedImageToCache(const TileKey& key, const std::string& variant, const osg::Image* image)
+{
+    OE_PROFILING_ZONE;
+
+    if (!isOpen() || !key.valid() || !image || !getCacheSettings())
+        return false;
+
+    const CachePolicy& policy = getCacheSettings()->cachePolicy().get();
+    if (!policy.isCacheWriteable())
+        return false;
+
+    CacheBin* cacheBin = getCacheBin(key.getProfile());
+    if (!cacheBin)
+        return false;
+
+    return cacheBin->write(makePreparedImageCacheKey(key, variant), image, nullptr);
+}
+
+GeoImage
+ImageLayer::createPreparedImage(
+    const TileKey& key,
+    const std::string& variant,
+    const PrepareImageFunction& prepare,
+    ProgressCallback* progress)
+{
+    OE_PROFILING_ZONE;
+
+    if (!isOpen() || !prepare)
+        return GeoImage::INVALID;
+
+    // post layers draw on the raw image, so there's nothing to reuse
+    bool usePreparedCache = _postLayers.empty() && isKeyInLegalRange(key);
+
+    if (usePreparedCache)
+    {
+        osg::ref_ptr<osg::Image> cached = readPreparedImageFromCache(key, variant);
+        if (cached.valid())
+        {
+            // same post-cache step that createImage runs on a cache hit
+            GeoImage result(cached.get(), key.getExtent());
+            postCreateImageImplementation(result, key, progress);
+            return result;
+        }
+    }
+
+    GeoImage raw = createImage(key, progress);
+    if (!raw.valid() || raw.getImage()->r() != 1 || raw.getImage()->requiresUpdateCall())
+        return raw;
+
+    osg::ref_ptr<const osg::Image> prepared = prepare(raw.getImage());
+    if (!prepared.valid())
+        return raw;
+
+    if (usePreparedCache)
+        writePreparedImageToCache(key, variant, prepared.get());
+
+    GeoImage result(prepared.get(), raw.getExtent());
+    result.setTrackingToken(raw.getTrackingToken());
+    return result;
+}
+
 GeoImage
 ImageLayer::assembleImage(const TileKey& key, ProgressCallback* progress)
 {
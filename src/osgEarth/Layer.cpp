@@ -330,6 +330,9 @@ Layer::init()
 Status
 Layer::open()
 {
+    // Map may open layers concurrently, and a layer may open one it refers to
+    Threading::ScopedRecursiveMutexLock lock(_openMutex);
+
     // Cannot open a layer that's already open OR is disabled.
     if (isOpen())
     {
@@ -0,0 +1,208 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/LocalTileReader>
+#include <osgEarth/Registry>
+#include <osgEarth/StringUtils>
+#include <osgDB/FileNameUtils>
+#include <osgDB/FileUtils>
+#include <osgDB/Registry>
+#include <istream>
+#include <streambuf>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+#define LC "[LocalTileReader] "
+
+namespace
+{
+    // Read-only, seekable stream buffer over a block of memory
+    struct MemoryStreamBuffer : public std::streambuf
+    {
+        MemoryStreamBuffer(char* data, std::size_t size)
+        {
+            setg(data, data, data + size);
+        }
+
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+        {
+            char* base =
+                dir == std::ios_base::beg ? eback() :
+                dir == std::ios_base::cur ? gptr() :
+                egptr();
+
+            if ((which & std::ios_base::in) == 0 || off < eback() - base || off > egptr() - base)
+                return pos_type(off_type(-1));
+
+            setg(eback(), base + off, egptr());
+            return pos_type(gptr() - eback());
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
+    // Reads an entire regular file into "buffer"
+    bool readFile(const std::string& path, std::vector<char>& buffer)
+    {
+#if defined(_WIN32)
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in.is_open())
+            return false;
+        buffer.resize((std::size_t)in.tellg());
+        in.seekg(0);
+        return !buffer.empty() && in.read(buffer.data(), buffer.size()).good();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        bool ok = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0;
+        if (ok)
+        {
+            buffer.resize((std::size_t)info.st_size);
+            std::size_t total = 0;
+            while (ok && total < buffer.size())
+            {
+                ssize_t n = ::pread(fd, buffer.data() + total, buffer.size() - total, (off_t)total);
+                if (n > 0)
+                    total += (std::size_t)n;
+                else if (n < 0 && errno == EINTR)
+                    continue;
+                else
+                    ok = false;
+            }
+        }
+        ::close(fd);
+        return ok;
+#endif
+    }
+}
+
+bool
+LocalTileReader::usable(const URI& uri, const osgDB::Options* readOptions)
+{
+    if (uri.empty() || uri.isRemote())
+        return false;
+
+    if (URIAliasMap::from(readOptions) || URIPostReadCallback::from(readOptions))
+        return false;
+
+    // everything before the first template marker must name an existing
+    // directory; anything else (an archive, a virtual path) goes through URI.
+    std::string path = toPath(uri.full());
+    std::string dir = osgDB::getFilePath(path.substr(0, path.find_first_of("{[$")));
+    return !dir.empty() && osgDB::fileType(dir) == osgDB::DIRECTORY;
+}
+
+std::string
+LocalTileReader::toPath(const std::string& url)
+{
+    if (!startsWith(url, "file://", false))
+        return url;
+
+    std::string path = url.substr(7);
+
+    // file:///C:/path on Windows
+    if (path.size() > 2 && path[0] == '/' && path[2] == ':')
+        path.erase(0, 1);
+
+    return path;
+}
+
+osgDB::ReaderWriter*
+LocalTileReader::getReader(const std::string& path) const
+{
+    std::string ext = osgDB::getLowerCaseFileExtension(path);
+
+    {
+        Threading::ScopedReadLock lock(_readersMutex);
+        auto i = _readers.find(ext);
+        if (i != _readers.end())
+            return i->second.get();
+    }
+
+    Threading::ScopedWriteLock lock(_readersMutex);
+    auto i = _readers.find(ext);
+    if (i == _readers.end())
+        i = _readers.emplace(ext, osgDB::Registry::instance()->getReaderWriterForExtension(ext)).first;
+    return i->second.get();
+}
+
+void
+LocalTileReader::disableReader(const std::string& path) const
+{
+    std::string ext = osgDB::getLowerCaseFileExtension(path);
+
+    Threading::ScopedWriteLock lock(_readersMutex);
+    if (_readers[ext].valid())
+    {
+        OE_INFO << LC << "No stream decoder for \"" << ext << "\"; reading those tiles through URI" << std::endl;
+        _readers[ext] = nullptr;
+    }
+}
+
+ReadResult
+LocalTileReader::readImage(const std::string& path, const osgDB::Options* readOptions) const
+{
+    // read callbacks must see every read
+    if (Registry::instance()->getURIReadCallback())
+        return ReadResult(ReadResult::RESULT_NOT_IMPLEMENTED);
+
+    osgDB::ReaderWriter* reader = getReader(path);
+    if (!reader)
+        return ReadResult(ReadResult::RESULT_NOT_IMPLEMENTED);
+
+    static thread_local std::vector<char> buffer;
+    if (!readFile(path, buffer))
+        return ReadResult("Tile not found: " + path);
+
+    MemoryStreamBuffer streamBuffer(buffer.data(), buffer.size());
+    std::istream stream(&streamBuffer);
+
+    osgDB::ReaderWriter::ReadResult r = reader->readImage(stream, readOptions);
+
+    if (r.validImage())
+    {
+        osg::Image* image = r.takeImage();
+        image->setFileName(path);
+        return ReadResult(image);
+    }
+
+    if (r.status() == osgDB::ReaderWriter::ReadResult::NOT_IMPLEMENTED ||
+        r.status() == osgDB::ReaderWriter::ReadResult::FILE_NOT_HANDLED)
+    {
+        disableReader(path);
+        return ReadResult(ReadResult::RESULT_NOT_IMPLEMENTED);
+    }
+
+    return ReadResult(ReadResult::RESULT_READER_ERROR);
+}
+
+void
+LocalTileReader::prefetch(const std::string& path)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        ::close(fd);
+    }
+#endif
+}
@@ -6,6 +6,13 @@
 #include <osgEarth/MapModelChange>
 #include <osgEarth/Registry>
 #include <osgEarth/Notify>
+#include <osgEarth/Metrics>
+#include <osgEarth/StringUtils>
+#include <osgEarth/Threading>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <unordered_map>
 
 using namespace osgEarth;
 
@@ -54,6 +61,8 @@ Map::Options::getConfig() const
 
     conf.set("disable_elevation_ranges", disableElevationRanges());
 
+    conf.set("layer_open_threads", layerOpenThreads());
+
     return conf;
 }
 
@@ -83,6 +92,8 @@ Map::Options::fromConfig(const Config& conf)
     conf.get("osg_options", osgOptionString()); // back compat
 
     conf.get("disable_elevation_ranges", disableElevationRanges());
+
+    conf.get("layer_open_threads", layerOpenThreads());
 }
 
 //...................................................................
@@ -648,19 +659,8 @@ Map::addLayers(const LayerVector& layers)
     // (b) invoke all the MapModelChange callbacks with the same 
     // new revision number.
 
-    for(auto& layer : layers)
-    {
-        if ( !layer )
-            continue;
-
-        layer->setReadOptions(getReadOptions());
-
-        // open, but don't call addedToMap(layer) yet.
-        if (layer->getOpenAutomatically())
-        {
-            layer->open();
-        }
-    }
+    // open, but don't call addedToMap(layer) yet.
+    openLayers(layers);
 
     unsigned firstIndex;
     unsigned count = 0;
@@ -720,6 +720,123 @@ Map::addLayers(const LayerVector& layers)
     }
 }
 
+void
+Map::openLayers(const LayerVector& layers)
+{
+    LayerVector toOpen;
+    for (auto& layer : layers)
+    {
+        if (layer.valid())
+        {
+            layer->setReadOptions(getReadOptions());
+            if (layer->getOpenAutomatically() && !layer->isOpen())
+                toOpen.push_back(layer);
+        }
+    }
+
+    static const unsigned defaultThreads = []() {
+        const char* value = ::getenv("OSGEARTH_LAYER_OPEN_THREADS");
+        return value ? (unsigned)Util::as<int>(value, 1) : std::max(4u, std::thread::hardware_concurrency());
+    }();
+
+    unsigned numThreads = options().layerOpenThreads().getOrUse(defaultThreads);
+
+    if (toOpen.size() < 2 || numThreads < 2)
+    {
+        for (auto& layer : toOpen)
+            layer->open();
+        return;
+    }
+
+    OE_PROFILING_ZONE;
+
+    // A layer that doesn't declare its dependencies might open any other
+    // layer in the batch, so open those one at a time before the rest.
+    std::vector<std::vector<std::string>> dependencies(toOpen.size());
+    LayerVector declared;
+    for (unsigned i = 0; i < toOpen.size(); ++i)
+    {
+        auto& names = dependencies[declared.size()];
+        if (toOpen[i]->getOpenDependencies(names))
+        {
+            declared.push_back(toOpen[i]);
+        }
+        else
+        {
+            names.clear();
+            toOpen[i]->open();
+        }
+    }
+
+    if (declared.empty())
+        return;
+
+    // A layer waits for the layers it depends on to open first.
+    std::unordered_map<std::string, unsigned> byName;
+    for (unsigned i = 0; i < declared.size(); ++i)
+        if (!declared[i]->getName().empty())
+            byName.emplace(Util::toLower(declared[i]->getName()), i);
+
+    struct State
+    {
+        LayerVector layers;
+        std::vector<std::vector<unsigned>> dependents;
+        std::vector<std::atomic_int> waitingOn;
+        jobs::context context;
+        std::function<void(unsigned)> open;
+        State(std::size_t n) : dependents(n), waitingOn(n) { }
+    };
+    auto state = std::make_shared<State>(declared.size());
+    state->layers = declared;
+
+    for (unsigned i = 0; i < declared.size(); ++i)
+    {
+        std::set<unsigned> waitFor;
+        for (auto& name : dependencies[i])
+        {
+            auto iter = byName.find(Util::toLower(name));
+            if (iter != byName.end() && iter->second != i)
+                waitFor.insert(iter->second);
+        }
+        for (auto d : waitFor)
+            state->dependents[d].push_back(i);
+        state->waitingOn[i] = (int)waitFor.size();
+    }
+
+    jobs::get_pool("oe.layers.open")->set_concurrency(numThreads);
+    state->context.name = "open layer";
+    state->context.pool = jobs::get_pool("oe.layers.open");
+    state->context.group = jobs::jobgroup::create();
+
+    // Opening a layer releases the layers waiting on it. The state only
+    // lives as long as the jobs, so the lambda holds it weakly.
+    std::weak_ptr<State> weak = state;
+    state->open = [weak](unsigned i)
+        {
+            auto state = weak.lock();
+            if (!state) return;
+            jobs::dispatch([state, i]()
+                {
+                    state->layers[i]->open();
+                    for (auto d : state->dependents[i])
+                        if (--state->waitingOn[d] == 0)
+                            state->open(d);
+                },
+                state->context);
+        };
+
+    for (unsigned i = 0; i < declared.size(); ++i)
+        if (state->waitingOn[i] == 0)
+            state->open(i);
+
+    state->context.group->join();
+
+    // Anything left is part of a dependency cycle; open it here in order.
+    for (unsigned i = 0; i < declared.size(); ++i)
+        if (state->waitingOn[i] > 0)
+            declared[i]->open();
+}
+
 void
 Map::installLayerCallbacks(Layer* layer)
 {
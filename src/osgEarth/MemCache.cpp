@@ -27,9 +27,17 @@ namespace
             //nop
         }
 
+        // counts only; memory reads are too quick to be worth timing
+        static BinMetrics& metrics()
+        {
+            static BinMetrics s_metrics("memory");
+            return s_metrics;
+        }
+
         ReadResult readObject(const std::string& key, const osgDB::Options*) override
         {
             auto cached = _lru.get(key);
+            metrics().countRead(cached.has_value());
 
             // clone required since the cache is in memory
 
@@ -69,10 +77,14 @@ namespace
 #else
                 _lru.insert( key, std::make_pair(object, meta) );
 #endif
+                metrics().countWrite(true);
                 return true;
             }
             else
+            {
+                metrics().countWrite(false);
                 return false;
+            }
         }
 
         bool remove(const std::string& key) override
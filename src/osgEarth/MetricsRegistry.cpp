@@ -0,0 +1,398 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/MetricsRegistry>
+#include <osgEarth/Threading>
+#include <osgEarth/Notify>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+
+#define LC "[MetricsRegistry] "
+
+std::atomic_bool MetricsRegistry::_enabled = { ::getenv("OSGEARTH_METRICS") != nullptr };
+
+namespace
+{
+    // index of the highest set bit; v must be nonzero
+    inline unsigned highestBit(std::uint64_t v)
+    {
+#ifdef _MSC_VER
+        unsigned long i;
+        _BitScanReverse64(&i, v);
+        return (unsigned)i;
+#else
+        return 63u - (unsigned)__builtin_clzll(v);
+#endif
+    }
+
+    // {a="1",b="2"}, or empty
+    std::string renderLabels(const MetricsRegistry::Labels& labels, const std::string& extra = {})
+    {
+        if (labels.empty() && extra.empty())
+            return {};
+
+        std::string out = "{";
+        for (auto& label : labels)
+        {
+            if (out.size() > 1)
+                out += ',';
+            out += label.first + "=\"";
+            for (char c : label.second)
+            {
+                if (c == '\\' || c == '"') out += '\\', out += c;
+                else if (c == '\n') out += "\\n";
+                else out += c;
+            }
+            out += '"';
+        }
+        if (!extra.empty())
+        {
+            if (out.size() > 1)
+                out += ',';
+            out += extra;
+        }
+        return out + "}";
+    }
+
+    std::string jsonString(const std::string& in)
+    {
+        std::string out = "\"";
+        for (char c : in)
+        {
+            if (c == '\\' || c == '"') out += '\\', out += c;
+            else if (c == '\n') out += "\\n";
+            else if ((unsigned char)c < 0x20) out += ' ';
+            else out += c;
+        }
+        return out + "\"";
+    }
+
+    const char* typeName(int type)
+    {
+        return type == 0 ? "counter" : type == 1 ? "gauge" : "histogram";
+    }
+}
+
+//........................................................................
+
+unsigned
+MetricsRegistry::Histogram::bucketOf(std::uint64_t micros)
+{
+    const std::uint64_t sub = 1u << SUB_BUCKET_BITS;
+    if (micros < sub)
+        return (unsigned)micros;
+
+    unsigned shift = highestBit(micros) - SUB_BUCKET_BITS;
+    if (shift > MAX_VALUE_BITS - SUB_BUCKET_BITS - 1u)
+        return NUM_BUCKETS - 1u;
+
+    // (shift << bits) + a sub-bucket in [sub, 2*sub)
+    return (shift << SUB_BUCKET_BITS) + (unsigned)(micros >> shift);
+}
+
+std::uint64_t
+MetricsRegistry::Histogram::bucketLowerBound(unsigned index)
+{
+    const unsigned sub = 1u << SUB_BUCKET_BITS;
+    if (index < 2u * sub)
+        return index;
+
+    unsigned shift = (index >> SUB_BUCKET_BITS) - 1u;
+    return (std::uint64_t)(index - (shift << SUB_BUCKET_BITS)) << shift;
+}
+
+std::uint64_t
+MetricsRegistry::Histogram::bucketUpperBound(unsigned index)
+{
+    const unsigned sub = 1u << SUB_BUCKET_BITS;
+    if (index < 2u * sub)
+        return index + 1u;
+
+    unsigned shift = (index >> SUB_BUCKET_BITS) - 1u;
+    return bucketLowerBound(index) + ((std::uint64_t)1u << shift);
+}
+
+void
+MetricsRegistry::Histogram::record(std::uint64_t micros)
+{
+    if (!enabled())
+        return;
+
+    _buckets[bucketOf(micros)].fetch_add(1u, std::memory_order_relaxed);
+    _count.fetch_add(1u, std::memory_order_relaxed);
+    _sum.fetch_add(micros, std::memory_order_relaxed);
+
+    std::uint64_t prev = _max.load(std::memory_order_relaxed);
+    while (micros > prev && !_max.compare_exchange_weak(prev, micros, std::memory_order_relaxed));
+}
+
+std::uint64_t
+MetricsRegistry::Histogram::percentile(double q) const
+{
+    std::uint64_t total = count();
+    if (total == 0u)
+        return 0u;
+
+    std::uint64_t target = std::max((std::uint64_t)1u,
+        (std::uint64_t)std::ceil(std::min(std::max(q, 0.0), 1.0) * (double)total));
+
+    std::uint64_t seen = 0u;
+    for (unsigned i = 0; i < NUM_BUCKETS; ++i)
+    {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return std::min(bucketUpperBound(i) - 1u, max());
+    }
+    return max();
+}
+
+void
+MetricsRegistry::Histogram::reset()
+{
+    for (auto& bucket : _buckets)
+        bucket.store(0u, std::memory_order_relaxed);
+    _count.store(0u, std::memory_order_relaxed);
+    _sum.store(0u, std::memory_order_relaxed);
+    _max.store(0u, std::memory_order_relaxed);
+}
+
+//........................................................................
+
+MetricsRegistry&
+MetricsRegistry::instance()
+{
+    // never destroyed, so that threads still running at exit can record
+    static MetricsRegistry* s_instance = new MetricsRegistry();
+    return *s_instance;
+}
+
+MetricsRegistry::MetricsRegistry()
+{
+    _mismatch.counter = std::make_unique<Counter>();
+    _mismatch.gauge = std::make_unique<Gauge>();
+    _mismatch.histogram = std::make_unique<Histogram>();
+
+    // Job pool activity, mirrored from the weejobs metrics
+    addCollector([](MetricsRegistry& registry)
+        {
+            for (auto* pool : jobs::get_metrics()->all())
+            {
+                if (!pool)
+                    continue;
+
+                Labels labels{ { "pool", pool->name } };
+                registry.gauge("osgearth_jobs_concurrency", "Threads in a job pool", labels).set(pool->concurrency);
+                registry.gauge("osgearth_jobs_pending", "Jobs waiting to run", labels).set(pool->pending);
+                registry.gauge("osgearth_jobs_running", "Jobs running", labels).set(pool->running);
+                registry.gauge("osgearth_jobs_postprocessing", "Jobs in post-processing", labels).set(pool->postprocessing);
+                registry.counter("osgearth_jobs_total", "Jobs dispatched", labels).set(pool->total);
+                registry.counter("osgearth_jobs_canceled_total", "Jobs canceled before running", labels).set(pool->canceled);
+            }
+        });
+}
+
+void
+MetricsRegistry::setEnabled(bool value)
+{
+    _enabled = value;
+}
+
+MetricsRegistry::Series&
+MetricsRegistry::series(const std::string& name, const std::string& help, const Labels& labels, Type type)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto iter = _families.find(name);
+    if (iter == _families.end())
+    {
+        iter = _families.emplace(name, Family()).first;
+        iter->second.type = type;
+        iter->second.help = help;
+    }
+    else if (iter->second.type != type)
+    {
+        OE_WARN << LC << "\"" << name << "\" is a " << typeName(iter->second.type)
+            << ", not a " << typeName(type) << "; values will not be exported" << std::endl;
+        return _mismatch;
+    }
+
+    Series& s = iter->second.series[renderLabels(labels)];
+    if (!s.counter && !s.gauge && !s.histogram)
+    {
+        s.labels = labels;
+        if (type == COUNTER) s.counter = std::make_unique<Counter>();
+        else if (type == GAUGE) s.gauge = std::make_unique<Gauge>();
+        else s.histogram = std::make_unique<Histogram>();
+    }
+    return s;
+}
+
+MetricsRegistry::Counter&
+MetricsRegistry::counter(const std::string& name, const std::string& help, const Labels& labels)
+{
+    return *series(name, help, labels, COUNTER).counter;
+}
+
+MetricsRegistry::Gauge&
+MetricsRegistry::gauge(const std::string& name, const std::string& help, const Labels& labels)
+{
+    return *series(name, help, labels, GAUGE).gauge;
+}
+
+MetricsRegistry::Histogram&
+MetricsRegistry::histogram(const std::string& name, const std::string& help, const Labels& labels)
+{
+    return *series(name, help, labels, HISTOGRAM).histogram;
+}
+
+void
+MetricsRegistry::addCollector(Collector collector)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _collectors.emplace_back(collector);
+}
+
+void
+MetricsRegistry::collect()
+{
+    // collectors look up metrics, so run them outside the lock
+    std::vector<Collector> collectors;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        collectors = _collectors;
+    }
+    for (auto& collector : collectors)
+        collector(*this);
+}
+
+std::string
+MetricsRegistry::toJSON()
+{
+    collect();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::ostringstream out;
+    out << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"metrics\":[";
+
+    bool first = true;
+    for (auto& family : _families)
+    {
+        for (auto& s : family.second.series)
+        {
+            out << (first ? "" : ",") << "{\"name\":" << jsonString(family.first)
+                << ",\"type\":\"" << typeName(family.second.type) << "\""
+                << ",\"help\":" << jsonString(family.second.help)
+                << ",\"labels\":{";
+            for (unsigned i = 0; i < s.second.labels.size(); ++i)
+            {
+                out << (i > 0 ? "," : "") << jsonString(s.second.labels[i].first)
+                    << ":" << jsonString(s.second.labels[i].second);
+            }
+            out << "}";
+
+            if (s.second.counter)
+            {
+                out << ",\"value\":" << s.second.counter->value();
+            }
+            else if (s.second.gauge)
+            {
+                out << ",\"value\":" << s.second.gauge->value();
+            }
+            else
+            {
+                const Histogram& h = *s.second.histogram;
+                std::uint64_t count = h.count();
+                out << ",\"count\":" << count
+                    << ",\"sum_us\":" << h.sum()
+                    << ",\"mean_us\":" << (count > 0 ? h.sum() / count : 0u)
+                    << ",\"p50_us\":" << h.percentile(0.5)
+                    << ",\"p90_us\":" << h.percentile(0.9)
+                    << ",\"p99_us\":" << h.percentile(0.99)
+                    << ",\"p999_us\":" << h.percentile(0.999)
+                    << ",\"max_us\":" << h.max();
+            }
+            out << "}";
+            first = false;
+        }
+    }
+    out << "]}";
+    return out.str();
+}
+
+std::string
+MetricsRegistry::toPrometheus()
+{
+    collect();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    for (auto& family : _families)
+    {
+        const std::string& name = family.first;
+        out << "# HELP " << name << " " << family.second.help << "\n"
+            << "# TYPE " << name << " " << typeName(family.second.type) << "\n";
+
+        for (auto& s : family.second.series)
+        {
+            if (s.second.counter)
+            {
+                out << name << s.first << " " << s.second.counter->value() << "\n";
+            }
+            else if (s.second.gauge)
+            {
+                out << name << s.first << " " << s.second.gauge->value() << "\n";
+            }
+            else
+            {
+                // Cumulative buckets at each power of two, up to the largest value
+                const Histogram& h = *s.second.histogram;
+                std::uint64_t count = h.count(), cumulative = 0u;
+                for (unsigned i = 0; i < Histogram::NUM_BUCKETS; ++i)
+                {
+                    cumulative += h._buckets[i].load(std::memory_order_relaxed);
+                    std::uint64_t upper = Histogram::bucketUpperBound(i);
+                    if ((upper & (upper - 1u)) == 0u)
+                    {
+                        std::ostringstream le;
+                        le << std::setprecision(9) << "le=\"" << (double)upper * 1e-6 << "\"";
+                        out << name << "_bucket" << renderLabels(s.second.labels, le.str()) << " " << cumulative << "\n";
+                        if (cumulative >= count)
+                            break;
+                    }
+                }
+                out << name << "_bucket" << renderLabels(s.second.labels, "le=\"+Inf\"") << " " << count << "\n"
+                    << name << "_sum" << s.first << " " << (double)h.sum() * 1e-6 << "\n"
+                    << name << "_count" << s.first << " " << count << "\n";
+            }
+        }
+    }
+    return out.str();
+}
+
+void
+MetricsRegistry::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto& family : _families)
+    {
+        for (auto& s : family.second.series)
+        {
+            if (s.second.counter) s.second.counter->_value = 0u;
+            if (s.second.gauge) s.second.gauge->_value = 0;
+            if (s.second.histogram) s.second.histogram->reset();
+        }
+    }
+}
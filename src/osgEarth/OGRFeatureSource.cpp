@@ -10,6 +10,7 @@
 #include <osgEarth/StringUtils>
 
 #include <gdal.h>
+#include <cstring>
 #include <queue>
 
 #ifdef OSGEARTH_HAVE_SUPERLUMINALAPI
@@ -71,6 +72,298 @@ namespace osgEarth { namespace OGR
 
 //........................................................................
 
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,6,0)
+#define OSGEARTH_OGR_ARROW_STREAM
+#endif
+
+namespace osgEarth { namespace OGR
+{
+    /**
+     * Reads a layer in columnar record batches through GDAL's Arrow C stream
+     * interface, and converts each batch to features in one pass: field
+     * names are resolved once per stream instead of once per feature, and
+     * geometry is decoded straight from WKB.
+     */
+    struct ArrowBatchReader
+    {
+#ifdef OSGEARTH_OGR_ARROW_STREAM
+        enum Kind { SKIP, FID, BOOLEAN, INT8, UINT8, INT16, UINT16, INT32, UINT32, INT64, UINT64, FLOAT, DOUBLE, STRING, LARGE_STRING, BINARY, LARGE_BINARY };
+
+        struct Column
+        {
+            Kind kind = SKIP;
+            AttributeKey name;
+        };
+
+        ArrowArrayStream stream;
+        ArrowSchema schema;
+        bool streamValid = false;
+        bool schemaValid = false;
+        std::vector<Column> columns;
+        int fidColumn = -1;
+        int geometryColumn = -1;
+
+        ArrowBatchReader()
+        {
+            std::memset(&stream, 0, sizeof(stream));
+            std::memset(&schema, 0, sizeof(schema));
+        }
+
+        ~ArrowBatchReader()
+        {
+            if (schemaValid && schema.release)
+                schema.release(&schema);
+            if (streamValid && stream.release)
+                stream.release(&stream);
+        }
+
+        // Value of a key in an Arrow metadata blob
+        static std::string getMetadata(const char* metadata, const std::string& key)
+        {
+            if (!metadata)
+                return {};
+            auto readInt = [&metadata]() {
+                std::int32_t value;
+                std::memcpy(&value, metadata, 4);
+                metadata += 4;
+                return value;
+            };
+            std::int32_t count = readInt();
+            for (std::int32_t i = 0; i < count; ++i)
+            {
+                std::int32_t keyLength = readInt();
+                std::string k(metadata, keyLength);
+                metadata += keyLength;
+                std::int32_t valueLength = readInt();
+                std::string v(metadata, valueLength);
+                metadata += valueLength;
+                if (k == key)
+                    return v;
+            }
+            return {};
+        }
+
+        static Kind getKind(const ArrowSchema* field)
+        {
+            if (field->dictionary)
+                return SKIP;
+
+            std::string format(field->format);
+            if (format == "b") return BOOLEAN;
+            if (format == "c") return INT8;
+            if (format == "C") return UINT8;
+            if (format == "s") return INT16;
+            if (format == "S") return UINT16;
+            if (format == "i") return INT32;
+            if (format == "I") return UINT32;
+            if (format == "l") return INT64;
+            if (format == "L") return UINT64;
+            if (format == "f") return FLOAT;
+            if (format == "g") return DOUBLE;
+            if (format == "u") return STRING;
+            if (format == "U") return LARGE_STRING;
+            if (format == "z") return BINARY;
+            if (format == "Z") return LARGE_BINARY;
+            return SKIP;
+        }
+
+        //! Starts the stream. Returns false if the layer has no fast Arrow path
+        //! or has fields the batch conversion doesn't handle, in which case
+        //! the caller reads features one at a time instead.
+        bool open(OGRLayerH layer, unsigned chunkSize)
+        {
+            if (!OGR_L_TestCapability(layer, OLCFastGetArrowStream))
+                return false;
+
+            std::string maxFeatures = "MAX_FEATURES_IN_BATCH=" + std::to_string(std::min(chunkSize, 65536u));
+            const char* streamOptions[] = {
+                "INCLUDE_FID=YES",
+                maxFeatures.c_str(),
+                nullptr
+            };
+
+            if (!OGR_L_GetArrowStream(layer, &stream, const_cast<char**>(streamOptions)))
+                return false;
+            streamValid = true;
+
+            if (stream.get_schema(&stream, &schema) != 0)
+                return false;
+            schemaValid = true;
+
+            const char* fidName = OGR_L_GetFIDColumn(layer);
+            std::string fidColumnName = (fidName && *fidName) ? fidName : "OGC_FID";
+
+            const char* geometryName = OGR_L_GetGeometryColumn(layer);
+            std::string geometryColumnName = (geometryName && *geometryName) ? geometryName : "wkb_geometry";
+
+            columns.resize(schema.n_children);
+            for (int i = 0; i < (int)schema.n_children; ++i)
+            {
+                const ArrowSchema* field = schema.children[i];
+                std::string name = field->name ? field->name : "";
+                Column& column = columns[i];
+                column.name = AttributeKey(name);
+                column.kind = getKind(field);
+
+                if (column.kind == BINARY || column.kind == LARGE_BINARY)
+                {
+                    bool isGeometry =
+                        getMetadata(field->metadata, "ARROW:extension:name") == "ogc.wkb" ||
+                        ciEquals(name, geometryColumnName);
+
+                    // binary attributes would need OGR's string formatting
+                    if (!isGeometry)
+                        return false;
+
+                    // only the first geometry field, like OGR_F_GetGeometryRef
+                    if (geometryColumn < 0)
+                        geometryColumn = i;
+                    else
+                        column.kind = SKIP;
+                }
+                else if (fidColumn < 0 && column.kind == INT64 && ciEquals(name, fidColumnName))
+                {
+                    column.kind = FID;
+                    fidColumn = i;
+                }
+                else if (column.kind == SKIP)
+                {
+                    // dates, lists, dictionaries... these would need OGR's string formatting
+                    return false;
+                }
+            }
+
+            return fidColumn >= 0;
+        }
+
+        static bool isValid(const ArrowArray* array, std::int64_t i)
+        {
+            if (array->null_count == 0 || array->buffers[0] == nullptr)
+                return true;
+            const std::uint8_t* bits = static_cast<const std::uint8_t*>(array->buffers[0]);
+            return (bits[i >> 3] & (1 << (i & 7))) != 0;
+        }
+
+        template<typename T>
+        static T value(const ArrowArray* array, std::int64_t i)
+        {
+            return static_cast<const T*>(array->buffers[1])[i];
+        }
+
+        template<typename OFFSET>
+        static std::pair<const char*, std::size_t> bytes(const ArrowArray* array, std::int64_t i)
+        {
+            const OFFSET* offsets = static_cast<const OFFSET*>(array->buffers[1]);
+            const char* data = static_cast<const char*>(array->buffers[2]);
+            return { data + offsets[i], (std::size_t)(offsets[i + 1] - offsets[i]) };
+        }
+
+        //! Converts the next record batch. Returns false at the end of the
+        //! stream or on error.
+        bool next(const OgrUtils::OGRFeatureFactory& factory, FeatureList& output)
+        {
+            ArrowArray batch;
+            std::memset(&batch, 0, sizeof(batch));
+            if (stream.get_next(&stream, &batch) != 0 || batch.release == nullptr)
+            {
+                if (batch.release)
+                    batch.release(&batch);
+                return false;
+            }
+
+            std::size_t first = output.size();
+            output.reserve(first + (std::size_t)batch.length);
+
+            for (std::int64_t row = 0; row < batch.length; ++row)
+            {
+                Geometry* geometry = nullptr;
+                if (geometryColumn >= 0)
+                {
+                    const ArrowArray* array = batch.children[geometryColumn];
+                    std::int64_t i = array->offset + batch.offset + row;
+                    if (isValid(array, i))
+                    {
+                        auto wkb = columns[geometryColumn].kind == BINARY ? bytes<std::int32_t>(array, i) : bytes<std::int64_t>(array, i);
+                        geometry = OgrUtils::createGeometryFromWKB(
+                            reinterpret_cast<const unsigned char*>(wkb.first), wkb.second, factory.rewindPolygons);
+                    }
+                }
+
+                const ArrowArray* fids = batch.children[fidColumn];
+                FeatureID fid = value<std::int64_t>(fids, fids->offset + batch.offset + row);
+
+                Feature* feature = new Feature(geometry, factory.srs, Style(), fid);
+                if (factory.srs && factory.interp.isSet())
+                    feature->geoInterp() = factory.interp.value();
+                output.emplace_back(feature);
+            }
+
+            // attributes go column by column
+            for (int c = 0; c < (int)columns.size(); ++c)
+            {
+                const Column& column = columns[c];
+                if (column.kind == SKIP || column.kind == FID || c == geometryColumn)
+                    continue;
+
+                const ArrowArray* array = batch.children[c];
+                for (std::int64_t row = 0; row < batch.length; ++row)
+                {
+                    Feature* feature = output[first + row].get();
+                    std::int64_t i = array->offset + batch.offset + row;
+
+                    if (!isValid(array, i))
+                    {
+                        if (factory.keepNullValues)
+                            feature->setNull(column.name);
+                        continue;
+                    }
+
+                    switch (column.kind)
+                    {
+                    case BOOLEAN:
+                    {
+                        const std::uint8_t* bits = static_cast<const std::uint8_t*>(array->buffers[1]);
+                        feature->set(column.name, (long long)((bits[i >> 3] >> (i & 7)) & 1));
+                        break;
+                    }
+                    case INT8: feature->set(column.name, (long long)value<std::int8_t>(array, i)); break;
+                    case UINT8: feature->set(column.name, (long long)value<std::uint8_t>(array, i)); break;
+                    case INT16: feature->set(column.name, (long long)value<std::int16_t>(array, i)); break;
+                    case UINT16: feature->set(column.name, (long long)value<std::uint16_t>(array, i)); break;
+                    case INT32: feature->set(column.name, (long long)value<std::int32_t>(array, i)); break;
+                    case UINT32: feature->set(column.name, (long long)value<std::uint32_t>(array, i)); break;
+                    case INT64: feature->set(column.name, (long long)value<std::int64_t>(array, i)); break;
+                    case UINT64: feature->set(column.name, (long long)value<std::uint64_t>(array, i)); break;
+                    case FLOAT: feature->set(column.name, (double)value<float>(array, i)); break;
+                    case DOUBLE: feature->set(column.name, value<double>(array, i)); break;
+                    case STRING:
+                    {
+                        auto str = bytes<std::int32_t>(array, i);
+                        feature->set(column.name, std::string(str.first, str.second));
+                        break;
+                    }
+                    case LARGE_STRING:
+                    {
+                        auto str = bytes<std::int64_t>(array, i);
+                        feature->set(column.name, std::string(str.first, str.second));
+                        break;
+                    }
+                    default:
+                        break;
+                    }
+                }
+            }
+
+            batch.release(&batch);
+            return true;
+        }
+#else
+        bool open(OGRLayerH, unsigned) { return false; }
+        bool next(const OgrUtils::OGRFeatureFactory&, FeatureList&) { return false; }
+#endif
+    };
+} }
+
 OGR::OGRFeatureCursor::OGRFeatureCursor(
     void* dsHandle,
     void* layerHandle,
@@ -80,7 +373,8 @@ OGR::OGRFeatureCursor::OGRFeatureCursor(
     const FeatureFilterChain& filters,
     bool rewindPolygons,
     unsigned chunkSize,
-    ProgressCallback* progress) :
+    ProgressCallback* progress,
+    bool useArrowStream) :
 
     FeatureCursor(progress),
     _source(source),
@@ -186,6 +480,16 @@ OGR::OGRFeatureCursor::OGRFeatureCursor(
 
     OGR_L_ResetReading(static_cast<OGRLayerH>(_resultSetHandle));
 
+    if (useArrowStream && _resultSetHandle && _profile.valid())
+    {
+        _arrow.reset(new ArrowBatchReader());
+        if (!_arrow->open(static_cast<OGRLayerH>(_resultSetHandle), _chunkSize))
+        {
+            _arrow.reset();
+            OGR_L_ResetReading(static_cast<OGRLayerH>(_resultSetHandle));
+        }
+    }
+
     readChunk();
 }
 
@@ -204,6 +508,9 @@ OGR::OGRFeatureCursor::OGRFeatureCursor(void* resultSetHandle, const FeatureProf
 
 OGR::OGRFeatureCursor::~OGRFeatureCursor()
 {
+    // the stream belongs to the layer, so release it first
+    _arrow.reset();
+
     if ( _nextHandleToQueue )
         OGR_F_Destroy( static_cast<OGRFeatureH>(_nextHandleToQueue) );
 
@@ -249,6 +556,12 @@ OGR::OGRFeatureCursor::readChunk()
     if ( !_resultSetHandle )
         return;
 
+    if (_arrow)
+    {
+        readArrowChunk();
+        return;
+    }
+
     OgrUtils::OGRFeatureFactory factory;
     factory.srs = _profile->getSRS();
     factory.interp = _profile->geoInterp();
@@ -306,6 +619,38 @@ OGR::OGRFeatureCursor::readChunk()
     }
 }
 
+// same as readChunk, but converts whole record batches from the Arrow stream
+void
+OGR::OGRFeatureCursor::readArrowChunk()
+{
+    OgrUtils::OGRFeatureFactory factory;
+    factory.srs = _profile->getSRS();
+    factory.interp = _profile->geoInterp();
+    factory.rewindPolygons = _rewindPolygons;
+
+    FeatureList batch;
+    while (_queue.size() < _chunkSize && !_resultSetEndReached)
+    {
+        batch.clear();
+        if (!_arrow->next(factory, batch))
+        {
+            _resultSetEndReached = true;
+            break;
+        }
+
+        for (auto& feature : batch)
+        {
+            if (_source == NULL || !_source->isBlacklisted(feature->getFID()))
+            {
+                if (validateGeometry(feature->getGeometry()))
+                {
+                    _queue.push(feature);
+                }
+            }
+        }
+    }
+}
+
 //........................................................................
 
 Config
@@ -321,6 +666,7 @@ OGRFeatureSource::Options::getConfig() const
     conf.set("geometry_url", _geometryUrl);
     conf.set("layer", _layer);
     conf.set("query", _query);
+    conf.set("use_arrow_stream", _useArrowStream);
     return conf;
 }
 
@@ -336,6 +682,7 @@ OGRFeatureSource::Options::fromConfig(const Config& conf)
     conf.get("geometry_url", _geometryUrl);
     conf.get("layer", _layer);
     conf.get("query", _query);
+    conf.get("use_arrow_stream", _useArrowStream);
 }
 
 //........................................................................
@@ -349,6 +696,7 @@ OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, std::string, OGRDriver, ogrDriver);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, URI, GeometryURL, geometryUrl);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, std::string, Layer, layer);
 OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, Query, Query, query);
+OE_LAYER_PROPERTY_IMPL(OGRFeatureSource, bool, UseArrowStream, useArrowStream);
 
 void
 OGRFeatureSource::init()
@@ -850,7 +1198,8 @@ OGRFeatureSource::createFeatureCursorImplementation(const Query& query, Progress
                 getFilters(),
                 _options->rewindPolygons().get(),
                 0, // default chunksize
-                progress
+                progress,
+                options().useArrowStream().get()
                 );
         }
         else
@@ -942,7 +1291,7 @@ OGRFeatureSource::insertFeature(Feature* feature)
             std::string name = OGR_Fld_GetNameRef(field_handle_ref);
             int field_index = OGR_F_GetFieldIndex(feature_handle, name.c_str());
 
-            AttributeTable::const_iterator a = attrs.find(toLower(name));
+            AttributeTable::const_iterator a = attrs.find(AttributeKey::find(name));
             if (a != attrs.end())
             {
                 switch (OGR_Fld_GetType(field_handle_ref))
@@ -3,6 +3,8 @@
 * MIT License
 */
 #include <osgEarth/OgrUtils>
+#include <algorithm>
+#include <cstring>
 
 #define LC "[FeatureSource] "
 
@@ -234,6 +236,232 @@ OgrUtils::createGeometry( OGRGeometryH geomHandle, bool rewindPolygons)
     return output;
 }
 
+namespace
+{
+    // Reads WKB into osgEarth geometry, following the same rules as
+    // OgrUtils::createGeometry. Returns false on anything it doesn't
+    // handle (curves, TINs, truncated data) so the caller can fall back on OGR.
+    struct WKBReader
+    {
+        const unsigned char* ptr;
+        const unsigned char* end;
+        bool rewindPolygons;
+        bool swap = false;
+        bool hasZ = false;
+        bool hasM = false;
+
+        bool readByteOrder()
+        {
+            if (ptr >= end) return false;
+            swap = ((*ptr++ == 1) != isLittleEndian());
+            return true;
+        }
+
+        static bool isLittleEndian()
+        {
+            const std::uint16_t one = 1;
+            return *reinterpret_cast<const std::uint8_t*>(&one) == 1;
+        }
+
+        bool readUInt(std::uint32_t& value)
+        {
+            if (end - ptr < 4) return false;
+            std::memcpy(&value, ptr, 4);
+            ptr += 4;
+            if (swap)
+                value = (value >> 24) | ((value >> 8) & 0xff00) | ((value << 8) & 0xff0000) | (value << 24);
+            return true;
+        }
+
+        double readDouble()
+        {
+            unsigned char bytes[8];
+            std::memcpy(bytes, ptr, 8);
+            ptr += 8;
+            if (swap)
+                std::reverse(bytes, bytes + 8);
+            double value;
+            std::memcpy(&value, bytes, 8);
+            return value;
+        }
+
+        // type code without dimension flags, plus the dimensions
+        bool readType(std::uint32_t& base)
+        {
+            std::uint32_t type;
+            if (!readByteOrder() || !readUInt(type))
+                return false;
+
+            hasZ = (type & 0x80000000u) != 0; // 2.5D or EWKB
+            hasM = (type & 0x40000000u) != 0; // EWKB
+            if (type & 0x20000000u)           // EWKB SRID
+            {
+                std::uint32_t srid;
+                if (!readUInt(srid)) return false;
+            }
+            type &= 0x0fffffffu;
+
+            switch (type / 1000u) // ISO
+            {
+            case 1: hasZ = true; break;
+            case 2: hasM = true; break;
+            case 3: hasZ = true; hasM = true; break;
+            }
+            base = type % 1000u;
+            return true;
+        }
+
+        bool readPoints(Geometry* target, std::uint32_t count)
+        {
+            std::size_t stride = 8u * (2u + (hasZ ? 1u : 0u) + (hasM ? 1u : 0u));
+            if ((std::size_t)(end - ptr) / stride < count)
+                return false;
+
+            target->reserve(target->size() + count);
+            for (std::uint32_t v = 0; v < count; ++v)
+            {
+                osg::Vec3d p;
+                p.x() = readDouble();
+                p.y() = readDouble();
+                p.z() = hasZ ? readDouble() : 0.0;
+                if (hasM) ptr += 8;
+                if (target->size() == 0 || p != target->back()) // remove dupes
+                    target->push_back(p);
+            }
+            return true;
+        }
+
+        bool readPoint(Geometry* target)
+        {
+            // WKB writes an empty point as NaN coordinates
+            std::size_t stride = 8u * (2u + (hasZ ? 1u : 0u) + (hasM ? 1u : 0u));
+            if ((std::size_t)(end - ptr) < stride)
+                return false;
+            const unsigned char* start = ptr;
+            double x = readDouble();
+            ptr = start;
+            if (osg::isNaN(x))
+            {
+                ptr += stride;
+                return true;
+            }
+            return readPoints(target, 1);
+        }
+
+        bool readRing(Ring* ring, Ring::Orientation orientation)
+        {
+            std::uint32_t count;
+            if (!readUInt(count) || !readPoints(ring, count))
+                return false;
+            if (rewindPolygons)
+            {
+                ring->open();
+                ring->rewind(orientation);
+            }
+            return true;
+        }
+
+        Geometry* read()
+        {
+            std::uint32_t type, count;
+            if (!readType(type))
+                return nullptr;
+
+            switch (type)
+            {
+            case 1: // point
+            {
+                osg::ref_ptr<Point> point = new Point();
+                return readPoint(point.get()) ? point.release() : nullptr;
+            }
+
+            case 2: // linestring
+            {
+                osg::ref_ptr<LineString> line = new LineString();
+                return readUInt(count) && readPoints(line.get(), count) ? line.release() : nullptr;
+            }
+
+            case 3: // polygon
+            {
+                if (!readUInt(count))
+                    return nullptr;
+                osg::ref_ptr<Polygon> polygon = new Polygon();
+                for (std::uint32_t r = 0; r < count; ++r)
+                {
+                    if (r == 0)
+                    {
+                        if (!readRing(polygon.get(), Ring::ORIENTATION_CCW))
+                            return nullptr;
+                    }
+                    else
+                    {
+                        osg::ref_ptr<Ring> hole = new Ring();
+                        if (!readRing(hole.get(), Ring::ORIENTATION_CW))
+                            return nullptr;
+                        polygon->getHoles().push_back(hole.get());
+                    }
+                }
+                return polygon.release();
+            }
+
+            case 4: // multipoint
+            {
+                if (!readUInt(count))
+                    return nullptr;
+                osg::ref_ptr<PointSet> points = new PointSet();
+                for (std::uint32_t n = 0; n < count; ++n)
+                {
+                    std::uint32_t partType;
+                    if (!readType(partType) || partType != 1 || !readPoint(points.get()))
+                        return nullptr;
+                }
+                return points.release();
+            }
+
+            case 5: // multilinestring
+            case 6: // multipolygon
+            case 7: // geometrycollection
+            {
+                if (!readUInt(count))
+                    return nullptr;
+                osg::ref_ptr<MultiGeometry> multi = new MultiGeometry();
+                for (std::uint32_t n = 0; n < count; ++n)
+                {
+                    Geometry* part = read();
+                    if (!part)
+                        return nullptr;
+                    multi->getComponents().push_back(part);
+                }
+                return multi.release();
+            }
+            }
+
+            return nullptr;
+        }
+    };
+}
+
+Geometry*
+OgrUtils::createGeometryFromWKB(const unsigned char* data, std::size_t length, bool rewindPolygons)
+{
+    if (!data || length == 0)
+        return nullptr;
+
+    WKBReader reader{ data, data + length, rewindPolygons };
+    Geometry* output = reader.read();
+    if (output)
+        return output;
+
+    // something we don't decode ourselves; let OGR have a go
+    OGRGeometryH handle = nullptr;
+    if (OGR_G_CreateFromWkb(data, nullptr, &handle, (int)length) == OGRERR_NONE && handle)
+    {
+        output = createGeometry(handle, rewindPolygons);
+        OGR_G_DestroyGeometry(handle);
+    }
+    return output;
+}
+
 OGRGeometryH
 OgrUtils::encodePart( const Geometry* geometry, OGRwkbGeometryType part_type )
 {
@@ -498,13 +726,13 @@ OgrUtils::OGRFeatureFactory::createFeature(OGRFeatureH handle) const
         feature->geoInterp() = interp.value();
 
     int numAttrs = OGR_F_GetFieldCount(handle);
+    feature->reserveAttrs(numAttrs);
     for (int i = 0; i < numAttrs; ++i)
     {
         OGRFieldDefnH field_handle_ref = OGR_F_GetFieldDefnRef( handle, i );
 
-        // get the field name and convert to lower case:
-        const char* field_name = OGR_Fld_GetNameRef( field_handle_ref );
-        std::string name = osgEarth::toLower( std::string(field_name) );
+        // get the (case-insensitive) attribute key for the field name:
+        AttributeKey name(OGR_Fld_GetNameRef( field_handle_ref ));
 
         // get the field type and set the value appropriately
         OGRFieldType field_type = OGR_Fld_GetType( field_handle_ref );
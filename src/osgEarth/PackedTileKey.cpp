@@ -0,0 +1,169 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/PackedTileKey>
+#include <osgEarth/Notify>
+#include <osgEarth/Threading>
+#include <osg/observer_ptr>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+using namespace osgEarth;
+
+#define LC "[PackedTileKey] "
+
+namespace
+{
+    // Process-wide table of the profiles referenced by packed keys.
+    // Index 0 is reserved so that a zero value is an invalid key.
+    struct ProfileTable
+    {
+        // Profiles by index, one per full signature, so that unpacking
+        // restores the vertical datum as well as the horizontal profile
+        osg::ref_ptr<const Profile> profiles[PackedTileKey::MAX_PROFILES + 1];
+        std::unordered_map<std::string, unsigned> indices;
+        Threading::ReadWriteMutex mutex;
+        std::atomic_bool warned = { false };
+
+        unsigned indexOf(const Profile* profile)
+        {
+            const std::string& signature = profile->getFullSignature();
+            {
+                Threading::ScopedReadLock lock(mutex);
+                auto i = indices.find(signature);
+                if (i != indices.end())
+                    return i->second;
+            }
+
+            Threading::ScopedWriteLock lock(mutex);
+            auto i = indices.find(signature);
+            if (i != indices.end())
+                return i->second;
+
+            if (indices.size() == PackedTileKey::MAX_PROFILES)
+            {
+                if (!warned.exchange(true))
+                    OE_WARN << LC << "Too many distinct profiles; keys in new profiles will not be packed" << std::endl;
+                return 0u;
+            }
+
+            unsigned index = (unsigned)indices.size() + 1u;
+            profiles[index] = profile;
+            indices.emplace(signature, index);
+            return index;
+        }
+    };
+
+    ProfileTable& profileTable()
+    {
+        // never destroyed, so keys stay valid during static destruction
+        static ProfileTable* s_table = new ProfileTable();
+        return *s_table;
+    }
+
+    // Profiles this thread packed keys for most recently. An observer
+    // does not keep its profile alive, and stops matching once the
+    // profile is deleted, so a new profile allocated at the same address
+    // never picks up a stale index.
+    struct RecentProfiles
+    {
+        static constexpr unsigned SIZE = 4u;
+        osg::observer_ptr<const Profile> profiles[SIZE];
+        unsigned indices[SIZE] = { 0u, 0u, 0u, 0u };
+        unsigned next = 0u;
+    };
+}
+
+unsigned
+PackedTileKey::getProfileIndex(const Profile* profile)
+{
+    if (!profile)
+        return 0u;
+
+    static thread_local RecentProfiles recent;
+
+    for (unsigned i = 0; i < RecentProfiles::SIZE; ++i)
+        if (recent.profiles[i].get() == profile)
+            return recent.indices[i];
+
+    unsigned index = profileTable().indexOf(profile);
+
+    recent.profiles[recent.next] = profile;
+    recent.indices[recent.next] = index;
+    recent.next = (recent.next + 1u) % RecentProfiles::SIZE;
+    return index;
+}
+
+bool
+PackedTileKey::fits(const TileKey& key)
+{
+    return
+        key.valid() &&
+        fits(key.getLOD(), key.getTileX(), key.getTileY()) &&
+        getProfileIndex(key.getProfile()) > 0u;
+}
+
+unsigned
+PackedTileKey::getMaxLOD(const Profile* profile)
+{
+    unsigned lod = 0u;
+    for (; lod + 1u < (1u << LOD_BITS); ++lod)
+    {
+        unsigned wide, high;
+        profile->getNumTiles(lod + 1u, wide, high);
+        if (!fits(lod + 1u, wide - 1u, high - 1u))
+            break;
+    }
+    return lod;
+}
+
+PackedTileKey::PackedTileKey(unsigned lod, unsigned x, unsigned y, const Profile* profile)
+{
+    if (profile)
+    {
+        _value = make(getProfileIndex(profile), lod, x, y)._value;
+    }
+}
+
+PackedTileKey::PackedTileKey(const TileKey& key) :
+    PackedTileKey(key.getLOD(), key.getTileX(), key.getTileY(), key.getProfile())
+{
+    //nop
+}
+
+PackedTileKey::operator TileKey() const
+{
+    if (!valid())
+        return TileKey::INVALID;
+
+    return TileKey(getLOD(), getTileX(), getTileY(), getProfile());
+}
+
+const Profile*
+PackedTileKey::getProfile() const
+{
+    return valid() ? profileTable().profiles[getProfileIndex()].get() : nullptr;
+}
+
+const GeoExtent
+PackedTileKey::getExtent() const
+{
+    const Profile* profile = getProfile();
+    if (!profile)
+        return GeoExtent::INVALID;
+
+    double width, height;
+    profile->getTileDimensions(getLOD(), width, height);
+    double xmin = profile->getExtent().xMin() + (width * (double)getTileX());
+    double ymax = profile->getExtent().yMax() - (height * (double)getTileY());
+
+    return GeoExtent(profile->getSRS(), xmin, ymax - height, xmin + width, ymax);
+}
+
+PackedTileKey
+PackedTileKey::fromMorton(unsigned lod, std::uint64_t code, const Profile* profile)
+{
+    return PackedTileKey(lod, compact(code), compact(code >> 1), profile);
+}
@@ -50,3 +50,32 @@ ScaleFilter::push( FeatureList& input, FilterContext& cx )
     return cx;
 }
 
+FilterContext
+ScaleFilter::pushBatch( FeatureBatch& input, FilterContext& cx )
+{
+    auto& coords = input.getCoords();
+    auto& parts = input.getParts();
+    auto& offsets = input.getPartOffsets();
+
+    for( std::size_t row = 0; row < input.size(); ++row )
+    {
+        if ( !input.hasGeometry(row) || offsets[row] == offsets[row+1] )
+            continue;
+
+        Bounds envelope = input.getBounds(row);
+
+        // a row's parts are contiguous in the coordinate buffer
+        auto end = coords.begin() + parts[offsets[row+1]-1].end;
+        for( auto v = coords.begin() + parts[offsets[row]].begin; v != end; ++v )
+        {
+            double xr = (v->x() - envelope.xMin()) / width(envelope);
+            v->x() += (xr - 0.5) * _scale;
+
+            double yr = (v->y() - envelope.yMin()) / height(envelope);
+            v->y() += (yr - 0.5) * _scale;
+        }
+    }
+
+    return cx;
+}
+
@@ -4,12 +4,14 @@
  */
 #include <osgEarth/Metrics>
 #include <osgEarth/TDTiles>
+#include <osgEarth/TDTilesTree>
 #include <osgEarth/Utils>
 #include <osgEarth/Registry>
 #include <osgEarth/URI>
 #include <osgEarth/NodeUtils>
 #include <osgEarth/FileUtils>
 #include <osgEarth/NetworkMonitor>
+#include <osgEarth/Progress>
 #include <osgEarth/Threading>
 #include <osgEarth/GLUtils>
 #include <osgEarth/LineDrawable>
@@ -17,6 +19,8 @@
 #include <osgDB/FileNameUtils>
 #include <osgDB/Registry>
 #include <osgUtil/IncrementalCompileOperation>
+#include <osg/Texture>
+#include <unordered_set>
 
 using namespace osgEarth;
 using namespace osgEarth::Threading;
@@ -383,6 +387,28 @@ Tile::getBoundingSphere()
     return bsphere;
 }
 
+bool
+Tile::mayHaveChildren() const
+{
+    return !children().empty() || (_deferredChildren.valid() && !_deferredChildren->empty());
+}
+
+bool
+Tile::resolveChildrenRequiresIO() const
+{
+    return _deferredChildren.valid() && _deferredChildren->requiresIO();
+}
+
+void
+Tile::resolveChildren(const osgDB::Options* readOptions)
+{
+    if (_deferredChildren.valid())
+    {
+        _deferredChildren->create(children(), readOptions);
+        _deferredChildren = nullptr;
+    }
+}
+
 //........................................................................
 
 void
@@ -416,15 +442,27 @@ Tileset::getJSON() const
 Tileset*
 Tileset::create(const std::string& json, const URIContext& uc)
 {
-    Json::Reader reader;
-    Json::Value root(Json::objectValue);
-    if (!reader.parse(json, root, false))
+    OE_PROFILING_ZONE;
+
+    // Parse into a compact tree instead of a JSON document; Tile objects
+    // are created from it as the scene graph reaches them.
+    TileTree::Header header;
+    std::string error;
+    osg::ref_ptr<TileTree> tree = TileTree::parse(json, header, error);
+    if (!tree.valid())
+    {
+        OE_WARN << LC << uc.referrer() << ": " << error << std::endl;
         return NULL;
+    }
 
-    LoadContext lc;
-    lc._uc = uc;
+    Tileset* tileset = new Tileset();
+    tileset->asset() = header.asset;
+    if (header.geometricError.isSet())
+        tileset->geometricError() = header.geometricError.get();
+    if (tree->size() > 0)
+        tileset->root() = tree->createTile(0, uc, nullptr);
 
-    return new Tileset(root, lc);
+    return tileset;
 }
 
 static VirtualProgram* getOrCreateDebugVirtualProgram()
@@ -512,6 +550,72 @@ namespace
     };
 
 
+    // Estimates the memory held by a content node's geometry and textures.
+    struct ContentSizeVisitor : public osg::NodeVisitor
+    {
+        std::size_t _bytes = 0u;
+        std::unordered_set<const osg::Object*> _visited;
+
+        ContentSizeVisitor() : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN) { }
+
+        bool first(const osg::Object* object)
+        {
+            return object && _visited.insert(object).second;
+        }
+
+        void apply(osg::StateSet* stateSet)
+        {
+            if (!first(stateSet))
+                return;
+
+            for (unsigned unit = 0; unit < stateSet->getNumTextureAttributeLists(); ++unit)
+            {
+                auto texture = dynamic_cast<osg::Texture*>(
+                    stateSet->getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+
+                if (texture)
+                {
+                    for (unsigned i = 0; i < texture->getNumImages(); ++i)
+                    {
+                        const osg::Image* image = texture->getImage(i);
+                        if (first(image))
+                            _bytes += image->getTotalSizeInBytesIncludingMipmaps();
+                    }
+                }
+            }
+        }
+
+        void apply(osg::Node& node) override
+        {
+            // nested tilesets account for their own content
+            if (dynamic_cast<ThreeDTilesetContentNode*>(&node))
+                return;
+
+            apply(node.getStateSet());
+            traverse(node);
+        }
+
+        void apply(osg::Geometry& geom) override
+        {
+            apply(geom.getStateSet());
+
+            osg::Geometry::ArrayList arrays;
+            geom.getArrayList(arrays);
+            for (auto& array : arrays)
+            {
+                if (first(array.get()))
+                    _bytes += array->getTotalDataSize();
+            }
+
+            for (unsigned i = 0; i < geom.getNumPrimitiveSets(); ++i)
+            {
+                auto elements = dynamic_cast<const osg::DrawElements*>(geom.getPrimitiveSet(i));
+                if (first(elements))
+                    _bytes += elements->getTotalDataSize();
+            }
+        }
+    };
+
     using ReadTileData = osg::ref_ptr<osg::Node>;
     using ReadTileResult = Future<ReadTileData>;
     //typedef Job<osg::ref_ptr<osg::Node>> AsyncTileJob;
@@ -525,10 +629,22 @@ namespace
         return operation.loadTileSet(nullptr);
     }
 
+    // Dynamic job priority that tracks the requesting tile as the camera moves.
+    std::function<float()> tilePriority(ThreeDTileNode* tile)
+    {
+        osg::observer_ptr<ThreeDTileNode> tile_weak(tile);
+        return [tile_weak]()
+            {
+                osg::ref_ptr<ThreeDTileNode> tile;
+                return tile_weak.lock(tile) ? tile->getPriority() : -FLT_MAX;
+            };
+    }
+
     ReadTileResult readTilesetAsync(
         ThreeDTilesetNode* parentTileset,
         const URI& uri,
-        osgDB::Options* options)
+        osgDB::Options* options,
+        ThreeDTileNode* tile)
     {
         std::shared_ptr<LoadTilesetOperation> operation = std::make_shared<LoadTilesetOperation>(
             parentTileset, uri, options);
@@ -538,8 +654,12 @@ namespace
             return operation->loadTileSet(&progress);
         };
 
-        return jobs::dispatch(job,
-            jobs::context{ uri.full(), jobs::get_pool("oe.3dtiles") });
+        jobs::context context;
+        context.name = uri.full();
+        context.pool = jobs::get_pool("oe.3dtiles");
+        context.priority = tilePriority(tile);
+
+        return jobs::dispatch(job, context);
     }
 
     osg::ref_ptr<osg::Node> readTileContentSync(
@@ -558,16 +678,19 @@ namespace
 
     ReadTileResult readTileContentAsync(
         const URI& uri,
-        osg::ref_ptr<const osgDB::Options> options)
+        osg::ref_ptr<const osgDB::Options> options,
+        ThreeDTileNode* tile)
     {
         jobs::context context;
         context.name = uri.full();
         context.pool = jobs::get_pool("oe.3dtiles");
+        context.priority = tilePriority(tile);
 
         return jobs::dispatch([uri, options](Cancelable& progress)
             {
-                osg::ref_ptr<osg::Node> node = uri.getNode(options.get(), nullptr);
-                if (node.valid())
+                osg::ref_ptr<ProgressCallback> p = new ProgressCallback(&progress);
+                osg::ref_ptr<osg::Node> node = uri.getNode(options.get(), p.get());
+                if (node.valid() && !progress.canceled())
                 {
                     ImageUtils::compressAndMipmapTextures(node.get());
                     GLObjectsCompiler compiler;
@@ -646,30 +769,106 @@ ThreeDTileNode::ThreeDTileNode(ThreeDTilesetNode* tileset, Tile* tile, bool imme
         OE_PROFILING_ZONE_TEXT("Immediate load");
     }
 
+    // Tiles from a compact tree or implicit tileset create their children on first use
+    if (!_tile->hasDeferredChildren())
+    {
+        _children = createChildren();
+        if (_children.valid())
+        {
+            addChild(_children.get());
+        }
+        _childrenResolved = true;
+    }
+
+    _debugColor = randomColor();
+
+    getOrCreateStateSet()->getOrCreateUniform("debugColor", osg::Uniform::FLOAT_VEC4)->set(_debugColor);
+
+    computeBoundingVolume();
+
+    createDebugBounds();
+}
+
+osg::ref_ptr<osg::Group> ThreeDTileNode::createChildren()
+{
+    _tile->resolveChildren(_options.get());
+
+    osg::ref_ptr<osg::Group> children;
     if (_tile->children().size() > 0)
     {
-        _children = new osg::Group;
+        children = new osg::Group;
         for (unsigned int i = 0; i < _tile->children().size(); ++i)
         {
             ThreeDTileNode* child = new ThreeDTileNode(_tileset, _tile->children()[i].get(), false, _options.get());
             child->setParentTile(this);
-            _children->addChild(child);
+            children->addChild(child);
         }
+    }
+    return children;
+}
+
+bool ThreeDTileNode::resolveChildren()
+{
+    if (_childrenResolved)
+    {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_childrenMutex);
 
-        if (_children->getNumChildren() == 0)
+        if (_childrenResolved || !_childrenFuture.empty())
         {
-            _children = 0;
+            return _childrenResolved;
         }
-        addChild(_children.get());
+
+        // Read any implicit subtree and build the child nodes in the
+        // background; the update traversal adds them to the graph.
+        osg::observer_ptr<ThreeDTileNode> tile_weak(this);
+
+        jobs::context context;
+        context.name = "3D Tiles children";
+        context.pool = jobs::get_pool("oe.3dtiles");
+        context.priority = tilePriority(this);
+
+        _childrenFuture = jobs::dispatch([tile_weak](Cancelable& c)
+            {
+                osg::ref_ptr<osg::Group> children;
+                osg::ref_ptr<ThreeDTileNode> tile;
+                if (!c.canceled() && tile_weak.lock(tile))
+                {
+                    children = tile->createChildren();
+                }
+                return children;
+            },
+            context);
     }
 
-    _debugColor = randomColor();
+    _tileset->attachChildrenLater(this);
+    return false;
+}
 
-    getOrCreateStateSet()->getOrCreateUniform("debugColor", osg::Uniform::FLOAT_VEC4)->set(_debugColor);
+bool ThreeDTileNode::attachChildren()
+{
+    std::lock_guard<std::mutex> lock(_childrenMutex);
 
-    computeBoundingVolume();
+    if (_childrenResolved)
+    {
+        return true;
+    }
 
-    createDebugBounds();
+    if (_childrenFuture.empty() || !_childrenFuture.available())
+    {
+        return false;
+    }
+
+    _children = _childrenFuture.value();
+    if (_children.valid())
+    {
+        addChild(_children.get());
+    }
+    _childrenResolved = true;
+    return true;
 }
 
 void ThreeDTileNode::setParentTile(ThreeDTileNode* parentTile)
@@ -888,10 +1087,32 @@ void ThreeDTileNode::resolveContent()
             _tileset->runPostMergeOperations(_content.get());
 
             addChild(_content.get());
+
+            ContentSizeVisitor sizer;
+            _content->accept(sizer);
+            _contentBytes = sizer._bytes;
+            _tileset->addContentBytes((std::ptrdiff_t)_contentBytes);
         }
     }
 }
 
+bool ThreeDTileNode::isContentPending() const
+{
+    return _requestedContent && !_content.valid() && _contentFuture.working();
+}
+
+bool ThreeDTileNode::cancelContent()
+{
+    if (!isContentPending())
+    {
+        return false;
+    }
+
+    _contentFuture.abandon();
+    _requestedContent = false;
+    return true;
+}
+
 
 void ThreeDTileNode::requestContent(ICO* ico)
 {
@@ -922,12 +1143,12 @@ void ThreeDTileNode::requestContent(ICO* ico)
         if (osgEarth::Strings::endsWith(osgEarth::removeQueryParams(_tile->content()->uri()->base()), ".json"))
         {
             // "json" extension = external tileset:
-            _contentFuture = readTilesetAsync(_tileset, uri, localOptions.get());
+            _contentFuture = readTilesetAsync(_tileset, uri, localOptions.get(), this);
         }
         else
         {
             // else, actual content:
-            _contentFuture = readTileContentAsync(uri, localOptions);
+            _contentFuture = readTileContentAsync(uri, localOptions, this);
         }
 
         _requestedContent = true;
@@ -940,6 +1161,15 @@ double ThreeDTileNode::getDistanceToTile(osgUtil::CullVisitor* cv)
     return (double)cv->getDistanceToViewPoint(bs.center(), true) - bs.radius();
 }
 
+void ThreeDTileNode::updatePriority(osgUtil::CullVisitor* cv)
+{
+    // Tiles with the largest screen space error matter most; the distance
+    // term is below one pixel, so it only orders tiles of equal error
+    // (e.g. leaves, whose geometric error is usually zero).
+    double distance = osg::maximum(getDistanceToTile(cv), 0.0);
+    _priority.store((float)(computeScreenSpaceError(cv) + 1.0 / (1.0 + distance)), std::memory_order_relaxed);
+}
+
 double ThreeDTileNode::computeScreenSpaceError(osgUtil::CullVisitor* cv)
 {
     double distance = osg::maximum(getDistanceToTile(cv), 0.0000001);
@@ -975,6 +1205,12 @@ bool ThreeDTileNode::unloadContent()
         _content = nullptr;
     }
 
+    if (_contentBytes > 0u)
+    {
+        _tileset->addContentBytes(-(std::ptrdiff_t)_contentBytes);
+        _contentBytes = 0u;
+    }
+
     _firstVisit = true;
     _content = 0;
     _requestedContent = false;
@@ -1039,6 +1275,8 @@ void ThreeDTileNode::updateTracking(osgUtil::CullVisitor* cv)
 
 void ThreeDTileNode::traverse(osg::NodeVisitor& nv)
 {
+    resolveChildren();
+
     if (nv.getVisitorType() == nv.CULL_VISITOR)
     {
         osgUtil::CullVisitor* cv = static_cast<osgUtil::CullVisitor*>(&nv);
@@ -1066,6 +1304,7 @@ void ThreeDTileNode::traverse(osg::NodeVisitor& nv)
         }
 
         // This allows nodes to reload themselves
+        updatePriority(cv);
         requestContent(ico);
         resolveContent();
 
@@ -1087,6 +1326,7 @@ void ThreeDTileNode::traverse(osg::NodeVisitor& nv)
                     // Can we traverse the child?
                     if (childTile->hasContent() && !childTile->isContentReady())
                     {
+                        childTile->updatePriority(cv);
                         childTile->requestContent(ico);
                         areChildrenReady = false;
                     }
@@ -1197,6 +1437,10 @@ ThreeDTilesetNode::ThreeDTilesetNode(Tileset* tileset, const std::string& author
     _showBoundingVolumes(false),
     _showColorPerTile(false),
     _maxAge(5.0f),
+    _maxContentBytes(0u),
+    _contentBytes(0u),
+    _cancelStaleRequests(true),
+    _numCanceledRequests(0u),
     _lastExpiredFrame(0),
     _authorizationHeader(authorizationHeader),
     _sgCallbacks(sceneGraphCallbacks),
@@ -1215,6 +1459,12 @@ ThreeDTilesetNode::ThreeDTilesetNode(Tileset* tileset, const std::string& author
         setMaxAge((float)atof(c));
     }
 
+    c = ::getenv("OSGEARTH_3DTILES_MAX_CONTENT_MB");
+    if (c)
+    {
+        setMaxContentBytes((std::size_t)atoi(c) * 1024u * 1024u);
+    }
+
     _tracker.push_back(0);
     // Pointer to last element
     _sentryItr = --_tracker.end();
@@ -1275,6 +1525,41 @@ void ThreeDTilesetNode::setMaxAge(float maxAge)
     _maxAge = maxAge;
 }
 
+std::size_t ThreeDTilesetNode::getMaxContentBytes() const
+{
+    return _maxContentBytes;
+}
+
+void ThreeDTilesetNode::setMaxContentBytes(std::size_t maxContentBytes)
+{
+    _maxContentBytes = maxContentBytes;
+}
+
+std::size_t ThreeDTilesetNode::getContentBytes() const
+{
+    return _contentBytes;
+}
+
+void ThreeDTilesetNode::addContentBytes(std::ptrdiff_t delta)
+{
+    _contentBytes += (std::size_t)delta;
+}
+
+bool ThreeDTilesetNode::getCancelStaleRequests() const
+{
+    return _cancelStaleRequests;
+}
+
+void ThreeDTilesetNode::setCancelStaleRequests(bool value)
+{
+    _cancelStaleRequests = value;
+}
+
+unsigned ThreeDTilesetNode::getNumCanceledRequests() const
+{
+    return _numCanceledRequests;
+}
+
 float ThreeDTilesetNode::getMaximumScreenSpaceError() const
 {
     return _maximumScreenSpaceError;
@@ -1362,6 +1647,38 @@ void ThreeDTilesetNode::touchTile(ThreeDTileNode* node)
     node->_trackerItr = --_tracker.end();
 }
 
+void ThreeDTilesetNode::attachChildrenLater(ThreeDTileNode* node)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _childrenToAttach.emplace_back(node);
+}
+
+void ThreeDTilesetNode::attachPendingChildren()
+{
+    // Attach outside the lock; a tile holds its own lock while queueing itself.
+    std::vector<osg::observer_ptr<ThreeDTileNode>> pending;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        pending.swap(_childrenToAttach);
+    }
+
+    std::vector<osg::observer_ptr<ThreeDTileNode>> notReady;
+    for (auto& tile_weak : pending)
+    {
+        osg::ref_ptr<ThreeDTileNode> tile;
+        if (tile_weak.lock(tile) && !tile->attachChildren())
+        {
+            notReady.emplace_back(tile.get());
+        }
+    }
+
+    if (!notReady.empty())
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _childrenToAttach.insert(_childrenToAttach.end(), notReady.begin(), notReady.end());
+    }
+}
+
 void ThreeDTilesetNode::expireTiles(const osg::NodeVisitor& nv)
 {
     OE_PROFILING_ZONE;
@@ -1377,17 +1694,57 @@ void ThreeDTilesetNode::expireTiles(const osg::NodeVisitor& nv)
     // Max time in ms to allocate to erasing tiles
     float maxTime = 2.0f;
 
-    ThreeDTileNode::TileTracker::iterator itr = _tracker.begin();
+    auto outOfTime = [&]()
+        {
+            endTime = osg::Timer::instance()->tick();
+            return osg::Timer::instance()->delta_m(startTime, endTime) > maxTime;
+        };
+
+    ThreeDTileNode::TileTracker::iterator itr;
+
+    // Everything ahead of the sentry went unvisited in the last cull.
+    // Stop loading content for tiles that have been out of view for more
+    // than a frame so the pool can work on what the camera sees now.
+    // The scan shares the time budget with the unloading below.
+    bool timeLeft = true;
+    if (_cancelStaleRequests)
+    {
+        for (itr = _tracker.begin(); itr != _sentryItr; ++itr)
+        {
+            ThreeDTileNode* tile = itr->get();
+            if (tile &&
+                tile->getAutoUnload() &&
+                frameNumber > tile->getLastCulledFrameNumber() + 1u &&
+                tile->cancelContent())
+            {
+                ++_numCanceledRequests;
+            }
+
+            if (outOfTime())
+            {
+                timeLeft = false;
+                break;
+            }
+        }
+    }
+
+    auto overBudget = [&]()
+        {
+            return _maxContentBytes > 0u && _contentBytes > _maxContentBytes;
+        };
+
+    itr = _tracker.begin();
 
     unsigned int numErased = 0;
     unsigned int numSkipped = 0;
-    while (_tracker.size() > _maxTiles && itr != _sentryItr)
+    while (timeLeft && (_tracker.size() > _maxTiles || overBudget()) && itr != _sentryItr)
     {
         osg::ref_ptr< ThreeDTileNode > tile = dynamic_cast<ThreeDTileNode*>(itr->get());
         if (tile.valid())
         {
+            // Over the memory budget, any tile that was not visible last frame may go
             float age = frameTime - tile->getLastCulledFrameTime();
-            bool canUnload = tile->getAutoUnload() && age >= _maxAge;
+            bool canUnload = tile->getAutoUnload() && (age >= _maxAge || overBudget());
 
             if (canUnload && tile->unloadContent())
             {
@@ -1402,8 +1759,7 @@ void ThreeDTilesetNode::expireTiles(const osg::NodeVisitor& nv)
             }
         }
 
-        endTime = osg::Timer::instance()->tick();
-        if (osg::Timer::instance()->delta_m(startTime, endTime) > maxTime)
+        if (outOfTime())
         {
             break;
         }
@@ -1431,6 +1787,7 @@ void ThreeDTilesetNode::traverse(osg::NodeVisitor& nv)
         // This can happen if the node has multiple parents.
         if (nv.getFrameStamp()->getFrameNumber() > _lastExpiredFrame)
         {
+            attachPendingChildren();
             expireTiles(nv);
             _lastExpiredFrame = nv.getFrameStamp()->getFrameNumber();
         }
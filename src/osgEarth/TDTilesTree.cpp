@@ -0,0 +1,1131 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/TDTilesTree>
+#include <osgEarth/JsonUtils>
+#include <osgEarth/StringUtils>
+#include <osgEarth/Notify>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <locale>
+#include <sstream>
+#include <unordered_map>
+
+#define LC "[3DTiles] "
+
+using namespace osgEarth;
+using namespace osgEarth::Util;
+using namespace osgEarth::Contrib::ThreeDTiles;
+
+namespace
+{
+    // Pull parser over a JSON document; reads values in place without
+    // building a DOM. Any syntax error clears "ok" and stops the parse.
+    struct JsonCursor
+    {
+        const char* p;
+        const char* end;
+        const char* errorAt = nullptr;
+        bool ok = true;
+
+        JsonCursor(const std::string& input) :
+            p(input.data()), end(input.data() + input.size()) { }
+
+        bool fail()
+        {
+            if (ok) errorAt = p;
+            ok = false;
+            p = end;
+            return false;
+        }
+
+        void ws()
+        {
+            while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+                ++p;
+        }
+
+        bool peek(char c)
+        {
+            ws();
+            return p < end && *p == c;
+        }
+
+        bool expect(char c)
+        {
+            ws();
+            if (p < end && *p == c)
+            {
+                ++p;
+                return true;
+            }
+            return fail();
+        }
+
+        // Iterates the members of an object:
+        //   bool first = true; while (c.member(first, key)) { ...read or skip value... }
+        bool member(bool& first, std::string& key)
+        {
+            if (!ok) return false;
+            if (first && !expect('{')) return false;
+            if (peek('}'))
+            {
+                ++p;
+                return false;
+            }
+            if (!first && !expect(',')) return false;
+            first = false;
+            return string(key) && expect(':');
+        }
+
+        // Iterates the elements of an array:
+        //   bool first = true; while (c.element(first)) { ...read or skip value... }
+        bool element(bool& first)
+        {
+            if (!ok) return false;
+            if (first && !expect('[')) return false;
+            if (peek(']'))
+            {
+                ++p;
+                return false;
+            }
+            if (!first && !expect(',')) return false;
+            first = false;
+            return true;
+        }
+
+        static void utf8(unsigned cp, std::string& out)
+        {
+            if (cp < 0x80) out += (char)cp;
+            else if (cp < 0x800) { out += (char)(0xC0 | (cp >> 6)); out += (char)(0x80 | (cp & 0x3F)); }
+            else if (cp < 0x10000) { out += (char)(0xE0 | (cp >> 12)); out += (char)(0x80 | ((cp >> 6) & 0x3F)); out += (char)(0x80 | (cp & 0x3F)); }
+            else { out += (char)(0xF0 | (cp >> 18)); out += (char)(0x80 | ((cp >> 12) & 0x3F)); out += (char)(0x80 | ((cp >> 6) & 0x3F)); out += (char)(0x80 | (cp & 0x3F)); }
+        }
+
+        bool hex4(unsigned& cp)
+        {
+            if (end - p < 4) return fail();
+            cp = 0u;
+            for (int i = 0; i < 4; ++i)
+            {
+                char c = *p++;
+                cp <<= 4;
+                if (c >= '0' && c <= '9') cp |= (unsigned)(c - '0');
+                else if (c >= 'a' && c <= 'f') cp |= (unsigned)(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F') cp |= (unsigned)(c - 'A' + 10);
+                else return fail();
+            }
+            return true;
+        }
+
+        bool string(std::string& out)
+        {
+            out.clear();
+            if (!expect('"')) return false;
+            for (;;)
+            {
+                const char* run = p;
+                while (p < end && *p != '"' && *p != '\\')
+                    ++p;
+                out.append(run, p);
+                if (p >= end) return fail();
+                if (*p++ == '"') return true;
+
+                // escape sequence
+                if (p >= end) return fail();
+                char c = *p++;
+                switch (c)
+                {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    unsigned cp;
+                    if (!hex4(cp)) return false;
+                    if (cp >= 0xD800 && cp <= 0xDBFF && end - p >= 6 && p[0] == '\\' && p[1] == 'u')
+                    {
+                        p += 2;
+                        unsigned low;
+                        if (!hex4(low)) return false;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    utf8(cp, out);
+                    break;
+                }
+                default: return fail();
+                }
+            }
+        }
+
+        // Numbers of up to 15 significant digits with a small exponent are
+        // exact as mantissa and power of ten, so one multiply or divide gives
+        // the correctly rounded value; anything else goes through a stream
+        // in the classic locale. Neither depends on the global locale, which
+        // may use a decimal comma.
+        bool number(double& out)
+        {
+            static const double powersOf10[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+            ws();
+            const char* start = p;
+            bool negative = p < end && *p == '-';
+            if (negative) ++p;
+
+            std::uint64_t mantissa = 0u;
+            int significant = 0, scale = 0;
+            bool anyDigits = false;
+
+            const auto digits = [&](bool fraction)
+                {
+                    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+                    {
+                        anyDigits = true;
+                        if (significant < 19)
+                        {
+                            mantissa = mantissa * 10u + (unsigned)(*p - '0');
+                            if (mantissa > 0u) ++significant;
+                            if (fraction) --scale;
+                        }
+                        else if (!fraction)
+                        {
+                            ++scale;
+                        }
+                    }
+                };
+
+            digits(false);
+            if (p < end && *p == '.')
+            {
+                ++p;
+                digits(true);
+            }
+            if (!anyDigits) return fail();
+
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                bool negativeExp = false;
+                if (p < end && (*p == '+' || *p == '-'))
+                    negativeExp = *p++ == '-';
+                if (p >= end || *p < '0' || *p > '9') return fail();
+                int exp10 = 0;
+                for (; p < end && *p >= '0' && *p <= '9'; ++p)
+                    if (exp10 < 100000) exp10 = exp10 * 10 + (*p - '0');
+                scale += negativeExp ? -exp10 : exp10;
+            }
+
+            if (significant <= 15 && scale >= -22 && scale <= 22)
+            {
+                double value = (double)mantissa;
+                value = scale < 0 ? value / powersOf10[-scale] : value * powersOf10[scale];
+                out = negative ? -value : value;
+                return true;
+            }
+
+            std::istringstream in(std::string(start, p));
+            in.imbue(std::locale::classic());
+            if (!(in >> out)) return fail();
+            return true;
+        }
+
+        bool literal(const char* word)
+        {
+            std::size_t len = std::strlen(word);
+            if ((std::size_t)(end - p) < len || std::strncmp(p, word, len) != 0) return fail();
+            p += len;
+            return true;
+        }
+
+        // Skips any value, including nested objects and arrays.
+        bool skip()
+        {
+            ws();
+            if (p >= end) return fail();
+            switch (*p)
+            {
+            case '"':
+            {
+                ++p;
+                while (p < end && *p != '"')
+                    p += (*p == '\\') ? 2 : 1;
+                if (p >= end) return fail();
+                ++p;
+                return true;
+            }
+            case '{':
+            case '[':
+            {
+                // strings may contain brackets, so track them while counting depth
+                int depth = 0;
+                while (p < end)
+                {
+                    char c = *p++;
+                    if (c == '"')
+                    {
+                        while (p < end && *p != '"')
+                            p += (*p == '\\') ? 2 : 1;
+                        if (p >= end) return fail();
+                        ++p;
+                    }
+                    else if (c == '{' || c == '[') ++depth;
+                    else if (c == '}' || c == ']')
+                    {
+                        if (--depth == 0) return true;
+                    }
+                }
+                return fail();
+            }
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default:
+            {
+                double unused;
+                return number(unused);
+            }
+            }
+        }
+
+        // Reads an array of numbers, up to "max" of them.
+        unsigned numbers(double* out, unsigned max)
+        {
+            unsigned count = 0u;
+            bool first = true;
+            while (element(first))
+            {
+                double v;
+                if (!number(v)) return 0u;
+                if (count < max) out[count] = v;
+                ++count;
+            }
+            return count;
+        }
+    };
+
+    // The conversion BoundingVolume::fromJSON applies to an oriented box
+    void boxToAABB(const double* b, double* out)
+    {
+        osg::Vec3d center(b[0], b[1], b[2]);
+        osg::BoundingBoxd bb;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            osg::Vec3d v(b[3 + axis * 3], b[4 + axis * 3], b[5 + axis * 3]);
+            bb.expandBy(center + v);
+            bb.expandBy(center - v);
+        }
+        out[0] = bb.xMin(); out[1] = bb.yMin(); out[2] = bb.zMin();
+        out[3] = bb.xMax(); out[4] = bb.yMax(); out[5] = bb.zMax();
+    }
+
+    void setBoundingVolume(BoundingVolume& bv, TileTree::VolumeType type, const double* v)
+    {
+        if (type == TileTree::VOLUME_REGION)
+            bv.region() = osg::BoundingBoxd(v[0], v[1], v[4], v[2], v[3], v[5]);
+        else if (type == TileTree::VOLUME_BOX)
+            bv.box() = osg::BoundingBoxd(v[0], v[1], v[2], v[3], v[4], v[5]);
+        else if (type == TileTree::VOLUME_SPHERE)
+            bv.sphere() = osg::BoundingSphere(osg::Vec3(v[0], v[1], v[2]), v[3]);
+    }
+}
+
+//........................................................................
+
+namespace osgEarth { namespace Contrib { namespace ThreeDTiles
+{
+    class TileTreeBuilder
+    {
+    public:
+        TileTree& tree;
+        JsonCursor& c;
+        std::vector<TileTree::Index> parents;
+        std::unordered_map<std::string, TileTree::Index> interned;
+        std::string key, str;
+
+        TileTreeBuilder(TileTree& t, JsonCursor& cursor) : tree(t), c(cursor) { }
+
+        TileTree::Index intern(const std::string& value)
+        {
+            auto result = interned.emplace(value, (TileTree::Index)tree._strings.size());
+            if (result.second)
+            {
+                tree._strings.append(value);
+                tree._strings.push_back('\0');
+            }
+            return result.first->second;
+        }
+
+        // Reads a boundingVolume object into six values; keeps the
+        // original box in "box" for implicit subdivision.
+        TileTree::VolumeType volume(double* out, double* box)
+        {
+            TileTree::VolumeType type = TileTree::VOLUME_NONE;
+            bool first = true;
+            while (c.member(first, key))
+            {
+                double v[12];
+                if (key == "region")
+                {
+                    if (c.numbers(v, 12) == 6)
+                    {
+                        std::copy(v, v + 6, out);
+                        type = TileTree::VOLUME_REGION;
+                    }
+                    else OE_WARN << LC << "Invalid region array" << std::endl;
+                }
+                else if (key == "box")
+                {
+                    if (c.numbers(v, 12) == 12)
+                    {
+                        boxToAABB(v, out);
+                        if (box) std::copy(v, v + 12, box);
+                        type = TileTree::VOLUME_BOX;
+                    }
+                    else OE_WARN << LC << "Invalid box array" << std::endl;
+                }
+                else if (key == "sphere")
+                {
+                    if (c.numbers(v, 12) == 4)
+                    {
+                        std::copy(v, v + 4, out);
+                        out[4] = out[5] = 0.0;
+                        type = TileTree::VOLUME_SPHERE;
+                    }
+                }
+                else c.skip();
+            }
+            return type;
+        }
+
+        // Reads a content object (or the first of a "contents" array).
+        bool content(std::string& uri)
+        {
+            bool found = false;
+            bool first = true;
+            while (c.member(first, key))
+            {
+                if ((key == "uri" || key == "url") && c.string(str))
+                {
+                    uri = str;
+                    found = true;
+                }
+                else c.skip();
+            }
+            return found;
+        }
+
+        void implicitTiling(ImplicitTiling& tiling)
+        {
+            bool first = true;
+            while (c.member(first, key))
+            {
+                double v;
+                if (key == "subdivisionScheme" && c.string(str))
+                    tiling.octree = ciEquals(str, "OCTREE");
+                else if (key == "subtreeLevels" && c.number(v))
+                    tiling.subtreeLevels = (unsigned)v;
+                else if (key == "availableLevels" && c.number(v))
+                    tiling.availableLevels = (unsigned)v;
+                else if (key == "maximumLevel" && c.number(v)) // pre-1.1 extension
+                    tiling.availableLevels = (unsigned)v + 1u;
+                else if (key == "subtrees")
+                {
+                    bool first2 = true;
+                    while (c.member(first2, key))
+                    {
+                        if ((key == "uri" || key == "url") && c.string(str))
+                            tiling.subtreesURI = str;
+                        else c.skip();
+                    }
+                }
+                else c.skip();
+            }
+        }
+
+        // Reads a tile and its descendants, depth first.
+        void tile(TileTree::Index parent)
+        {
+            TileTree::Index index = (TileTree::Index)tree._flags.size();
+            tree._volumes.resize(tree._volumes.size() + 6, 0.0);
+            tree._geometricError.push_back(0.0f);
+            tree._flags.push_back(0u);
+            tree._content.push_back(TileTree::NONE);
+            tree._transform.push_back(TileTree::NONE);
+            parents.push_back(parent);
+
+            std::string contentURI;
+            bool hasContent = false;
+            bool isImplicit = false;
+            ImplicitTiling tiling;
+            double box[12];
+
+            bool first = true;
+            while (c.member(first, key))
+            {
+                if (key == "boundingVolume")
+                {
+                    auto type = volume(&tree._volumes[index * 6], box);
+                    tree._flags[index] = (tree._flags[index] & ~TileTree::FLAG_VOLUME) | type;
+                    tiling.hasBox = (type == TileTree::VOLUME_BOX);
+                }
+                else if (key == "geometricError")
+                {
+                    double v;
+                    if (c.number(v))
+                    {
+                        tree._geometricError[index] = (float)v;
+                        tree._flags[index] |= TileTree::FLAG_ERROR;
+                    }
+                }
+                else if (key == "refine")
+                {
+                    if (c.string(str))
+                    {
+                        tree._flags[index] |= TileTree::FLAG_REFINE;
+                        if (ciEquals(str, "ADD"))
+                            tree._flags[index] |= TileTree::FLAG_ADD;
+                    }
+                }
+                else if (key == "transform")
+                {
+                    double m[16];
+                    if (c.numbers(m, 16) == 16)
+                    {
+                        tree._transform[index] = (TileTree::Index)tree._transforms.size();
+                        tree._transforms.push_back(osg::Matrixd(m));
+                    }
+                }
+                else if (key == "content")
+                {
+                    hasContent = content(contentURI);
+                }
+                else if (key == "contents")
+                {
+                    bool first2 = true;
+                    while (c.element(first2))
+                    {
+                        std::string uri;
+                        if (content(uri) && !hasContent)
+                        {
+                            contentURI = uri;
+                            hasContent = true;
+                        }
+                    }
+                }
+                else if (key == "implicitTiling")
+                {
+                    implicitTiling(tiling);
+                    isImplicit = true;
+                }
+                else if (key == "children" && c.peek('['))
+                {
+                    bool first2 = true;
+                    while (c.element(first2))
+                    {
+                        if (c.peek('{'))
+                            tile(index);
+                        else
+                            c.skip();
+                    }
+                }
+                else c.skip();
+            }
+
+            if (isImplicit)
+            {
+                // the content URI of an implicit root is a template for all its tiles
+                if (hasContent)
+                    tiling.contentURI = contentURI;
+                if (tiling.hasBox)
+                    std::copy(box, box + 12, tiling.box);
+                tree._implicit.emplace_back(index, tiling);
+            }
+            else if (hasContent)
+            {
+                tree._content[index] = intern(contentURI);
+            }
+        }
+
+        // Lays out the children of each tile contiguously
+        void finish()
+        {
+            std::size_t n = parents.size();
+            tree._childOffsets.assign(n + 1, 0u);
+            for (std::size_t i = 0; i < n; ++i)
+                if (parents[i] != TileTree::NONE)
+                    ++tree._childOffsets[parents[i] + 1];
+
+            for (std::size_t i = 0; i < n; ++i)
+                tree._childOffsets[i + 1] += tree._childOffsets[i];
+
+            // parse order keeps siblings in document order
+            tree._children.resize(n > 0 ? n - 1 : 0);
+            std::vector<TileTree::Index> cursor(tree._childOffsets.begin(), tree._childOffsets.end() - 1);
+            for (std::size_t i = 0; i < n; ++i)
+                if (parents[i] != TileTree::NONE)
+                    tree._children[cursor[parents[i]]++] = (TileTree::Index)i;
+
+            std::sort(tree._implicit.begin(), tree._implicit.end(),
+                [](const std::pair<TileTree::Index, ImplicitTiling>& a, const std::pair<TileTree::Index, ImplicitTiling>& b) {
+                    return a.first < b.first; });
+
+            tree._volumes.shrink_to_fit();
+            tree._geometricError.shrink_to_fit();
+            tree._flags.shrink_to_fit();
+            tree._content.shrink_to_fit();
+            tree._transform.shrink_to_fit();
+            tree._transforms.shrink_to_fit();
+            tree._strings.shrink_to_fit();
+        }
+    };
+} } }
+
+//........................................................................
+
+TileTree*
+TileTree::parse(const std::string& json, Header& header, std::string& error)
+{
+    osg::ref_ptr<TileTree> tree = new TileTree();
+    JsonCursor c(json);
+    TileTreeBuilder builder(*tree, c);
+
+    std::string key, str;
+    bool first = true;
+    while (c.member(first, key))
+    {
+        if (key == "asset")
+        {
+            bool first2 = true;
+            while (c.member(first2, key))
+            {
+                if (key == "version" && c.string(str))
+                    header.asset.version() = str;
+                else if (key == "tilesetVersion" && c.string(str))
+                    header.asset.tilesetVersion() = str;
+                else if (key == "gltfUpAxis" && c.string(str))
+                    header.asset.gltfUpAxis() = str;
+                else c.skip();
+            }
+        }
+        else if (key == "geometricError")
+        {
+            double v;
+            if (c.number(v))
+                header.geometricError() = v;
+        }
+        else if (key == "root")
+        {
+            if (tree->size() == 0 && c.peek('{'))
+                builder.tile(NONE);
+            else
+                c.skip();
+        }
+        else c.skip();
+    }
+
+    if (!c.ok)
+    {
+        error = Stringify() << "JSON syntax error at offset " << (std::size_t)(c.errorAt - json.data());
+        return nullptr;
+    }
+
+    builder.finish();
+    return tree.release();
+}
+
+const osg::Matrixd*
+TileTree::getTransform(Index i) const
+{
+    return _transform[i] != NONE ? &_transforms[_transform[i]] : nullptr;
+}
+
+const char*
+TileTree::getContentURI(Index i) const
+{
+    return _content[i] != NONE ? _strings.c_str() + _content[i] : nullptr;
+}
+
+const ImplicitTiling*
+TileTree::getImplicitTiling(Index i) const
+{
+    auto iter = std::lower_bound(_implicit.begin(), _implicit.end(), i,
+        [](const std::pair<Index, ImplicitTiling>& entry, Index value) { return entry.first < value; });
+    return iter != _implicit.end() && iter->first == i ? &iter->second : nullptr;
+}
+
+std::size_t
+TileTree::getMemoryUsage() const
+{
+    return sizeof(*this) +
+        _volumes.capacity() * sizeof(double) +
+        _geometricError.capacity() * sizeof(float) +
+        _flags.capacity() +
+        _content.capacity() * sizeof(Index) +
+        _transform.capacity() * sizeof(Index) +
+        _transforms.capacity() * sizeof(osg::Matrixd) +
+        _childOffsets.capacity() * sizeof(Index) +
+        _children.capacity() * sizeof(Index) +
+        _strings.capacity() +
+        _implicit.capacity() * sizeof(std::pair<Index, ImplicitTiling>);
+}
+
+//........................................................................
+
+std::string
+ImplicitTiling::expand(const std::string& templ, unsigned level, unsigned x, unsigned y, unsigned z)
+{
+    std::string out = templ;
+    replaceIn(out, "{level}", std::to_string(level));
+    replaceIn(out, "{x}", std::to_string(x));
+    replaceIn(out, "{y}", std::to_string(y));
+    replaceIn(out, "{z}", std::to_string(z));
+    return out;
+}
+
+//........................................................................
+
+bool
+ImplicitSubtree::Availability::get(std::uint64_t i) const
+{
+    if (bits.empty())
+        return constant != 0;
+    std::uint64_t byte = i >> 3;
+    return byte < bits.size() && (bits[byte] & (1u << (i & 7u))) != 0;
+}
+
+std::uint64_t
+ImplicitSubtree::morton(unsigned x, unsigned y, unsigned z, bool octree)
+{
+    std::uint64_t result = 0u;
+    for (unsigned bit = 0; bit < 21u; ++bit)
+    {
+        if (octree)
+        {
+            result |= (std::uint64_t)((x >> bit) & 1u) << (3 * bit);
+            result |= (std::uint64_t)((y >> bit) & 1u) << (3 * bit + 1);
+            result |= (std::uint64_t)((z >> bit) & 1u) << (3 * bit + 2);
+        }
+        else
+        {
+            result |= (std::uint64_t)((x >> bit) & 1u) << (2 * bit);
+            result |= (std::uint64_t)((y >> bit) & 1u) << (2 * bit + 1);
+        }
+    }
+    return result;
+}
+
+std::uint64_t
+ImplicitSubtree::offset(unsigned level) const
+{
+    // number of tiles in all the levels above this one
+    return _octree ?
+        (((std::uint64_t)1u << (3u * level)) - 1u) / 7u :
+        (((std::uint64_t)1u << (2u * level)) - 1u) / 3u;
+}
+
+bool
+ImplicitSubtree::isTileAvailable(unsigned level, std::uint64_t index) const
+{
+    return _tiles.get(offset(level) + index);
+}
+
+bool
+ImplicitSubtree::isContentAvailable(unsigned level, std::uint64_t index) const
+{
+    return _content.get(offset(level) + index);
+}
+
+bool
+ImplicitSubtree::isChildSubtreeAvailable(std::uint64_t index) const
+{
+    return _childSubtrees.get(index);
+}
+
+ImplicitSubtree*
+ImplicitSubtree::create(
+    const std::string& data,
+    const ImplicitTiling& tiling,
+    const URIContext& context,
+    const osgDB::Options* readOptions,
+    std::string& error)
+{
+    std::string json;
+    std::string binary;
+
+    // binary subtree: magic, version, JSON length, binary length, JSON, binary
+    if (data.size() >= 24 && data.compare(0, 4, "subt") == 0)
+    {
+        std::uint64_t jsonLength, binaryLength;
+        ::memcpy(&jsonLength, data.data() + 8, 8);
+        ::memcpy(&binaryLength, data.data() + 16, 8);
+        if (24u + jsonLength + binaryLength > data.size())
+        {
+            error = "Truncated subtree";
+            return nullptr;
+        }
+        json = data.substr(24, (std::size_t)jsonLength);
+        binary = data.substr(24 + (std::size_t)jsonLength, (std::size_t)binaryLength);
+    }
+    else
+    {
+        json = data;
+    }
+
+    Json::Reader reader;
+    Json::Value doc;
+    if (!reader.parse(json, doc, false))
+    {
+        error = "Invalid subtree JSON";
+        return nullptr;
+    }
+    const Json::Value& root = doc;
+
+    // Resolve buffers: one without a URI refers to the binary chunk.
+    std::vector<std::string> buffers;
+    const Json::Value& bufferList = root["buffers"];
+    for (Json::Value::const_iterator i = bufferList.begin(); i != bufferList.end(); ++i)
+    {
+        const Json::Value& b = *i;
+        if (b.isMember("uri"))
+        {
+            ReadResult rr = URI(b["uri"].asString(), context).readString(readOptions);
+            if (rr.failed())
+            {
+                error = "Failed to read subtree buffer " + b["uri"].asString();
+                return nullptr;
+            }
+            buffers.push_back(rr.getString());
+        }
+        else
+        {
+            buffers.push_back(binary);
+        }
+    }
+
+    osg::ref_ptr<ImplicitSubtree> subtree = new ImplicitSubtree();
+    subtree->_octree = tiling.octree;
+
+    auto availability = [&](const Json::Value& value, Availability& out)
+        {
+            if (value.isMember("bitstream") || value.isMember("bufferView"))
+            {
+                unsigned viewIndex = (value.isMember("bitstream") ? value["bitstream"] : value["bufferView"]).asUInt();
+                const Json::Value& view = root["bufferViews"][viewIndex];
+                unsigned buffer = view.get("buffer", 0).asUInt();
+                std::size_t offset = view.get("byteOffset", 0).asUInt();
+                std::size_t length = view.get("byteLength", 0).asUInt();
+                if (buffer >= buffers.size() || offset + length > buffers[buffer].size())
+                    return false;
+                out.bits.assign(buffers[buffer].begin() + offset, buffers[buffer].begin() + offset + length);
+            }
+            else
+            {
+                out.constant = value.get("constant", 0).asInt();
+            }
+            return true;
+        };
+
+    // contentAvailability is an array in 3D Tiles 1.1 and an object before it
+    const Json::Value& content = root["contentAvailability"];
+    bool good =
+        availability(root["tileAvailability"], subtree->_tiles) &&
+        availability(content.isArray() ? content[0u] : content, subtree->_content) &&
+        availability(root["childSubtreeAvailability"], subtree->_childSubtrees);
+
+    if (!good)
+    {
+        error = "Invalid subtree buffer view";
+        return nullptr;
+    }
+
+    return subtree.release();
+}
+
+//........................................................................
+
+namespace
+{
+    // Shared by all the tiles of one implicit tileset
+    struct ImplicitRoot : public osg::Referenced
+    {
+        ImplicitTiling tiling;
+        TileTree::VolumeType volumeType = TileTree::VOLUME_NONE;
+        double region[6];
+        double geometricError = 0.0;
+        optional<RefinePolicy> refine;
+        URIContext context;
+    };
+
+    osg::ref_ptr<ImplicitSubtree> readSubtree(
+        const ImplicitRoot& root, unsigned level, unsigned x, unsigned y, unsigned z,
+        const osgDB::Options* readOptions)
+    {
+        URI uri(ImplicitTiling::expand(root.tiling.subtreesURI, level, x, y, z), root.context);
+        ReadResult rr = uri.readString(readOptions);
+        if (rr.failed())
+        {
+            OE_WARN << LC << "Failed to read subtree " << uri.full() << ": " << rr.errorDetail() << std::endl;
+            return nullptr;
+        }
+
+        std::string error;
+        osg::ref_ptr<ImplicitSubtree> subtree = ImplicitSubtree::create(rr.getString(), root.tiling, uri.full(), readOptions, error);
+        if (!subtree.valid())
+        {
+            OE_WARN << LC << uri.full() << ": " << error << std::endl;
+        }
+        return subtree;
+    }
+
+    Tile* createImplicitTile(
+        const ImplicitRoot* root, const ImplicitSubtree* subtree,
+        unsigned subtreeLevel, unsigned level, unsigned x, unsigned y, unsigned z);
+
+    // Children of one tile of an implicit tileset
+    class ImplicitChildren : public Tile::DeferredChildren
+    {
+    public:
+        osg::ref_ptr<const ImplicitRoot> _root;
+        osg::ref_ptr<const ImplicitSubtree> _subtree;
+        unsigned _subtreeLevel; // level of the subtree's root tile
+        unsigned _level, _x, _y, _z;
+
+        unsigned numChildren() const { return _root->tiling.octree ? 8u : 4u; }
+
+        void child(unsigned i, unsigned& x, unsigned& y, unsigned& z) const
+        {
+            x = _x * 2u + (i & 1u);
+            y = _y * 2u + ((i >> 1) & 1u);
+            z = _root->tiling.octree ? _z * 2u + ((i >> 2) & 1u) : 0u;
+        }
+
+        // Whether the children are roots of other subtrees
+        bool childrenInChildSubtrees() const
+        {
+            return _level + 1u - _subtreeLevel >= _root->tiling.subtreeLevels;
+        }
+
+        // Whether child i exists, from availability already in memory
+        bool available(unsigned i) const
+        {
+            unsigned x, y, z;
+            child(i, x, y, z);
+            unsigned local = _level + 1u - _subtreeLevel;
+            std::uint64_t m = ImplicitSubtree::morton(
+                x - ((_x >> (_level - _subtreeLevel)) << local),
+                y - ((_y >> (_level - _subtreeLevel)) << local),
+                z - ((_z >> (_level - _subtreeLevel)) << local),
+                _root->tiling.octree);
+
+            return childrenInChildSubtrees() ?
+                _subtree->isChildSubtreeAvailable(m) :
+                _subtree->isTileAvailable(local, m);
+        }
+
+        bool empty() const override
+        {
+            if (_level + 1u >= _root->tiling.availableLevels)
+                return true;
+            for (unsigned i = 0; i < numChildren(); ++i)
+                if (available(i))
+                    return false;
+            return true;
+        }
+
+        bool requiresIO() const override
+        {
+            return childrenInChildSubtrees();
+        }
+
+        void create(std::vector<osg::ref_ptr<Tile>>& output, const osgDB::Options* readOptions) const override
+        {
+            if (_level + 1u >= _root->tiling.availableLevels)
+                return;
+
+            for (unsigned i = 0; i < numChildren(); ++i)
+            {
+                if (!available(i))
+                    continue;
+
+                unsigned x, y, z;
+                child(i, x, y, z);
+
+                if (childrenInChildSubtrees())
+                {
+                    auto subtree = readSubtree(*_root, _level + 1u, x, y, z, readOptions);
+                    if (subtree.valid() && subtree->isTileAvailable(0u, 0u))
+                        output.push_back(createImplicitTile(_root.get(), subtree.get(), _level + 1u, _level + 1u, x, y, z));
+                }
+                else
+                {
+                    output.push_back(createImplicitTile(_root.get(), _subtree.get(), _subtreeLevel, _level + 1u, x, y, z));
+                }
+            }
+        }
+    };
+
+    Tile* createImplicitTile(
+        const ImplicitRoot* root, const ImplicitSubtree* subtree,
+        unsigned subtreeLevel, unsigned level, unsigned x, unsigned y, unsigned z)
+    {
+        const ImplicitTiling& tiling = root->tiling;
+        const double f = 1.0 / (double)(1u << level);
+
+        Tile* tile = new Tile();
+
+        // subdivide the root volume
+        double v[6];
+        if (root->volumeType == TileTree::VOLUME_REGION)
+        {
+            const double* r = root->region;
+            v[0] = r[0] + (r[2] - r[0]) * f * x;
+            v[2] = v[0] + (r[2] - r[0]) * f;
+            v[1] = r[1] + (r[3] - r[1]) * f * y;
+            v[3] = v[1] + (r[3] - r[1]) * f;
+            v[4] = tiling.octree ? r[4] + (r[5] - r[4]) * f * z : r[4];
+            v[5] = tiling.octree ? v[4] + (r[5] - r[4]) * f : r[5];
+            setBoundingVolume(tile->boundingVolume().mutable_value(), TileTree::VOLUME_REGION, v);
+        }
+        else if (root->volumeType == TileTree::VOLUME_BOX)
+        {
+            const double* b = tiling.box;
+            double child[12];
+            for (int k = 0; k < 3; ++k)
+            {
+                child[k] = b[k]
+                    + b[3 + k] * (-1.0 + (2.0 * x + 1.0) * f)
+                    + b[6 + k] * (-1.0 + (2.0 * y + 1.0) * f)
+                    + (tiling.octree ? b[9 + k] * (-1.0 + (2.0 * z + 1.0) * f) : 0.0);
+                child[3 + k] = b[3 + k] * f;
+                child[6 + k] = b[6 + k] * f;
+                child[9 + k] = tiling.octree ? b[9 + k] * f : b[9 + k];
+            }
+            boxToAABB(child, v);
+            setBoundingVolume(tile->boundingVolume().mutable_value(), TileTree::VOLUME_BOX, v);
+        }
+
+        tile->geometricError() = root->geometricError * f;
+
+        if (root->refine.isSet())
+            tile->refine() = root->refine.get();
+
+        unsigned local = level - subtreeLevel;
+        std::uint64_t m = ImplicitSubtree::morton(
+            x - ((x >> local) << local),
+            y - ((y >> local) << local),
+            z - ((z >> local) << local),
+            tiling.octree);
+
+        if (!tiling.contentURI.empty() && subtree->isContentAvailable(local, m))
+        {
+            tile->content().mutable_value().uri() = URI(ImplicitTiling::expand(tiling.contentURI, level, x, y, z), root->context);
+        }
+
+        if (level + 1u < tiling.availableLevels)
+        {
+            ImplicitChildren* children = new ImplicitChildren();
+            children->_root = root;
+            children->_subtree = subtree;
+            children->_subtreeLevel = subtreeLevel;
+            children->_level = level;
+            children->_x = x;
+            children->_y = y;
+            children->_z = z;
+            tile->setDeferredChildren(children);
+        }
+
+        return tile;
+    }
+
+    // Children of one tile of an explicit tileset
+    class TreeChildren : public Tile::DeferredChildren
+    {
+    public:
+        osg::ref_ptr<const TileTree> _tree;
+        TileTree::Index _index;
+        URIContext _context;
+
+        bool empty() const override
+        {
+            return _tree->getNumChildren(_index) == 0u;
+        }
+
+        void create(std::vector<osg::ref_ptr<Tile>>& output, const osgDB::Options* readOptions) const override
+        {
+            for (unsigned i = 0; i < _tree->getNumChildren(_index); ++i)
+            {
+                output.push_back(_tree->createTile(_tree->getChild(_index, i), _context, readOptions));
+            }
+        }
+    };
+}
+
+Tile*
+TileTree::createTile(Index i, const URIContext& context, const osgDB::Options* readOptions) const
+{
+    const ImplicitTiling* tiling = getImplicitTiling(i);
+    if (tiling)
+    {
+        osg::ref_ptr<ImplicitRoot> root = new ImplicitRoot();
+        root->tiling = *tiling;
+        root->volumeType = getVolumeType(i);
+        std::copy(getVolume(i), getVolume(i) + 6, root->region);
+        root->geometricError = getGeometricError(i);
+        if (hasRefine(i))
+            root->refine = getRefine(i);
+        root->context = context;
+
+        if (root->volumeType == VOLUME_SPHERE || root->tiling.subtreeLevels == 0u || root->tiling.subtreesURI.empty())
+        {
+            OE_WARN << LC << "Unsupported implicit tiling" << std::endl;
+        }
+        else
+        {
+            osg::ref_ptr<ImplicitSubtree> subtree = readSubtree(*root, 0u, 0u, 0u, 0u, readOptions);
+            if (subtree.valid() && subtree->isTileAvailable(0u, 0u))
+            {
+                Tile* tile = createImplicitTile(root.get(), subtree.get(), 0u, 0u, 0u, 0u, 0u);
+                if (getTransform(i))
+                    tile->transform() = osg::Matrix(*getTransform(i));
+                return tile;
+            }
+        }
+    }
+
+    Tile* tile = new Tile();
+
+    setBoundingVolume(tile->boundingVolume().mutable_value(), getVolumeType(i), getVolume(i));
+
+    if (hasGeometricError(i))
+        tile->geometricError() = getGeometricError(i);
+
+    if (hasRefine(i))
+        tile->refine() = getRefine(i);
+
+    if (getTransform(i))
+        tile->transform() = osg::Matrix(*getTransform(i));
+
+    if (getContentURI(i))
+        tile->content().mutable_value().uri() = URI(getContentURI(i), context);
+
+    if (!tiling && getNumChildren(i) > 0u)
+    {
+        TreeChildren* children = new TreeChildren();
+        children->_tree = this;
+        children->_index = i;
+        children->_context = context;
+        tile->setDeferredChildren(children);
+    }
+
+    return tile;
+}
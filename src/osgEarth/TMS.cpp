@@ -798,6 +798,7 @@ TMS::Driver::close()
     _tileMap = NULL;
     _writer = NULL;
     _forceRGBWrites = false;
+    _local = false;
 }
 
 Status
@@ -921,6 +922,15 @@ TMS::Driver::open(const URI& uri,
         dataExtents.push_back(DataExtent(profile->getExtent(), 0, _tileMap->getMaxLevel()));
     }
 
+    // tiles in a local repo bypass the URI machinery, unless a
+    // tile set points somewhere else
+    _local = LocalTileReader::usable(uri, readOptions);
+    for (auto& tileSet : _tileMap->getTileSets())
+    {
+        if (osgDB::containsServerAddress(tileSet.getHref()))
+            _local = false;
+    }
+
     return STATUS_OK;
 }
 
@@ -939,8 +949,33 @@ TMS::Driver::read(const URI& uri,
 
         if (!image_url.empty())
         {
-            URI uri(image_url, uri.context());
-            osgEarth::ReadResult rr = uri.readImage(readOptions, progress);
+            osgEarth::ReadResult rr(ReadResult::RESULT_NOT_IMPLEMENTED);
+
+            if (_local)
+            {
+                if (_prefetchSiblings && key.getLevelOfDetail() > 0)
+                {
+                    TileKey parent = key.createParentKey();
+                    for (unsigned q = 0; q < 4; ++q)
+                    {
+                        if (q != key.getQuadrant())
+                        {
+                            std::string sibling_url = _tileMap->getURL(parent.createChildKey(q), invertY);
+                            if (!sibling_url.empty())
+                                LocalTileReader::prefetch(LocalTileReader::toPath(sibling_url));
+                        }
+                    }
+                }
+
+                rr = _localReader.readImage(LocalTileReader::toPath(image_url), readOptions);
+            }
+
+            if (rr.code() == ReadResult::RESULT_NOT_IMPLEMENTED)
+            {
+                URI uri(image_url, uri.context());
+                rr = uri.readImage(readOptions, progress);
+            }
+
             if (rr.failed())
                 return rr;
 
@@ -1132,7 +1167,8 @@ TMS::Options::getMetadata()
         "properties" : [
           { "name": "url", "description" : "Location of the TMS repository", "type" : "string", "default" : "" },
           { "name": "tms_type", "description" : "Set to 'google' to invert the Y index", "type" : "string", "default" : "" },
-          { "name": "format", "description" : "Image format to assume", "type" : "string", "default" : "" }
+          { "name": "format", "description" : "Image format to assume", "type" : "string", "default" : "" },
+          { "name": "prefetch_siblings", "description" : "Preload the sibling tiles of each tile read from a local repo", "type" : "boolean", "default" : "false" }
         ]
       }
       )");
@@ -1144,6 +1180,7 @@ TMS::Options::readFrom(const Config& conf)
     conf.get("url", _url);
     conf.get("format", _format);
     conf.get("tms_type", _tmsType);
+    conf.get("prefetch_siblings", _prefetchSiblings);
 }
 
 void
@@ -1152,6 +1189,7 @@ TMS::Options::writeTo(Config& conf) const
     conf.set("url", _url);
     conf.set("tms_type", _tmsType);
     conf.set("format", _format);
+    conf.set("prefetch_siblings", _prefetchSiblings);
 }
 
 //........................................................................
@@ -1177,6 +1215,7 @@ REGISTER_OSGEARTH_LAYER(tmsimage, TMSImageLayer);
 OE_LAYER_PROPERTY_IMPL(TMSImageLayer, URI, URL, url);
 OE_LAYER_PROPERTY_IMPL(TMSImageLayer, std::string, TMSType, tmsType);
 OE_LAYER_PROPERTY_IMPL(TMSImageLayer, std::string, Format, format);
+OE_LAYER_PROPERTY_IMPL(TMSImageLayer, bool, PrefetchSiblings, prefetchSiblings);
 
 void
 TMSImageLayer::init()
@@ -1198,6 +1237,9 @@ TMSImageLayer::openImplementation()
     osg::ref_ptr<const Profile> profile = getProfile();
 
     DataExtentList dataExtents;
+
+    _driver.setPrefetchSiblings(options().prefetchSiblings() == true);
+
     Status status = _driver.open(
         options().url().get(),
         profile,
@@ -5,113 +5,418 @@
 #include <osgEarth/TMSBackFiller>
 #include <osgEarth/FileUtils>
 #include <osgEarth/ImageMosaic>
+#include <osgEarth/ImageLayer>
+#include <osgEarth/ElevationLayer>
+#include <osgEarth/ImageToHeightFieldConverter>
+#include <osgEarth/weejobs.h>
 
 #include <osgDB/FileUtils>
 #include <osgDB/FileNameUtils>
 #include <osgDB/ReadFile>
 #include <osgDB/WriteFile>
 
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
 #define LC "[TMSBackFiller] "
 
 using namespace osgEarth;
 using namespace osgEarth::Contrib;
 
+namespace
+{
+    // Averages each 2x2 block of two source rows into one pixel of the
+    // output row. The channel count is a template parameter so that the
+    // compiler can unroll and vectorize the inner loop.
+    template<unsigned C>
+    void downsampleRow(const unsigned char* row0, const unsigned char* row1, unsigned char* out, unsigned pixels)
+    {
+        for (unsigned i = 0; i < pixels; ++i)
+        {
+            const unsigned char* a = row0 + 2 * C * i;
+            const unsigned char* b = row1 + 2 * C * i;
+            for (unsigned c = 0; c < C; ++c)
+            {
+                out[C * i + c] = (unsigned char)((a[c] + a[c + C] + b[c] + b[c + C] + 2u) >> 2);
+            }
+        }
+    }
+
+    // Same for single-channel float (elevation) data, skipping no-data samples.
+    void downsampleRowFloat(const float* row0, const float* row1, float* out, unsigned pixels)
+    {
+        for (unsigned i = 0; i < pixels; ++i)
+        {
+            const float s[4] = { row0[2 * i], row0[2 * i + 1], row1[2 * i], row1[2 * i + 1] };
+            float sum = 0.0f;
+            unsigned count = 0u;
+            for (float v : s)
+            {
+                if (v != NO_DATA_VALUE)
+                {
+                    sum += v;
+                    ++count;
+                }
+            }
+            out[i] = count > 0u ? sum / (float)count : NO_DATA_VALUE;
+        }
+    }
+
+    // Whether the four children can be box-filtered directly into a parent of the same size.
+    bool canDownsample(const osg::ref_ptr<const osg::Image> (&children)[4])
+    {
+        const osg::Image* first = children[0].get();
+        if (first->s() < 2 || first->t() < 2 || (first->s() & 1) || (first->t() & 1) || first->r() != 1)
+            return false;
+
+        if (first->isCompressed() || first->getPacking() != 1)
+            return false;
+
+        bool isByte = first->getDataType() == GL_UNSIGNED_BYTE && osg::Image::computeNumComponents(first->getPixelFormat()) <= 4;
+        bool isFloat = first->getDataType() == GL_FLOAT && osg::Image::computeNumComponents(first->getPixelFormat()) == 1;
+        if (!isByte && !isFloat)
+            return false;
+
+        for (auto& child : children)
+        {
+            if (child->s() != first->s() || child->t() != first->t() || child->r() != 1 ||
+                child->getPixelFormat() != first->getPixelFormat() ||
+                child->getDataType() != first->getDataType() ||
+                child->getPacking() != first->getPacking())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Box-filters four children (UL, UR, LL, LR) into one parent. Row 0 of
+    // an image is its southern edge, so the lower half of the parent comes
+    // from the LL and LR children.
+    osg::Image* downsample(const osg::ref_ptr<const osg::Image> (&children)[4])
+    {
+        const osg::Image* first = children[0].get();
+        unsigned s = first->s(), t = first->t();
+        unsigned channels = osg::Image::computeNumComponents(first->getPixelFormat());
+
+        osg::Image* parent = new osg::Image();
+        parent->allocateImage(s, t, 1, first->getPixelFormat(), first->getDataType(), first->getPacking());
+        parent->setInternalTextureFormat(first->getInternalTextureFormat());
+
+        for (unsigned row = 0; row < t; ++row)
+        {
+            bool upper = row >= t / 2;
+            const osg::Image* left = upper ? children[0].get() : children[2].get();
+            const osg::Image* right = upper ? children[1].get() : children[3].get();
+            unsigned srcRow = 2 * (upper ? row - t / 2 : row);
+
+            for (unsigned half = 0; half < 2; ++half)
+            {
+                const osg::Image* src = half == 0 ? left : right;
+                const unsigned char* row0 = src->data(0, srcRow);
+                const unsigned char* row1 = src->data(0, srcRow + 1);
+                unsigned char* out = parent->data(half * (s / 2), row);
+
+                if (first->getDataType() == GL_FLOAT)
+                {
+                    downsampleRowFloat((const float*)row0, (const float*)row1, (float*)out, s / 2);
+                }
+                else switch (channels)
+                {
+                case 1: downsampleRow<1>(row0, row1, out, s / 2); break;
+                case 2: downsampleRow<2>(row0, row1, out, s / 2); break;
+                case 3: downsampleRow<3>(row0, row1, out, s / 2); break;
+                default: downsampleRow<4>(row0, row1, out, s / 2); break;
+                }
+            }
+        }
+
+        return parent;
+    }
+
+    // Builds a parent tile from its four children, or returns nullptr if any is missing.
+    osg::Image* createParent(const TileKey& key, const osg::ref_ptr<const osg::Image> (&children)[4])
+    {
+        for (auto& child : children)
+            if (!child.valid())
+                return nullptr;
+
+        if (canDownsample(children))
+            return downsample(children);
+
+        // formats the kernels don't handle go through the mosaic:
+        ImageMosaic mosaic;
+        for (unsigned i = 0; i < 4; ++i)
+            mosaic.getImages().push_back(TileImage(children[i].get(), key.createChildKey(i)));
+
+        osg::ref_ptr<osg::Image> merged = mosaic.createImage();
+        if (!merged.valid())
+            return nullptr;
+
+        //Resize the image so it's the same size as one of the input files
+        osg::ref_ptr<osg::Image> resized;
+        ImageUtils::resizeImage(merged.get(), children[0]->s(), children[0]->t(), resized);
+        return resized.release();
+    }
+
+    struct TileRange
+    {
+        unsigned xmin = 1u, xmax = 0u, ymin = 1u, ymax = 0u;
+
+        std::size_t count() const {
+            return xmax >= xmin && ymax >= ymin ? (std::size_t)(xmax - xmin + 1) * (ymax - ymin + 1) : 0u;
+        }
+
+        bool contains(const TileKey& key) const {
+            return key.getTileX() >= xmin && key.getTileX() <= xmax && key.getTileY() >= ymin && key.getTileY() <= ymax;
+        }
+    };
+
+    using ImageMap = std::unordered_map<TileKey, osg::ref_ptr<const osg::Image>>;
+}
+
 TMSBackFiller::TMSBackFiller() :
 _minLevel(0u),
 _maxLevel(0u),
-_verbose(false)
+_verbose(false),
+_numThreads(std::max(1u, std::thread::hardware_concurrency())),
+_numTilesWritten(0u)
 {
     //nop
 }
 
 
 void TMSBackFiller::process( const std::string& tms, osgDB::Options* options )
-{               
-    std::string fullPath = getFullPath( "", tms );        
+{
+    std::string fullPath = getFullPath( "", tms );
+    _tmsPath = fullPath;
     _options = options;
 
     //Read the tilemap
     _tileMap = TMS::TileMapReaderWriter::read( fullPath, 0 );
     if (_tileMap)
-    {                        
+    {
         //The max level is where we are going to read data from, so we need to start one level up.
-        osg::ref_ptr< const Profile> profile = _tileMap->createProfile();           
-
-        //If the bounds aren't valid just use the full extent of the profile.
-        if (!_bounds.valid())
-        {                
-            _bounds = profile->getExtent().bounds();
-        }
+        osg::ref_ptr< const Profile> profile = _tileMap->createProfile();
 
+        run(
+            profile.get(),
+            [this](const TileKey& key) { return osg::ref_ptr<const osg::Image>(readTile(key)); },
+            [this](const TileKey& key, const osg::Image* image) { return writeTile(key, image); });
+    }
+    else
+    {
+        OE_NOTICE << "Failed to load TileMap from " << _tmsPath << std::endl;
+    }
+}
 
-        int firstLevel = _maxLevel-1;            
-
-        GeoExtent extent( profile->getSRS(), _bounds );           
-
-        //Process each level in it's entirety
-        for (int level = firstLevel; level >= static_cast<int>(_minLevel); level--)
-        {
-            if (_verbose) OE_NOTICE << "Processing level " << level << std::endl;                
-
-            TileKey ll = profile->createTileKey(extent.xMin(), extent.yMin(), level);
-            TileKey ur = profile->createTileKey(extent.xMax(), extent.yMax(), level);
+Status TMSBackFiller::process( TileLayer* layer )
+{
+    if (!layer || !layer->getProfile())
+        return Status(Status::ConfigurationError, "Backfill requires an open layer with a profile");
 
-            for (unsigned int x = ll.getTileX(); x <= ur.getTileX(); x++)
+    if (auto* imageLayer = dynamic_cast<ImageLayer*>(layer))
+    {
+        run(
+            layer->getProfile(),
+            [imageLayer](const TileKey& key)
             {
-                for (unsigned int y = ur.getTileY(); y <= ll.getTileY(); y++)
-                {
-                    TileKey key = TileKey(level, x, y, profile.get());
-                    processKey( key );
-                }
-            }                
+                GeoImage image = imageLayer->createImage(key);
+                return osg::ref_ptr<const osg::Image>(image.valid() ? image.getImage() : nullptr);
+            },
+            [imageLayer](const TileKey& key, const osg::Image* image)
+            {
+                return imageLayer->writeImage(key, image).isOK();
+            });
+    }
 
-        }            
+    else if (auto* elevationLayer = dynamic_cast<ElevationLayer*>(layer))
+    {
+        // elevation tiles travel through the engine as single-channel float images
+        run(
+            layer->getProfile(),
+            [elevationLayer](const TileKey& key)
+            {
+                GeoHeightField hf = elevationLayer->createHeightField(key);
+                ImageToHeightFieldConverter conv;
+                return osg::ref_ptr<const osg::Image>(hf.valid() ? conv.convertToR32F(hf.getHeightField()) : nullptr);
+            },
+            [elevationLayer](const TileKey& key, const osg::Image* image)
+            {
+                osg::ref_ptr<osg::HeightField> hf = new osg::HeightField();
+                hf->allocate(image->s(), image->t());
+                ::memcpy(&hf->getFloatArray()->front(), image->data(), sizeof(float) * image->s() * image->t());
+                return elevationLayer->writeHeightField(key, hf.get(), nullptr).isOK();
+            });
     }
+
     else
     {
-        OE_NOTICE << "Failed to load TileMap from " << _tmsPath << std::endl;
+        return Status(Status::ServiceUnavailable, "Backfill supports image and elevation layers");
     }
+
+    return Status::NoError;
 }
 
-void TMSBackFiller::processKey( const TileKey& key )
+void TMSBackFiller::run( const Profile* profile, const ReadFunction& read, const WriteFunction& write )
 {
-    if (_verbose) OE_NOTICE << "Processing key " << key.str() << std::endl;
-
-    //Get all of the child tiles for this key, load them and mosaic them into a new tile
-    TileKey ulKey = key.createChildKey( 0 );
-    TileKey urKey = key.createChildKey( 1 );
-    TileKey llKey = key.createChildKey( 2 );
-    TileKey lrKey = key.createChildKey( 3 );
-
-    osg::ref_ptr< osg::Image > ul = readTile( ulKey );
-    osg::ref_ptr< osg::Image > ur = readTile( urKey );
-    osg::ref_ptr< osg::Image > ll = readTile( llKey );
-    osg::ref_ptr< osg::Image > lr = readTile( lrKey );
-
-    if (ul.valid() && ur.valid() && ll.valid() && lr.valid())
-    {            
-        //Merge them together
-        ImageMosaic mosaic;
-        mosaic.getImages().push_back( TileImage( ul.get(), ulKey ) );
-        mosaic.getImages().push_back( TileImage( ur.get(), urKey ) );
-        mosaic.getImages().push_back( TileImage( ll.get(), llKey ) );
-        mosaic.getImages().push_back( TileImage( lr.get(), lrKey ) );            
+    _numTilesWritten = 0u;
+
+    if (_maxLevel == 0u || _maxLevel - 1u < _minLevel)
+        return;
+
+    // levels deeper than this don't fit in a TileKey anyway
+    if (_maxLevel > 30u)
+    {
+        OE_WARN << LC << "Please set a max level to backfill from" << std::endl;
+        return;
+    }
+
+    //If the bounds aren't valid just use the full extent of the profile.
+    if (!_bounds.valid())
+    {
+        _bounds = profile->getExtent().bounds();
+    }
+
+    const unsigned firstLevel = _maxLevel - 1u;
+
+    GeoExtent extent( profile->getSRS(), _bounds );
+
+    // range of tiles to rebuild at each level:
+    std::vector<TileRange> ranges(_maxLevel + 1u);
+    for (unsigned level = _minLevel; level <= firstLevel; ++level)
+    {
+        TileKey ll = profile->createTileKey(extent.xMin(), extent.yMin(), level);
+        TileKey ur = profile->createTileKey(extent.xMax(), extent.yMax(), level);
+        if (ll.valid() && ur.valid())
+        {
+            ranges[level].xmin = ll.getTileX();
+            ranges[level].xmax = ur.getTileX();
+            ranges[level].ymin = ur.getTileY();
+            ranges[level].ymax = ll.getTileY();
+        }
+    }
+
+    auto forEachKey = [&](unsigned level, const std::function<void(const TileKey&)>& func)
+        {
+            for (unsigned x = ranges[level].xmin; x <= ranges[level].xmax && ranges[level].count() > 0; x++)
+                for (unsigned y = ranges[level].ymin; y <= ranges[level].ymax; y++)
+                    func(TileKey(level, x, y, profile));
+        };
+
+    std::atomic_uint written(0u);
+
+    auto buildAndWrite = [&](const TileKey& key, const osg::ref_ptr<const osg::Image> (&children)[4])
+        {
+            if (_verbose) OE_NOTICE << "Processing key " << key.str() << std::endl;
+
+            osg::ref_ptr<const osg::Image> parent = createParent(key, children);
+            if (parent.valid() && write(key, parent.get()))
+                ++written;
+            return parent;
+        };
+
+    // Builds a tile and everything under it depth first. Each freshly built
+    // tile is handed straight to its parent; only children that were not
+    // rebuilt come from the source.
+    std::function<osg::ref_ptr<const osg::Image>(const TileKey&)> build = [&](const TileKey& key)
+        {
+            osg::ref_ptr<const osg::Image> children[4];
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                TileKey child = key.createChildKey(i);
+                if (child.getLOD() <= firstLevel && ranges[child.getLOD()].contains(child))
+                    children[i] = build(child);
+                if (!children[i].valid())
+                    children[i] = read(child);
+            }
+            return buildAndWrite(key, children);
+        };
 
-        osg::ref_ptr< osg::Image> merged = mosaic.createImage();
-        if (merged.valid())
+    // Split the pyramid at the shallowest level with enough tiles to keep
+    // every thread busy. Each tile at that level is one job that builds its
+    // whole subtree, so memory stays bounded by the depth of the pyramid.
+    unsigned numThreads = std::max(1u, _numThreads);
+    unsigned splitLevel = firstLevel;
+    for (unsigned level = _minLevel; level < firstLevel; ++level)
+    {
+        if (ranges[level].count() >= 4u * numThreads)
         {
-            //Resize the image so it's the same size as one of the input files
-            osg::ref_ptr<osg::Image> resized;
-            ImageUtils::resizeImage( merged.get(), ul->s(), ul->t(), resized );
-            std::string outputFilename = getFilename( key );                
-            writeTile( key, resized.get() );
+            splitLevel = level;
+            break;
         }
-    }                
-}    
+    }
+
+    jobs::get_pool("oe.backfill")->set_concurrency(numThreads);
+
+    jobs::context context;
+    context.name = "oe.backfill";
+    context.pool = jobs::get_pool("oe.backfill");
+
+    // Tiles built at one level for the next; kept only above the split level.
+    ImageMap built;
+    std::mutex builtMutex;
+
+    if (_verbose) OE_NOTICE << "Processing levels " << splitLevel << " to " << firstLevel << std::endl;
+
+    context.group = jobs::jobgroup::create();
+    forEachKey(splitLevel, [&](const TileKey& key)
+        {
+            jobs::dispatch([&, key]()
+                {
+                    auto image = build(key);
+                    if (image.valid() && splitLevel > _minLevel)
+                    {
+                        std::lock_guard<std::mutex> lock(builtMutex);
+                        built[key] = image;
+                    }
+                },
+                context);
+        });
+    context.group->join();
+
+    //Process each remaining level in it's entirety
+    for (int level = (int)splitLevel - 1; level >= static_cast<int>(_minLevel); level--)
+    {
+        if (_verbose) OE_NOTICE << "Processing level " << level << std::endl;
+
+        ImageMap next;
+
+        context.group = jobs::jobgroup::create();
+        forEachKey(level, [&](const TileKey& key)
+            {
+                jobs::dispatch([&, key]()
+                    {
+                        osg::ref_ptr<const osg::Image> children[4];
+                        for (unsigned i = 0; i < 4; ++i)
+                        {
+                            TileKey child = key.createChildKey(i);
+                            auto iter = built.find(child);
+                            children[i] = iter != built.end() ? iter->second : read(child);
+                        }
+
+                        auto image = buildAndWrite(key, children);
+                        if (image.valid() && level > (int)_minLevel)
+                        {
+                            std::lock_guard<std::mutex> lock(builtMutex);
+                            next[key] = image;
+                        }
+                    },
+                    context);
+            });
+        context.group->join();
+
+        built.swap(next);
+    }
+
+    _numTilesWritten = written;
+}
 
 std::string TMSBackFiller::getFilename( const TileKey& key )
 {
-    return _tileMap->getURL( key, false );        
+    return _tileMap->getURL( key, false );
 }
 
 osg::Image* TMSBackFiller::readTile( const TileKey& key )
@@ -121,11 +426,14 @@ osg::Image* TMSBackFiller::readTile( const TileKey& key )
     return image.release();
 }
 
-void TMSBackFiller::writeTile( const TileKey& key, osg::Image* image )
+bool TMSBackFiller::writeTile( const TileKey& key, const osg::Image* image )
 {
     std::string filename = getFilename( key );
-    if ( !osgDB::fileExists( osgDB::getFilePath(filename) ) )
-        osgEarth::makeDirectoryForFile( filename );
-    osgDB::writeImageFile( *image, filename, _options.get() );        
+    {
+        std::lock_guard<std::mutex> lock( _directoryMutex );
+        if ( !osgDB::fileExists( osgDB::getFilePath(filename) ) )
+            osgEarth::makeDirectoryForFile( filename );
+    }
+    return osgDB::writeImageFile( *image, filename, _options.get() );
 }
-     
+
@@ -39,6 +39,7 @@ TerrainOptions::getConfig() const
     conf.set( "min_expiry_frames", _minExpiryFrames);
     conf.set( "min_resident_tiles", minResidentTiles());
     conf.set( "max_tiles_to_unload_per_frame", _maxTilesToUnloadPerFrame);
+    conf.set( "tile_memory_budget_mb", _tileMemoryBudgetMB);
     conf.set( "cast_shadows", _castShadows);
     conf.set( "tile_pixel_size", _tilePixelSize);
     conf.set( "lod_method", "screen_space", _lodMethod, LODMethod::SCREEN_SPACE);
@@ -56,6 +57,7 @@ TerrainOptions::getConfig() const
     conf.set( "merges_per_frame", mergesPerFrame() );
     conf.set( "priority_scale", priorityScale() );
     conf.set( "texture_compression", textureCompression());
+    conf.set( "cache_textures", cacheTextures());
     conf.set( "concurrency", concurrency());
     conf.set( "use_land_cover", useLandCover() );
     //conf.set("screen_space_error", screenSpaceError()); // don't serialize me, i'm set by the MapNode
@@ -95,6 +97,7 @@ TerrainOptions::fromConfig(const Config& conf)
     conf.get( "min_expiry_frames", _minExpiryFrames);
     conf.get( "min_resident_tiles", minResidentTiles());
     conf.get( "max_tiles_to_unload_per_frame", _maxTilesToUnloadPerFrame);
+    conf.get( "tile_memory_budget_mb", _tileMemoryBudgetMB);
     conf.get( "cast_shadows", _castShadows);
     conf.get( "tile_pixel_size", _tilePixelSize);
     conf.get( "lod_method", "screen_space", _lodMethod, LODMethod::SCREEN_SPACE);
@@ -112,6 +115,7 @@ TerrainOptions::fromConfig(const Config& conf)
     conf.get( "merges_per_frame", mergesPerFrame() );
     conf.get( "priority_scale", priorityScale());
     conf.get( "texture_compression", textureCompression());
+    conf.get( "cache_textures", cacheTextures());
     conf.get( "concurrency", concurrency());
     conf.get( "use_land_cover", useLandCover());
     //conf.get("screen_space_error", screenSpaceError()); // don't serialize me, i'm set by the MapNode
@@ -187,6 +191,7 @@ OE_OPTION_IMPL(TerrainOptionsAPI, double, MinExpiryTime, minExpiryTime);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, MinExpiryRange, minExpiryRange);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MaxTilesToUnloadPerFrame, maxTilesToUnloadPerFrame);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MinResidentTiles, minResidentTiles);
+OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, TileMemoryBudgetMB, tileMemoryBudgetMB);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, HeightFieldSkirtRatio, heightFieldSkirtRatio);
 OE_OPTION_IMPL(TerrainOptionsAPI, Color, Color, color);
 OE_OPTION_IMPL(TerrainOptionsAPI, bool, Progressive, progressive);
@@ -198,6 +203,7 @@ OE_OPTION_IMPL(TerrainOptionsAPI, bool, MorphImagery, morphImagery);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MergesPerFrame, mergesPerFrame);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, PriorityScale, priorityScale);
 OE_OPTION_IMPL(TerrainOptionsAPI, std::string, TextureCompressionMethod, textureCompression);
+OE_OPTION_IMPL(TerrainOptionsAPI, bool, CacheTextures, cacheTextures);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, Concurrency, concurrency);
 OE_OPTION_IMPL(TerrainOptionsAPI, float, ScreenSpaceError, screenSpaceError);
 OE_OPTION_IMPL(TerrainOptionsAPI, unsigned, MaxTextureSize, maxTextureSize);
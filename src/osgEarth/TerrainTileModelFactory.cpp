@@ -8,6 +8,7 @@
 #include "LandCoverLayer"
 #include "TerrainConstraintLayer"
 #include "Metrics"
+#include "MetricsRegistry"
 #include "TerrainMeshLayer"
 
 #include <osg/Texture2D>
@@ -138,16 +139,30 @@ TerrainTileModelFactory::createTileModel(
 {
     OE_PROFILING_ZONE;
 
+    auto& registry = MetricsRegistry::instance();
+    static auto& totalLatency = registry.histogram("osgearth_tile_model_seconds", "Terrain tile model creation time", { { "stage", "total" } });
+    static auto& colorLatency = registry.histogram("osgearth_tile_model_seconds", "Terrain tile model creation time", { { "stage", "color" } });
+    static auto& elevationLatency = registry.histogram("osgearth_tile_model_seconds", "Terrain tile model creation time", { { "stage", "elevation" } });
+    static auto& landCoverLatency = registry.histogram("osgearth_tile_model_seconds", "Terrain tile model creation time", { { "stage", "landcover" } });
+    static auto& meshLatency = registry.histogram("osgearth_tile_model_seconds", "Terrain tile model creation time", { { "stage", "mesh" } });
+
+    MetricsRegistry::ScopedTimer totalTimer(totalLatency);
+
     // Make a new model:
     osg::ref_ptr<TerrainTileModel> model = new TerrainTileModel(
         key,
         map->getDataModelRevision() );
 
     // assemble all the components:
-    addColorLayers(model.get(), map, require, key, manifest, progress, false);
+    {
+        MetricsRegistry::ScopedTimer timer(colorLatency);
+        addColorLayers(model.get(), map, require, key, manifest, progress, false);
+    }
 
     if (require.elevationTextures)
     {
+        MetricsRegistry::ScopedTimer timer(elevationLatency);
+
         unsigned border = (require.elevationBorder) ? 1u : 0u;
 
         addElevation( model.get(), map, key, manifest, border, progress );
@@ -155,6 +170,7 @@ TerrainTileModelFactory::createTileModel(
 
     if (require.landCoverTextures)
     {
+        MetricsRegistry::ScopedTimer timer(landCoverLatency);
         addLandCover(model.get(), map, key, require, manifest, progress);
     }
 
@@ -162,6 +178,7 @@ TerrainTileModelFactory::createTileModel(
     {
         if (key.getLOD() <= _options.maxLOD().value())
         {
+            MetricsRegistry::ScopedTimer timer(meshLatency);
             addMesh(model.get(), map, key, require, manifest, progress);
         }
     }
@@ -249,14 +266,34 @@ TerrainTileModelFactory::addImageLayer(
 
         else
         {
-            GeoImage geoImage = imageLayer->createImage(key, progress);
+            // GPU-ready images persisted in the cache skip the image pipeline,
+            // and the mipmapping and compression, altogether:
+            bool cacheTextures = _options.cacheTextures() == true && !imageLayer->isCoverage();
+
+            GeoImage geoImage;
+            if (cacheTextures)
+            {
+                geoImage = imageLayer->createPreparedImage(
+                    key,
+                    getCompressionMethod(imageLayer),
+                    [&](const osg::Image* image) { return prepareImage(image, imageLayer); },
+                    progress);
+            }
+            else
+            {
+                geoImage = imageLayer->createImage(key, progress);
+            }
 
             if (geoImage.valid())
             {
                 if (imageLayer->isCoverage())
+                {
                     tex = createCoverageTexture(geoImage.getImage());
+                }
                 else
+                {
                     tex = createImageTexture(geoImage.getImage(), imageLayer);
+                }
 
                 // Propagate the tracking token to the texture if there is one:
                 if (tex && geoImage.getTrackingToken())
@@ -651,6 +688,22 @@ namespace
     }
 }
 
+std::string
+TerrainTileModelFactory::getCompressionMethod(const ImageLayer* layer) const
+{
+    std::string compressionMethod = layer->getCompressionMethod();
+    if (compressionMethod.empty())
+        compressionMethod = _options.textureCompression().get();
+    return compressionMethod;
+}
+
+osg::ref_ptr<const osg::Image>
+TerrainTileModelFactory::prepareImage(const osg::Image* image, const ImageLayer* layer) const
+{
+    osg::ref_ptr<const osg::Image> compressed = ImageUtils::compressImage(image, getCompressionMethod(layer));
+    return ImageUtils::mipmapImage(compressed.get());
+}
+
 Texture::Ptr
 TerrainTileModelFactory::createImageTexture(
     const osg::Image* image,
@@ -672,9 +725,7 @@ TerrainTileModelFactory::createImageTexture(
     else
     {
         // figure out the texture compression method to use (if any)
-        std::string compressionMethod = layer->getCompressionMethod();
-        if (compressionMethod.empty())
-            compressionMethod = _options.textureCompression().get();
+        std::string compressionMethod = getCompressionMethod(layer);
 
         GLenum pixelFormat = image->getPixelFormat();
         GLenum internalFormat = image->getInternalTextureFormat();
@@ -692,10 +743,9 @@ TerrainTileModelFactory::createImageTexture(
 
         if (image->r() == 1)
         {
-            osg::ref_ptr<const osg::Image> compressed = ImageUtils::compressImage(image, compressionMethod);
-            const osg::Image* mipmapped = ImageUtils::mipmapImage(compressed.get());
+            osg::ref_ptr<const osg::Image> mipmapped = prepareImage(image, layer);
 
-            tex = createTexture2D(mipmapped);
+            tex = createTexture2D(mipmapped.get());
 
             hasMipMaps = mipmapped->isMipmap();
             isCompressed = mipmapped->isCompressed();
@@ -2,44 +2,42 @@
 * Copyright 2025 Pelican Mapping
 * MIT License
 */
-#include <iterator>
 #include <osgEarth/Tessellator>
 
 #include <osgEarth/earcut.hpp>
+#include <algorithm>
 namespace mapbox {
     namespace util {
         template <>
-        struct nth<0, osg::Vec2> {
-            inline static float get(const osg::Vec2 &t) {
+        struct nth<0, osg::Vec2d> {
+            inline static double get(const osg::Vec2d &t) {
                 return t.x();
             };
         };
 
         template <>
-        struct nth<1, osg::Vec2> {
-            inline static float get(const osg::Vec2 &t) {
+        struct nth<1, osg::Vec2d> {
+            inline static double get(const osg::Vec2d &t) {
                 return t.y();
             };
         };
 
         template <>
         struct nth<0, osg::Vec3d> {
-            inline static float get(const osg::Vec3d &t) {
+            inline static double get(const osg::Vec3d &t) {
                 return t.x();
             };
         };
 
         template <>
         struct nth<1, osg::Vec3d> {
-            inline static float get(const osg::Vec3d &t) {
+            inline static double get(const osg::Vec3d &t) {
                 return t.y();
             };
         };
     }
 }
 
-#define USE_EARCUT
-
 using namespace osgEarth;
 using namespace osgEarth::Util;
 
@@ -51,95 +49,6 @@ using namespace osgEarth::Util;
 namespace
 {
 
-// Borrowed from osgUtil/DelaunayTriangulator.cpp
-// Compute the circumcircle of a triangle (only x and y coordinates are used),
-// return (Cx, Cy, r^2)
-inline osg::Vec3 compute_circumcircle(
-    const osg::Vec3 &a,
-    const osg::Vec3 &b,
-    const osg::Vec3 &c)
-{
-    float D =
-        (a.x() - c.x()) * (b.y() - c.y()) -
-        (b.x() - c.x()) * (a.y() - c.y());
-
-    float cx, cy, r2;
-
-    if(D==0.0)
-    {
-        // (Nearly) degenerate condition - either two of the points are equal (which we discount)
-        // or the three points are colinear. In this case we just determine the average of
-        // the three points as the centre for correctness, but squirt out a zero radius.
-        // This method will produce a triangulation with zero area, so we have to check later
-        cx = (a.x()+b.x()+c.x())/3.0;
-        cy = (a.y()+b.y()+c.y())/3.0;
-        r2 = 0.0;
-    }
-    else
-    {
-        cx =
-        (((a.x() - c.x()) * (a.x() + c.x()) +
-        (a.y() - c.y()) * (a.y() + c.y())) / 2 * (b.y() - c.y()) -
-        ((b.x() - c.x()) * (b.x() + c.x()) +
-        (b.y() - c.y()) * (b.y() + c.y())) / 2 * (a.y() - c.y())) / D;
-
-        cy =
-        (((b.x() - c.x()) * (b.x() + c.x()) +
-        (b.y() - c.y()) * (b.y() + c.y())) / 2 * (a.x() - c.x()) -
-        ((a.x() - c.x()) * (a.x() + c.x()) +
-        (a.y() - c.y()) * (a.y() + c.y())) / 2 * (b.x() - c.x())) / D;
-
-      //  r2 = (c.x() - cx) * (c.x() - cx) + (c.y() - cy) * (c.y() - cy);
-        // the return r square is compared with r*r many times in an inner loop
-        // so for efficiency use the inefficient sqrt once rather than 30* multiplies later.
-        r2 = sqrt((c.x() - cx) * (c.x() - cx) + (c.y() - cy) * (c.y() - cy));
-    }
-    return osg::Vec3(cx, cy, r2);
-}
-
-// Test whether a point (only the x and y coordinates are used) lies inside
-// a circle; the circle is passed as a vector: (Cx, Cy, r).
-
-inline bool point_in_circle(const osg::Vec3 &point, const osg::Vec3 &circle)
-{
-    float r2 =
-        (point.x() - circle.x()) * (point.x() - circle.x()) +
-        (point.y() - circle.y()) * (point.y() - circle.y());
-    return r2 <= circle.z()*circle.z();
-//    return r2 <= circle.z();
-}
-
-int checkCCW(double x1, double y1, double x2, double y2, double x3, double y3)
-{
-    double v = (x2 - x1) * (y3 - y1) - (y2 - y1) * (x3 - x1);
-    return (v == 0.0 ? 0 : (v > 0.0 ? 1 : -1));
-}
-
-//bool point_in_tri(const osg::Vec3 &p, const osg::Vec3 &t1, const osg::Vec3 &t2, const osg::Vec3 &t3)
-bool point_in_tri(double xp, double yp, double x1, double y1, double x2, double y2, double x3, double y3)
-{
-  int t1 = checkCCW(xp, yp, x1, y1, x2, y2);
-  int t2 = checkCCW(xp, yp, x2, y2, x3, y3);
-  int t3 = checkCCW(xp, yp, x3, y3, x1, y1);
-
-  return t1 == t2 && t2 == t3;
-}
-
-struct TriIndices
-{
-    unsigned int a;
-    unsigned int b;
-    unsigned int c;
-
-    TriIndices(unsigned int p1, unsigned int p2, unsigned int p3)
-      : a(p1), b(p2), c(p3)
-    {
-      //nop
-    }
-};
-
-typedef std::vector<TriIndices> TriList;
-
 enum AreaPlane{
     AREA_PLANE_XY,
     AREA_PLANE_XZ,
@@ -222,322 +131,187 @@ void rotateToXY(std::vector<std::vector<osg::Vec3d>>& polygon)
     }
 }
 
+inline osg::Vec2d project(const osg::Vec3& v, AreaPlane plane)
+{
+    switch (plane) {
+        case AREA_PLANE_XZ: return osg::Vec2d(v.x(), v.z());
+        case AREA_PLANE_YZ: return osg::Vec2d(v.y(), v.z());
+        default:            return osg::Vec2d(v.x(), v.y());
+    }
 }
 
-
-bool
-Tessellator::tessellateGeometry(osg::Geometry &geom)
+template<typename T>
+double signedArea(const std::vector<T>& ring)
 {
-#ifndef USE_EARCUT
-    osg::Vec3Array* vertices = dynamic_cast<osg::Vec3Array*>(geom.getVertexArray());
-
-    if (!vertices || vertices->empty() || geom.getPrimitiveSetList().empty()) return false;
-
-    // copy the original primitive set list
-    osg::Geometry::PrimitiveSetList originalPrimitives = geom.getPrimitiveSetList();
-
-    // clear the primitive sets
-    unsigned int nprimsetoriginal= geom.getNumPrimitiveSets();
-    if (nprimsetoriginal) geom.removePrimitiveSet(0, nprimsetoriginal);
-
-    bool success = true;
-    for (unsigned int i=0; i < originalPrimitives.size(); i++)
-    {
-        osg::ref_ptr<osg::PrimitiveSet> primitive = originalPrimitives[i].get();
-
-        if (primitive->getMode()==osg::PrimitiveSet::POLYGON || primitive->getMode()==osg::PrimitiveSet::LINE_LOOP)
-        {
-            if (primitive->getType()==osg::PrimitiveSet::DrawArrayLengthsPrimitiveType)
-            {
-                osg::DrawArrayLengths* drawArrayLengths = static_cast<osg::DrawArrayLengths*>(primitive.get());
-                unsigned int first = drawArrayLengths->getFirst();
-                for(osg::DrawArrayLengths::iterator itr=drawArrayLengths->begin();
-                    itr!=drawArrayLengths->end();
-                    ++itr)
-                {
-                    unsigned int last = first + *itr;
-                    osg::PrimitiveSet* newPrimitive = tessellatePrimitive(first, last, vertices);
-                    if (newPrimitive)
-                    {
-                        geom.addPrimitiveSet(newPrimitive);
-                    }
-                    else
-                    {
-                        // tessellation failed, add old primitive set back
-                        geom.addPrimitiveSet(primitive.get());
-                        success = false;
-                    }
-
-                    first = last;
-                }
-            }
-            else
-            {
-                if (primitive->getNumIndices()>=3)
-                {
-                    osg::PrimitiveSet* newPrimitive = tessellatePrimitive(primitive.get(), vertices);
-                    if (newPrimitive)
-                    {
-                        geom.addPrimitiveSet(newPrimitive);
-                    }
-                    else
-                    {
-                        // tessellation failed, add old primitive set back
-                        geom.addPrimitiveSet(primitive.get());
-                        success = false;
-                    }
-                }
-            }
-        }
-        else
-        {
-            //
-            // TODO: handle more primitive modes
-            //
-        }
-    }
-    return success;
-#else
-    // Create array
-    std::vector< std::vector< osg::Vec2 > > polygon;
-    osg::Vec3Array* verts = static_cast<osg::Vec3Array*>(geom.getVertexArray());
-    int areaPlane = polygonPlane(*verts);
+    double area = 0.0;
+    for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
+        area += (ring[j].x() - ring[i].x()) * (ring[i].y() + ring[j].y());
+    return 0.5 * area;
+}
 
-    for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); i++)
+// even-odd test
+bool contains(const std::vector<osg::Vec2d>& ring, const osg::Vec2d& p)
+{
+    bool inside = false;
+    for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++)
     {
-        std::vector< osg::Vec2 > ring;
-        osg::PrimitiveSet* pset = geom.getPrimitiveSet(i);
-        if (pset->getType() == osg::PrimitiveSet::DrawArraysPrimitiveType)
+        if (((ring[i].y() > p.y()) != (ring[j].y() > p.y())) &&
+            (p.x() < (ring[j].x() - ring[i].x()) * (p.y() - ring[i].y()) / (ring[j].y() - ring[i].y()) + ring[i].x()))
         {
-            osg::DrawArrays* drawArray = static_cast<osg::DrawArrays*>(pset);
-            unsigned int first = drawArray->getFirst();
-            unsigned int last = first + drawArray->getCount();
-            ring.reserve(drawArray->getCount());
-            for (unsigned int j = first; j < last; j++)
-            {
-                const osg::Vec3& v = verts->at(j);
-                switch (areaPlane) {
-                    case AREA_PLANE_XY: ring.push_back(osg::Vec2(v.x(), v.y())); break;
-                    case AREA_PLANE_XZ: ring.push_back(osg::Vec2(v.x(), v.z())); break;
-                    case AREA_PLANE_YZ: ring.push_back(osg::Vec2(v.y(), v.z())); break;
-                }
-            }
+            inside = !inside;
         }
-        polygon.push_back(ring);
     }
-
-    // The index type. Defaults to uint32_t, but you can also pass uint16_t if you know that your
-    // data won't have more than 65536 vertices.
-    std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon);
-    // Remove the existing primitive sets
-    geom.removePrimitiveSet(0, geom.getNumPrimitiveSets());
-    osg::DrawElementsUInt* drawElements = new osg::DrawElementsUInt(GL_TRIANGLES);
-    drawElements->reserve(indices.size());
-    std::copy(indices.begin(), indices.end(), std::back_inserter(*drawElements));
-    geom.addPrimitiveSet(drawElements);
-    return true;
-#endif
+    return inside;
 }
 
-
-osg::PrimitiveSet*
-Tessellator::tessellatePrimitive(osg::PrimitiveSet* primitive, osg::Vec3Array* vertices)
+// A vertex of the ring that is not on the other ring, to test containment
+// with; rings that share vertices (a hole touching its shell) are common.
+const osg::Vec2d& probe(const std::vector<osg::Vec2d>& ring, const std::vector<osg::Vec2d>& other)
 {
-    switch(primitive->getType())
-    {
-    case(osg::PrimitiveSet::DrawArraysPrimitiveType):
-        {
-            osg::DrawArrays* drawArray = static_cast<osg::DrawArrays*>(primitive);
-            unsigned int first = drawArray->getFirst();
-            unsigned int last = first+drawArray->getCount();
-            return tessellatePrimitive(first, last, vertices);
-         }
-    default:
-        OE_NOTICE << LC << "Primitive type " << primitive->getType()<< " not handled" << std::endl;
-        break;
-    }
-
-    return 0L;
+    for (auto& p : ring)
+        if (std::find(other.begin(), other.end(), p) == other.end())
+            return p;
+    return ring.front();
 }
 
-osg::PrimitiveSet*
-Tessellator::tessellatePrimitive(unsigned int first, unsigned int last, osg::Vec3Array* vertices)
+struct LoopRange
 {
-    std::vector<unsigned int> activeVerts;
-    activeVerts.reserve( last-first+1 );
-    for (unsigned int i=first; i < last; i++)
-    {
-        activeVerts.push_back(i);
-    }
-
-    TriList tris;
-    tris.reserve( activeVerts.size() );
+    unsigned first;
+    unsigned count;
+    std::vector<osg::Vec2d> points;
+};
 
-    bool success = true;
-    unsigned int cursor = 0;
-    unsigned int cursor_start = 0;
-    unsigned int tradCursor = UINT_MAX;
-    while (activeVerts.size() > 3)
-    {
-        if (isConvex(*vertices, activeVerts, cursor))
-        {
-            bool tradEar = tradCursor != UINT_MAX;
-            if (isEar(*vertices, activeVerts, cursor, tradEar))
-            {
-                unsigned int prev = cursor == 0 ? activeVerts.size() - 1 : cursor - 1;
-                unsigned int next = cursor == activeVerts.size() - 1 ? 0 : cursor + 1;
+}
 
-                tris.push_back(TriIndices(activeVerts[prev], activeVerts[cursor], activeVerts[next]));
 
-                activeVerts.erase(activeVerts.begin() + cursor);
-                if (cursor >= activeVerts.size())
-                    cursor = 0;
+bool
+Tessellator::tessellateGeometry(osg::Geometry &geom)
+{
+    osg::Vec3Array* verts = dynamic_cast<osg::Vec3Array*>(geom.getVertexArray());
+    if (!verts || verts->empty() || geom.getNumPrimitiveSets() == 0)
+        return false;
 
-                cursor_start = cursor;
-                tradCursor = UINT_MAX;
+    // collect the rings; any other primitive sets are kept as they are.
+    std::vector<LoopRange> rings;
+    osg::Geometry::PrimitiveSetList others;
 
-                continue;
-            }
+    for (unsigned int i = 0; i < geom.getNumPrimitiveSets(); i++)
+    {
+        osg::PrimitiveSet* pset = geom.getPrimitiveSet(i);
+        bool isRing =
+            pset->getMode() == osg::PrimitiveSet::POLYGON ||
+            pset->getMode() == osg::PrimitiveSet::LINE_LOOP;
 
-            if (tradEar && tradCursor == UINT_MAX)
-            {
-                tradCursor = cursor;
-            }
+        if (isRing && pset->getType() == osg::PrimitiveSet::DrawArraysPrimitiveType)
+        {
+            osg::DrawArrays* da = static_cast<osg::DrawArrays*>(pset);
+            rings.push_back(LoopRange{ (unsigned)da->getFirst(), (unsigned)da->getCount() });
         }
-
-        cursor++;
-        if (cursor >= activeVerts.size())
-            cursor = 0;
-
-        if (cursor == cursor_start)
+        else if (isRing && pset->getType() == osg::PrimitiveSet::DrawArrayLengthsPrimitiveType)
         {
-            if (tradCursor != UINT_MAX)
+            osg::DrawArrayLengths* dal = static_cast<osg::DrawArrayLengths*>(pset);
+            unsigned first = dal->getFirst();
+            for (auto length : *dal)
             {
-                // No ear was found with circumcircle test, use first traditional ear found
-
-                cursor = tradCursor;
-
-                unsigned int prev = cursor == 0 ? activeVerts.size() - 1 : cursor - 1;
-                unsigned int next = cursor == activeVerts.size() - 1 ? 0 : cursor + 1;
-
-                tris.push_back(TriIndices(activeVerts[prev], activeVerts[cursor], activeVerts[next]));
-
-                activeVerts.erase(activeVerts.begin() + cursor);
-                if (cursor >= activeVerts.size())
-                    cursor = 0;
-
-                cursor_start = cursor;
-                tradCursor = UINT_MAX;
-
-                continue;
-            }
-            else
-            {
-                success = false;
-                break;
+                rings.push_back(LoopRange{ first, (unsigned)length });
+                first += length;
             }
         }
-    }
-
-    if (success)
-    {
-        if (activeVerts.size() == 3)
+        else
         {
-            // add last tri
-            tris.push_back(TriIndices(activeVerts[0], activeVerts[1], activeVerts[2]));
+            others.push_back(pset);
         }
+    }
 
-        osg::DrawElementsUInt* triElements = new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, 0);
-        triElements->reserve( tris.size() * 3 );
-        for (TriList::const_iterator it = tris.begin(); it != tris.end(); ++it)
-        {
-            triElements->push_back(it->a);
-            triElements->push_back(it->b);
-            triElements->push_back(it->c);
-        }
+    if (rings.empty())
+        return false;
 
-        return triElements;
-    }
-    else
+    // project to the dominant plane, in double precision so that large
+    // (projected or ECEF) coordinates keep their detail:
+    AreaPlane plane = polygonPlane(*verts);
+    for (auto& ring : rings)
     {
-        //TODO: handle?
-        //OE_DEBUG << LC << "Tessellation failed!" << std::endl;
+        if (ring.first + ring.count > verts->size())
+            return false;
+        ring.points.reserve(ring.count);
+        for (unsigned j = ring.first; j < ring.first + ring.count; ++j)
+            ring.points.push_back(project((*verts)[j], plane));
     }
 
-    return 0L;
-}
-
-
-bool
-Tessellator::isConvex(const osg::Vec3Array &vertices, const std::vector<unsigned int> &activeVerts, unsigned int cursor)
-{
-    unsigned int prev = cursor == 0 ? activeVerts.size() - 1 : cursor - 1;
-    unsigned int next = cursor == activeVerts.size() - 1 ? 0 : cursor + 1;
-
-    unsigned int a = activeVerts[prev];
-    unsigned int b = activeVerts[cursor];
-    unsigned int c = activeVerts[next];
-
-    osg::Vec3d dataA;
-    dataA._v[0] = vertices[a][0];
-    dataA._v[1] = vertices[a][1];
-    dataA._v[2] = vertices[a][2];
-
-    osg::Vec3d dataB;
-    dataB._v[0] = vertices[b][0];
-    dataB._v[1] = vertices[b][1];
-    dataB._v[2] = vertices[b][2];
-
-    osg::Vec3d dataC;
-    dataC._v[0] = vertices[c][0];
-    dataC._v[1] = vertices[c][1];
-    dataC._v[2] = vertices[c][2];
-
-    //http://www.gamedev.net/topic/542870-determine-which-side-of-a-line-a-point-is/#entry4500667
-    //(Bx - Ax) * (Cy - Ay) - (By - Ay) * (Cx - Ax)
-
-    return (dataB.x() - dataA.x()) * (dataC.y() - dataA.y()) - (dataB.y() - dataA.y()) * (dataC.x() - dataA.x()) > 0.0;
-}
-
-bool
-Tessellator::isEar(const osg::Vec3Array &vertices, const std::vector<unsigned int> &activeVerts, unsigned int cursor, bool &tradEar)
-{
-    unsigned int prev = cursor == 0 ? activeVerts.size() - 1 : cursor - 1;
-    unsigned int next = cursor == activeVerts.size() - 1 ? 0 : cursor + 1;
+    // group the rings into polygons: a ring inside an earlier shell, and
+    // not inside one of its holes, is a hole of that shell. This does not
+    // depend on the winding order, which varies by data source.
+    std::vector<std::vector<unsigned>> polygons;
+    for (unsigned i = 0; i < rings.size(); ++i)
+    {
+        if (rings[i].count < 3)
+            continue;
 
-    osg::Vec3d cc(compute_circumcircle(vertices[activeVerts[prev]], vertices[activeVerts[cursor]], vertices[activeVerts[next]]));
+        int owner = -1;
+        for (unsigned p = 0; p < polygons.size() && owner < 0; ++p)
+        {
+            const LoopRange& shell = rings[polygons[p][0]];
+            if (contains(shell.points, probe(rings[i].points, shell.points)))
+            {
+                owner = p;
+                for (unsigned h = 1; h < polygons[p].size(); ++h)
+                {
+                    const LoopRange& hole = rings[polygons[p][h]];
+                    if (contains(hole.points, probe(rings[i].points, hole.points)))
+                    {
+                        owner = -1;
+                        break;
+                    }
+                }
+            }
+        }
 
-    unsigned int nextNext = next == activeVerts.size() - 1 ? 0 : next + 1;
+        if (owner >= 0)
+            polygons[owner].push_back(i);
+        else
+            polygons.push_back({ i });
+    }
 
-        // Check every point not part of the ear
-    bool circEar = true;
-        while( nextNext != prev )
-        {
-        unsigned int p = activeVerts[nextNext];
+    osg::ref_ptr<osg::DrawElementsUInt> triangles = new osg::DrawElementsUInt(GL_TRIANGLES);
 
-        if (circEar && point_in_circle(vertices[p], cc))
+    std::vector<std::vector<osg::Vec2d>> input;
+    std::vector<unsigned> vertexOf;
+    for (auto& polygon : polygons)
+    {
+        input.clear();
+        vertexOf.clear();
+        for (auto r : polygon)
         {
-            circEar = false;
-
-            if (tradEar)
-              return false;
+            input.push_back(rings[r].points);
+            for (unsigned j = 0; j < rings[r].count; ++j)
+                vertexOf.push_back(rings[r].first + j);
         }
 
-        if (!tradEar &&
-            point_in_tri(vertices[p].x(), vertices[p].y(),
-                         vertices[activeVerts[prev]].x(), vertices[activeVerts[prev]].y(),
-                         vertices[activeVerts[cursor]].x(), vertices[activeVerts[cursor]].y(),
-                         vertices[activeVerts[next]].x(), vertices[activeVerts[next]].y()))
-              {
-            return false;
-              }
+        std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(input);
 
-              nextNext = nextNext == activeVerts.size() - 1 ? 0 : nextNext + 1;
+        if (indices.empty())
+        {
+            // nothing to draw for a degenerate shell; otherwise let the
+            // caller fall back on another tessellator.
+            if (signedArea(input[0]) != 0.0)
+            {
+                OE_DEBUG << LC << "Tessellation failed on a ring of " << input[0].size() << " points" << std::endl;
+                return false;
+            }
+            continue;
         }
 
-    tradEar = true;
+        triangles->reserve(triangles->size() + indices.size());
+        for (auto i : indices)
+            triangles->push_back(vertexOf[i]);
+    }
+
+    geom.removePrimitiveSet(0, geom.getNumPrimitiveSets());
+    geom.addPrimitiveSet(triangles.get());
+    for (auto& pset : others)
+        geom.addPrimitiveSet(pset.get());
 
-        return circEar;
+    return true;
 }
 
 
@@ -549,24 +323,46 @@ Tessellator::tessellate2D(
 {
     typedef std::vector< std::vector<osg::Vec3d> > poly_t;
 
-    // build the data structure to tessellate:
+    out_indices.clear();
+    if (!input)
+        return false;
+
+    // Tessellate each polygon (a shell and its holes) on its own. The
+    // indices follow the order of ConstGeometryIterator(input, true),
+    // which visits each shell followed by its holes.
     poly_t polygon;
+    std::vector<uint32_t> indices;
+    uint32_t offset = 0u;
+    bool valid = false;
 
-    ConstGeometryIterator iter(input, true);
+    ConstGeometryIterator iter(input, false);
     while (iter.hasMore())
     {
         const Geometry* part = iter.next();
-        polygon.emplace_back(part->size());
-        std::copy(part->begin(), part->end(), polygon.back().begin());
-    }
 
-    if (plane == PLANE_AUTO)
-    {
-        rotateToXY(polygon);
-    }
+        polygon.clear();
+        polygon.emplace_back(part->begin(), part->end());
+        if (part->getType() == Geometry::TYPE_POLYGON)
+        {
+            for (auto& hole : static_cast<const Polygon*>(part)->getHoles())
+                polygon.emplace_back(hole->begin(), hole->end());
+        }
+
+        if (plane == PLANE_AUTO)
+        {
+            rotateToXY(polygon);
+        }
 
-    // tessellate:
-    out_indices = mapbox::earcut<uint32_t>(polygon);
+        indices = mapbox::earcut<uint32_t>(polygon);
+        for (auto i : indices)
+            out_indices.push_back(i + offset);
 
-    return true;
+        if (polygon[0].size() >= 3 && signedArea(polygon[0]) != 0.0)
+            valid = true;
+
+        for (auto& ring : polygon)
+            offset += ring.size();
+    }
+
+    return !out_indices.empty() || !valid;
 }
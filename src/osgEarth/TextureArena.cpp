@@ -183,6 +183,23 @@ Texture::dataLoaded() const
         osgTexture()->getImage(0) != nullptr;
 }
 
+std::size_t
+Texture::getResidentImageBytes() const
+{
+    const osg::Texture* tex = osgTexture().get();
+    if (!tex || !keepImage() || tex->getUnRefImageDataAfterApply())
+        return 0u;
+
+    std::size_t bytes = 0u;
+    for (unsigned i = 0; i < tex->getNumImages(); ++i)
+    {
+        const osg::Image* image = tex->getImage(i);
+        if (image)
+            bytes += image->getTotalSizeInBytesIncludingMipmaps();
+    }
+    return bytes;
+}
+
 bool
 Texture::compileGLObjects(osg::State& state) const
 {
@@ -22,6 +22,7 @@ ThreeDTilesLayer::Options::getConfig() const
     Config conf = VisibleLayer::Options::getConfig();
     conf.set("url", _url);
     conf.set("max_sse", _maximumScreenSpaceError);
+    conf.set("max_content_mb", _maxContentMB);
     return conf;
 }
 
@@ -31,6 +32,7 @@ ThreeDTilesLayer::Options::fromConfig( const Config& conf )
     _maximumScreenSpaceError.init(15.0f);
     conf.get("url", _url);
     conf.get("max_sse", _maximumScreenSpaceError);
+    conf.get("max_content_mb", _maxContentMB);
 }
 
 //........................................................................
@@ -77,6 +79,10 @@ ThreeDTilesLayer::openImplementation()
 
     _tilesetNode = new ThreeDTilesetNode(tileset, "", getSceneGraphCallbacks(), readOptions.get());
     _tilesetNode->setMaximumScreenSpaceError(*options().maximumScreenSpaceError());
+    if (options().maxContentMB().isSet())
+    {
+        _tilesetNode->setMaxContentBytes((std::size_t)options().maxContentMB().get() * 1024u * 1024u);
+    }
     _tilesetNode->setOwnerName(getName());
 
     return STATUS_OK;
@@ -98,6 +104,22 @@ ThreeDTilesLayer::setMaximumScreenSpaceError(float maximumScreenSpaceError)
     }
 }
 
+unsigned
+ThreeDTilesLayer::getMaxContentMB() const
+{
+    return *options().maxContentMB();
+}
+
+void
+ThreeDTilesLayer::setMaxContentMB(unsigned value)
+{
+    options().maxContentMB() = value;
+    if (_tilesetNode)
+    {
+        _tilesetNode->setMaxContentBytes((std::size_t)value * 1024u * 1024u);
+    }
+}
+
 osg::Node*
 ThreeDTilesLayer::getNode() const
 {
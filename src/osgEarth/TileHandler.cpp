@@ -10,6 +10,15 @@ using namespace osgEarth::Util;
 
 bool TileHandler::handleTile(const TileKey& key, const TileVisitor& tv)
 {
+    if (isStaged())
+    {
+        TileData data = readTile(key, tv);
+        if (data.valid())
+            data = processTile(key, data.get(), tv);
+        if (data.valid())
+            data = encodeTile(key, data.get(), tv);
+        return data.valid() && writeTile(key, data.get(), tv);
+    }
     return true;    
 }
 
@@ -5,6 +5,9 @@
 #include "TileMesher"
 #include "Locators"
 #include "weemesh.h"
+#include <memory>
+#include <mutex>
+#include <vector>
 
 using namespace osgEarth;
 
@@ -361,6 +364,62 @@ namespace
         }
     }
 
+    // Scratch meshes for constrained tiles, shared by all meshers. A
+    // reused mesh keeps its vertex table, triangle blocks and spatial
+    // index nodes, so meshing stops allocating once the pool is warm.
+    // A mesh that built an unusually large tile frees its storage before
+    // going back, and the pool holds at most MAX_POOLED meshes.
+    class ScratchMeshPool
+    {
+    public:
+        static constexpr int HIGH_WATER_TRIANGLES = 16384;
+        static constexpr std::size_t MAX_POOLED = 16u;
+
+        std::unique_ptr<weemesh::mesh_t> acquire()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_meshes.empty())
+                {
+                    auto mesh = std::move(_meshes.back());
+                    _meshes.pop_back();
+                    return mesh;
+                }
+            }
+            return std::unique_ptr<weemesh::mesh_t>(new weemesh::mesh_t());
+        }
+
+        void release(std::unique_ptr<weemesh::mesh_t> mesh)
+        {
+            if (mesh->uidgen > HIGH_WATER_TRIANGLES)
+                mesh->release();
+            else
+                mesh->clear();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_meshes.size() < MAX_POOLED)
+                _meshes.emplace_back(std::move(mesh));
+        }
+
+    private:
+        std::mutex _mutex;
+        std::vector<std::unique_ptr<weemesh::mesh_t>> _meshes;
+    };
+
+    ScratchMeshPool& scratchMeshPool()
+    {
+        // never destroyed, so meshing jobs can outlive static destruction
+        static ScratchMeshPool* s_pool = new ScratchMeshPool();
+        return *s_pool;
+    }
+
+    // A mesh from the pool, returned to it when this goes out of scope
+    struct ScratchMesh
+    {
+        std::unique_ptr<weemesh::mesh_t> mesh = scratchMeshPool().acquire();
+        ~ScratchMesh() { scratchMeshPool().release(std::move(mesh)); }
+    };
+
     void load_mesh(weemesh::mesh_t& mesh, const TileMesh& input)
     {
         mesh.set_boundary_marker(VERTEX_BOUNDARY);
@@ -428,7 +487,8 @@ TileMesher::createMeshWithConstraints(
     TileMesh geom; // final output.
     geom.localToWorld = local2world;
 
-    weemesh::mesh_t mesh;
+    ScratchMesh scratch;
+    weemesh::mesh_t& mesh = *scratch.mesh;
 
     // if we have an input mesh, use it. Otherwise, build a regular gridded mesh.
     if (input_mesh.verts.valid())
@@ -564,11 +624,9 @@ TileMesher::createMeshWithConstraints(
     // ... pluggable behavior ?
     if (have_any_removal_requests)
     {
-        std::unordered_set<weemesh::triangle_t*> insiders;
-        std::unordered_set<weemesh::triangle_t*> insiders_to_remove;
-        std::unordered_set<weemesh::triangle_t*> outsiders_to_possibly_remove;
-        weemesh::vert_t centroid;
-        const double one_third = 1.0 / 3.0;
+        // per-triangle flags, indexed by UID
+        enum : std::uint8_t { INSIDE = 1, REMOVE = 2, OUTSIDE = 4 };
+        std::vector<std::uint8_t> flags(mesh.uidgen, 0);
         std::vector<weemesh::triangle_t*> tris;
 
         for (auto& edit : edits)
@@ -594,21 +652,25 @@ TileMesher::createMeshWithConstraints(
                                 // expensive path, much check ALL triangles when removing exterior.
                                 for (auto& tri_iter : mesh.triangles)
                                 {
-                                    weemesh::triangle_t* tri = &tri_iter.second;
+                                    const weemesh::triangle_t& tri = tri_iter.second;
 
-                                    bool inside = part->contains2D(tri->centroid.x, tri->centroid.y);
+                                    // only test triangles in the polygon's bounding box
+                                    bool inside =
+                                        tri.centroid.x >= bb.xMin() && tri.centroid.x <= bb.xMax() &&
+                                        tri.centroid.y >= bb.yMin() && tri.centroid.y <= bb.yMax() &&
+                                        part->contains2D(tri.centroid.x, tri.centroid.y);
 
                                     if (inside)
                                     {
-                                        insiders.insert(tri);
+                                        flags[tri.uid] |= INSIDE;
                                         if (edit.removeInterior)
                                         {
-                                            insiders_to_remove.insert(tri);
+                                            flags[tri.uid] |= REMOVE;
                                         }
                                     }
                                     else if (edit.removeExterior)
                                     {
-                                        outsiders_to_possibly_remove.insert(tri);
+                                        flags[tri.uid] |= OUTSIDE;
                                     }
                                 }
                             }
@@ -622,7 +684,7 @@ TileMesher::createMeshWithConstraints(
                                     bool inside = part->contains2D(tri->centroid.x, tri->centroid.y);
                                     if (inside)
                                     {
-                                        insiders_to_remove.insert(tri);
+                                        flags[tri->uid] |= REMOVE;
                                     }
                                 }
                             }
@@ -635,16 +697,13 @@ TileMesher::createMeshWithConstraints(
             }
         }
 
-        for (auto tri : insiders_to_remove)
-        {
-            mesh.remove_triangle(*tri);
-        }
-
-        for (auto tri : outsiders_to_possibly_remove)
+        // remove interior triangles, and exterior triangles that are not
+        // inside any other polygon
+        for (weemesh::UID uid = 0; uid < flags.size(); ++uid)
         {
-            if (insiders.count(tri) == 0)
+            if ((flags[uid] & REMOVE) || (flags[uid] & (INSIDE | OUTSIDE)) == OUTSIDE)
             {
-                mesh.remove_triangle(*tri);
+                mesh.remove_triangle(mesh.triangles[uid]);
             }
         }
 
@@ -0,0 +1,414 @@
+/* osgEarth
+ * Copyright 2025 Pelican Mapping
+ * MIT License
+ */
+#include <osgEarth/TilePrefetcher>
+#include <osgEarth/ImageLayer>
+#include <osgEarth/ElevationLayer>
+#include <osgEarth/Metrics>
+#include <algorithm>
+#include <unordered_map>
+
+#define LC "[TilePrefetcher] "
+
+using namespace osgEarth;
+
+TilePrefetcher::TilePrefetcher(const Map* map) :
+    _map(map),
+    _generation(std::make_shared<std::atomic_uint>(0u)),
+    _pending(std::make_shared<std::atomic_uint>(0u)),
+    _group(jobs::jobgroup::create())
+{
+    computeRanges();
+}
+
+TilePrefetcher::~TilePrefetcher()
+{
+    cancel();
+    join();
+}
+
+void
+TilePrefetcher::setTerrainOptions(const TerrainOptionsAPI& options)
+{
+    _minTileRangeFactor = options.getMinTileRangeFactor();
+    _firstLOD = options.getFirstLOD();
+    _maxLOD = options.getMaxLOD();
+    computeRanges();
+}
+
+void
+TilePrefetcher::setMinTileRangeFactor(float value)
+{
+    _minTileRangeFactor = value;
+    computeRanges();
+}
+
+void
+TilePrefetcher::setFirstLOD(unsigned value)
+{
+    _firstLOD = value;
+}
+
+void
+TilePrefetcher::setMaxLOD(unsigned value)
+{
+    _maxLOD = value;
+    computeRanges();
+}
+
+void
+TilePrefetcher::computeRanges()
+{
+    // Same visibility ranges the terrain engine computes for distance-to-eye
+    // LOD selection: a tile subdivides when the eye comes within its
+    // children's range.
+    _ranges.clear();
+
+    osg::ref_ptr<const Map> map;
+    if (!_map.lock(map) || !map->getProfile())
+        return;
+
+    const Profile* profile = map->getProfile();
+
+    _ranges.resize(_maxLOD + 1u);
+    for (unsigned lod = 0; lod <= _maxLOD; ++lod)
+    {
+        unsigned tx, ty;
+        profile->getNumTiles(lod, tx, ty);
+        TileKey key(lod, tx / 2, ty / 2, profile);
+        GeoCircle c = key.getExtent().computeBoundingGeoCircle();
+        _ranges[lod] = c.getRadius() * _minTileRangeFactor * 2.0 * (1.0 / 1.405);
+    }
+}
+
+bool
+TilePrefetcher::computeEye(const Viewpoint& vp, osg::Vec3d& eye) const
+{
+    osg::ref_ptr<const Map> map;
+    if (!_map.lock(map) || !vp.focalPoint().isSet())
+        return false;
+
+    GeoPoint focal = vp.focalPoint()->transform(map->getSRS());
+    if (!focal.isValid())
+        return false;
+
+    osg::Vec3d world;
+    osg::Matrixd local2world;
+    if (!focal.toWorld(world) || !focal.createLocalToWorld(local2world))
+        return false;
+
+    double range = vp.range().isSet() ? vp.range()->as(Units::METERS) : 0.0;
+    double heading = vp.heading().isSet() ? vp.heading()->as(Units::RADIANS) : 0.0;
+    double pitch = vp.pitch().isSet() ? vp.pitch()->as(Units::RADIANS) : -osg::PI_2;
+
+    // look vector in the local tangent plane (east, north, up);
+    // the eye sits "range" units behind the focal point.
+    osg::Vec3d look(
+        sin(heading) * cos(pitch),
+        cos(heading) * cos(pitch),
+        sin(pitch));
+
+    eye = (-look * range) * local2world;
+    return true;
+}
+
+void
+TilePrefetcher::computeKeys(const std::vector<Sample>& samples, std::vector<Request>& out) const
+{
+    OE_PROFILING_ZONE;
+
+    osg::ref_ptr<const Map> map;
+    if (!_map.lock(map) || !map->getProfile() || _ranges.empty())
+        return;
+
+    const Profile* profile = map->getProfile();
+
+    // time at which each key is first needed
+    std::unordered_map<TileKey, double> firstNeeded;
+
+    const auto distanceTo = [](const TileKey& key, const osg::Vec3d& eye)
+    {
+        GeoCircle c = key.getExtent().computeBoundingGeoCircle();
+        osg::Vec3d center;
+        c.getCenter().toWorld(center);
+        return std::max(0.0, (eye - center).length() - c.getRadius());
+    };
+
+    std::vector<TileKey> roots;
+    profile->getAllKeysAtLOD(_firstLOD, roots);
+
+    std::vector<TileKey> stack;
+
+    for (auto& sample : samples)
+    {
+        stack = roots;
+
+        while (!stack.empty())
+        {
+            TileKey key = stack.back();
+            stack.pop_back();
+
+            firstNeeded.emplace(key, sample.time);
+
+            unsigned childLOD = key.getLOD() + 1u;
+            if (childLOD > _maxLOD || childLOD >= _ranges.size())
+                continue;
+
+            // the terrain creates all four children when any one of them
+            // comes into range.
+            TileKey children[4];
+            bool subdivide = false;
+            for (unsigned q = 0; q < 4; ++q)
+            {
+                children[q] = key.createChildKey(q);
+                if (!subdivide && distanceTo(children[q], sample.eye) < _ranges[childLOD])
+                    subdivide = true;
+            }
+
+            if (subdivide)
+            {
+                for (unsigned q = 0; q < 4; ++q)
+                    stack.push_back(children[q]);
+            }
+        }
+    }
+
+    out.reserve(out.size() + firstNeeded.size());
+    for (auto& i : firstNeeded)
+    {
+        out.emplace_back();
+        out.back().key = i.first;
+        out.back().time = i.second;
+    }
+
+    std::sort(out.begin(), out.end(), [](const Request& lhs, const Request& rhs) {
+        return lhs.time < rhs.time || (lhs.time == rhs.time && lhs.key.getLOD() < rhs.key.getLOD());
+    });
+}
+
+void
+TilePrefetcher::computeKeys(const Path& path, double startTime, double endTime, std::vector<Request>& out) const
+{
+    if (path.empty() || endTime < startTime)
+        return;
+
+    // eye position at each waypoint:
+    std::vector<Sample> waypoints;
+    waypoints.reserve(path.size());
+    for (auto& wp : path)
+    {
+        Sample s;
+        s.time = wp.time;
+        if (computeEye(wp.viewpoint, s.eye))
+            waypoints.emplace_back(s);
+    }
+
+    if (waypoints.empty())
+        return;
+
+    // sample the path at regular intervals, interpolating between waypoints:
+    std::vector<Sample> samples;
+    unsigned w = 0;
+    for (double t = startTime; t <= endTime + _sampleInterval * 0.5; t += _sampleInterval)
+    {
+        double time = std::min(t, endTime);
+
+        while (w + 1 < waypoints.size() && waypoints[w + 1].time <= time)
+            ++w;
+
+        Sample s;
+        s.time = time;
+        if (time <= waypoints[w].time || w + 1 == waypoints.size())
+        {
+            s.eye = waypoints[w].eye;
+        }
+        else
+        {
+            const Sample& a = waypoints[w];
+            const Sample& b = waypoints[w + 1];
+            double span = b.time - a.time;
+            double u = span > 0.0 ? (time - a.time) / span : 0.0;
+            s.eye = a.eye + (b.eye - a.eye) * u;
+        }
+        samples.emplace_back(s);
+    }
+
+    computeKeys(samples, out);
+}
+
+void
+TilePrefetcher::computeKeys(const Viewpoint& current, const osg::Vec3d& worldVelocity, double seconds, std::vector<Request>& out) const
+{
+    osg::Vec3d eye;
+    if (!computeEye(current, eye))
+        return;
+
+    std::vector<Sample> samples;
+    for (double t = 0.0; t <= seconds + _sampleInterval * 0.5; t += _sampleInterval)
+    {
+        double time = std::min(t, seconds);
+        samples.push_back(Sample{ time, eye + worldVelocity * time });
+    }
+
+    computeKeys(samples, out);
+}
+
+void
+TilePrefetcher::setMaxRequestedKeys(unsigned value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxRequested = std::max(value, 1u);
+    trimRequested();
+}
+
+unsigned
+TilePrefetcher::getNumRequested() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (unsigned)_requested.size();
+}
+
+void
+TilePrefetcher::trimRequested()
+{
+    // forget the oldest requests first
+    while (_requested.size() > _maxRequested && !_requestOrder.empty())
+    {
+        _requested.erase(_requestOrder.front());
+        _requestOrder.pop_front();
+    }
+}
+
+unsigned
+TilePrefetcher::prefetch(const std::vector<Request>& requests)
+{
+    osg::ref_ptr<const Map> map;
+    if (!_map.lock(map))
+        return 0u;
+
+    // one snapshot of the open layers, shared by all the jobs in this batch
+    struct Layers
+    {
+        std::vector<osg::ref_ptr<ImageLayer>> image;
+        std::vector<osg::ref_ptr<ElevationLayer>> elevation;
+    };
+    auto layers = std::make_shared<Layers>();
+    map->getOpenLayers(layers->image);
+    map->getOpenLayers(layers->elevation);
+    std::shared_ptr<const Layers> sharedLayers = layers;
+
+    osg::observer_ptr<const Map> map_weak(map.get());
+    ElevationPool::WorkingSet* ws = _workingSet;
+    auto generation = _generation;
+    auto pending = _pending;
+    unsigned myGeneration = *_generation;
+
+    jobs::context context;
+    context.pool = jobs::get_pool(_poolName);
+    context.group = _group;
+
+    unsigned count = 0u;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    for (auto& request : requests)
+    {
+        // jobs needed soonest run first
+        float value = -(float)request.time;
+
+        auto i = _requested.find(request.key);
+        if (i != _requested.end())
+        {
+            // already queued; move it up if it is now needed sooner
+            auto& priority = *i->second;
+            if (value > priority.load(std::memory_order_relaxed))
+                priority.store(value, std::memory_order_relaxed);
+            continue;
+        }
+
+        Priority priority = std::make_shared<std::atomic<float>>(value);
+        _requested.emplace(request.key, priority);
+        _requestOrder.push_back(request.key);
+
+        context.name = "prefetch " + request.key.str();
+        context.priority = [priority]() { return priority->load(std::memory_order_relaxed); };
+
+        ++(*pending);
+        ++count;
+
+        TileKey key = request.key;
+
+        jobs::dispatch([key, sharedLayers, map_weak, ws, generation, pending, myGeneration]()
+            {
+                if (*generation == myGeneration)
+                {
+                    for (auto& layer : sharedLayers->image)
+                    {
+                        if (*generation != myGeneration) break;
+                        if (layer->isKeyInLegalRange(key) && layer->mayHaveData(key))
+                            layer->createImage(key, nullptr);
+                    }
+
+                    for (auto& layer : sharedLayers->elevation)
+                    {
+                        if (*generation != myGeneration) break;
+                        if (layer->isKeyInLegalRange(key) && layer->mayHaveData(key))
+                            layer->createHeightField(key, nullptr);
+                    }
+
+                    osg::ref_ptr<const Map> safeMap;
+                    if (ws && *generation == myGeneration && map_weak.lock(safeMap))
+                    {
+                        osg::ref_ptr<ElevationTexture> tile;
+                        safeMap->getElevationPool()->getTile(key, true, tile, ws, nullptr);
+                    }
+                }
+                --(*pending);
+            },
+            context);
+    }
+
+    trimRequested();
+
+    OE_DEBUG << LC << "Queued " << count << " of " << requests.size() << " tiles" << std::endl;
+
+    return count;
+}
+
+unsigned
+TilePrefetcher::prefetch(const Path& path, double now)
+{
+    return prefetch(path, now, now + _lookahead);
+}
+
+unsigned
+TilePrefetcher::prefetch(const Path& path, double startTime, double endTime)
+{
+    std::vector<Request> requests;
+    computeKeys(path, startTime, endTime, requests);
+    return prefetch(requests);
+}
+
+unsigned
+TilePrefetcher::prefetch(const Viewpoint& current, const osg::Vec3d& worldVelocity)
+{
+    std::vector<Request> requests;
+    computeKeys(current, worldVelocity, _lookahead, requests);
+    return prefetch(requests);
+}
+
+void
+TilePrefetcher::join()
+{
+    _group->join();
+}
+
+void
+TilePrefetcher::cancel()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ++(*_generation);
+    _requested.clear();
+    _requestOrder.clear();
+}
@@ -3,6 +3,11 @@
  * MIT License
  */
 #include <osgEarth/TileVisitor>
+#include <osgEarth/FileUtils>
+#include <osgEarth/StringUtils>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
 #include <thread>
 
 #include <osg/os_utils>
@@ -109,6 +114,10 @@ void TileVisitor::run( const Profile* mapProfile )
 
     estimate();
 
+    openCheckpoint();
+
+    startVisit();
+
     // Get all the root keys and process them.
     std::vector<TileKey> keys;
     mapProfile->getRootKeys(keys);
@@ -117,6 +126,85 @@ void TileVisitor::run( const Profile* mapProfile )
     {
         processKey( keys[i] );
     }
+
+    finishVisit();
+
+    closeCheckpoint();
+}
+
+void TileVisitor::openCheckpoint()
+{
+    _checkpointed.clear();
+
+    if (_checkpointFile.empty())
+        return;
+
+    // Each line is "lod, x, y, traverse" for one finished tile.
+    std::ifstream in(_checkpointFile.c_str());
+    std::string line;
+    while (std::getline(in, line))
+    {
+        auto parts = StringTokenizer()
+            .delim(",")
+            .standardQuotes()
+            .tokenize(line);
+
+        if (parts.size() >= 4)
+        {
+            TileKey key(
+                as<unsigned int>(parts[0], 0u),
+                as<unsigned int>(parts[1], 0u),
+                as<unsigned int>(parts[2], 0u),
+                _profile.get());
+
+            _checkpointed[key] = as<int>(parts[3], 1) != 0;
+        }
+    }
+    in.close();
+
+    if (!_checkpointed.empty())
+    {
+        OE_INFO << "[TileVisitor] Resuming from " << _checkpointFile << " with "
+            << _checkpointed.size() << " tiles already finished" << std::endl;
+    }
+
+    makeDirectoryForFile(_checkpointFile);
+    _checkpointOut.open(_checkpointFile.c_str(), std::ios::out | std::ios::app);
+    _lastCheckpointFlush = std::chrono::steady_clock::now();
+}
+
+void TileVisitor::checkpoint(const TileKey& key, bool traverseChildren)
+{
+    if (!_checkpointOut.is_open())
+        return;
+
+    std::lock_guard<std::mutex> lk(_checkpointMutex);
+
+    _checkpointOut << key.getLevelOfDetail() << ", " << key.getTileX() << ", " << key.getTileY()
+        << ", " << (traverseChildren ? 1 : 0) << "\n";
+
+    // flush now and then, so an interruption loses at most a few tiles
+    auto now = std::chrono::steady_clock::now();
+    if (now - _lastCheckpointFlush >= std::chrono::seconds(1))
+    {
+        _checkpointOut.flush();
+        _lastCheckpointFlush = now;
+    }
+}
+
+void TileVisitor::closeCheckpoint()
+{
+    if (!_checkpointOut.is_open())
+        return;
+
+    _checkpointOut.close();
+    _checkpointed.clear();
+
+    // a completed run starts over next time
+    if (!_progress.valid() || !_progress->isCanceled())
+    {
+        ::remove(_checkpointFile.c_str());
+    }
 }
 
 void TileVisitor::estimate()
@@ -164,8 +252,18 @@ void TileVisitor::processKey( const TileKey& key )
         }
         else
         {
-            // Process the key
-            traverseChildren = handleTile(key);
+            // Skip keys finished by an earlier run
+            auto done = _checkpointed.find(key);
+            if (done != _checkpointed.end())
+            {
+                traverseChildren = done->second;
+                incrementProgress(1);
+            }
+            else
+            {
+                // Process the key
+                traverseChildren = handleTile(key);
+            }
         }
     }
 
@@ -217,6 +315,11 @@ bool TileVisitor::handleTile( const TileKey& key )
         result = _tileHandler->handleTile( key, *this );
     }
 
+    if (!_progress.valid() || !_progress->isCanceled())
+    {
+        checkpoint(key, result);
+    }
+
     incrementProgress(1);
 
     return result;
@@ -226,14 +329,88 @@ bool TileVisitor::handleTile( const TileKey& key )
 
 /*****************************************************************************************/
 
+#define MTTV "oe.mttilevisitor"
+
+namespace
+{
+    // Queue with a fixed capacity. Pushing to a full queue blocks until
+    // there is room, and popping from an empty one blocks until there is
+    // an item, or until the queue is closed.
+    template<typename T>
+    class BoundedQueue
+    {
+    public:
+        BoundedQueue(unsigned capacity) : _capacity(std::max(1u, capacity)) { }
+
+        //! Adds an item, waiting for room. Returns false if the queue is closed.
+        bool push(T&& value)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notFull.wait(lock, [this]() { return _closed || _items.size() < _capacity; });
+            if (_closed)
+                return false;
+            _items.emplace_back(std::move(value));
+            _notEmpty.notify_one();
+            return true;
+        }
+
+        //! Takes an item, waiting for one. Returns false once the
+        //! queue is closed and empty.
+        bool pop(T& value)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notEmpty.wait(lock, [this]() { return _closed || !_items.empty(); });
+            if (_items.empty())
+                return false;
+            value = std::move(_items.front());
+            _items.pop_front();
+            _notFull.notify_one();
+            return true;
+        }
+
+        //! No more items will arrive; wakes everyone waiting.
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+            _notEmpty.notify_all();
+            _notFull.notify_all();
+        }
+
+    private:
+        std::deque<T> _items;
+        unsigned _capacity;
+        bool _closed = false;
+        std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+    };
+
+    const char* stagePoolNames[TileHandler::NUM_STAGES] = {
+        MTTV ".read", MTTV ".process", MTTV ".encode", MTTV ".write"
+    };
+}
+
+struct MultithreadedTileVisitor::Pipeline
+{
+    struct Item
+    {
+        TileKey key;
+        TileHandler::TileData data;
+        bool ok = true; // false once a stage fails
+    };
+
+    // one queue in front of each stage, and the group of workers draining it
+    std::vector<std::unique_ptr<BoundedQueue<Item>>> queues;
+    std::vector<std::shared_ptr<jobs::jobgroup>> workers;
+};
+
 MultithreadedTileVisitor::MultithreadedTileVisitor() :
     _numThreads(std::max(1u, std::thread::hardware_concurrency()))
 {
     // We must do this to avoid an error message in OpenSceneGraph b/c the findWrapper method doesn't appear to be threadsafe.
     // This really isn't a big deal b/c this only effects data that is already cached.
     osgDB::ObjectWrapper* wrapper = osgDB::Registry::instance()->getObjectWrapperManager()->findWrapper("osg::Image");
-
-    _group = jobs::jobgroup::create();
 }
 
 MultithreadedTileVisitor::MultithreadedTileVisitor(TileHandler* handler) :
@@ -252,48 +429,148 @@ void MultithreadedTileVisitor::setNumThreads( unsigned int numThreads)
     _numThreads = numThreads;
 }
 
-#define MTTV "oe.mttilevisitor"
-
-void MultithreadedTileVisitor::run(const Profile* mapProfile)
+void MultithreadedTileVisitor::setNumStageThreads(TileHandler::Stage stage, unsigned numThreads)
 {
-    // Start up the task service
-    OE_DEBUG << "Starting " << _numThreads << " threads " << std::endl;
+    if (stage < TileHandler::NUM_STAGES)
+        _stageThreads[stage] = numThreads;
+}
 
-    jobs::get_pool(MTTV)->set_concurrency(_numThreads);
+unsigned MultithreadedTileVisitor::getNumStageThreads(TileHandler::Stage stage) const
+{
+    if (stage >= TileHandler::NUM_STAGES)
+        return 0u;
+    return _stageThreads[stage] > 0u ? _stageThreads[stage] : std::max(1u, _numThreads);
+}
 
-    // Produce the tiles
-    TileVisitor::run( mapProfile );
+void MultithreadedTileVisitor::setQueueSize(unsigned value)
+{
+    _queueSize = std::max(1u, value);
+}
 
-    _group->join();
+unsigned MultithreadedTileVisitor::getQueueSize() const
+{
+    return _queueSize;
 }
 
-bool MultithreadedTileVisitor::handleTile(const TileKey& key)
+void MultithreadedTileVisitor::startVisit()
 {
-    // atomically increment the task count
-    //_numTiles++;
+    _pipeline = std::make_shared<Pipeline>();
+
+    osg::ref_ptr<TileHandler> handler = _tileHandler;
+    bool staged = handler.valid() && handler->isStaged();
+    unsigned numStages = staged ? (unsigned)TileHandler::NUM_STAGES : 1u;
 
-    // don't let the task queue get too large...?    
-    while(jobs::get_metrics()->total_pending() > 1000)
+    for (unsigned s = 0; s < numStages; ++s)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        _pipeline->queues.emplace_back(new BoundedQueue<Pipeline::Item>(_queueSize));
     }
 
-    // Add the tile to the task queue.
-    auto task = [this, key]()
+    for (unsigned s = 0; s < numStages; ++s)
     {
-        if ((_tileHandler.valid()) && (!_progress.valid() || !_progress->isCanceled()))
+        unsigned numThreads = staged ? getNumStageThreads((TileHandler::Stage)s) : std::max(1u, _numThreads);
+
+        jobs::context job;
+        job.name = staged ? stagePoolNames[s] : MTTV;
+        job.pool = jobs::get_pool(job.name);
+        job.pool->set_concurrency(numThreads);
+        job.group = jobs::jobgroup::create();
+        _pipeline->workers.push_back(job.group);
+
+        OE_DEBUG << "Starting " << numThreads << " threads for " << job.name << std::endl;
+
+        BoundedQueue<Pipeline::Item>* input = _pipeline->queues[s].get();
+        BoundedQueue<Pipeline::Item>* output = s + 1 < numStages ? _pipeline->queues[s + 1].get() : nullptr;
+
+        auto worker = [this, handler, staged, s, input, output]()
+        {
+            Pipeline::Item item;
+            while (input->pop(item))
+            {
+                // keep draining after a cancelation so nobody stays blocked
+                if (!handler.valid() || (_progress.valid() && _progress->isCanceled()))
+                    continue;
+
+                bool done = true;
+
+                if (!staged)
+                {
+                    item.ok = handler->handleTile(item.key, *this);
+                }
+                else
+                {
+                    switch (s)
+                    {
+                    case TileHandler::STAGE_READ:
+                        item.data = handler->readTile(item.key, *this);
+                        break;
+                    case TileHandler::STAGE_PROCESS:
+                        item.data = handler->processTile(item.key, item.data.get(), *this);
+                        break;
+                    case TileHandler::STAGE_ENCODE:
+                        item.data = handler->encodeTile(item.key, item.data.get(), *this);
+                        break;
+                    case TileHandler::STAGE_WRITE:
+                        item.ok = handler->writeTile(item.key, item.data.get(), *this);
+                        item.data = nullptr;
+                        break;
+                    }
+
+                    // a stage with no output ends the work for this tile
+                    // (and, like TileHandler::handleTile, fails it)
+                    if (output != nullptr && !item.data.valid())
+                        item.ok = false;
+
+                    done = (output == nullptr || !item.ok);
+                }
+
+                if (done)
+                {
+                    // only finished tiles are recorded, so a resumed run
+                    // retries the ones that failed. Children are always
+                    // visited, so record them as such.
+                    if (item.ok && (!_progress.valid() || !_progress->isCanceled()))
+                    {
+                        checkpoint(item.key, true);
+                    }
+                    incrementProgress(1);
+                }
+                else
+                {
+                    output->push(std::move(item));
+                }
+            }
+        };
+
+        for (unsigned t = 0; t < numThreads; ++t)
         {
-            _tileHandler->handleTile(key, *this);
-            this->incrementProgress(1);
+            jobs::dispatch(worker, job);
         }
-    };
+    }
+}
 
-    jobs::context job;
-    job.name = "handleTile";
-    job.pool = jobs::get_pool(MTTV);
-    job.group = _group;
+void MultithreadedTileVisitor::finishVisit()
+{
+    if (!_pipeline)
+        return;
+
+    // Drain the pipeline front to back: once a stage's input is closed and
+    // its workers finish, nothing more can arrive at the next stage.
+    for (unsigned s = 0; s < _pipeline->queues.size(); ++s)
+    {
+        _pipeline->queues[s]->close();
+        _pipeline->workers[s]->join();
+    }
+
+    _pipeline = nullptr;
+}
+
+bool MultithreadedTileVisitor::handleTile(const TileKey& key)
+{
+    if (!_pipeline)
+        return false;
 
-    jobs::dispatch(task, job);
+    // Blocks while the first stage is backed up
+    _pipeline->queues.front()->push(Pipeline::Item{ key, nullptr, true });
 
     return true;
 }
@@ -121,15 +121,7 @@ TransformFilter::push( FeatureList& input, FilterContext& incx )
         if ( !push( i->get(), incx ) )
             ok = false;
 
-    FilterContext outcx( incx );
-
-    if ( _outputSRS.valid() )
-    {
-        if ( incx.extent()->isValid() )
-            outcx.setProfile( new FeatureProfile( incx.extent()->transform( _outputSRS.get()) ) );
-        else
-            outcx.setProfile( new FeatureProfile( incx.profile()->getExtent().transform( _outputSRS.get()) ) );
-    }
+    FilterContext outcx = createOutputContext( incx );
 
     // set the reference frame to shift data to the centroid. This will
     // prevent floating point precision errors in the openGL pipeline for
@@ -150,3 +142,68 @@ TransformFilter::push( FeatureList& input, FilterContext& incx )
 
     return outcx;
 }
+
+FilterContext
+TransformFilter::createOutputContext( FilterContext& incx ) const
+{
+    FilterContext outcx( incx );
+
+    if ( _outputSRS.valid() )
+    {
+        if ( incx.extent()->isValid() )
+            outcx.setProfile( new FeatureProfile( incx.extent()->transform( _outputSRS.get()) ) );
+        else
+            outcx.setProfile( new FeatureProfile( incx.profile()->getExtent().transform( _outputSRS.get()) ) );
+    }
+
+    return outcx;
+}
+
+FilterContext
+TransformFilter::pushBatch( FeatureBatch& input, FilterContext& incx )
+{
+    // rows in different SRSs need a transform each
+    if ( input.hasMixedSRS() )
+        return FeatureFilter::pushBatch( input, incx );
+
+    _bbox = osg::BoundingBoxd();
+
+    // the whole batch shares one SRS, so transform all the points at once:
+    std::vector<osg::Vec3d>& coords = input.getCoords();
+    const SpatialReference* inputSRS = input.getSRS();
+
+    if ( inputSRS && !coords.empty() )
+    {
+        bool needsSRSXform =
+            _outputSRS.valid() &&
+            !inputSRS->isEquivalentTo(_outputSRS.get());
+
+        if ( !_mat.isIdentity() )
+        {
+            for( auto& p : coords )
+                p = p * _mat;
+        }
+
+        if ( needsSRSXform )
+        {
+            inputSRS->transform( coords, _outputSRS.get() );
+        }
+
+        if ( _localize )
+        {
+            for( auto& p : coords )
+                _bbox.expandBy( p );
+        }
+    }
+
+    FilterContext outcx = createOutputContext( incx );
+
+    if ( _bbox.valid() && _localize )
+    {
+        osg::Matrixd localizer = osg::Matrixd::translate( -_bbox.center() );
+        for( auto& p : coords )
+            p = p * localizer;
+    }
+
+    return outcx;
+}
@@ -9,6 +9,7 @@
 #include <osgEarth/FileUtils>
 #include <osgEarth/Progress>
 #include <osgEarth/NetworkMonitor>
+#include <osgEarth/MetricsRegistry>
 #include <osgDB/FileNameUtils>
 #include <osgDB/ReadFile>
 #include <osgDB/Archive>
@@ -510,7 +511,7 @@ namespace
     // have 4 95%-identical code paths to maintain...
 
     template<typename READ_FUNCTOR>
-    ReadResult doRead(
+    ReadResult readURI(
         const URI&            inputURI,
         const osgDB::Options* dbOptions,
         ProgressCallback*     progress)
@@ -703,6 +704,41 @@ namespace
 
         return result;
     }
+
+    // Times and counts each read in the metrics registry, by source
+    template<typename READ_FUNCTOR>
+    ReadResult doRead(
+        const URI&            inputURI,
+        const osgDB::Options* dbOptions,
+        ProgressCallback*     progress)
+    {
+        using Util::MetricsRegistry;
+        auto& registry = MetricsRegistry::instance();
+        static MetricsRegistry::Histogram* latency[2] = {
+            &registry.histogram("osgearth_uri_read_seconds", "URI read latency", { { "source", "file" } }),
+            &registry.histogram("osgearth_uri_read_seconds", "URI read latency", { { "source", "network" } })
+        };
+        static MetricsRegistry::Counter* reads[2][3] = {
+            { &registry.counter("osgearth_uri_reads_total", "URI reads", { { "source", "file" }, { "result", "ok" } }),
+              &registry.counter("osgearth_uri_reads_total", "URI reads", { { "source", "file" }, { "result", "failed" } }),
+              &registry.counter("osgearth_uri_reads_total", "URI reads", { { "source", "file" }, { "result", "canceled" } }) },
+            { &registry.counter("osgearth_uri_reads_total", "URI reads", { { "source", "network" }, { "result", "ok" } }),
+              &registry.counter("osgearth_uri_reads_total", "URI reads", { { "source", "network" }, { "result", "failed" } }),
+              &registry.counter("osgearth_uri_reads_total", "URI reads", { { "source", "network" }, { "result", "canceled" } }) }
+        };
+
+        if (!MetricsRegistry::enabled())
+            return readURI<READ_FUNCTOR>(inputURI, dbOptions, progress);
+
+        unsigned source = inputURI.isRemote() ? 1 : 0;
+        ReadResult result;
+        {
+            MetricsRegistry::ScopedTimer timer(*latency[source]);
+            result = readURI<READ_FUNCTOR>(inputURI, dbOptions, progress);
+        }
+        reads[source][result.succeeded() ? 0 : (progress && progress->isCanceled()) ? 2 : 1]->add();
+        return result;
+    }
 }
 
 ReadResult
@@ -41,15 +41,14 @@ XYZ::Driver::open(const URI& uri,
 
     _format = !format.empty() ? format : osgDB::getLowerCaseFileExtension(uri.base());
 
+    // tiles in a local directory bypass the URI machinery
+    _local = LocalTileReader::usable(uri, readOptions);
+
     return STATUS_OK;
 }
 
-osgEarth::ReadResult
-XYZ::Driver::read(const URI& uri,
-                  const TileKey& key, 
-                  bool invertY,
-                  ProgressCallback* progress,
-                  const osgDB::Options* readOptions) const
+std::string
+XYZ::Driver::createLocation(const TileKey& key, bool invertY) const
 {
     unsigned x, y;
     key.getTileXY(x, y);
@@ -77,6 +76,18 @@ XYZ::Driver::read(const URI& uri,
     replaceIn( location, "{-y}", Stringify() << inverted_y);
     replaceIn( location, "{z}", Stringify() << key.getLevelOfDetail() );
 
+    return location;
+}
+
+osgEarth::ReadResult
+XYZ::Driver::read(const URI& uri,
+                  const TileKey& key, 
+                  bool invertY,
+                  ProgressCallback* progress,
+                  const osgDB::Options* readOptions) const
+{
+    std::string location = createLocation(key, invertY);
+
     std::string cacheKey;
 
     if ( !_rotateChoices.empty() )
@@ -86,6 +97,22 @@ XYZ::Driver::read(const URI& uri,
         replaceIn( location, _rotateString, Stringify() << _rotateChoices[index] );
     }
 
+    if (_local)
+    {
+        if (_prefetchSiblings && _rotateChoices.empty() && key.getLevelOfDetail() > 0)
+        {
+            TileKey parent = key.createParentKey();
+            for (unsigned q = 0; q < 4; ++q)
+            {
+                if (q != key.getQuadrant())
+                    LocalTileReader::prefetch(LocalTileReader::toPath(createLocation(parent.createChildKey(q), invertY)));
+            }
+        }
+
+        ReadResult r = _localReader.readImage(LocalTileReader::toPath(location), readOptions);
+        if (r.code() != ReadResult::RESULT_NOT_IMPLEMENTED)
+            return r;
+    }
 
     URI myUri( location, uri.context() );
     if ( !cacheKey.empty() )
@@ -107,6 +134,7 @@ XYZImageLayer::Options::getConfig() const
     conf.set("invert_y", _invertY);
     conf.set("min_level", minLevel());
     conf.set("max_level", maxLevel());
+    conf.set("prefetch_siblings", prefetchSiblings());
     return conf;
 }
 
@@ -118,6 +146,7 @@ XYZImageLayer::Options::fromConfig(const Config& conf)
     conf.get("invert_y", _invertY);
     conf.get("min_level", minLevel());
     conf.get("max_level", maxLevel());
+    conf.get("prefetch_siblings", prefetchSiblings());
 }
 
 //........................................................................
@@ -133,6 +162,7 @@ XYZElevationLayer::Options::getConfig() const
     conf.set("max_level", maxLevel());
     conf.set("elevation_encoding", _elevationEncoding);
     conf.set("stitch_edges", stitchEdges());
+    conf.set("prefetch_siblings", prefetchSiblings());
     return conf;
 }
 
@@ -147,6 +177,7 @@ XYZElevationLayer::Options::fromConfig(const Config& conf)
     conf.get("elevation_encoding", _elevationEncoding);
     conf.get("interpretation", elevationEncoding()); // compat with QGIS
     conf.get("stitch_edges", stitchEdges());
+    conf.get("prefetch_siblings", prefetchSiblings());
 }
 
 //........................................................................
@@ -156,6 +187,7 @@ REGISTER_OSGEARTH_LAYER(xyzimage, XYZImageLayer);
 OE_LAYER_PROPERTY_IMPL(XYZImageLayer, URI, URL, url);
 OE_LAYER_PROPERTY_IMPL(XYZImageLayer, bool, InvertY, invertY);
 OE_LAYER_PROPERTY_IMPL(XYZImageLayer, std::string, Format, format);
+OE_LAYER_PROPERTY_IMPL(XYZImageLayer, bool, PrefetchSiblings, prefetchSiblings);
 
 void
 XYZImageLayer::init()
@@ -184,6 +216,8 @@ XYZImageLayer::openImplementation()
 
     DataExtentList dataExtents;
 
+    _driver.setPrefetchSiblings(options().prefetchSiblings() == true);
+
     Status status = _driver.open(
         options().url().get(),
         options().format().get(),
@@ -29,7 +29,7 @@
 #define RTREE_TEMPLATE template<class DATATYPE, class ELEMTYPE, int NUMDIMS, class ELEMTYPEREAL, int TMAXNODES, int TMINNODES>
 #define RTREE_QUAL RTree<DATATYPE, ELEMTYPE, NUMDIMS, ELEMTYPEREAL, TMAXNODES, TMINNODES>
 
-#define RTREE_DONT_USE_MEMPOOLS // This version does not contain a fixed memory allocator, fill in lines with EXAMPLE to implement one.
+//#define RTREE_DONT_USE_MEMPOOLS // Define to new/delete every node instead of recycling freed nodes through a per-tree free list.
 #define RTREE_USE_SPHERICAL_VOLUME // Better split classification, may be slower on some systems
 
 #define RTREE_STOP_SEARCHING false
@@ -51,7 +51,9 @@ class RTFileStream;  // File I/O helper class, look below for implementation and
 /// ELEMTYPEREAL Type of element that allows fractional and large values such as float or double, for use in volume calcs
 ///
 /// NOTES: Inserting and removing data requires the knowledge of its constant Minimal Bounding Rectangle.
-///        This version uses new/delete for nodes, I recommend using a fixed size allocator for efficiency.
+///        Nodes freed by Remove() or RemoveAll() are kept on a per-tree free list and reused by later inserts,
+///        so a tree that is cleared and refilled (e.g. per terrain tile) stops allocating once it is warm.
+///        ReleaseFreeNodes() gives that memory back.
 ///        Instead of using a callback function for returned results, I recommend and efficient pre-sized, grow-only memory
 ///        array similar to MFC CArray or STL Vector for returning search query result.
 ///
@@ -108,6 +110,9 @@ public:
     /// Remove all entries from tree
     void RemoveAll();
 
+    /// Free the nodes kept for reuse by earlier removals
+    void ReleaseFreeNodes();
+
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int Count();
 
@@ -376,6 +381,9 @@ protected:
     void CopyRec(Node* current, Node* other);
 
     Node* m_root;                                    ///< Root of tree
+#ifndef RTREE_DONT_USE_MEMPOOLS
+    std::vector<Node*> m_freeNodes;                  ///< Freed nodes, reused by AllocNode until ReleaseFreeNodes()
+#endif // RTREE_DONT_USE_MEMPOOLS
     ELEMTYPEREAL m_unitSphereVolume;                 ///< Unit sphere constant for required number of dimensions
 
 public:
@@ -496,6 +504,7 @@ RTREE_TEMPLATE
 RTREE_QUAL::~RTree()
 {
     Reset(); // Free, or reset node memory
+    ReleaseFreeNodes();
 }
 
 
@@ -841,6 +850,19 @@ void RTREE_QUAL::RemoveAll()
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::ReleaseFreeNodes()
+{
+#ifndef RTREE_DONT_USE_MEMPOOLS
+    for (Node* node : m_freeNodes)
+    {
+        delete node;
+    }
+    std::vector<Node*>().swap(m_freeNodes);
+#endif // RTREE_DONT_USE_MEMPOOLS
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::Reset()
 {
@@ -848,8 +870,8 @@ void RTREE_QUAL::Reset()
     // Delete all existing nodes
     RemoveAllRec(m_root);
 #else // RTREE_DONT_USE_MEMPOOLS
-    // Just reset memory pools.  We are not using complex types
-    // EXAMPLE
+    // Return all existing nodes to the free list
+    RemoveAllRec(m_root);
 #endif // RTREE_DONT_USE_MEMPOOLS
 }
 
@@ -878,7 +900,15 @@ typename RTREE_QUAL::Node* RTREE_QUAL::AllocNode()
 #ifdef RTREE_DONT_USE_MEMPOOLS
     newNode = new Node;
 #else // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
+    if (!m_freeNodes.empty())
+    {
+        newNode = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        newNode = new Node;
+    }
 #endif // RTREE_DONT_USE_MEMPOOLS
     InitNode(newNode);
     return newNode;
@@ -893,7 +923,7 @@ void RTREE_QUAL::FreeNode(Node* a_node)
 #ifdef RTREE_DONT_USE_MEMPOOLS
     delete a_node;
 #else // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
+    m_freeNodes.push_back(a_node);
 #endif // RTREE_DONT_USE_MEMPOOLS
 }
 
@@ -906,7 +936,8 @@ typename RTREE_QUAL::ListNode* RTREE_QUAL::AllocListNode()
 #ifdef RTREE_DONT_USE_MEMPOOLS
     return new ListNode;
 #else // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
+    // list nodes are rare (only when a removal underfills a node)
+    return new ListNode;
 #endif // RTREE_DONT_USE_MEMPOOLS
 }
 
@@ -917,7 +948,7 @@ void RTREE_QUAL::FreeListNode(ListNode* a_listNode)
 #ifdef RTREE_DONT_USE_MEMPOOLS
     delete a_listNode;
 #else // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
+    delete a_listNode;
 #endif // RTREE_DONT_USE_MEMPOOLS
 }
 
@@ -2,11 +2,17 @@
 #include "rtree.h"
 #include <cmath>
 #include <climits>
+#include <cstdint>
+#include <cstring>
 #include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <unordered_map>
 #include <iterator>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 #define marker_is_set(INDEX, BITS) ((markers[INDEX] & BITS) != 0)
 #define marker_not_set(INDEX, BITS) ((markers[INDEX] & BITS) == 0)
@@ -21,6 +27,7 @@ namespace weemesh
     // MESHING SDK
 
     using UID = std::uint32_t;
+    constexpr UID INVALID_UID = ~UID(0);
 
     constexpr double DEFAULT_EPSILON = 0.00015;
     constexpr double INVERSE_EPSILON = 6666;
@@ -133,13 +140,110 @@ namespace weemesh
             equivalent(a.y, b.y, epsilon);
     }
 
-    // uniquely map vertices to indices
-#if 0
-    using vert_table_compare_t = std::function<bool(const vert_t&, const vert_t&)>;
-    using vert_table_t = std::map<vert_t, int, vert_table_compare_t>;
-#else
-    using vert_table_t = std::map<vert_t, int>;
-#endif
+    // uniquely map vertices to indices, by exact XY location.
+    // Open addressing in one flat array, so adding a vertex does not
+    // allocate, and clear() keeps the capacity for the next mesh.
+    class vert_table_t
+    {
+    public:
+        // index of the vertex at the XY location of v, or -1
+        int find(const vert_t& v) const
+        {
+            if (_size == 0)
+                return -1;
+
+            for (std::size_t i = slot_of(v); ; i = (i + 1) & _mask)
+            {
+                const entry_t& e = _entries[i];
+                if (e.index < 0)
+                    return -1;
+                if (e.x == v.x && e.y == v.y)
+                    return e.index;
+            }
+        }
+
+        // add a vertex that is not already in the table
+        void insert(const vert_t& v, int index)
+        {
+            if ((_size + 1) * 2 > _entries.size())
+                rehash(std::max((std::size_t)64, _entries.size() * 2));
+
+            std::size_t i = slot_of(v);
+            while (_entries[i].index >= 0)
+                i = (i + 1) & _mask;
+
+            _entries[i] = { v.x, v.y, index };
+            ++_size;
+        }
+
+        void reserve(std::size_t count)
+        {
+            std::size_t capacity = 64;
+            while (capacity < count * 2)
+                capacity *= 2;
+            if (capacity > _entries.size())
+                rehash(capacity);
+        }
+
+        void clear()
+        {
+            if (_size > 0)
+            {
+                for (auto& e : _entries)
+                    e.index = -1;
+                _size = 0;
+            }
+        }
+
+        std::size_t size() const
+        {
+            return _size;
+        }
+
+        // remove all vertices and free the storage
+        void release()
+        {
+            std::vector<entry_t>().swap(_entries);
+            _mask = 0;
+            _size = 0;
+        }
+
+    private:
+        struct entry_t
+        {
+            vert_t::value_type x, y;
+            int index;
+        };
+        std::vector<entry_t> _entries;
+        std::size_t _mask = 0;
+        std::size_t _size = 0;
+
+        std::size_t slot_of(const vert_t& v) const
+        {
+            // adding 0.0 folds -0.0 into 0.0, which compare equal
+            vert_t::value_type x = v.x + 0.0, y = v.y + 0.0;
+            std::uint64_t a, b;
+            std::memcpy(&a, &x, sizeof(a));
+            std::memcpy(&b, &y, sizeof(b));
+            std::uint64_t h = a ^ (b * 0x9e3779b97f4a7c15ull);
+            h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return (std::size_t)h & _mask;
+        }
+
+        void rehash(std::size_t capacity)
+        {
+            std::vector<entry_t> old;
+            old.swap(_entries);
+            _entries.assign(capacity, { 0.0, 0.0, -1 });
+            _mask = capacity - 1;
+            _size = 0;
+            for (auto& e : old)
+                if (e.index >= 0)
+                    insert(vert_t(e.x, e.y, 0.0), e.index);
+        }
+    };
 
     // array of vert_t's
     using vert_array_t = std::vector<vert_t>;
@@ -243,6 +347,136 @@ namespace weemesh
         }
     };
 
+    // Triangles by UID. UIDs are handed out sequentially, so instead of one
+    // heap node per triangle the table stores them in fixed-size blocks
+    // indexed by UID; a removed triangle leaves a hole. References stay
+    // valid as triangles are added, and clear() keeps the blocks for the
+    // next mesh. Iterates like the std::unordered_map<UID, triangle_t> it
+    // replaces (in UID order).
+    class triangle_table_t
+    {
+    public:
+        using value_type = std::pair<const UID, triangle_t>;
+        static_assert(std::is_trivially_destructible<value_type>::value, "triangle_t must be trivially destructible");
+
+        template<class V, class TABLE>
+        class iterator_t
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = V;
+            using difference_type = std::ptrdiff_t;
+            using pointer = V*;
+            using reference = V&;
+
+            iterator_t(TABLE* table, UID uid) : _table(table), _uid(uid) { }
+            V& operator*() const { return *_table->slot(_uid); }
+            V* operator->() const { return _table->slot(_uid); }
+            iterator_t& operator++() { _uid = _table->next(_uid + 1); return *this; }
+            bool operator == (const iterator_t& rhs) const { return _uid == rhs._uid; }
+            bool operator != (const iterator_t& rhs) const { return _uid != rhs._uid; }
+
+        private:
+            TABLE* _table;
+            UID _uid;
+        };
+
+        using iterator = iterator_t<value_type, triangle_table_t>;
+        using const_iterator = iterator_t<const value_type, const triangle_table_t>;
+
+        triangle_table_t() = default;
+
+        triangle_table_t(const triangle_table_t& rhs)
+        {
+            for (auto& i : rhs)
+                emplace(i.first, i.second);
+        }
+
+        triangle_table_t& operator = (const triangle_table_t& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                for (auto& i : rhs)
+                    emplace(i.first, i.second);
+            }
+            return *this;
+        }
+
+        // add a triangle under a UID that is not in use
+        void emplace(UID uid, const triangle_t& tri)
+        {
+            while ((std::size_t)uid >= _blocks.size() * BLOCK_SIZE)
+                _blocks.emplace_back(new slot_t[BLOCK_SIZE]);
+            if ((std::size_t)uid >= _live.size())
+                _live.resize((std::size_t)uid + 1, 0);
+
+            new (_blocks[uid / BLOCK_SIZE][uid % BLOCK_SIZE].bytes) value_type(uid, tri);
+            _live[uid] = 1;
+            ++_size;
+        }
+
+        // the triangle with a UID that is in use
+        triangle_t& operator[](UID uid) { return slot(uid)->second; }
+        const triangle_t& operator[](UID uid) const { return slot(uid)->second; }
+
+        std::size_t count(UID uid) const
+        {
+            return (std::size_t)uid < _live.size() && _live[uid] ? 1 : 0;
+        }
+
+        std::size_t erase(UID uid)
+        {
+            if (count(uid) == 0)
+                return 0;
+            _live[uid] = 0;
+            --_size;
+            return 1;
+        }
+
+        // remove all triangles, keeping the storage
+        void clear()
+        {
+            _live.clear();
+            _size = 0;
+        }
+
+        // remove all triangles and free the storage
+        void release()
+        {
+            decltype(_blocks)().swap(_blocks);
+            decltype(_live)().swap(_live);
+            _size = 0;
+        }
+
+        std::size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        iterator begin() { return iterator(this, next(0)); }
+        iterator end() { return iterator(this, (UID)_live.size()); }
+        const_iterator begin() const { return const_iterator(this, next(0)); }
+        const_iterator end() const { return const_iterator(this, (UID)_live.size()); }
+
+    private:
+        static constexpr unsigned BLOCK_SIZE = 1024;
+        struct slot_t { alignas(value_type) unsigned char bytes[sizeof(value_type)]; };
+        std::vector<std::unique_ptr<slot_t[]>> _blocks;
+        std::vector<std::uint8_t> _live;
+        std::size_t _size = 0;
+
+        value_type* slot(UID uid) {
+            return std::launder(reinterpret_cast<value_type*>(_blocks[uid / BLOCK_SIZE][uid % BLOCK_SIZE].bytes));
+        }
+        const value_type* slot(UID uid) const {
+            return std::launder(reinterpret_cast<const value_type*>(_blocks[uid / BLOCK_SIZE][uid % BLOCK_SIZE].bytes));
+        }
+        UID next(UID uid) const {
+            while ((std::size_t)uid < _live.size() && !_live[uid])
+                ++uid;
+            return uid;
+        }
+    };
+
     using spatial_index_t = RTree<UID, vert_t::value_type, 2>;
 
 #if 0 // for testing
@@ -294,7 +528,7 @@ namespace weemesh
         // a commutative way, i.e., such that if _i0 and _i1 are 
         // interchanged, they will return the same hash code.
         std::size_t operator()(const edge_t& edge) const {
-            return hash_value_unsigned(_i0 + _i1);
+            return hash_value_unsigned(edge._i0 + edge._i1);
         }
     };
 
@@ -302,12 +536,16 @@ namespace weemesh
     struct mesh_t
     {
         int uidgen = 0;
-        std::unordered_map<UID, triangle_t> triangles;
+        triangle_table_t triangles;
         vert_array_t verts;
         std::vector<int> markers;
 
         spatial_index_t _spatial_index;
         vert_table_t _vert_lut;
+
+        // scratch lists for insert(), reused from call to call
+        std::vector<UID> _found;
+        std::vector<UID> _work;
         vert_t::value_type _epsilon = DEFAULT_EPSILON;
         int _num_edits = 0;
         int _boundary_marker = 1;
@@ -327,6 +565,34 @@ namespace weemesh
         }
 #endif
 
+        // Empty the mesh so it can be reused. Keeps all allocated storage,
+        // so a mesh object reused across tiles stops allocating once it
+        // has seen the largest one.
+        void clear()
+        {
+            uidgen = 0;
+            triangles.clear();
+            verts.clear();
+            markers.clear();
+            _spatial_index.RemoveAll();
+            _vert_lut.clear();
+            _num_edits = 0;
+        }
+
+        // Empty the mesh and free its storage, including the spatial
+        // index nodes kept for reuse.
+        void release()
+        {
+            clear();
+            triangles.release();
+            vert_array_t().swap(verts);
+            std::vector<int>().swap(markers);
+            _spatial_index.ReleaseFreeNodes();
+            _vert_lut.release();
+            std::vector<UID>().swap(_found);
+            std::vector<UID>().swap(_work);
+        }
+
         void set_boundary_marker(int value)
         {
             _boundary_marker = value;
@@ -359,7 +625,7 @@ namespace weemesh
         UID add_triangle(int i0, int i1, int i2)
         {
             if (i0 == i1 || i1 == i2 || i2 == i0)
-                return -1;
+                return INVALID_UID;
 
             UID uid(uidgen++);
             triangle_t tri;
@@ -431,7 +697,7 @@ namespace weemesh
         // find the marker for a vertex
         int& get_marker(const vert_t& vert)
         {
-            return markers[_vert_lut[vert]];
+            return markers[_vert_lut.find(vert)];
         }
 
         // find the marker for a vertex index
@@ -444,19 +710,17 @@ namespace weemesh
         // If the vertex already exists, update its marker if necessary.
         int get_or_create_vertex(const vert_t& input, int marker)
         {
-            int index;
-            vert_table_t::iterator i = _vert_lut.find(input);
-            if (i != _vert_lut.end())
+            int index = _vert_lut.find(input);
+            if (index >= 0)
             {
-                index = i->second;
-                markers[i->second] |= marker;
+                markers[index] |= marker;
             }
-            else if (verts.size() + 1 < 0xFFFFFFFF)
+            else if (verts.size() + 1 < 0x7FFFFFFF)
             {
                 verts.push_back(input);
                 markers.push_back(marker);
-                _vert_lut[input] = verts.size() - 1;
                 index = verts.size() - 1;
+                _vert_lut.insert(input, index);
             }
             else
             {
@@ -490,21 +754,24 @@ namespace weemesh
         void insert(const vert_t& vert, int marker)
         {
             // does it already exist?
-            if (_vert_lut.count(vert) > 0)
+            if (_vert_lut.find(vert) >= 0)
                 return;
 
             // search for possible intersecting triangles
             vert_t::value_type a_min_max[2] = { vert.x, vert.y };
-            std::vector<UID> uids;
+            _found.clear();
 
             _spatial_index.Search(a_min_max, a_min_max, [&](const UID& uid)
                 {
-                    uids.push_back(uid);
+                    _found.push_back(uid);
                     return RTREE_KEEP_SEARCHING;
                 });
 
-            for (auto uid : uids)
+            for (auto uid : _found)
             {
+                if (triangles.count(uid) == 0)
+                    continue;
+
                 triangle_t& tri = triangles[uid];
 
                 if (tri.is_2d_degenerate)
@@ -533,11 +800,13 @@ namespace weemesh
             vert_t::value_type a_min[2] = { std::min(seg.first.x, seg.second.x), std::min(seg.first.y, seg.second.y) };
             vert_t::value_type a_max[2] = { std::max(seg.first.x, seg.second.x), std::max(seg.first.y, seg.second.y) };
 
-            std::queue<UID> uid_list;
+            // work list of triangles to check, consumed front to back
+            std::vector<UID>& uid_list = _work;
+            uid_list.clear();
 
             _spatial_index.Search(a_min, a_max, [&](const UID& uid)
                 {
-                    uid_list.emplace(uid);
+                    uid_list.emplace_back(uid);
                     return RTREE_KEEP_SEARCHING;
                 });
 
@@ -548,10 +817,12 @@ namespace weemesh
             // splits will just happen on the new triangles later. (That's why
             // every split operation is followed by a "continue" to short-circuit
             // to loop)
-            while(!uid_list.empty())
+            for (std::size_t next = 0; next < uid_list.size(); ++next)
             {
-                auto uid = uid_list.front();
-                uid_list.pop();
+                auto uid = uid_list[next];
+
+                if (triangles.count(uid) == 0)
+                    continue;
 
                 triangle_t& tri = triangles[uid];
 
@@ -617,21 +888,21 @@ namespace weemesh
                     int new_tris = 0;
 
                     new_uid = add_triangle(new_i, tri.i2, tri.i0);
-                    if (new_uid >= 0) {
+                    if (new_uid != INVALID_UID) {
                         markers[tri.i2] |= _constraint_marker;
                         markers[tri.i0] |= _constraint_marker;
                         if (!triangles[new_uid].is_2d_degenerate) {
-                            uid_list.emplace(new_uid);
+                            uid_list.emplace_back(new_uid);
                             ++new_tris;
                         }
                     }
 
                     new_uid = add_triangle(new_i, tri.i1, tri.i2);
-                    if (new_uid >= 0) {
+                    if (new_uid != INVALID_UID) {
                         markers[tri.i1] |= _constraint_marker;
                         markers[tri.i2] |= _constraint_marker;
                         if (!triangles[new_uid].is_2d_degenerate) {
-                            uid_list.emplace(new_uid);
+                            uid_list.emplace_back(new_uid);
                             ++new_tris;
                         }
                     }
@@ -667,21 +938,21 @@ namespace weemesh
                     int new_tris = 0;
 
                     new_uid = add_triangle(new_i, tri.i0, tri.i1);
-                    if (new_uid >= 0) {
+                    if (new_uid != INVALID_UID) {
                         markers[tri.i0] |= _constraint_marker;
                         markers[tri.i1] |= _constraint_marker;
                         if (!triangles[new_uid].is_2d_degenerate) {
-                            uid_list.emplace(new_uid);
+                            uid_list.emplace_back(new_uid);
                             ++new_tris;
                         }
                     }
 
                     new_uid = add_triangle(new_i, tri.i2, tri.i0);
-                    if (new_uid >= 0) {
+                    if (new_uid != INVALID_UID) {
                         markers[tri.i2] |= _constraint_marker;
                         markers[tri.i0] |= _constraint_marker;
                         if (!triangles[new_uid].is_2d_degenerate) {
-                            uid_list.emplace(new_uid);
+                            uid_list.emplace_back(new_uid);
                             ++new_tris;
                         }
                     }
@@ -717,21 +988,21 @@ namespace weemesh
                     int new_tris = 0;
 
                     new_uid = add_triangle(new_i, tri.i1, tri.i2);
-                    if (new_uid >= 0) {
+                    if (new_uid != INVALID_UID) {
                         markers[tri.i1] |= _constraint_marker;
                         markers[tri.i2] |= _constraint_marker;
                         if (!triangles[new_uid].is_2d_degenerate) {
-                            uid_list.emplace(new_uid);
+                            uid_list.emplace_back(new_uid);
                             ++new_tris;
                         }
                     }
 
                     new_uid = add_triangle(new_i, tri.i0, tri.i1);
-                    if (new_uid >= 0) {
+                    if (new_uid != INVALID_UID) {
                         markers[tri.i0] |= _constraint_marker;
                         markers[tri.i1] |= _constraint_marker;
                         if (!triangles[new_uid].is_2d_degenerate) {
-                            uid_list.emplace(new_uid);
+                            uid_list.emplace_back(new_uid);
                             ++new_tris;
                         }
                     }
@@ -757,7 +1028,7 @@ namespace weemesh
         // inserts point "p" into the interior of triangle "tri",
         // adds three new triangles, and removes the original triangle.
         // return true if a split actual happened
-        bool inside_split(triangle_t& tri, const vert_t& p, std::queue<UID>* uid_list, int new_marker)
+        bool inside_split(triangle_t& tri, const vert_t& p, std::vector<UID>* uid_list, int new_marker)
         {
             int new_i = get_or_create_vertex(p, new_marker);
             if (new_i < 0)
@@ -787,39 +1058,39 @@ namespace weemesh
 
             if (!equivalent(bary[2], 0.0, bary_epsilon)) {
                 new_uid = add_triangle(tri.i0, tri.i1, new_i);
-                if (new_uid > 0) {
+                if (new_uid != INVALID_UID) {
                     markers[tri.i0] |= _constraint_marker;
                     markers[tri.i1] |= _constraint_marker;
                     if (!triangles[new_uid].is_2d_degenerate) {
                         ++new_tris;
                         if (uid_list)
-                            uid_list->emplace(new_uid);
+                            uid_list->emplace_back(new_uid);
                     }
                 }
             }
 
             if (!equivalent(bary[0], 0.0, bary_epsilon)) {
                 new_uid = add_triangle(tri.i1, tri.i2, new_i);
-                if (new_uid >= 0) {
+                if (new_uid != INVALID_UID) {
                     markers[tri.i1] |= _constraint_marker;
                     markers[tri.i2] |= _constraint_marker;
                     if (!triangles[new_uid].is_2d_degenerate) {
                         ++new_tris;
                         if (uid_list)
-                            uid_list->emplace(new_uid);
+                            uid_list->emplace_back(new_uid);
                     }
                 }
             }
 
             if (!equivalent(bary[1], 0.0, bary_epsilon)) {
                 new_uid = add_triangle(tri.i2, tri.i0, new_i);
-                if (new_uid >= 0) {
+                if (new_uid != INVALID_UID) {
                     markers[tri.i2] |= _constraint_marker;
                     markers[tri.i0] |= _constraint_marker;
                     if (!triangles[new_uid].is_2d_degenerate) {
                         ++new_tris;
                         if (uid_list)
-                            uid_list->emplace(new_uid);
+                            uid_list->emplace_back(new_uid);
                     }
                 }
             }
@@ -10,18 +10,79 @@
 
 #include <basisu/transcoder/basisu_transcoder.h>
 
+#include <cstring>
+#include <iterator>
+
 using namespace basisu;
 
+// basisu 1.16 removed the ETC1S global selector codebook
+#if defined(BASISD_LIB_VERSION) && BASISD_LIB_VERSION >= 116
+#define BASIS_NO_CODEBOOK
+#endif
+
+namespace
+{
+    // Transcodes to BC1, or to BC3 when the image has alpha, and lays out the
+    // mipmap levels one after another.
+    struct Output
+    {
+        basist::transcoder_texture_format format = basist::transcoder_texture_format::cTFBC1;
+        GLenum glFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        std::vector<unsigned int> levelOffsets;
+        unsigned int totalSize = 0;
+
+        Output(bool alpha)
+        {
+            /*
+                basist::transcoder_texture_format transcoder_texture_format = basist::transcoder_texture_format::cTFETC1;
+                GLenum internalTextureFormat = GL_COMPRESSED_RGB8_ETC2;
+                GLenum pixelFormat = GL_COMPRESSED_RGB8_ETC2;
+                */
+
+            // If the image has alpha then switch to dxt5 to get a format that supports alpha.
+            if (alpha)
+            {
+                format = basist::transcoder_texture_format::cTFBC3;
+                glFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            }
+        }
+
+        unsigned int addLevel(unsigned int totalBlocks)
+        {
+            unsigned int offset = totalSize;
+            levelOffsets.push_back(offset);
+            totalSize += basist::basis_get_bytes_per_block(format) * totalBlocks;
+            return offset;
+        }
+
+        osg::Image* createImage(unsigned int width, unsigned int height, unsigned char* data) const
+        {
+            osg::Image* image = new osg::Image;
+            image->setImage(width, height, 1, glFormat, glFormat, GL_UNSIGNED_BYTE, data, osg::Image::USE_NEW_DELETE);
+            if (levelOffsets.size() > 1)
+            {
+                // offsets of the levels after the first
+                image->setMipmapLevels(osg::Image::MipmapDataType(levelOffsets.begin() + 1, levelOffsets.end()));
+            }
+            image->flipVertical();
+            return image;
+        }
+    };
+}
+
 class ReaderWriterBasis : public osgDB::ReaderWriter
 {
 public:
     ReaderWriterBasis()
     {
         supportsExtension("basis", "Basis image format");
+        supportsExtension("ktx2", "KTX2 image format (Basis Universal)");
 
         // one-time initialization at startup
         basist::basisu_transcoder_init();
+#ifndef BASIS_NO_CODEBOOK
         sel_codebook = basist::etc1_global_selector_codebook(basist::g_global_selector_cb_size, basist::g_global_selector_cb);
+#endif
     }
 
     virtual const char* className() const { return "Basis Universal Image Reader/Writer"; }
@@ -38,21 +99,24 @@ public:
 
     virtual ReadResult readImage(std::istream& fin, const osgDB::ReaderWriter::Options* = NULL) const
     {
-        // get length of file:
-        fin.seekg(0, fin.end);
-        int length = fin.tellg();
-        fin.seekg(0, fin.beg);
-        char* data = new char[length];
-        fin.read(data, length);
+        std::string buffer((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+        const char* data = buffer.data();
+        unsigned int length = (unsigned int)buffer.size();
 
-        basist::basisu_transcoder transcoder(&sel_codebook);
+        static const unsigned char ktx2Magic[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        if (length >= 12 && ::memcmp(data, ktx2Magic, 12) == 0)
+        {
+            return readKTX2(data, length);
+        }
 
-        unsigned int numImages = transcoder.get_total_images(data, length);
+#ifdef BASIS_NO_CODEBOOK
+        basist::basisu_transcoder transcoder;
+#else
+        basist::basisu_transcoder transcoder(&sel_codebook);
+#endif
 
         // TODO:  Pass in an option or automatically determine the desired output format
 
-
-
         basist::basisu_image_info image_info;
         unsigned int imageIndex = 0;
         if (transcoder.get_image_info(data, length, image_info, imageIndex))
@@ -60,77 +124,34 @@ public:
             OSG_INFO << "Got image info " << std::endl
                 << "Dimensions " << image_info.m_width << "x" << image_info.m_height << std::endl
                 << "Total levels " << image_info.m_total_levels << std::endl
-                << "Alpha " << image_info.m_alpha_flag << std::endl
-                << "Total levels " << image_info.m_total_levels << std::endl;
+                << "Alpha " << image_info.m_alpha_flag << std::endl;
 
             transcoder.start_transcoding(data, length);
 
-            /*
-                basist::transcoder_texture_format transcoder_texture_format = basist::transcoder_texture_format::cTFETC1;
-                GLenum internalTextureFormat = GL_COMPRESSED_RGB8_ETC2;
-                GLenum pixelFormat = GL_COMPRESSED_RGB8_ETC2;
-                */
-
-            basist::transcoder_texture_format transcoder_texture_format = basist::transcoder_texture_format::cTFBC1;
-            GLenum internalTextureFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
-            GLenum pixelFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
-
-            // If the image has alpha then switch to dxt5 to get a format that supports alpha.
-            if (image_info.m_alpha_flag)
-            {
-                transcoder_texture_format = basist::transcoder_texture_format::cTFBC3;
-                internalTextureFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
-                pixelFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
-            }
-
-            unsigned int totalSize = 0;
-
-            std::vector< unsigned int > mipmapDataOffsets;
-            mipmapDataOffsets.reserve(image_info.m_total_levels - 1);
+            Output output(image_info.m_alpha_flag);
 
             // Compute the total size of the output buffer
             for (unsigned int levelIndex = 0; levelIndex < image_info.m_total_levels; levelIndex++)
             {
-                if (levelIndex > 0)
-                {
-                    mipmapDataOffsets.push_back(totalSize);
-                }
-
                 basist::basisu_image_level_info level_info;
-                transcoder.get_image_level_info(data, length, level_info, 0, levelIndex);
-
-                unsigned int bytesPerBlock = basist::basis_get_bytes_per_block(transcoder_texture_format);
-                unsigned int levelSize = bytesPerBlock * level_info.m_total_blocks;
-                totalSize += levelSize;
+                transcoder.get_image_level_info(data, length, level_info, imageIndex, levelIndex);
+                output.addLevel(level_info.m_total_blocks);
             }
 
             // Allocate memory for the total image including mipmaps
-            unsigned char* decoded = new unsigned char[totalSize];
-            memset(decoded, 0, totalSize);
+            unsigned char* decoded = new unsigned char[output.totalSize];
+            memset(decoded, 0, output.totalSize);
 
             for (unsigned int levelIndex = 0; levelIndex < image_info.m_total_levels; levelIndex++)
             {
                 basist::basisu_image_level_info level_info;
-                transcoder.get_image_level_info(data, length, level_info, 0, levelIndex);
+                transcoder.get_image_level_info(data, length, level_info, imageIndex, levelIndex);
 
-                unsigned int offset = 0;
-                if (levelIndex > 0)
-                {
-                    offset = mipmapDataOffsets[levelIndex - 1];
-                }
-
-                transcoder.transcode_image_level(data, length, imageIndex, levelIndex, &decoded[offset], level_info.m_total_blocks, transcoder_texture_format, 0);
+                transcoder.transcode_image_level(data, length, imageIndex, levelIndex,
+                    &decoded[output.levelOffsets[levelIndex]], level_info.m_total_blocks, output.format, 0);
             }
 
-            osg::Image* image = new osg::Image;
-            image->setImage(image_info.m_width, image_info.m_height, 1, internalTextureFormat, pixelFormat, GL_UNSIGNED_BYTE, decoded, osg::Image::USE_NEW_DELETE);
-            if (!mipmapDataOffsets.empty())
-            {
-                image->setMipmapLevels(mipmapDataOffsets);
-            }
-
-            image->flipVertical();
-            return image;
+            return output.createImage(image_info.m_width, image_info.m_height, decoded);
         }
 
         return ReadResult::ERROR_IN_READING_FILE;
@@ -151,7 +172,55 @@ public:
     }
 
 private:
+#ifndef BASIS_NO_CODEBOOK
     basist::etc1_global_selector_codebook sel_codebook;
+#endif
+
+    //! KTX2 container with ETC1S or UASTC payload, as used by glTF's KHR_texture_basisu
+    ReadResult readKTX2(const char* data, unsigned int length) const
+    {
+#if BASISD_SUPPORT_KTX2
+#ifdef BASIS_NO_CODEBOOK
+        basist::ktx2_transcoder transcoder;
+#else
+        basist::ktx2_transcoder transcoder(const_cast<basist::etc1_global_selector_codebook*>(&sel_codebook));
+#endif
+        if (!transcoder.init(data, length) || !transcoder.start_transcoding())
+        {
+            return ReadResult::ERROR_IN_READING_FILE;
+        }
+
+        Output output(transcoder.get_has_alpha());
+
+        for (unsigned int levelIndex = 0; levelIndex < transcoder.get_levels(); levelIndex++)
+        {
+            basist::ktx2_image_level_info level_info;
+            if (!transcoder.get_image_level_info(level_info, levelIndex, 0, 0))
+                return ReadResult::ERROR_IN_READING_FILE;
+            output.addLevel(level_info.m_total_blocks);
+        }
+
+        unsigned char* decoded = new unsigned char[output.totalSize];
+        memset(decoded, 0, output.totalSize);
+
+        for (unsigned int levelIndex = 0; levelIndex < transcoder.get_levels(); levelIndex++)
+        {
+            basist::ktx2_image_level_info level_info;
+            transcoder.get_image_level_info(level_info, levelIndex, 0, 0);
+            if (!transcoder.transcode_image_level(levelIndex, 0, 0,
+                &decoded[output.levelOffsets[levelIndex]], level_info.m_total_blocks, output.format))
+            {
+                delete[] decoded;
+                return ReadResult::ERROR_IN_READING_FILE;
+            }
+        }
+
+        return output.createImage(transcoder.get_width(), transcoder.get_height(), decoded);
+#else
+        OSG_WARN << "[basis] This build of basisu does not support KTX2" << std::endl;
+        return ReadResult::FILE_NOT_HANDLED;
+#endif
+    }
 };
 
-REGISTER_OSGPLUGIN(basis, ReaderWriterBasis)
\ No newline at end of file
+REGISTER_OSGPLUGIN(basis, ReaderWriterBasis)
@@ -17,6 +17,8 @@
 #include <osgDB/FileNameUtils>
 #include <osgDB/WriteFile>
 #include <fstream>
+#include <functional>
+#include <thread>
 #include <sys/stat.h>
 
 using namespace osgEarth;
@@ -104,7 +106,27 @@ namespace
 
         bool clear() override;
 
+        std::vector<ReadResult> readMany(const std::vector<std::string>& keys, const osgDB::Options* dbo) override;
+
+        std::vector<ReadResult> readManyImages(const std::vector<std::string>& keys, const osgDB::Options* dbo) override;
+
+        unsigned writeMany(const std::vector<Record>& records, const osgDB::Options* dbo) override;
+
+        std::vector<RecordStatus> statusMany(const std::vector<std::string>& keys) override;
+
     protected:
+        // runs func(0..count-1) on the bulk I/O pool and waits for them all
+        void inParallel(unsigned count, const std::function<void(unsigned)>& func);
+
+        // untimed implementations of readObject, readImage and write
+        ReadResult readObjectFile(const std::string& key, const osgDB::Options* dbo);
+
+        ReadResult readImageFile(const std::string& key, const osgDB::Options* dbo);
+
+        bool writeFile(const std::string& key, const osg::Object* object, const Config& meta, const osgDB::Options* dbo);
+
+        static BinMetrics& metrics();
+
         bool purgeDirectory( const std::string& dir );
 
         bool binValidForReading(bool silent =true);
@@ -202,6 +224,10 @@ namespace
 
         // create a thread pool dedicated to asynchronous cache writes
         setNumThreads(_options.threads().get());
+
+        // ...and one for the bulk reads and writes, which are I/O bound
+        jobs::get_pool("oe.fscache.bulk")->set_concurrency(
+            osg::clampBetween(std::thread::hardware_concurrency(), 2u, 8u));
     }
 
     void
@@ -366,8 +392,21 @@ namespace
         }
     }
 
+    CacheBin::BinMetrics&
+    FileSystemCacheBin::metrics()
+    {
+        static BinMetrics s_metrics("filesystem");
+        return s_metrics;
+    }
+
     ReadResult
     FileSystemCacheBin::readImage(const std::string& key, const osgDB::Options* readOptions)
+    {
+        return metrics().read([&]() { return readImageFile(key, readOptions); });
+    }
+
+    ReadResult
+    FileSystemCacheBin::readImageFile(const std::string& key, const osgDB::Options* readOptions)
     {
         if ( !binValidForReading() )
             return ReadResult(ReadResult::RESULT_NOT_FOUND);
@@ -453,6 +492,12 @@ namespace
     
     ReadResult
     FileSystemCacheBin::readObject(const std::string& key, const osgDB::Options* readOptions)
+    {
+        return metrics().read([&]() { return readObjectFile(key, readOptions); });
+    }
+
+    ReadResult
+    FileSystemCacheBin::readObjectFile(const std::string& key, const osgDB::Options* readOptions)
     {
         OE_PROFILING_ZONE;
 
@@ -550,6 +595,16 @@ namespace
 
     bool
     FileSystemCacheBin::write(
+        const std::string& key,
+        const osg::Object* object,
+        const Config& meta,
+        const osgDB::Options* writeOptions)
+    {
+        return metrics().write([&]() { return writeFile(key, object, meta, writeOptions); });
+    }
+
+    bool
+    FileSystemCacheBin::writeFile(
         const std::string& key,
         const osg::Object* raw_object,
         const Config& meta,
@@ -710,6 +765,67 @@ namespace
         return osgEarth::touchFile( path );
     }
 
+    void
+    FileSystemCacheBin::inParallel(unsigned count, const std::function<void(unsigned)>& func)
+    {
+        if (count < 2)
+        {
+            for (unsigned i = 0; i < count; ++i)
+                func(i);
+            return;
+        }
+
+        jobs::context job;
+        job.name = "oe.fscache.bulk";
+        job.pool = jobs::get_pool(job.name);
+        job.group = jobs::jobgroup::create();
+
+        for (unsigned i = 0; i < count; ++i)
+            jobs::dispatch([&func, i]() { func(i); }, job);
+
+        job.group->join();
+    }
+
+    std::vector<ReadResult>
+    FileSystemCacheBin::readMany(const std::vector<std::string>& keys, const osgDB::Options* readOptions)
+    {
+        std::vector<ReadResult> results(keys.size());
+        inParallel(keys.size(), [&](unsigned i) { results[i] = readObject(keys[i], readOptions); });
+        return results;
+    }
+
+    std::vector<ReadResult>
+    FileSystemCacheBin::readManyImages(const std::vector<std::string>& keys, const osgDB::Options* readOptions)
+    {
+        std::vector<ReadResult> results(keys.size());
+        inParallel(keys.size(), [&](unsigned i) { results[i] = readImage(keys[i], readOptions); });
+        return results;
+    }
+
+    unsigned
+    FileSystemCacheBin::writeMany(const std::vector<Record>& records, const osgDB::Options* writeOptions)
+    {
+        // asynchronous writes are already queued in parallel
+        if (_pool)
+            return CacheBin::writeMany(records, writeOptions);
+
+        std::atomic_uint count(0u);
+        inParallel(records.size(), [&](unsigned i)
+            {
+                if (write(records[i].key, records[i].object.get(), records[i].metadata, writeOptions))
+                    ++count;
+            });
+        return count;
+    }
+
+    std::vector<CacheBin::RecordStatus>
+    FileSystemCacheBin::statusMany(const std::vector<std::string>& keys)
+    {
+        std::vector<RecordStatus> results(keys.size(), STATUS_NOT_FOUND);
+        inParallel(keys.size(), [&](unsigned i) { results[i] = getRecordStatus(keys[i]); });
+        return results;
+    }
+
     bool
     FileSystemCacheBin::purgeDirectory( const std::string& dir )
     {
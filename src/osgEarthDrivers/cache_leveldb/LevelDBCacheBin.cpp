@@ -18,6 +18,12 @@ using namespace osgEarth::Drivers::LevelDBCache;
 
 namespace
 {
+    CacheBin::BinMetrics& metrics()
+    {
+        static CacheBin::BinMetrics s_metrics("leveldb");
+        return s_metrics;
+    }
+
     void encodeMeta(const Config& meta, std::string& out)
     {
         out = Stringify() << meta.toJSON(false);
@@ -215,20 +221,20 @@ LevelDBCacheBin::timeEndGlobal() const
 ReadResult
 LevelDBCacheBin::readImage(const std::string& key, const osgDB::Options* readOptions)
 {
-    return read(key, ImageReader(_rw.get(), readOptions));
+    return metrics().read([&]() { return read(key, ImageReader(_rw.get(), readOptions)); });
 }
 
 ReadResult
 LevelDBCacheBin::readObject(const std::string& key, const osgDB::Options* readOptions)
 {
     //OE_INFO << LC << "Read attempt: " << key << " from " << getID() << std::endl;
-    return read(key, ObjectReader(_rw.get(), readOptions));
+    return metrics().read([&]() { return read(key, ObjectReader(_rw.get(), readOptions)); });
 }
 
 ReadResult
 LevelDBCacheBin::readNode(const std::string& key, const osgDB::Options* readOptions)
 {
-    return read(key, NodeReader(_rw.get(), readOptions));
+    return metrics().read([&]() { return read(key, NodeReader(_rw.get(), readOptions)); });
 }
 
 ReadResult
@@ -319,15 +325,9 @@ LevelDBCacheBin::readString(const std::string& key, const osgDB::Options* readOp
 }
 
 bool
-LevelDBCacheBin::write(const std::string& key, const osg::Object* object, const Config& meta, const osgDB::Options* writeOptions)
+LevelDBCacheBin::serialize(const osg::Object* object, const osgDB::Options* writeOptions, std::string& out, std::string& message)
 {
-    if ( !binValidForWriting() || !object ) 
-        return false;
-        
     osgDB::ReaderWriter::WriteResult r;
-    bool objWriteOK = false;
-
-    std::string       data;
     std::stringstream datastream;
 
     if ( dynamic_cast<const osg::Image*>(object) )
@@ -338,7 +338,6 @@ LevelDBCacheBin::write(const std::string& key, const osg::Object* object, const
             return false;
         }
         r = _rw->writeImage( *static_cast<const osg::Image*>(object), datastream, writeOptions );
-        objWriteOK = r.success();
     }
     else if ( dynamic_cast<const osg::Node*>(object) )
     {
@@ -348,7 +347,6 @@ LevelDBCacheBin::write(const std::string& key, const osg::Object* object, const
             return false;
         }
         r = _rw->writeNode( *static_cast<const osg::Node*>(object), datastream, writeOptions );
-        objWriteOK = r.success();
     }
     else
     {
@@ -358,28 +356,55 @@ LevelDBCacheBin::write(const std::string& key, const osg::Object* object, const
             return false;
         }
         r = _rw->writeObject( *object, datastream, writeOptions );
-        objWriteOK = r.success();
     }
 
-    if (objWriteOK)
-    {
-        DateTime now;
-        leveldb::WriteBatch batch;
+    message = r.message();
+    if ( !r.success() )
+        return false;
 
-        // write the data:
-        data = datastream.str();
-        if ( _tracker->seed().isSet() )
-            blend(data, _tracker->seed().value());
-        batch.Put( dataKey(key), data );
+    out = datastream.str();
+    if ( _tracker->seed().isSet() )
+        blend(out, _tracker->seed().value());
 
-        // write the timestamp index:
-        batch.Put( timeKey(now, key), binDataKeyTuple(key) );
+    return true;
+}
 
-        // write the metadata:
-        Config metadata(meta);
-        metadata.set( TIME_FIELD, now.asCompactISO8601() );
-        encodeMeta( metadata, data );
-        batch.Put( metaKey(key), data );
+void
+LevelDBCacheBin::putRecord(leveldb::WriteBatch& batch, const std::string& key, const std::string& data,
+                           const Config& meta, const DateTime& now)
+{
+    // write the data:
+    batch.Put( dataKey(key), data );
+
+    // write the timestamp index:
+    batch.Put( timeKey(now, key), binDataKeyTuple(key) );
+
+    // write the metadata:
+    Config metadata(meta);
+    metadata.set( TIME_FIELD, now.asCompactISO8601() );
+    std::string metavalue;
+    encodeMeta( metadata, metavalue );
+    batch.Put( metaKey(key), metavalue );
+}
+
+bool
+LevelDBCacheBin::write(const std::string& key, const osg::Object* object, const Config& meta, const osgDB::Options* writeOptions)
+{
+    Util::MetricsRegistry::ScopedTimer timer(metrics().writeLatency);
+
+    if ( !binValidForWriting() || !object ) 
+    {
+        metrics().countWrite(false);
+        return false;
+    }
+
+    std::string data, message;
+    bool objWriteOK = serialize(object, writeOptions, data, message);
+
+    if (objWriteOK)
+    {
+        leveldb::WriteBatch batch;
+        putRecord( batch, key, data, meta, DateTime() );
 
         objWriteOK = _db->Write( leveldb::WriteOptions(), &batch ).ok();
 
@@ -394,17 +419,67 @@ LevelDBCacheBin::write(const std::string& key, const osg::Object* object, const
             }
         }
     }
-
         
     if ( !objWriteOK )
     {
         OE_WARN << LC << "Bin " << getID() << ": FAILED to write (" << key << "); msg = \"" 
-            << r.message() << "\"\n";
+            << message << "\"\n";
     }
 
+    metrics().countWrite(objWriteOK);
     return objWriteOK;
 }
 
+unsigned
+LevelDBCacheBin::writeMany(const std::vector<Record>& records, const osgDB::Options* writeOptions)
+{
+    if ( !binValidForWriting() || records.empty() )
+        return 0u;
+
+    // all the records go into the database in one batch.
+    DateTime now;
+    leveldb::WriteBatch batch;
+    std::vector<const std::string*> written;
+
+    for(auto& record : records)
+    {
+        std::string data, message;
+        if ( !record.object.valid() || !serialize(record.object.get(), writeOptions, data, message) )
+        {
+            OE_WARN << LC << "Bin " << getID() << ": FAILED to write (" << record.key << "); msg = \"" 
+                << message << "\"\n";
+            continue;
+        }
+
+        putRecord( batch, record.key, data, record.metadata, now );
+        written.push_back( &record.key );
+    }
+
+    if ( written.empty() )
+        return 0u;
+
+    if ( !_db->Write(leveldb::WriteOptions(), &batch).ok() )
+    {
+        OE_WARN << LC << "Bin " << getID() << ": FAILED to write " << written.size() << " records\n";
+        return 0u;
+    }
+
+    metrics().writes.add(written.size());
+
+    for(auto key : written)
+    {
+        ++_tracker->writes;
+        postWrite();
+
+        if ( _debug )
+        {
+            OE_NOTICE << LC << "Bin " << getID() << ": wrote (" << *key << ")\n";
+        }
+    }
+
+    return written.size();
+}
+
 void
 LevelDBCacheBin::postWrite()
 {
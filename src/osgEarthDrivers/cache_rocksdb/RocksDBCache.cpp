@@ -23,7 +23,7 @@
 
 #define OSGEARTH_ENV_CACHE_MAX_SIZE_MB "OSGEARTH_CACHE_MAX_SIZE_MB"
 
-#define ROCKSDB_CACHE_VERSION 1
+#define ROCKSDB_CACHE_VERSION 2
 
 using namespace osgEarth;
 using namespace osgEarth::RocksDBCache;
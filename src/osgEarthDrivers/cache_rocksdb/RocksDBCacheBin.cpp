@@ -9,6 +9,7 @@
 #include <osgDB/Registry>
 #include <rocksdb/write_batch.h>
 #include <string>
+#include <vector>
 
 using namespace osgEarth;
 using namespace osgEarth::Threading;
@@ -18,6 +19,12 @@ using namespace osgEarth::RocksDBCache;
 
 namespace
 {
+    CacheBin::BinMetrics& metrics()
+    {
+        static CacheBin::BinMetrics s_metrics("rocksdb");
+        return s_metrics;
+    }
+
     void encodeMeta(const Config& meta, std::string& out)
     {
         out = Stringify() << meta.toJSON(false);
@@ -34,6 +41,79 @@ namespace
         meta.fromJSON( bufStr );
     }
 
+    void decodeMeta(const rocksdb::Slice& in, Config& meta)
+    {
+        meta.fromJSON( in.ToString() );
+    }
+
+    // A record holds both the metadata and the data of a key so that a read
+    // is a single lookup: a magic byte, a format byte, the little-endian
+    // length of the JSON metadata, the metadata, and then the data.
+    const char        RECORD_MAGIC       = 'R';
+    const char        RECORD_FORMAT      = 1;
+    const std::size_t RECORD_HEADER_SIZE = 6;
+
+    void encodeRecord(const rocksdb::Slice& meta, const rocksdb::Slice& data, std::string& out)
+    {
+        uint32_t len = (uint32_t)meta.size();
+        out.clear();
+        out.reserve(RECORD_HEADER_SIZE + meta.size() + data.size());
+        out.push_back(RECORD_MAGIC);
+        out.push_back(RECORD_FORMAT);
+        for(unsigned i=0; i<4; ++i)
+            out.push_back((char)((len >> (8*i)) & 0xff));
+        out.append(meta.data(), meta.size());
+        out.append(data.data(), data.size());
+    }
+
+    bool decodeRecord(const rocksdb::Slice& in, rocksdb::Slice& meta, rocksdb::Slice& data)
+    {
+        if ( in.size() < RECORD_HEADER_SIZE || in[0] != RECORD_MAGIC || in[1] != RECORD_FORMAT )
+            return false;
+
+        std::size_t len = 0;
+        for(unsigned i=0; i<4; ++i)
+            len |= (std::size_t)(unsigned char)in[2+i] << (8*i);
+
+        if ( RECORD_HEADER_SIZE + len > in.size() )
+            return false;
+
+        meta = rocksdb::Slice(in.data() + RECORD_HEADER_SIZE, len);
+        data = rocksdb::Slice(in.data() + RECORD_HEADER_SIZE + len, in.size() - RECORD_HEADER_SIZE - len);
+        return true;
+    }
+
+    // Read-only stream over memory owned elsewhere (like a pinned RocksDB
+    // value) so the OSGB reader can decode it in place.
+    struct MemoryStreamBuf : public std::streambuf
+    {
+        MemoryStreamBuf(const char* data, std::size_t size)
+        {
+            char* ptr = const_cast<char*>(data);
+            setg(ptr, ptr, ptr + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+        {
+            char* base =
+                dir == std::ios_base::beg ? eback() :
+                dir == std::ios_base::cur ? gptr() :
+                egptr();
+
+            if ( (which & std::ios_base::in) == 0 || off < eback() - base || off > egptr() - base )
+                return pos_type(off_type(-1));
+
+            setg(eback(), base + off, egptr());
+            return pos_type(gptr() - eback());
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
     void blend(std::string& data, unsigned seed)
     {
         osgEarth::Random prng(seed, osgEarth::Random::METHOD_FAST);
@@ -71,7 +151,9 @@ RocksDBCacheBin::RocksDBCacheBin(const std::string& binID,
 osgEarth::CacheBin( binID ),
 _db               ( db ),
 _tracker          ( tracker ),
-_debug            ( false )
+_debug            ( false ),
+_lastTouchFlush   ( std::chrono::steady_clock::now() ),
+_hasLegacyRecords ( false )
 {
     // reader to parse data:
     _rw = osgDB::Registry::instance()->getReaderWriterForExtension( "osgb" );
@@ -79,11 +161,27 @@ _debug            ( false )
     
     if ( ::getenv("OSGEARTH_CACHE_DEBUG") )
         _debug = true;
+
+    // Look for records in the old layout once, so that a cache miss
+    // can skip looking for them when there are none.
+    if ( _db )
+    {
+        rocksdb::Iterator* i = _db->NewIterator(rocksdb::ReadOptions());
+        i->Seek( dataBegin() );
+        _hasLegacyRecords = i->Valid() && i->key().ToString() < dataEnd();
+        if ( !_hasLegacyRecords )
+        {
+            i->Seek( metaBegin() );
+            _hasLegacyRecords = i->Valid() && i->key().ToString() < metaEnd();
+        }
+        delete i;
+    }
 }
 
 RocksDBCacheBin::~RocksDBCacheBin()
 {
-    // nop
+    if ( _db )
+        flushTouches();
 }
 
 bool
@@ -111,7 +209,7 @@ RocksDBCacheBin::binValidForWriting(bool silent)
 std::string
 RocksDBCacheBin::getHashedKey(const std::string& key) const
 {
-    return dataKey(key);
+    return recordKey(key);
 }
 
 #define SEP std::string("!")
@@ -128,6 +226,54 @@ RocksDBCacheBin::binKey() const
     return "b" + SEP + getID();
 }
 
+std::string
+RocksDBCacheBin::recordKey(const std::string& key) const
+{
+    return "r" + SEP + binDataKeyTuple(key);
+}
+
+std::string
+RocksDBCacheBin::recordKeyFromTuple(const std::string& tuple) const
+{
+    return "r" + SEP + tuple;
+}
+
+std::string
+RocksDBCacheBin::recordBegin() const
+{
+    return "r" + SEP + getID() + SEP;
+}
+
+std::string
+RocksDBCacheBin::recordEnd() const
+{
+    return "r" + SEP + getID() + SEP + "\xff";
+}
+
+std::string
+RocksDBCacheBin::accessKey(const std::string& key) const
+{
+    return "a" + SEP + binDataKeyTuple(key);
+}
+
+std::string
+RocksDBCacheBin::accessKeyFromTuple(const std::string& tuple) const
+{
+    return "a" + SEP + tuple;
+}
+
+std::string
+RocksDBCacheBin::accessBegin() const
+{
+    return "a" + SEP + getID() + SEP;
+}
+
+std::string
+RocksDBCacheBin::accessEnd() const
+{
+    return "a" + SEP + getID() + SEP + "\xff";
+}
+
 std::string
 RocksDBCacheBin::dataKey(const std::string& key) const
 {
@@ -215,14 +361,26 @@ RocksDBCacheBin::timeEndGlobal() const
 ReadResult
 RocksDBCacheBin::readImage(const std::string& key, const osgDB::Options* readOptions)
 {
-    return read(key, ImageReader(_rw.get(), readOptions));  
+    return metrics().read([&]() { return read(key, ImageReader(_rw.get(), readOptions)); });
 }
 
 ReadResult
 RocksDBCacheBin::readObject(const std::string& key, const osgDB::Options* readOptions)
 {
     //OE_INFO << LC << "Read attempt: " << key << " from " << getID() << std::endl;
-    return read(key, ObjectReader(_rw.get(), readOptions));
+    return metrics().read([&]() { return read(key, ObjectReader(_rw.get(), readOptions)); });
+}
+
+std::vector<ReadResult>
+RocksDBCacheBin::readMany(const std::vector<std::string>& keys, const osgDB::Options* readOptions)
+{
+    return readMany(keys, ObjectReader(_rw.get(), readOptions));
+}
+
+std::vector<ReadResult>
+RocksDBCacheBin::readManyImages(const std::vector<std::string>& keys, const osgDB::Options* readOptions)
+{
+    return readMany(keys, ImageReader(_rw.get(), readOptions));
 }
 
 ReadResult
@@ -233,44 +391,172 @@ RocksDBCacheBin::read(const std::string& key, const Reader& reader)
 
     ++_tracker->reads;
 
+    // a single lookup gets both the metadata and the data. The value stays
+    // pinned (in the block cache or memtable) while we decode it in place.
+    rocksdb::PinnableSlice value;
+    rocksdb::Status status = _db->Get( rocksdb::ReadOptions(), _db->DefaultColumnFamily(), recordKey(key), &value );
+    if ( status.IsNotFound() )
+    {
+        // it may still be stored in the old layout.
+        return readLegacy(key, reader);
+    }
+    else if ( !status.ok() )
+    {
+        OE_WARN << LC << "Bin " << getID() << ": failed to read (" << key << "): " << status.ToString() << std::endl;
+        return ReadResult(ReadResult::RESULT_READER_ERROR);
+    }
+
+    return decodeValue(key, reader, value);
+}
+
+std::vector<ReadResult>
+RocksDBCacheBin::readMany(const std::vector<std::string>& keys, const Reader& reader)
+{
+    std::vector<ReadResult> results(keys.size());
+    if ( !binValidForReading() || keys.empty() )
+        return results;
+
+    _tracker->reads += keys.size();
+
+    // one batched lookup for all the records:
+    std::vector<std::string> recordKeys;
+    recordKeys.reserve( keys.size() );
+    for(auto& key : keys)
+        recordKeys.push_back( recordKey(key) );
+
+    std::vector<rocksdb::Slice> slices(recordKeys.begin(), recordKeys.end());
+    std::vector<rocksdb::PinnableSlice> values(keys.size());
+    std::vector<rocksdb::Status> statuses(keys.size());
+    _db->MultiGet( rocksdb::ReadOptions(), _db->DefaultColumnFamily(), keys.size(), slices.data(), values.data(), statuses.data() );
+
+    for(unsigned i=0; i<keys.size(); ++i)
+    {
+        if ( statuses[i].ok() )
+        {
+            results[i] = decodeValue(keys[i], reader, values[i]);
+        }
+        else if ( statuses[i].IsNotFound() )
+        {
+            results[i] = readLegacy(keys[i], reader);
+        }
+        else
+        {
+            OE_WARN << LC << "Bin " << getID() << ": failed to read (" << keys[i] << "): " << statuses[i].ToString() << std::endl;
+            results[i] = ReadResult(ReadResult::RESULT_READER_ERROR);
+        }
+        values[i].Reset();
+        metrics().countRead(results[i].succeeded());
+    }
+
+    return results;
+}
+
+ReadResult
+RocksDBCacheBin::decodeValue(const std::string& key, const Reader& reader, const rocksdb::Slice& value)
+{
+    rocksdb::Slice metavalue, datavalue;
+    if ( !decodeRecord(value, metavalue, datavalue) )
+    {
+        OE_WARN << LC << "Bin " << getID() << ": corrupt record (" << key << ")" << std::endl;
+        return ReadResult(ReadResult::RESULT_READER_ERROR);
+    }
+
     Config metadata;
-    rocksdb::Status status;
-    rocksdb::ReadOptions ro;
+    decodeMeta(metavalue, metadata);
 
-    // first read the metadata record.
-    std::string metavalue;
-    status = _db->Get( ro, metaKey(key), &metavalue );
-    TimeStamp lastModified = (TimeStamp)0;
-    if ( status.ok() )
-    {        
-        decodeMeta(metavalue, metadata);
-        DateTime t( metadata.value(TIME_FIELD));
-        lastModified = t.asTimeStamp();
+    // blended data has to be copied to unblend it.
+    if ( _tracker->seed().isSet() )
+    {
+        std::string data = datavalue.ToString();
+        unblend(data, _tracker->seed().value());
+        MemoryStreamBuf buf(data.data(), data.size());
+        std::istream datastream(&buf);
+        return decode(key, reader, datastream, metadata);
     }
-        
-    // next read the data record.
-    std::string datakey = dataKey(key);
+    else
+    {
+        MemoryStreamBuf buf(datavalue.data(), datavalue.size());
+        std::istream datastream(&buf);
+        return decode(key, reader, datastream, metadata);
+    }
+}
+
+ReadResult
+RocksDBCacheBin::readLegacy(const std::string& key, const Reader& reader)
+{
+    // Version 1 caches keep the metadata and data in separate records.
+    if ( !_hasLegacyRecords )
+        return ReadResult(ReadResult::RESULT_NOT_FOUND);
+
+    rocksdb::ReadOptions ro;
+
     std::string datavalue;
-    status = _db->Get( ro, datakey, &datavalue );
-    if ( !status.ok() )
+    if ( !_db->Get(ro, dataKey(key), &datavalue).ok() )
     {
         // main record not found for some reason.
         return ReadResult(ReadResult::RESULT_NOT_FOUND);
     }
 
+    Config metadata;
+    std::string metavalue;
+    if ( _db->Get(ro, metaKey(key), &metavalue).ok() )
+    {
+        decodeMeta(metavalue, metadata);
+    }
+
+    // the migration rewrites the record's time index entry.
+    std::unique_lock<std::mutex> indexLock( _timeIndexMutex );
+
+    // Migrate to a combined record, keeping its place in the time index,
+    // unless another thread migrated or rewrote it since we read it.
+    std::string current;
+    if ( _db->Get(ro, recordKey(key), &current).IsNotFound() )
+    {
+        rocksdb::WriteBatch batch;
+        std::string time = metadata.value(TIME_FIELD);
+        if ( time.empty() )
+        {
+            time = DateTime().asCompactISO8601();
+            metadata.set(TIME_FIELD, time);
+            batch.Put( timeKey(time, key), binDataKeyTuple(key) );
+        }
+        encodeMeta(metadata, metavalue);
+
+        std::string record;
+        encodeRecord(metavalue, datavalue, record);
+        batch.Put( recordKey(key), record );
+        batch.Put( accessKey(key), time );
+        batch.Delete( dataKey(key) );
+        batch.Delete( metaKey(key) );
+
+        if ( !_db->Write(rocksdb::WriteOptions(), &batch).ok() )
+        {
+            OE_WARN << LC << "Bin " << getID() << ": failed to migrate (" << key << ")" << std::endl;
+        }
+    }
+
+    indexLock.unlock();
+
     // blend the data string
     if ( _tracker->seed().isSet() )
         unblend(datavalue, _tracker->seed().value());
 
-    // finally, decode the OSGB stream into an object.
-    std::istringstream datastream(datavalue);
-    osgDB::ReaderWriter::ReadResult r = reader.read(datastream);
+    MemoryStreamBuf buf(datavalue.data(), datavalue.size());
+    std::istream datastream(&buf);
+    return decode(key, reader, datastream, metadata);
+}
+
+ReadResult
+RocksDBCacheBin::decode(const std::string& key, const Reader& reader, std::istream& in, const Config& metadata)
+{
+    // decode the OSGB stream into an object.
+    osgDB::ReaderWriter::ReadResult r = reader.read(in);
     if ( !r.success() )
     {
         OE_WARN << LC << "Cache read failure!"
             << "\n reader = " << reader.name()
             << "\n error detail = " << r.message()
-            << "\n data value = " << datavalue
+            << "\n key = " << key
             << "\n";
 
         return ReadResult(ReadResult::RESULT_READER_ERROR);
@@ -281,12 +567,16 @@ RocksDBCacheBin::read(const std::string& key, const Reader& reader)
         OE_NOTICE << LC << "Bin " << getID() << ": read (" << key << ")\n";
     }
 
-    // if there's a size limit, we need to 'touch' the record.
+    // if there's a size limit, record the access for the time index.
     if ( _tracker->hasSizeLimit() )
     {
-        // Room for optimization here since we already have the 
-        // meta/time records around.
-        touch( key );
+        deferTouch( key );
+    }
+
+    TimeStamp lastModified = (TimeStamp)0;
+    if ( metadata.hasValue(TIME_FIELD) )
+    {
+        lastModified = DateTime(metadata.value(TIME_FIELD)).asTimeStamp();
     }
 
     ++_tracker->hits;
@@ -313,15 +603,9 @@ RocksDBCacheBin::readString(const std::string& key, const osgDB::Options* readOp
 }
 
 bool
-RocksDBCacheBin::write(const std::string& key, const osg::Object* object, const Config& meta, const osgDB::Options* writeOptions)
+RocksDBCacheBin::serialize(const osg::Object* object, const osgDB::Options* writeOptions, std::string& out, std::string& message)
 {
-    if ( !binValidForWriting() || !object ) 
-        return false;
-        
     osgDB::ReaderWriter::WriteResult r;
-    bool objWriteOK = false;
-
-    std::string       data;
     std::stringstream datastream;
 
     if ( dynamic_cast<const osg::Image*>(object) )
@@ -332,7 +616,6 @@ RocksDBCacheBin::write(const std::string& key, const osg::Object* object, const
             return false;
         }
         r = _rw->writeImage( *static_cast<const osg::Image*>(object), datastream, writeOptions);
-        objWriteOK = r.success();
     }
     else if ( dynamic_cast<const osg::Node*>(object) )
     {
@@ -342,7 +625,6 @@ RocksDBCacheBin::write(const std::string& key, const osg::Object* object, const
             return false;
         }
         r = _rw->writeNode( *static_cast<const osg::Node*>(object), datastream, writeOptions);
-        objWriteOK = r.success();
     }
     else
     {
@@ -352,30 +634,77 @@ RocksDBCacheBin::write(const std::string& key, const osg::Object* object, const
             return false;
         }
         r = _rw->writeObject( *object, datastream, writeOptions );
-        objWriteOK = r.success();
     }
 
+    message = r.message();
+    if ( !r.success() )
+        return false;
+
+    out = datastream.str();
+    if ( _tracker->seed().isSet() )
+        blend(out, _tracker->seed().value());
+
+    return true;
+}
+
+void
+RocksDBCacheBin::putRecord(rocksdb::WriteBatch& batch, const std::string& key, const std::string& data,
+                           const Config& meta, const DateTime& now, const std::string* oldtime)
+{
+    std::string nowtime = now.asCompactISO8601();
+
+    // write the metadata and data as one record:
+    Config metadata(meta);
+    metadata.set( TIME_FIELD, nowtime );
+    std::string metavalue;
+    encodeMeta( metadata, metavalue );
+
+    std::string record;
+    encodeRecord( metavalue, data, record );
+    batch.Put( recordKey(key), record );
+
+    // replace the record's time index entry:
+    if ( oldtime )
+        batch.Delete( timeKey(*oldtime, key) );
+    batch.Put( timeKey(now, key), binDataKeyTuple(key) );
+    batch.Put( accessKey(key), nowtime );
+
+    // drop any copy in the old layout so it can't be migrated over this one.
+    if ( _hasLegacyRecords )
+    {
+        batch.Delete( dataKey(key) );
+        batch.Delete( metaKey(key) );
+    }
+}
+
+bool
+RocksDBCacheBin::write(const std::string& key, const osg::Object* object, const Config& meta, const osgDB::Options* writeOptions)
+{
+    Util::MetricsRegistry::ScopedTimer timer(metrics().writeLatency);
+
+    if ( !binValidForWriting() || !object ) 
+    {
+        metrics().countWrite(false);
+        return false;
+    }
+
+    std::string data, message;
+    bool objWriteOK = serialize(object, writeOptions, data, message);
+
     if (objWriteOK)
     {
-        DateTime now;
         rocksdb::WriteBatch batch;
 
-        // write the data:
-        data = datastream.str();
-        if ( _tracker->seed().isSet() )
-            blend(data, _tracker->seed().value());
-        batch.Put( dataKey(key), data );
-
-        // write the timestamp index:
-        batch.Put( timeKey(now, key), binDataKeyTuple(key) );
+        // replacing the time index entry has to be atomic with touches.
+        {
+            std::lock_guard<std::mutex> indexLock( _timeIndexMutex );
 
-        // write the metadata:
-        Config metadata(meta);
-        metadata.set( TIME_FIELD, now.asCompactISO8601() );
-        encodeMeta( metadata, data );
-        batch.Put( metaKey(key), data );
+            std::string oldtime;
+            bool replacing = readAccessTime(key, oldtime);
+            putRecord( batch, key, data, meta, DateTime(), replacing ? &oldtime : nullptr );
 
-        objWriteOK = _db->Write( rocksdb::WriteOptions(), &batch ).ok();
+            objWriteOK = _db->Write( rocksdb::WriteOptions(), &batch ).ok();
+        }
 
         if ( objWriteOK )
         {
@@ -389,16 +718,93 @@ RocksDBCacheBin::write(const std::string& key, const osg::Object* object, const
         }
     }
 
-        
     if ( !objWriteOK )
     {
         OE_WARN << LC << "Bin " << getID() << ": FAILED to write (" << key << "); msg = \"" 
-            << r.message() << "\"\n";
+            << message << "\"\n";
     }
 
+    metrics().countWrite(objWriteOK);
     return objWriteOK;
 }
 
+unsigned
+RocksDBCacheBin::writeMany(const std::vector<Record>& records, const osgDB::Options* writeOptions)
+{
+    if ( !binValidForWriting() || records.empty() )
+        return 0u;
+
+    // serialize everything before taking the time index lock:
+    std::vector<const Record*> serialized;
+    std::vector<std::string> datas;
+    serialized.reserve( records.size() );
+    datas.reserve( records.size() );
+    for(auto& record : records)
+    {
+        std::string data, message;
+        if ( !record.object.valid() || !serialize(record.object.get(), writeOptions, data, message) )
+        {
+            OE_WARN << LC << "Bin " << getID() << ": FAILED to write (" << record.key << "); msg = \""
+                << message << "\"\n";
+            continue;
+        }
+        serialized.push_back( &record );
+        datas.push_back( std::move(data) );
+    }
+
+    if ( serialized.empty() )
+        return 0u;
+
+    // replacing the time index entries has to be atomic with touches.
+    std::unique_lock<std::mutex> indexLock( _timeIndexMutex );
+
+    // find the time index entries of records we are replacing, all at once:
+    std::vector<std::string> keys;
+    keys.reserve( serialized.size() );
+    for(auto record : serialized)
+        keys.push_back( accessKey(record->key) );
+
+    std::vector<rocksdb::Slice> slices(keys.begin(), keys.end());
+    std::vector<std::string> oldtimes;
+    std::vector<rocksdb::Status> statuses = _db->MultiGet( rocksdb::ReadOptions(), slices, &oldtimes );
+
+    // ...and write them all in one batch.
+    DateTime now;
+    rocksdb::WriteBatch batch;
+    std::vector<const std::string*> written;
+
+    for(unsigned i=0; i<serialized.size(); ++i)
+    {
+        const Record& record = *serialized[i];
+        bool replacing = statuses[i].ok() || readLegacyTime(record.key, oldtimes[i]);
+        putRecord( batch, record.key, datas[i], record.metadata, now, replacing ? &oldtimes[i] : nullptr );
+        written.push_back( &record.key );
+    }
+
+    if ( !_db->Write(rocksdb::WriteOptions(), &batch).ok() )
+    {
+        OE_WARN << LC << "Bin " << getID() << ": FAILED to write " << written.size() << " records\n";
+        return 0u;
+    }
+
+    indexLock.unlock();
+
+    metrics().writes.add(written.size());
+
+    for(auto key : written)
+    {
+        ++_tracker->writes;
+        postWrite();
+
+        if ( _debug )
+        {
+            OE_NOTICE << LC << "Bin " << getID() << ": wrote (" << *key << ")\n";
+        }
+    }
+
+    return written.size();
+}
+
 void
 RocksDBCacheBin::postWrite()
 {
@@ -441,12 +847,17 @@ RocksDBCacheBin::getRecordStatus(const std::string& key)
     if ( !binValidForReading() ) 
         return STATUS_NOT_FOUND;
 
-    rocksdb::Status status;
     rocksdb::ReadOptions ro;
 
-    // read the metadata record.
-    std::string metavalue;
-    status = _db->Get( ro, metaKey(key), &metavalue );
+    // look up the record, or the metadata record of the old layout.
+    rocksdb::PinnableSlice value;
+    rocksdb::Status status = _db->Get( ro, _db->DefaultColumnFamily(), recordKey(key), &value );
+    if ( !status.ok() && _hasLegacyRecords )
+    {
+        value.Reset();
+        status = _db->Get( ro, _db->DefaultColumnFamily(), metaKey(key), &value );
+    }
+
     if ( status.ok() )
     {        
         return STATUS_OK;
@@ -457,25 +868,51 @@ RocksDBCacheBin::getRecordStatus(const std::string& key)
     }
 }
 
+std::vector<CacheBin::RecordStatus>
+RocksDBCacheBin::statusMany(const std::vector<std::string>& keys)
+{
+    std::vector<RecordStatus> results(keys.size(), STATUS_NOT_FOUND);
+    if ( !binValidForReading() || keys.empty() )
+        return results;
+
+    std::vector<std::string> recordKeys;
+    recordKeys.reserve( keys.size() );
+    for(auto& key : keys)
+        recordKeys.push_back( recordKey(key) );
+
+    std::vector<rocksdb::Slice> slices(recordKeys.begin(), recordKeys.end());
+    std::vector<rocksdb::PinnableSlice> values(keys.size());
+    std::vector<rocksdb::Status> statuses(keys.size());
+    _db->MultiGet( rocksdb::ReadOptions(), _db->DefaultColumnFamily(), keys.size(), slices.data(), values.data(), statuses.data() );
+
+    for(unsigned i=0; i<keys.size(); ++i)
+    {
+        // misses may still be stored in the old layout.
+        results[i] = statuses[i].ok() ? STATUS_OK : getRecordStatus(keys[i]);
+    }
+
+    return results;
+}
+
 bool
 RocksDBCacheBin::remove(const std::string& key)
 {
     if ( !binValidForReading() )
         return false;
 
-    // first read in the time from the metadata record.
-    std::string metavalue;
-    if ( _db->Get(rocksdb::ReadOptions(), metaKey(key), &metavalue).ok() == false )
-        return false;
+    std::lock_guard<std::mutex> indexLock( _timeIndexMutex );
 
-    Config metadata;
-    decodeMeta(metavalue, metadata);
-    DateTime t(metadata.value(TIME_FIELD));
+    // first find the record's time index entry.
+    std::string time;
+    if ( readAccessTime(key, time) == false )
+        return false;
 
     rocksdb::WriteBatch batch;
+    batch.Delete( recordKey(key) );
+    batch.Delete( accessKey(key) );
     batch.Delete( dataKey(key) );
     batch.Delete( metaKey(key) );
-    batch.Delete( timeKey(t, key) );
+    batch.Delete( timeKey(time, key) );
         
     rocksdb::Status status = _db->Write(rocksdb::WriteOptions(), &batch);
     if ( !status.ok() )
@@ -497,28 +934,49 @@ RocksDBCacheBin::touch(const std::string& key)
     if ( !binValidForWriting() )
         return false;
 
-    // first read in the time from the metadata record.
-    std::string metavalue;
-    if ( _db->Get(rocksdb::ReadOptions(), metaKey(key), &metavalue).ok() == false )
+    std::lock_guard<std::mutex> indexLock( _timeIndexMutex );
+
+    // first find the record's time index entry.
+    std::string oldtime;
+    if ( readAccessTime(key, oldtime) == false )
         return false;
 
-    Config metadata;
-    decodeMeta(metavalue, metadata);
-    DateTime oldtime(metadata.value(TIME_FIELD));
-        
+    rocksdb::ReadOptions ro;
     rocksdb::WriteBatch batch;
-
-    // In a transaction, update the metadata record with the current time.
     std::string newtime = DateTime().asCompactISO8601();
-    metadata.set(TIME_FIELD, newtime);
-    encodeMeta(metadata, metavalue);
-    batch.Put(metaKey(key), metavalue);
+
+    // In a transaction, update the metadata with the current time...
+    std::string value;
+    if ( _db->Get(ro, recordKey(key), &value).ok() )
+    {
+        rocksdb::Slice metavalue, datavalue;
+        if ( !decodeRecord(value, metavalue, datavalue) )
+            return false;
+
+        Config metadata;
+        decodeMeta(metavalue, metadata);
+        metadata.set(TIME_FIELD, newtime);
+
+        std::string meta, record;
+        encodeMeta(metadata, meta);
+        encodeRecord(meta, datavalue, record);
+        batch.Put(recordKey(key), record);
+    }
+    else if ( _db->Get(ro, metaKey(key), &value).ok() )
+    {
+        Config metadata;
+        decodeMeta(value, metadata);
+        metadata.set(TIME_FIELD, newtime);
+        encodeMeta(metadata, value);
+        batch.Put(metaKey(key), value);
+    }
 
     // ...remove the old time index record:
     batch.Delete( timeKey(oldtime, key) );
 
     // ...and write a new time index record.
     batch.Put( timeKey(newtime, key), binDataKeyTuple(key) );
+    batch.Put( accessKey(key), newtime );
 
     rocksdb::Status status = _db->Write(rocksdb::WriteOptions(), &batch);
     if ( !status.ok() )
@@ -532,12 +990,117 @@ RocksDBCacheBin::touch(const std::string& key)
     return status.ok();
 }
 
+bool
+RocksDBCacheBin::readAccessTime(const std::string& key, std::string& out)
+{
+    if ( _db->Get(rocksdb::ReadOptions(), accessKey(key), &out).ok() )
+        return true;
+
+    return readLegacyTime(key, out);
+}
+
+bool
+RocksDBCacheBin::readLegacyTime(const std::string& key, std::string& out)
+{
+    // old layout: the time is in the metadata record.
+    if ( !_hasLegacyRecords )
+        return false;
+
+    std::string metavalue;
+    if ( _db->Get(rocksdb::ReadOptions(), metaKey(key), &metavalue).ok() == false )
+        return false;
+
+    Config metadata;
+    decodeMeta(metavalue, metadata);
+    out = metadata.value(TIME_FIELD);
+    return true;
+}
+
+void
+RocksDBCacheBin::deferTouch(const std::string& key)
+{
+    auto now = std::chrono::steady_clock::now();
+    bool flush;
+    {
+        std::lock_guard<std::mutex> lock( _touchMutex );
+        _pendingTouches[key] = DateTime().asTimeStamp();
+        flush =
+            _pendingTouches.size() >= _tracker->touchBatchSize() ||
+            now - _lastTouchFlush >= _tracker->touchFlushPeriod();
+    }
+
+    if ( flush )
+    {
+        flushTouches();
+    }
+}
+
+void
+RocksDBCacheBin::flushTouches()
+{
+    // one time index update at a time, so that a flush and a write (or two
+    // flushes) of the same key cannot both replace the same old entry.
+    std::lock_guard<std::mutex> indexLock( _timeIndexMutex );
+
+    std::unordered_map<std::string, TimeStamp> touches;
+    {
+        std::lock_guard<std::mutex> lock( _touchMutex );
+        touches.swap( _pendingTouches );
+        _lastTouchFlush = std::chrono::steady_clock::now();
+    }
+
+    if ( touches.empty() )
+        return;
+
+    // look up all the current access times at once:
+    std::vector<std::string> keys;
+    keys.reserve( touches.size() );
+    for(auto& touch : touches)
+        keys.push_back( accessKey(touch.first) );
+
+    std::vector<rocksdb::Slice> slices(keys.begin(), keys.end());
+    std::vector<std::string> oldtimes;
+    std::vector<rocksdb::Status> statuses = _db->MultiGet( rocksdb::ReadOptions(), slices, &oldtimes );
+
+    rocksdb::WriteBatch batch;
+    unsigned i = 0;
+    for(auto& touch : touches)
+    {
+        const std::string& oldtime = oldtimes[i];
+        const std::string& akey = keys[i];
+        if ( statuses[i++].ok() ) // otherwise removed or purged since
+        {
+            std::string newtime = DateTime(touch.second).asCompactISO8601();
+            if ( newtime != oldtime )
+            {
+                batch.Delete( timeKey(oldtime, touch.first) );
+                batch.Put( timeKey(newtime, touch.first), binDataKeyTuple(touch.first) );
+                batch.Put( akey, newtime );
+            }
+        }
+    }
+
+    if ( batch.Count() > 0 && !_db->Write(rocksdb::WriteOptions(), &batch).ok() )
+    {
+        OE_WARN << LC << "Failed to update access times in bin " << getID() << std::endl;
+    }
+    else if ( _debug )
+    {
+        OE_NOTICE << LC << "Bin " << getID() << ": touched " << touches.size() << " record(s)\n";
+    }
+}
+
 bool
 RocksDBCacheBin::clear()
 {
     if ( !binValidForWriting() )
         return false;
     
+    {
+        std::lock_guard<std::mutex> lock( _touchMutex );
+        _pendingTouches.clear();
+    }
+
     rocksdb::WriteOptions wo;
     std::string binphrase = binPhrase();
     rocksdb::WriteBatch batch;
@@ -579,16 +1142,16 @@ RocksDBCacheBin::getStorageSize()
         return false;
 
     //Note: doesn't work..
-    rocksdb::Range ranges[3];
-    uint64_t       sizes[3];
+    std::string begins[5] = { recordBegin(), accessBegin(), dataBegin(), metaBegin(), timeBegin() };
+    std::string ends[5]   = { recordEnd(),   accessEnd(),   dataEnd(),   metaEnd(),   timeEnd()   };
+    rocksdb::Range ranges[5];
+    uint64_t       sizes[5] = { 0, 0, 0, 0, 0 };
 
-    ranges[0] = rocksdb::Range(dataBegin(), dataEnd());
-    ranges[1] = rocksdb::Range(metaBegin(), metaEnd());
-    ranges[2] = rocksdb::Range(timeBegin(), timeEnd());
-    sizes[0] = sizes[1] = sizes[2] = 0;
+    for(unsigned i=0; i<5; ++i)
+        ranges[i] = rocksdb::Range(begins[i], ends[i]);
 
-    _db->GetApproximateSizes( ranges, 3, sizes );
-    return sizes[0] + sizes[1] + sizes[2];
+    _db->GetApproximateSizes( ranges, 5, sizes );
+    return sizes[0] + sizes[1] + sizes[2] + sizes[3] + sizes[4];
 }
 
 Config
@@ -639,6 +1202,9 @@ RocksDBCacheBin::purgeOldest(unsigned maxnum)
     if ( !binValidForWriting() )
         return false;
 
+    // so recently read records are not the ones purged.
+    flushTouches();
+
     rocksdb::Iterator* it = _db->NewIterator(rocksdb::ReadOptions());
 
     unsigned count = 0;
@@ -657,6 +1223,8 @@ RocksDBCacheBin::purgeOldest(unsigned maxnum)
         // doing this in a WriteBatch did not work. The size of the
         // database would never go down.
         rocksdb::WriteOptions wo;
+        _db->Delete( wo, recordKeyFromTuple(tuple) );
+        _db->Delete( wo, accessKeyFromTuple(tuple) );
         _db->Delete( wo, dataKeyFromTuple(tuple) );
         _db->Delete( wo, metaKeyFromTuple(tuple) );
         _db->Delete( wo, it->key() );
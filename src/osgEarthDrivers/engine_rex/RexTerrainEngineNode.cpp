@@ -222,6 +222,12 @@ RexTerrainEngineNode::getNumResidentTiles() const
     return _tiles ? _tiles->size() : 0u;
 }
 
+std::size_t
+RexTerrainEngineNode::getResidentTileMemory() const
+{
+    return _tiles ? _tiles->getTotalBytes() : 0u;
+}
+
 void
 RexTerrainEngineNode::onSetMap()
 {
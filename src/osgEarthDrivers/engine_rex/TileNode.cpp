@@ -1089,6 +1089,9 @@ TileNode::merge(const TerrainTileModel* model, const CreateTileManifest& manifes
 
     // Bump the data revision for the tile.
     ++_revision;
+
+    // New data changes what this tile holds in memory.
+    _context->tiles()->updateFootprint(this);
 }
 
 void TileNode::inheritSharedSampler(int binding)
@@ -1367,6 +1370,50 @@ TileNode::removeSubTiles()
 }
 
 
+std::size_t
+TileNode::getMemoryFootprint() const
+{
+    std::size_t bytes = 0u;
+
+    // Only count textures this tile owns; inherited ones are counted
+    // by the ancestor that loaded them. Images dropped after the GPU
+    // upload do not count.
+    const auto addSampler = [&bytes](const Sampler& sampler)
+    {
+        if (sampler.ownsTexture())
+            bytes += sampler._texture->getResidentImageBytes();
+    };
+
+    for (unsigned i = 0; i < _renderModel._sharedSamplers.size(); ++i)
+        addSampler(_renderModel._sharedSamplers[i]);
+
+    for (auto& pass : _renderModel._passes)
+        for (unsigned i = 0; i < pass.samplers().size(); ++i)
+            addSampler(pass.sampler(i));
+
+    if (_surface.valid() && _surface->_drawable.valid())
+    {
+        const TileDrawable* drawable = _surface->_drawable.get();
+        bytes += drawable->_mesh.capacity() * sizeof(osg::Vec3);
+
+        // Geometry without constraints lives in the GeometryPool and is
+        // shared with other tiles, so only constrained geometry counts here.
+        const SharedGeometry* geom = drawable->_geom.get();
+        if (geom && geom->hasConstraints())
+        {
+            if (geom->_vertexArray.valid()) bytes += geom->_vertexArray->getTotalDataSize();
+            if (geom->_normalArray.valid()) bytes += geom->_normalArray->getTotalDataSize();
+            if (geom->_texcoordArray.valid()) bytes += geom->_texcoordArray->getTotalDataSize();
+            if (geom->_neighborArray.valid()) bytes += geom->_neighborArray->getTotalDataSize();
+            if (geom->_neighborNormalArray.valid()) bytes += geom->_neighborNormalArray->getTotalDataSize();
+            if (geom->_drawElements.valid()) bytes += geom->_drawElements->getTotalDataSize();
+            bytes += geom->_verts.capacity() * sizeof(GL4Vertex);
+        }
+    }
+
+    return bytes;
+}
+
 void
 TileNode::notifyOfArrival(TileNode* that)
 {
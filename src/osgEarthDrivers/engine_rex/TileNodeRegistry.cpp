@@ -16,6 +16,7 @@ using namespace osgEarth;
 #define SENTRY_VALUE nullptr
 
 #define PROFILING_REX_TILES "Live Terrain Tiles"
+#define PROFILING_REX_TILE_MEMORY "Terrain Tile Memory (MB)"
 
 //----------------------------------------------------------------------------
 
@@ -45,17 +46,15 @@ TileNodeRegistry::setDirty(
 {
     std::lock_guard<std::mutex> lock(_mutex);
     
-    for( TileTable::iterator i = _tiles.begin(); i != _tiles.end(); ++i )
-    {
-        const TileKey& key = i->first;
-
-        if (minLevel <= key.getLOD() && 
-            maxLevel >= key.getLOD() &&
-            (extent.isInvalid() || extent.intersects(key.getExtent())))
+    _tiles.forEach([&](const TileKey& key, TableEntry& entry)
         {
-            i->second._tile->refreshLayers(manifest);
-        }
-    }
+            if (minLevel <= key.getLOD() &&
+                maxLevel >= key.getLOD() &&
+                (extent.isInvalid() || extent.intersects(key.getExtent())))
+            {
+                entry._tile->refreshLayers(manifest);
+            }
+        });
 }
 
 void
@@ -68,6 +67,10 @@ TileNodeRegistry::add(TileNode* tile)
     bool recyclingOrphan = entry._trackerToken != nullptr;
     entry._trackerToken = _tracker.use(tile, nullptr);
 
+    std::size_t bytes = tile->getMemoryFootprint();
+    _totalBytes = _totalBytes - entry._bytes + bytes;
+    entry._bytes = bytes;
+
     // Start waiting on our neighbors.
     // (If we're recycling and orphaned record, we need to remove old listeners first)
     if (_notifyNeighbors)
@@ -85,20 +88,18 @@ TileNodeRegistry::add(TileNode* tile)
         startListeningFor(key.createNeighborKey(0, 1), tile);
 
         // check for tiles that are waiting on this tile, and notify them!
-        TileKeyOneToMany::iterator notifier = _notifiers.find( tile->getKey() );
-        if ( notifier != _notifiers.end() )
+        TileKeySet* listeners = _notifiers.find( tile->getKey() );
+        if ( listeners )
         {
-            TileKeySet& listeners = notifier->second;
-
-            for(TileKeySet::iterator listener = listeners.begin(); listener != listeners.end(); ++listener)
-            {
-                TileTable::iterator i = _tiles.find( *listener );
-                if ( i != _tiles.end())
+            listeners->forEach([&](const TileKey& listener, bool&)
                 {
-                    i->second._tile->notifyOfArrival( tile );
-                }
-            }
-            _notifiers.erase( notifier );
+                    TableEntry* i = _tiles.find( listener );
+                    if ( i )
+                    {
+                        i->_tile->notifyOfArrival( tile );
+                    }
+                });
+            _notifiers.erase( tile->getKey() );
         }
 
         OE_DEBUG << LC
@@ -108,6 +109,23 @@ TileNodeRegistry::add(TileNode* tile)
     }
 }
 
+void
+TileNodeRegistry::updateFootprint(TileNode* tile)
+{
+    std::size_t bytes = tile->getMemoryFootprint();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    TableEntry* i = _tiles.find(tile->getKey());
+    if (i && i->_tile.get() == tile)
+    {
+        _totalBytes = _totalBytes - i->_bytes + bytes;
+        i->_bytes = bytes;
+    }
+
+    OE_PROFILING_PLOT(PROFILING_REX_TILE_MEMORY, (float)((double)_totalBytes / 1048576.0));
+}
+
 void
 TileNodeRegistry::startListeningFor(
     const TileKey& tileToWaitFor,
@@ -115,10 +133,10 @@ TileNodeRegistry::startListeningFor(
 {
     // ASSUME EXCLUSIVE LOCK
 
-    TileTable::iterator i = _tiles.find(tileToWaitFor);
-    if (i != _tiles.end())
+    TableEntry* i = _tiles.find(tileToWaitFor);
+    if (i)
     {
-        TileNode* tile = i->second._tile.get();
+        TileNode* tile = i->_tile.get();
 
         //OE_DEBUG << LC << waiter->getKey().str() << " listened for " << tileToWaitFor.str()
         //    << ", but it was already in the repo.\n";
@@ -128,7 +146,7 @@ TileNodeRegistry::startListeningFor(
     else
     {
         //OE_DEBUG << LC << waiter->getKey().str() << " listened for " << tileToWaitFor.str() << ".\n";
-        _notifiers[tileToWaitFor].insert( waiter->getKey() );
+        _notifiers[tileToWaitFor][waiter->getKey()] = true;
     }
 }
 
@@ -139,16 +157,16 @@ TileNodeRegistry::stopListeningFor(
 {
     // ASSUME EXCLUSIVE LOCK
 
-    TileKeyOneToMany::iterator i = _notifiers.find(tileToWaitFor);
-    if (i != _notifiers.end())
+    TileKeySet* i = _notifiers.find(tileToWaitFor);
+    if (i)
     {
         // remove the waiter from this set:
-        i->second.erase(waiterKey);
+        i->erase(waiterKey);
 
         // if the set is now empty, remove the set entirely
-        if (i->second.empty())
+        if (i->empty())
         {
-            _notifiers.erase(i);
+            _notifiers.erase(tileToWaitFor);
         }
     }
 }
@@ -158,17 +176,20 @@ TileNodeRegistry::releaseAll(osg::State* state)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    for (auto& tile : _tiles)
-    {
-        tile.second._tile->releaseGLObjects(state);
-    }
+    _tiles.forEach([&](const TileKey&, TableEntry& entry)
+        {
+            entry._tile->releaseGLObjects(state);
+        });
     _tiles.clear();
 
+    _totalBytes = 0u;
+
     _tracker.reset();
 
     _notifiers.clear();
 
     _tilesToUpdate.clear();
+    _unpackedTilesToUpdate.clear();
 
     OE_PROFILING_PLOT(PROFILING_REX_TILES, (float)(_tiles.size()));
 }
@@ -178,15 +199,19 @@ TileNodeRegistry::touch(TileNode* tile, osg::NodeVisitor& nv)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
-    TileTable::iterator i = _tiles.find(tile->getKey());
+    TableEntry* i = _tiles.find(tile->getKey());
 
-    OE_SOFT_ASSERT_AND_RETURN(i != _tiles.end(), void());
+    OE_SOFT_ASSERT_AND_RETURN(i != nullptr, void());
 
-    _tracker.use(tile, i->second._trackerToken);
+    _tracker.use(tile, i->_trackerToken);
 
     if (tile->updateRequired())
     {
-        _tilesToUpdate.push_back(tile->getKey());
+        PackedTileKey packed(tile->getKey());
+        if (packed.valid())
+            _tilesToUpdate.push_back(packed);
+        else
+            _unpackedTilesToUpdate.push_back(tile->getKey());
     }
 }
 
@@ -195,22 +220,44 @@ TileNodeRegistry::update(osg::NodeVisitor& nv)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    // Sorting these from high to low LOD will reduce the number 
+    // of inheritance steps each updated image will have to perform
+    // against the tile's children. Keys that do not pack are usually
+    // the deepest ones, so they go first.
+    if (!_unpackedTilesToUpdate.empty())
+    {
+        std::sort(
+            _unpackedTilesToUpdate.begin(),
+            _unpackedTilesToUpdate.end(),
+            [](const TileKey& lhs, const TileKey& rhs) {
+                return lhs.getLOD() > rhs.getLOD();
+            });
+
+        for (auto& key : _unpackedTilesToUpdate)
+        {
+            TableEntry* entry = _tiles.find(key);
+            if (entry)
+            {
+                entry->_tile->update(nv);
+            }
+        }
+
+        _unpackedTilesToUpdate.clear();
+    }
+
     if (!_tilesToUpdate.empty())
     {
-        // Sorting these from high to low LOD will reduce the number 
-        // of inheritance steps each updated image will have to perform
-        // against the tile's children
         std::sort(
             _tilesToUpdate.begin(),
             _tilesToUpdate.end(),
-            [](const TileKey& lhs, const TileKey& rhs) {
+            [](const PackedTileKey& lhs, const PackedTileKey& rhs) {
                 return lhs.getLOD() > rhs.getLOD();
             });
 
         for (auto& key : _tilesToUpdate)
         {
-            auto iter = _tiles.find(key);
-            if (iter != _tiles.end())
+            auto iter = _tiles._packed.find(key);
+            if (iter != _tiles._packed.end())
             {
                 iter->second._tile->update(nv);
             }
@@ -227,35 +274,86 @@ TileNodeRegistry::collectDormantTiles(
     unsigned oldestAllowableFrame,
     float farthestAllowableRange,
     unsigned maxTiles,
+    std::size_t maxBytes,
+    unsigned minResidentTiles,
     std::vector<osg::observer_ptr<TileNode>>& output)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    const auto dispose = [&](osg::ref_ptr<TileNode>& tile)
+    {
+        const TileKey& key = tile->getKey();
+
+        if (_notifyNeighbors)
+        {
+            // remove neighbor listeners:
+            stopListeningFor(key.createNeighborKey(1, 0), key);
+            stopListeningFor(key.createNeighborKey(0, 1), key);
+        }
+
+        output.push_back(tile);
+
+        TableEntry* i = _tiles.find(key);
+        if (i)
+        {
+            _totalBytes -= i->_bytes;
+            _tiles.erase(key);
+        }
+    };
+
     unsigned count = 0u;
 
+    // Over the memory budget? Expire the least-recently-visible tiles until we
+    // are back under it. Here a tile only needs to be out of view; the
+    // minimum expiry time and range do not apply.
+    if (maxBytes > 0u && _totalBytes > maxBytes)
+    {
+        const auto disposeOverBudget = [&](osg::ref_ptr<TileNode>& tile) -> bool
+        {
+            OE_SOFT_ASSERT_AND_RETURN(tile, true);
+
+            // A footprint is measured when the tile merges new data, and its
+            // images can be released after that (e.g. once uploaded to the GPU),
+            // so re-measure each dormant tile as we come to it.
+            TableEntry* i = _tiles.find(tile->getKey());
+            if (i && i->_tile == tile)
+            {
+                std::size_t bytes = tile->getMemoryFootprint();
+                _totalBytes = _totalBytes - i->_bytes + bytes;
+                i->_bytes = bytes;
+                if (_totalBytes <= maxBytes)
+                    return false;
+            }
+
+            if (tile->getDoNotExpire() == false &&
+                tile->getLastTraversalFrame() < (int)oldestAllowableFrame &&
+                tile->areSiblingsDormant())
+            {
+                dispose(tile);
+                return true;
+            }
+            return false;
+        };
+
+        count = _tracker.flushOldest(
+            maxTiles,
+            disposeOverBudget,
+            [&]() { return _totalBytes <= maxBytes; });
+
+        _budgetEvictions += count;
+    }
+
     const auto disposeTile = [&](osg::ref_ptr<TileNode>& tile) -> bool
     {
         OE_SOFT_ASSERT_AND_RETURN(tile, true);
 
-        const TileKey& key = tile->getKey();
-
         if (tile->getDoNotExpire() == false &&
             tile->getLastTraversalTime() < oldestAllowableTime &&
             tile->getLastTraversalFrame() < (int)oldestAllowableFrame &&
             tile->getLastTraversalRange() > farthestAllowableRange &&
             tile->areSiblingsDormant())
         {
-            if (_notifyNeighbors)
-            {
-                // remove neighbor listeners:
-                stopListeningFor(key.createNeighborKey(1, 0), key);
-                stopListeningFor(key.createNeighborKey(0, 1), key);
-            }
-
-            output.push_back(tile);
-
-            _tiles.erase(key);
-
+            dispose(tile);
             return true; // dispose it
         }
         else
@@ -266,7 +364,10 @@ TileNodeRegistry::collectDormantTiles(
         }
     };
     
-    _tracker.flush(maxTiles, disposeTile);
+    // flush() also resets the sentry, so always call it
+    unsigned remaining = _tiles.size() > minResidentTiles ? maxTiles - count : 0u;
+    _tracker.flush(remaining, disposeTile);
 
     OE_PROFILING_PLOT(PROFILING_REX_TILES, (float)(_tiles.size()));
+    OE_PROFILING_PLOT(PROFILING_REX_TILE_MEMORY, (float)((double)_totalBytes / 1048576.0));
 }
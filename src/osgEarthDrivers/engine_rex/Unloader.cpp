@@ -35,7 +35,12 @@ UnloaderGroup::traverse(osg::NodeVisitor& nv)
         unsigned frame = _clock->getFrame();
         bool runUpdate = (_frameLastUpdated < frame);
 
-        if (runUpdate && _tiles->size() > _options.getMinResidentTiles())
+        // A memory budget overrides the minimum number of resident tiles.
+        std::size_t maxBytes = (std::size_t)_options.getTileMemoryBudgetMB() * 1048576u;
+        bool overBudget = maxBytes > 0u && _tiles->getTotalBytes() > maxBytes;
+        bool overMinimum = _tiles->size() > _options.getMinResidentTiles();
+
+        if (runUpdate && (overMinimum || overBudget))
         {
             _frameLastUpdated = frame;
 
@@ -57,6 +62,8 @@ UnloaderGroup::traverse(osg::NodeVisitor& nv)
                 oldestAllowableFrame,
                 _options.getMinExpiryRange(),
                 _options.getMaxTilesToUnloadPerFrame(),
+                maxBytes,
+                _options.getMinResidentTiles(),
                 _deadpool);
 
             // Remove them from the scene graph:
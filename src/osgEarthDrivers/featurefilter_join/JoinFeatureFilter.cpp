@@ -98,7 +98,7 @@ public: // FeatureFilter
                     // Copy the attributes from the boundary to the feature (and overwrite)
                     for (const auto& attr : boundary->getAttrs())
                     {
-                        feature->set(attr.first, attr.second);
+                        feature->set(attr.key, attr.second);
                     }
                 }
                 else
@@ -110,7 +110,7 @@ public: // FeatureFilter
                             // Copy the attributes from the boundary to the feature (and overwrite)
                             for (const auto& attr : boundary->getAttrs())
                             {
-                                feature->set(attr.first, attr.second);
+                                feature->set(attr.key, attr.second);
                             }
 
                             // upon success, don't check any more boundaries:
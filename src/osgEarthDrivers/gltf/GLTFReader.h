@@ -25,6 +25,10 @@
 #include <osgEarth/InstanceBuilder>
 #include <osgEarth/StateTransition>
 
+#ifdef OSGEARTH_HAVE_MESH_OPTIMIZER
+#include <meshoptimizer.h>
+#endif
+
 using namespace osgEarth;
 using namespace osgEarth::Util;
 
@@ -74,6 +78,103 @@ public:
         return osgDB::fileExists(abs_filename);
     }
 
+    //! Image loader that keeps KTX2 (KHR_texture_basisu) images encoded so
+    //! they can be transcoded later; anything else goes to the default loader.
+    static bool LoadImageData(tinygltf::Image* image, const int imageIndex, std::string* err,
+        std::string* warn, int reqWidth, int reqHeight, const unsigned char* bytes, int size, void* userData)
+    {
+        static const unsigned char ktx2[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        if (size >= 12 && memcmp(bytes, ktx2, 12) == 0)
+        {
+            image->image.assign(bytes, bytes + size);
+            image->mimeType = "image/ktx2";
+            image->as_is = true;
+            return true;
+        }
+        return tinygltf::LoadImageData(image, imageIndex, err, warn, reqWidth, reqHeight, bytes, size, userData);
+    }
+
+    //! Decodes buffer views compressed with EXT_meshopt_compression (or its
+    //! KHR_ successor) into a new buffer, and points the views at it.
+    static bool decodeMeshopt(tinygltf::Model& model, std::string& err)
+    {
+        tinygltf::Buffer decoded;
+
+        for (auto& view : model.bufferViews)
+        {
+            auto ext = view.extensions.find("EXT_meshopt_compression");
+            if (ext == view.extensions.end())
+                ext = view.extensions.find("KHR_meshopt_compression");
+            if (ext == view.extensions.end())
+                continue;
+
+#ifdef OSGEARTH_HAVE_MESH_OPTIMIZER
+            const tinygltf::Value& value = ext->second;
+            int buffer = (int)value.Get("buffer").GetNumberAsInt();
+            std::size_t byteOffset = value.Has("byteOffset") ? (std::size_t)value.Get("byteOffset").GetNumberAsInt() : 0u;
+            std::size_t byteLength = (std::size_t)value.Get("byteLength").GetNumberAsInt();
+            std::size_t byteStride = (std::size_t)value.Get("byteStride").GetNumberAsInt();
+            std::size_t count = (std::size_t)value.Get("count").GetNumberAsInt();
+            std::string mode = value.Get("mode").IsString() ? value.Get("mode").Get<std::string>() : "";
+            std::string filter = value.Get("filter").IsString() ? value.Get("filter").Get<std::string>() : "NONE";
+
+            if (buffer < 0 || buffer >= (int)model.buffers.size() ||
+                byteOffset + byteLength > model.buffers[buffer].data.size() ||
+                byteStride == 0 || count == 0)
+            {
+                err += "Invalid EXT_meshopt_compression buffer view\n";
+                return false;
+            }
+
+            // keep every view 4-byte aligned in the decoded buffer
+            std::size_t offset = (decoded.data.size() + 3u) & ~std::size_t(3u);
+            decoded.data.resize(offset + count * byteStride);
+            unsigned char* output = decoded.data.data() + offset;
+            const unsigned char* input = model.buffers[buffer].data.data() + byteOffset;
+
+            int result = -1;
+            if (mode == "ATTRIBUTES")
+                result = meshopt_decodeVertexBuffer(output, count, byteStride, input, byteLength);
+            else if (mode == "TRIANGLES")
+                result = meshopt_decodeIndexBuffer(output, count, byteStride, input, byteLength);
+            else if (mode == "INDICES")
+                result = meshopt_decodeIndexSequence(output, count, byteStride, input, byteLength);
+
+            if (result != 0)
+            {
+                err += "Failed to decode EXT_meshopt_compression buffer view (mode " + mode + ")\n";
+                return false;
+            }
+
+            if (filter == "OCTAHEDRAL")
+                meshopt_decodeFilterOct(output, count, byteStride);
+            else if (filter == "QUATERNION")
+                meshopt_decodeFilterQuat(output, count, byteStride);
+            else if (filter == "EXPONENTIAL")
+                meshopt_decodeFilterExp(output, count, byteStride);
+            else if (filter != "NONE")
+            {
+                err += "Unsupported EXT_meshopt_compression filter " + filter + "\n";
+                return false;
+            }
+
+            view.buffer = (int)model.buffers.size();
+            view.byteOffset = offset;
+            view.byteLength = count * byteStride;
+            view.extensions.erase(ext);
+#else
+            err += "EXT_meshopt_compression requires osgEarth to be built with meshoptimizer\n";
+            return false;
+#endif
+        }
+
+        if (!decoded.data.empty())
+        {
+            model.buffers.emplace_back(std::move(decoded));
+        }
+        return true;
+    }
+
     struct Env
     {
         Env(const std::string& loc, const osgDB::Options* opt) : referrer(loc), readOptions(opt) { }
@@ -109,6 +210,7 @@ public:
         fs.WriteWholeFile = &tinygltf::WriteWholeFile;
         fs.user_data = (void*)&location;
         loader.SetFsCallbacks(fs);
+        loader.SetImageLoader(&GLTFReader::LoadImageData, nullptr);
 
         tinygltf::Options opt;
         opt.skip_imagery = readOptions && readOptions->getOptionString().find("gltfSkipImagery") != std::string::npos;
@@ -146,6 +248,11 @@ public:
             }
         }
 
+        if (err.empty())
+        {
+            decodeMeshopt(model, err);
+        }
+
         if (!err.empty()) {
             OE_WARN << LC << "gltf Error loading " << location << std::endl;
             OE_WARN << LC << err << std::endl;
@@ -169,6 +276,7 @@ public:
         fs.WriteWholeFile = &tinygltf::WriteWholeFile;
         fs.user_data = (void*)&location;
         loader.SetFsCallbacks(fs);
+        loader.SetImageLoader(&GLTFReader::LoadImageData, nullptr);
 
         tinygltf::Options opt;
         opt.skip_imagery = readOptions && readOptions->getOptionString().find("gltfSkipImagery") != std::string::npos;
@@ -196,6 +304,11 @@ public:
             loader.LoadASCIIFromString(&model, &err, &warn, data->c_str(), data->size(), "", REQUIRE_VERSION, &opt);
         }
 
+        if (err.empty())
+        {
+            decodeMeshopt(model, err);
+        }
+
         if (!err.empty()) {
             OE_WARN << LC << "gltf Error loading " << location << std::endl;
             OE_WARN << LC << err << std::endl;
@@ -397,10 +510,21 @@ public:
             return top;
         }
 
-        osg::Texture2D* makeTextureFromModel(const tinygltf::Texture& texture) const
+        //! Image of a texture, preferring the KHR_texture_basisu source
+        const tinygltf::Image* getTextureImage(const tinygltf::Texture& texture) const
+        {
+            int source = texture.source;
+            auto ext = texture.extensions.find("KHR_texture_basisu");
+            if (ext != texture.extensions.end() && ext->second.Get("source").IsNumber())
+            {
+                source = (int)ext->second.Get("source").GetNumberAsInt();
+            }
+            return source >= 0 && source < (int)model.images.size() ? &model.images[source] : nullptr;
+        }
 
+        osg::Texture2D* makeTextureFromModel(const tinygltf::Texture& texture) const
         {
-            const tinygltf::Image& image = model.images[texture.source];
+            const tinygltf::Image& image = *getTextureImage(texture);
             bool imageEmbedded =
                 tinygltf::IsDataURI(image.uri) ||
                 image.image.size() > 0;
@@ -414,7 +538,28 @@ public:
             // First load the image
             osg::ref_ptr<osg::Image> img;
 
-            if (image.image.size() > 0)
+            if (image.as_is)
+            {
+                // KTX2/Basis Universal; transcoded here on the loader thread
+                // by the basis plugin
+                osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("ktx2");
+                if (rw)
+                {
+                    std::stringstream buf(std::string(image.image.begin(), image.image.end()));
+                    osgDB::ReaderWriter::ReadResult rr = rw->readImage(buf, env.readOptions);
+                    if (rr.validImage())
+                    {
+                        img = rr.takeImage();
+                        img->flipVertical();
+                    }
+                }
+                if (!img.valid())
+                {
+                    OE_WARN << LC << "Failed to transcode KTX2 texture in " << env.referrer << std::endl;
+                }
+            }
+
+            else if (image.image.size() > 0)
             {
                 GLenum format = GL_RGB, texFormat = GL_RGB8;
                 if (image.component == 4) format = GL_RGBA, texFormat = GL_RGBA8;
@@ -558,7 +703,9 @@ public:
                             {
                                 int index = i->second;
                                 const tinygltf::Texture& texture = model.textures[index];
-                                const tinygltf::Image& image = model.images[texture.source];
+                                if (getTextureImage(texture) == nullptr)
+                                    continue;
+                                const tinygltf::Image& image = *getTextureImage(texture);
                                 // don't cache embedded textures!
                                 bool imageEmbedded =
                                     tinygltf::IsDataURI(image.uri) ||
@@ -655,6 +802,14 @@ public:
                     }
                 }
 
+                // Nothing to draw if the vertices or indices could not be decoded
+                if (!geom->getVertexArray() || (primitive.indices >= 0 && !arrays[primitive.indices].valid()))
+                {
+                    OE_WARN << LC << "Skipping a primitive with undecodable data in " << env.referrer << std::endl;
+                    group->removeChild(geode);
+                    continue;
+                }
+
                 // If there is no color array just add one that has the base color factor in it.
                 if (!geom->getColorArray())
                 {
@@ -799,9 +954,19 @@ public:
             for (unsigned int i = 0; i < model.accessors.size(); i++)
             {
                 const tinygltf::Accessor& accessor = model.accessors[i];
+                osg::ref_ptr< osg::Array > osgArray;
+
+                // e.g. a Draco-compressed accessor that was not decoded
+                if (accessor.bufferView < 0 || accessor.bufferView >= (int)model.bufferViews.size() ||
+                    model.bufferViews[accessor.bufferView].buffer < 0 ||
+                    model.buffers[model.bufferViews[accessor.bufferView].buffer].data.empty())
+                {
+                    arrays.push_back(osgArray);
+                    continue;
+                }
+
                 const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
                 const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
-                osg::ref_ptr< osg::Array > osgArray;
 
                 switch (accessor.componentType)
                 {
@@ -35,12 +35,16 @@
 #include <osgUtil/Optimizer>
 #include <osgUtil/SmoothingVisitor>
 
+#include <algorithm>
 #include <cstdlib> // getenv
 #include <random>
+#include <thread>
+#include <unordered_map>
 
 #define LC "[VegetationLayer] " << getName() << ": "
 
 #define JOB_ARENA_VEGETATION "oe.vegetation"
+#define JOB_ARENA_VEGETATION_PLACEMENT "oe.vegetation.placement"
 
 #define OE_DEVEL OE_DEBUG
 
@@ -120,6 +124,8 @@ VegetationLayer::Options::getConfig() const
     conf.set("max_texture_size", maxTextureSize());
     conf.set("render_bin_number", renderBinNumber());
     conf.set("threads", threads());
+    conf.set("placement_cache_size", placementCacheSize());
+    conf.set("placement_block_size", placementBlockSize());
 
     Config layers("layers");
     for (auto group_name : { GROUP_TREES, GROUP_BUSHES, GROUP_UNDERGROWTH })
@@ -198,6 +204,8 @@ VegetationLayer::Options::fromConfig(const Config& conf)
     conf.get("max_texture_size", maxTextureSize());
     conf.get("render_bin_number", renderBinNumber());
     conf.get("threads", threads());
+    conf.get("placement_cache_size", placementCacheSize());
+    conf.get("placement_block_size", placementBlockSize());
 
     // some nice default group settings
     groups()[GROUP_TREES].lod().setDefault(14);
@@ -348,6 +356,14 @@ VegetationLayer::openImplementation()
 
     _lastVisit.setFrameNumber(~0);
 
+    if (options().placementCacheSize() > 0u)
+        _placementCache.setCapacity(options().placementCacheSize().get());
+    _placementCache.setMetricsName("vegetation.placement");
+
+    // placement sampling is short, CPU-bound work
+    jobs::get_pool(JOB_ARENA_VEGETATION_PLACEMENT)->set_concurrency(
+        osg::clampBetween(std::thread::hardware_concurrency(), 2u, 8u));
+
     return PatchLayer::openImplementation();
 }
 
@@ -404,6 +420,7 @@ VegetationLayer::update(osg::NodeVisitor& nv)
         {
             std::lock_guard<std::mutex> lock(_assets.mutex());
             _assets = std::move(_newAssets.release());
+            ++_placementRevision;
         }
 
         // do we need to activate A2C?
@@ -414,6 +431,9 @@ VegetationLayer::update(osg::NodeVisitor& nv)
 void
 VegetationLayer::dirty()
 {
+    ++_placementRevision;
+    _placementCache.clear();
+
     _tiles.scoped_lock([this]()
         {
             _tiles.clear();
@@ -1165,8 +1185,11 @@ VegetationLayer::reset()
     _assets.scoped_lock([this]()
         {
             _assets.clear();
+            ++_placementRevision;
         });
 
+    _placementCache.clear();
+
     _tiles.scoped_lock([this]()
         {
             _tiles.clear();
@@ -1221,6 +1244,109 @@ VegetationLayer::createDrawableAsync(
 #undef RAND
 #define RAND() prng.next()
 
+namespace
+{
+    // Lushness-based asset selector for one biome's assets. Any lushness
+    // value either falls exactly on one of the assets' min/max lush bounds
+    // or strictly between two neighboring bounds, and each of those cases
+    // has a fixed set of matching assets; so we build their indices and
+    // cumulative weights once instead of scanning the assets per instance.
+    struct AssetSelector
+    {
+        struct Entry
+        {
+            std::vector<unsigned> indices;
+            std::vector<float> cdf;
+        };
+
+        // sorted, unique lush bounds of all assets
+        std::vector<float> bounds;
+
+        // entries[2k] covers (bounds[k-1], bounds[k]); entries[2k+1] covers bounds[k]
+        std::vector<Entry> entries;
+
+        AssetSelector(const std::vector<ResidentModelAssetInstance>& instances)
+        {
+            for (auto& instance : instances)
+            {
+                bounds.push_back(instance.residentAsset()->assetDef()->minLush().get());
+                bounds.push_back(instance.residentAsset()->assetDef()->maxLush().get());
+            }
+            std::sort(bounds.begin(), bounds.end());
+            bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+            // the first and last entries lie outside all bounds and stay empty
+            entries.resize(2 * bounds.size() + 1);
+            for (unsigned e = 1; e + 1 < entries.size(); ++e)
+            {
+                unsigned k = e / 2;
+                float lo = (e & 1) ? bounds[k] : bounds[k - 1];
+                float hi = bounds[k];
+
+                float cumulativeWeight = 0.0f;
+                for (unsigned i = 0; i < instances.size(); ++i)
+                {
+                    float min_lush = instances[i].residentAsset()->assetDef()->minLush().get();
+                    float max_lush = instances[i].residentAsset()->assetDef()->maxLush().get();
+
+                    if (min_lush <= lo && hi <= max_lush)
+                    {
+                        entries[e].indices.push_back(i);
+                        cumulativeWeight += instances[i].weight();
+                        entries[e].cdf.push_back(cumulativeWeight);
+                    }
+                }
+            }
+        }
+
+        //! Index of the asset to use for a lushness value and a random
+        //! number [0..1], or -1 if no asset matches the lushness.
+        int select(float lush, float r) const
+        {
+            auto k = std::upper_bound(bounds.begin(), bounds.end(), lush) - bounds.begin();
+            const Entry& entry = (k > 0 && bounds[k - 1] == lush) ? entries[2 * k - 1] : entries[2 * k];
+
+            if (entry.indices.empty())
+                return -1;
+
+            if (entry.indices.size() == 1)
+                return entry.indices.front();
+
+            float w = r * entry.cdf.back();
+            auto i = std::lower_bound(entry.cdf.begin(), entry.cdf.end() - 1, w) - entry.cdf.begin();
+            return entry.indices[i];
+        }
+    };
+
+    struct BiomeSelection
+    {
+        const std::vector<ResidentModelAssetInstance>* instances;
+        AssetSelector selector;
+    };
+
+    // Placement candidates, stored by attribute so each pass over them
+    // touches only the data it needs.
+    struct Candidates
+    {
+        // random numbers, drawn up front in a fixed order
+        std::vector<float> u, v;
+        std::vector<float> asset_rand;
+        std::vector<float> rotation_rand;
+        std::vector<float> lush_offset;
+
+        // sampled results; instance is null for rejected candidates
+        std::vector<const ResidentModelAssetInstance*> instance;
+        std::vector<const Biome*> biome;
+        std::vector<float> density;
+        std::vector<float> clumpy;
+        std::vector<char> constrained;
+
+        Candidates(unsigned size) :
+            u(size), v(size), asset_rand(size), rotation_rand(size), lush_offset(size),
+            instance(size, nullptr), biome(size, nullptr), density(size), clumpy(size), constrained(size, 0) { }
+    };
+}
+
 bool
 VegetationLayer::getAssetPlacements(
     const TileKey& key,
@@ -1252,6 +1378,27 @@ VegetationLayer::getAssetPlacements(
     // by the biome manager.
     AssetsByBiomeId groupAssets;
 
+    // Placements are a pure function of the tile, the group's assets and
+    // the map data, so a revisited tile can reuse its earlier placements.
+    const bool useCache = options().placementCacheSize() > 0u;
+    PlacementCacheKey cacheKey;
+    int revision = 0;
+
+    auto readFromCache = [&]()
+        {
+            if (useCache)
+            {
+                cacheKey = std::make_tuple(key, group, revision, (int)map->getDataModelRevision());
+                auto cached = _placementCache.get(cacheKey);
+                if (cached.has_value())
+                {
+                    output = *cached.value();
+                    return true;
+                }
+            }
+            return false;
+        };
+
     if (loadBiomesOnDemand == false)
     {
         std::lock_guard<std::mutex> lock(_assets.mutex());
@@ -1266,6 +1413,7 @@ VegetationLayer::getAssetPlacements(
         else
         {
             groupAssets = iter->second; //shallow copy
+            revision = _placementRevision;
         }
 
         // if it's empty, bail out (and probably return later)
@@ -1276,6 +1424,11 @@ VegetationLayer::getAssetPlacements(
         }
     }
 
+    if (loadBiomesOnDemand == false && readFromCache())
+    {
+        return true;
+    }
+
     // Load a lifemap raster:
     GeoImage lifemap;
     osg::Matrix lifemap_sb;
@@ -1331,6 +1484,7 @@ VegetationLayer::getAssetPlacements(
             {
                 std::lock_guard<std::mutex> lock(_assets.mutex());
                 _assets = std::move(newAssets);
+                ++_placementRevision;
             }
         }
 
@@ -1346,6 +1500,7 @@ VegetationLayer::getAssetPlacements(
             else
             {
                 groupAssets = iter->second; // shallow copy
+                revision = _placementRevision;
             }
         }
 
@@ -1355,11 +1510,15 @@ VegetationLayer::getAssetPlacements(
             output = std::move(result);
             return true;
         }
+
+        if (readFromCache())
+        {
+            return true;
+        }
     }
 
     const Biome* default_biome = groupAssets.begin()->second.biome;
 
-    osg::Vec4f noise;
     ImageUtils::PixelReader readNoise(_noiseTex->osgTexture()->getImage(0));
     readNoise.setSampleAsRepeatingTexture(true);
 
@@ -1387,14 +1546,8 @@ VegetationLayer::getAssetPlacements(
 
     const GeoExtent& e = key.getExtent();
 
-    osg::Vec4f lifemap_value;
-    osg::Vec4f biomemap_value;
-    std::vector<double> hits;
-
     auto catalog = getBiomeLayer()->getBiomeCatalog();
 
-    bool scaleWithDensity = (group == GROUP_UNDERGROWTH);
-
     // determine a local tile bbox size for collisions and uv generation
     // note. This doesn't take elevation data into account. Does that matter?
     auto& ex = key.getExtent();
@@ -1407,14 +1560,12 @@ VegetationLayer::getAssetPlacements(
     double local_width = x1 - x0;
     double local_height = y1 - y0;
 
-    // keep track of biomes with no assets (for a possible error condition?)
-    std::set<const Biome*> empty_biomes;
-
-    // indicies of assets selected based on their lushness
-    std::vector<unsigned> assetIndices;
-
-    // cumulative density function based on asset weights
-    std::vector<float> assetCDF;
+    // asset selectors for each biome in the group
+    std::unordered_map<std::string, BiomeSelection> selections;
+    for (auto& iter : groupAssets)
+    {
+        selections.emplace(iter.first, BiomeSelection{ &iter.second.instances, AssetSelector(iter.second.instances) });
+    }
 
 
     //TEMP - DEBUGGING DETERMINISTIC BEHAVIOR.
@@ -1427,139 +1578,172 @@ VegetationLayer::getAssetPlacements(
     // normal distribution for lushness
     std::normal_distribution<float> normal_dist(0.0f, 1.0f / 6.0f);
 
-    // Generate random instances within the tile:
+    Candidates candidates(max_instances);
+
+    // Draw all the random numbers first, in a fixed order, so the placements
+    // stay deterministic no matter how the sampling below is scheduled.
     for (unsigned i = 0; i < max_instances; ++i)
     {
-        // perform all random number generations first to preserve determinism
-        // in the even of an early loop break.
-
         // random tile-normalized position:
-        float u = RAND();
-        float v = RAND();
-
-        float asset_index_rand = RAND();
-        float rotation_rand = RAND();
-        float normal_rand = RAND();
-        float lush_offset = normal_dist(gen);
+        candidates.u[i] = RAND();
+        candidates.v[i] = RAND();
 
+        candidates.asset_rand[i] = RAND();
+        candidates.rotation_rand[i] = RAND();
+        RAND(); // unused, but keeps the sequence stable
+        candidates.lush_offset[i] = normal_dist(gen);
+    }
 
-        // resolve the biome at this position:
-        const Biome* biome = nullptr;
-        if (biomemap.valid())
+    // Resolves the biome, life map, noise and asset for a range of
+    // candidates. Each candidate is independent, so blocks can run
+    // in parallel.
+    auto sample = [&](unsigned begin, unsigned end)
         {
-            float uu = u * biomemap_sb(0, 0) + biomemap_sb(3, 0);
-            float vv = v * biomemap_sb(1, 1) + biomemap_sb(3, 1);
-            biomemap.getReader()(biomemap_value, uu, vv);
-            int index = (int)biomemap_value.r();
-            biome = catalog->getBiomeByIndex(index);
-            if (!biome)
+            // block-local biome lookup, to avoid hashing the biome id per candidate
+            std::unordered_map<const Biome*, const BiomeSelection*> selectionOf;
+
+            osg::Vec4f noise;
+            osg::Vec4f lifemap_value;
+            osg::Vec4f biomemap_value;
+
+            for (unsigned i = begin; i < end; ++i)
             {
-                if (debug) OE_INFO << LC << "Instance " << i << " has invalid biome index " << index << std::endl;
-                continue;
-            }
-        }
+                float u = candidates.u[i];
+                float v = candidates.v[i];
 
-        if (biome == nullptr)
-        {
-            // not sure this is even possible
-            biome = default_biome;
-        }
+                // resolve the biome at this position:
+                const Biome* biome = nullptr;
+                if (biomemap.valid())
+                {
+                    float uu = u * biomemap_sb(0, 0) + biomemap_sb(3, 0);
+                    float vv = v * biomemap_sb(1, 1) + biomemap_sb(3, 1);
+                    biomemap.getReader()(biomemap_value, uu, vv);
+                    int index = (int)biomemap_value.r();
+                    biome = catalog->getBiomeByIndex(index);
+                    if (!biome)
+                    {
+                        continue;
+                    }
+                }
 
-        // fetch the collection of assets belonging to the selected biome:
-        auto iter = groupAssets.find(biome->id());
-        if (iter == groupAssets.end())
-        {
-            empty_biomes.insert(biome);
-            if (debug) OE_INFO << LC << "Instance " << i << " has no assets for biome " << biome->id() << std::endl;
-            continue;
-        }
-        ResidentBiomeModelAssetInstances& biome_assets = iter->second;
+                if (biome == nullptr)
+                {
+                    // not sure this is even possible
+                    biome = default_biome;
+                }
 
-        // sample the noise texture at this (u,v)
-        readNoise(noise, u, v);
+                // fetch the collection of assets belonging to the selected biome:
+                auto s = selectionOf.find(biome);
+                if (s == selectionOf.end())
+                {
+                    auto iter = selections.find(biome->id());
+                    s = selectionOf.emplace(biome, iter != selections.end() ? &iter->second : nullptr).first;
+                }
+                const BiomeSelection* selection = s->second;
+                if (selection == nullptr)
+                {
+                    continue;
+                }
 
-        // read the life map at this point:
-        float density = 1.0f;
-        float lush = 1.0f;
-        if (lifemap.valid())
-        {
-            float uu = u * lifemap_sb(0, 0) + lifemap_sb(3, 0);
-            float vv = v * lifemap_sb(1, 1) + lifemap_sb(3, 1);
-            lifemap.getReader()(lifemap_value, uu, vv);
-            density = lifemap_value[LIFEMAP_DENSE];
-            lush = lifemap_value[LIFEMAP_LUSH];
-        }
+                // sample the noise texture at this (u,v)
+                readNoise(noise, u, v);
 
-        auto& assetInstances = biome_assets.instances;
+                // read the life map at this point:
+                float density = 1.0f;
+                float lush = 1.0f;
+                if (lifemap.valid())
+                {
+                    float uu = u * lifemap_sb(0, 0) + lifemap_sb(3, 0);
+                    float vv = v * lifemap_sb(1, 1) + lifemap_sb(3, 1);
+                    lifemap.getReader()(lifemap_value, uu, vv);
+                    density = lifemap_value[LIFEMAP_DENSE];
+                    lush = lifemap_value[LIFEMAP_LUSH];
+                }
 
-        // RNG with normal distribution between approx lush-1..lush+1
-        // Note: moved this earlier in the loop to make it deterministic
-        //std::normal_distribution<float> normal_dist(lush, 1.0f / 6.0f);
-        lush = clamp(lush + lush_offset, 0.0f, 1.0f);
+                // RNG with normal distribution between approx lush-1..lush+1
+                lush = clamp(lush + candidates.lush_offset[i], 0.0f, 1.0f);
 
-        assetIndices.clear();
-        assetCDF.clear();
-        float cumulativeWeight = 0.0f;
-        for (unsigned i = 0; i < assetInstances.size(); ++i)
-        {
-            float min_lush = assetInstances[i].residentAsset()->assetDef()->minLush().get();
-            float max_lush = assetInstances[i].residentAsset()->assetDef()->maxLush().get();
+                // if there are no assets that match the lushness criteria, move on.
+                int assetIndex = selection->selector.select(lush, candidates.asset_rand[i]);
+                if (assetIndex < 0)
+                {
+                    continue;
+                }
 
-            if (lush >= min_lush && lush <= max_lush)
-            {
-                assetIndices.push_back(i);
-                cumulativeWeight += assetInstances[i].weight();
-                assetCDF.push_back(cumulativeWeight);
+                auto& instance = (*selection->instances)[assetIndex];
+
+                // if there's no geometry... bye
+                if (instance.residentAsset()->chonk() == nullptr)
+                {
+                    continue;
+                }
+
+                candidates.instance[i] = &instance;
+                candidates.biome[i] = biome;
+
+                // apply instance-specific density adjustment:
+                candidates.density[i] = density * instance.coverage();
+                candidates.clumpy[i] = noise[N_CLUMPY];
+
+                if (!constraints.empty())
+                {
+                    candidates.constrained[i] = inConstrainedRegion(
+                        e.xMin() + u * e.width(), e.yMin() + v * e.height(), constraints) ? 1 : 0;
+                }
             }
-        }
+        };
 
-        // if there are no assets that match the lushness criteria, move on.
-        if (assetIndices.empty())
-        {
-            if (debug) OE_INFO << LC << "Instance " << i << " has no assets for lushness " << lush << std::endl;
-            continue;
-        }
+    const unsigned blockSize = options().placementBlockSize().get();
+    unsigned blocks = blockSize > 0u ? (max_instances + blockSize - 1) / blockSize : 1u;
+    if (blocks > 1)
+    {
+        jobs::context job;
+        job.name = "Vegetation placement";
+        job.pool = jobs::get_pool(JOB_ARENA_VEGETATION_PLACEMENT);
+        job.group = jobs::jobgroup::create();
 
-        int assetIndex = 0;
-        if (assetIndices.size() > 1)
+        for (unsigned b = 0; b < blocks; ++b)
         {
-            float k = asset_index_rand * cumulativeWeight;
-            for (assetIndex = 0;
-                assetIndex < assetCDF.size() - 1 && k > assetCDF[assetIndex];
-                ++assetIndex);
+            unsigned begin = b * blockSize;
+            unsigned end = std::min(begin + blockSize, max_instances);
+            jobs::dispatch([&sample, begin, end]() { sample(begin, end); }, job);
         }
-        auto& instance = assetInstances[assetIndices[assetIndex]];
-        auto& asset = instance.residentAsset();
 
-        // if there's no geometry... bye
-        if (asset->chonk() == nullptr)
+        job.group->join();
+    }
+    else
+    {
+        sample(0, max_instances);
+    }
+
+    if (progress && progress->isCanceled())
+    {
+        return false;
+    }
+
+    // Place the surviving candidates in order, since each one's collision
+    // test depends on the ones placed before it.
+    for (unsigned i = 0; i < max_instances; ++i)
+    {
+        const ResidentModelAssetInstance* instance = candidates.instance[i];
+        if (instance == nullptr)
         {
-            if (debug) OE_INFO << LC << "Instance " << i << " has no geometry" << std::endl;
             continue;
         }
 
+        auto& asset = instance->residentAsset();
+
         osg::Vec3d scale(1, 1, 1);
 
         // Apply a size variation with some randomness
         if (asset->assetDef()->sizeVariation().isSet())
         {
             scale *= 1.0 + (asset->assetDef()->sizeVariation().get() *
-                (noise[N_CLUMPY] * 2.0f - 1.0f));
+                (candidates.clumpy[i] * 2.0f - 1.0f));
         }
 
-        // apply instance-specific density adjustment:
-        density *= instance.coverage();
-
-#if 0
-        // Removed, because this is causing the placement to go non-deterministic
-        // for some reason that I have not yet identified.
-        const float edge_threshold = 0.10f;
-        if (scaleWithDensity && density < edge_threshold)
-        {
-            float edginess = (density / edge_threshold);
-            scale *= edginess;
-        }
-#endif
+        float u = candidates.u[i];
+        float v = candidates.v[i];
 
         // tile-local coordinates of the position:
         osg::Vec2d local(
@@ -1591,20 +1775,18 @@ VegetationLayer::getAssetPlacements(
 
         if (pass)
         {
-            osg::Vec3d map_point(e.xMin() + u * e.width(), e.yMin() + v * e.height(), 0);
-
-            if (!inConstrainedRegion(map_point.x(), map_point.y(), constraints))
+            if (!candidates.constrained[i])
             {
-                map_points.emplace_back(map_point);
+                map_points.emplace_back(e.xMin() + u * e.width(), e.yMin() + v * e.height(), 0);
 
                 Placement p;
                 p.localPoint() = local;
                 p.uv().set(u, v);
                 p.scale() = scale;
-                p.rotation() = rotation_rand * 3.1415927 * 2.0;
+                p.rotation() = candidates.rotation_rand[i] * 3.1415927 * 2.0;
                 p.asset() = asset;
-                p.density() = density;
-                p.biome = biome;
+                p.density() = candidates.density[i];
+                p.biome = candidates.biome[i];
 
                 result.emplace_back(std::move(p));
             }
@@ -1660,22 +1842,15 @@ VegetationLayer::getAssetPlacements(
         result[i].mapPoint() = std::move(map_points[i]);
     }
 
-#if 0
-    // print warnings about empty biomes
-    if (!empty_biomes.empty())
+    if (useCache && !(progress && progress->isCanceled()))
     {
-        for (auto biome : empty_biomes)
-        {
-            OE_WARN << LC << "No assets defined in group " << AssetGroup::name(group) << " for biome " << biome->id() << std::endl;
-        }
+        _placementCache.insert(cacheKey, std::make_shared<const std::vector<Placement>>(result));
     }
-#endif
 
     output = std::move(result);
     return true;
 }
 
-
 std::string
 VegetationLayer::simulateAssetPlacement(const GeoPoint& point, const std::string& group) const
 {
@@ -1789,6 +1964,7 @@ VegetationLayer::simulateAssetPlacement(const GeoPoint& point, const std::string
             {
                 std::lock_guard<std::mutex> lock(_assets.mutex());
                 _assets = std::move(newAssets);
+                ++_placementRevision;
             }
         }
 
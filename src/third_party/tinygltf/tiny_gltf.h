@@ -3848,6 +3848,23 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const json &o,
   buffer->uri.clear();
   ParseStringProperty(&buffer->uri, err, o, "uri", false, "Buffer");
 
+  // A meshopt fallback buffer carries no data when every view into it is
+  // decoded from a compressed buffer (EXT_meshopt_compression).
+  if (buffer->uri.empty()) {
+    ParseExtensionsProperty(&buffer->extensions, err, o);
+    for (const char *name :
+         {"EXT_meshopt_compression", "KHR_meshopt_compression"}) {
+      auto ext = buffer->extensions.find(name);
+      if (ext != buffer->extensions.end() && ext->second.Has("fallback") &&
+          ext->second.Get("fallback").IsBool() &&
+          ext->second.Get("fallback").Get<bool>()) {
+        ParseStringProperty(&buffer->name, err, o, "name", false);
+        ParseExtrasProperty(&buffer->extras, o);
+        return true;
+      }
+    }
+  }
+
   // having an empty uri for a non embedded image should not be valid
   if (!is_binary && buffer->uri.empty()) {
     if (err) {